@@ -18,6 +18,7 @@ layout(push_constant) uniform push_constants {
 
 	// Only guaranteed a total of 128 bytes.
 	mat4 model; // 64 bytes
+	uint material_index;
 } u_push_constants;
 
 layout(location = 0) out int out_mode;
@@ -33,7 +34,11 @@ layout(location = 1) out struct dto {
 	vec4 tangent;
 } out_dto;
 
+// Read by the bindless fragment variant, instanced draws pass their own per instance.
+layout(location = 8) flat out uint out_material_index;
+
 void main() {
+	out_material_index = u_push_constants.material_index;
 
 	mat3 m3_model = mat3(u_push_constants.model);
 
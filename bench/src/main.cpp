@@ -0,0 +1,89 @@
+#include "scene_bench.hpp"
+#include "transform_bench.hpp"
+
+// Usage:
+//   bench scene <camera path> [--mesh name] [--scale s] [--no-occlusion] [--warmup frames] [--csv file]
+//                [--copies n] [--threads n] [--indirect]
+//   bench transforms [node count] [--iterations n]
+// Run from bin like the sandbox, assets are read from ../assets.
+static void PrintUsage() {
+    printf("Usage: bench scene <camera path> [--mesh name] [--scale s] [--no-occlusion] [--warmup frames] [--csv file]\n");
+    printf("                   [--copies n] [--threads n] [--indirect]\n");
+    printf("       bench transforms [node count] [--iterations n]\n");
+}
+
+static i32 RunScene(i32 argc, char** argv) {
+    if (argc < 3) {
+        PrintUsage();
+        return 1;
+    }
+
+    SceneBenchOptions& options = SceneBench::options;
+    options.camera_path = argv[2];
+    for (i32 i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        b8 has_value = i + 1 < argc;
+        if (arg == "--no-occlusion") {
+            options.occlusion = false;
+        } else if (arg == "--mesh" && has_value) {
+            options.mesh = argv[++i];
+        } else if (arg == "--scale" && has_value) {
+            options.scale = strtof(argv[++i], nullptr);
+        } else if (arg == "--warmup" && has_value) {
+            options.warmup = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--csv" && has_value) {
+            options.csv = argv[++i];
+        } else if (arg == "--copies" && has_value) {
+            options.copies = std::max(strtoul(argv[++i], nullptr, 10), 1ul);
+        } else if (arg == "--threads" && has_value) {
+            options.threads = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--indirect") {
+            options.submit_mode = Engine::RendererSubmitMode::INDIRECT;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    // Same size as the sandbox window, so recorded paths see the same frustum.
+    ApplicationSetup setup{
+        "Bench",
+        1280, 800,
+        100, 100,
+        true,
+        options.threads
+    };
+    EngineRunner<SceneBench> runner(setup);
+    runner.Run({ argc, argv });
+    return 0;
+}
+
+static i32 RunTransforms(i32 argc, char** argv) {
+    u32 node_count = 100000;
+    u32 iterations = 50;
+    for (i32 i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = strtoul(argv[++i], nullptr, 10);
+        } else {
+            node_count = strtoul(argv[i], nullptr, 10);
+        }
+    }
+    i32 result = RunTransformBench(node_count, iterations);
+    if (result) {
+        PrintUsage();
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "scene") {
+        return RunScene(argc, argv);
+    }
+    if (mode == "transforms") {
+        return RunTransforms(argc, argv);
+    }
+    PrintUsage();
+    return 1;
+}
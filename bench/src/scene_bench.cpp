@@ -0,0 +1,167 @@
+#include "scene_bench.hpp"
+#include <cstdio>
+
+using namespace Engine;
+
+SceneBenchOptions SceneBench::options;
+
+// Average and worst of one counter over the samples, timed_only skips frames without timings.
+template<typename F>
+static void PrintSummary(const char* name, const std::vector<SceneBenchSample>& samples, F value, b8 timed_only = false) {
+    f64 sum = 0.0;
+    f64 max = 0.0;
+    u32 count = 0;
+    for (const SceneBenchSample& sample : samples) {
+        if (timed_only && !sample.has_timings) {
+            continue;
+        }
+        f64 v = value(sample);
+        sum += v;
+        max = std::max(max, v);
+        count++;
+    }
+    printf("  %-20s avg %10.3f  max %10.3f\n", name, count ? sum / count : 0.0, max);
+}
+
+static f64 GetCulledPercent(const OcclusionStats& stats) {
+    return stats.candidates ? 100.0 * stats.culled / stats.candidates : 0.0;
+}
+
+b8 SceneBench::Initialize() {
+    if (!path.Load(options.camera_path) || !path.GetFrameCount()) {
+        ERROR("SceneBench - camera path '%s' has no frames.", options.camera_path.c_str());
+        return false;
+    }
+
+    MeshResource* mesh_resource = (MeshResource*)ResourceSystem::GetInstance()->LoadResource(ResourceType::MESH, options.mesh);
+    if (!mesh_resource) {
+        ERROR("SceneBench - unable to load mesh '%s'.", options.mesh.c_str());
+        return false;
+    }
+    GeometrySystem* gs = GeometrySystem::GetInstance();
+    MeshCreateConfig config{};
+    GeometryConfigs configs = mesh_resource->GetConfigs();
+    for (u32 i = 0; i < configs.size(); ++i) {
+        config.geometries.push_back(gs->AcquireGeometryFromConfig(configs[i], true));
+    }
+    config.transform = new Transform(glm::vec3(0), glm::identity<glm::quat>(), glm::vec3(options.scale));
+    meshes.push_back(new Mesh(config));
+    delete mesh_resource;
+    CreateCopies();
+
+    RendererFrontend* renderer = RendererFrontend::GetInstance();
+    renderer->meshes = meshes;
+    renderer->SetOcclusionCulling(options.occlusion);
+    renderer->SetSubmitMode(options.submit_mode);
+    return true;
+}
+
+void SceneBench::CreateCopies() {
+    Mesh* source = meshes[0];
+    glm::vec3 min_extents = glm::vec3(0.0f);
+    glm::vec3 max_extents = glm::vec3(0.0f);
+    for (Geometry* geometry : source->geometries) {
+        if (geometry->HasExtent()) {
+            min_extents = glm::min(min_extents, geometry->GetExtent().min_extents);
+            max_extents = glm::max(max_extents, geometry->GetExtent().max_extents);
+        }
+    }
+    glm::vec3 size = (max_extents - min_extents) * options.scale;
+    f32 spacing = std::max(std::max(size.x, size.z) * 1.1f, 1.0f);
+    u32 columns = (u32)std::ceil(std::sqrt((f32)options.copies));
+
+    GeometrySystem* gs = GeometrySystem::GetInstance();
+    for (u32 i = 1; i < options.copies; ++i) {
+        MeshCreateConfig config{};
+        for (GeometryHandle handle : source->handles) {
+            gs->AcquireGeometry(handle);
+            config.geometries.push_back(handle);
+        }
+        glm::vec3 position = glm::vec3((f32)(i % columns) * spacing, 0.0f, (f32)(i / columns) * spacing);
+        config.transform = new Transform(position, glm::identity<glm::quat>(), glm::vec3(options.scale));
+        meshes.push_back(new Mesh(config));
+    }
+}
+
+b8 SceneBench::Update(float delta, InputSystem* input) {
+    RendererFrontend* renderer = RendererFrontend::GetInstance();
+    u32 end = options.warmup + path.GetFrameCount();
+
+    // Update runs before each DrawFrame, so the stats read here are the previous pose's.
+    if (frame > options.warmup && frame <= end) {
+        SceneBenchSample sample;
+        sample.occlusion = renderer->GetOcclusionStats();
+        sample.queue = renderer->GetFrameStats();
+        samples.push_back(sample);
+    }
+
+    // Timings come a few frames late and only for the newest completed frame, pose i is frame warmup + i.
+    RendererFrameTimings timings;
+    if (renderer->GetFrameTimings(&timings) && timings.frame >= options.warmup && timings.frame - options.warmup < samples.size()) {
+        SceneBenchSample& sample = samples[timings.frame - options.warmup];
+        sample.has_timings = true;
+        sample.cpu_ms = timings.cpu_ms;
+        sample.gpu_ms = timings.gpu_ms;
+    }
+
+    if (frame >= end + SCENE_BENCH_DRAIN_FRAMES) {
+        Report();
+        return false;
+    }
+
+    path.Apply(frame > options.warmup ? frame - options.warmup : 0, CameraSystem::GetInstance()->GetActive());
+    frame++;
+    return true;
+}
+
+void SceneBench::Shutdown() {
+    RendererFrontend::GetInstance()->meshes.clear();
+    for (Mesh* mesh : meshes) {
+        delete mesh;
+    }
+    meshes.clear();
+}
+
+void SceneBench::Report() {
+    FILE* csv = fopen(options.csv.c_str(), "w");
+    if (csv) {
+        fprintf(csv, "frame,occluders,triangles,candidates,culled,culled_percent,raster_ms,test_ms,draws,instances,pipeline_binds,descriptor_binds,uniform_bytes,descriptor_writes,recording_jobs,cpu_ms,gpu_ms\n");
+        for (u32 i = 0; i < samples.size(); ++i) {
+            OcclusionStats& occlusion = samples[i].occlusion;
+            RenderQueueStats& queue = samples[i].queue;
+            fprintf(csv, "%u,%u,%u,%u,%u,%.2f,%.4f,%.4f,%u,%u,%u,%u,%llu,%u,%u,", i,
+                occlusion.occluders, occlusion.triangles, occlusion.candidates, occlusion.culled,
+                GetCulledPercent(occlusion), occlusion.raster_ms, occlusion.test_ms,
+                queue.draws, queue.instances, queue.pipeline_binds, queue.descriptor_binds,
+                queue.uniform_bytes, queue.descriptor_writes, queue.recording_jobs);
+            if (samples[i].has_timings) {
+                fprintf(csv, "%.4f,%.4f", samples[i].cpu_ms, samples[i].gpu_ms);
+            } else {
+                fprintf(csv, ",");
+            }
+            fprintf(csv, "\n");
+        }
+        fclose(csv);
+    } else {
+        ERROR("SceneBench - unable to write '%s'.", options.csv.c_str());
+    }
+
+    printf("%s x%u along %s: %u frames, occlusion %s, %s submission, %u recording threads, per frame values in %s\n",
+        options.mesh.c_str(), options.copies, options.camera_path.c_str(), (u32)samples.size(), options.occlusion ? "on" : "off",
+        options.submit_mode == RendererSubmitMode::INDIRECT ? "indirect" : "direct",
+        RendererFrontend::GetBackend()->GetRecordingThreadCount(), options.csv.c_str());
+    PrintSummary("occluders", samples, [](const SceneBenchSample& s) { return (f64)s.occlusion.occluders; });
+    PrintSummary("candidates", samples, [](const SceneBenchSample& s) { return (f64)s.occlusion.candidates; });
+    PrintSummary("culled %", samples, [](const SceneBenchSample& s) { return GetCulledPercent(s.occlusion); });
+    PrintSummary("raster ms", samples, [](const SceneBenchSample& s) { return s.occlusion.raster_ms; });
+    PrintSummary("test ms", samples, [](const SceneBenchSample& s) { return s.occlusion.test_ms; });
+    PrintSummary("draws", samples, [](const SceneBenchSample& s) { return (f64)s.queue.draws; });
+    PrintSummary("instances", samples, [](const SceneBenchSample& s) { return (f64)s.queue.instances; });
+    PrintSummary("pipeline binds", samples, [](const SceneBenchSample& s) { return (f64)s.queue.pipeline_binds; });
+    PrintSummary("descriptor binds", samples, [](const SceneBenchSample& s) { return (f64)s.queue.descriptor_binds; });
+    PrintSummary("uniform bytes", samples, [](const SceneBenchSample& s) { return (f64)s.queue.uniform_bytes; });
+    PrintSummary("descriptor writes", samples, [](const SceneBenchSample& s) { return (f64)s.queue.descriptor_writes; });
+    PrintSummary("recording jobs", samples, [](const SceneBenchSample& s) { return (f64)s.queue.recording_jobs; });
+    PrintSummary("cpu ms", samples, [](const SceneBenchSample& s) { return s.cpu_ms; }, true);
+    PrintSummary("gpu ms", samples, [](const SceneBenchSample& s) { return s.gpu_ms; }, true);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <entry.hpp>
+#include <core/logger/logger.hpp>
+#include <camera/camera_path.hpp>
+
+struct SceneBenchOptions {
+    // Recorded in the sandbox with P.
+    std::string camera_path;
+    std::string mesh = "sponza";
+    f32 scale = 0.05f;
+    b8 occlusion = true;
+    // Frames drawn from the first pose before measuring, while uploads settle.
+    u32 warmup = 30;
+    std::string csv = "bench_scene.csv";
+    // Copies of the mesh on a grid, sharing its geometry, to scale the draw count.
+    u32 copies = 1;
+    // Renderer job threads, 0 takes the default.
+    u32 threads = 0;
+    Engine::RendererSubmitMode submit_mode = Engine::RendererSubmitMode::DIRECT;
+};
+
+// Frames drawn after the path ends, so the timings of its last frames come back.
+#define SCENE_BENCH_DRAIN_FRAMES 8
+
+// Counters of one replayed frame.
+struct SceneBenchSample {
+    Engine::OcclusionStats occlusion;
+    Engine::RenderQueueStats queue;
+    // CPU recording and GPU time, not every frame gets them.
+    b8 has_timings = false;
+    f64 cpu_ms = 0.0;
+    f64 gpu_ms = 0.0;
+};
+
+// Renders a mesh headless along a camera path, one pose per frame, and reports what the
+// renderer did for each frame.
+class SceneBench {
+public:
+    static SceneBenchOptions options;
+
+    b8 Initialize();
+    b8 Update(float delta, Engine::InputSystem* input);
+    void Shutdown();
+
+private:
+    void CreateCopies();
+    void Report();
+
+    Engine::CameraPath path;
+    std::vector<Engine::Mesh*> meshes;
+    std::vector<SceneBenchSample> samples;
+    u32 frame = 0;
+};
@@ -0,0 +1,99 @@
+#include "transform_bench.hpp"
+#include <cstdio>
+#include <core/logger/logger.hpp>
+#include <platform/platform.hpp>
+#include <math/transform/transform.hpp>
+
+using namespace Engine;
+
+struct TransformBenchTimes {
+    f64 sum = 0.0;
+    f64 min = 0.0;
+
+    void Add(f64 ms) {
+        min = sum == 0.0 ? ms : std::min(min, ms);
+        sum += ms;
+    };
+};
+
+static void PrintTimes(const char* hierarchy, const char* name, const TransformBenchTimes& times, u32 iterations) {
+    printf("  %-6s %-26s avg %8.3f ms  min %8.3f ms\n", hierarchy, name, times.sum / iterations, times.min);
+}
+
+// Every node dirty, then only the first root, each followed by a read of every world matrix as the renderer does.
+static void RunHierarchy(const char* hierarchy, std::vector<Transform*>& nodes, u32 iterations) {
+    TransformSystem* system = TransformSystem::GetInstance();
+    system->Update();
+
+    TransformBenchTimes all_dirty;
+    TransformBenchTimes root_dirty;
+    TransformBenchTimes read_worlds;
+    glm::vec3 sink = glm::vec3(0.0f);
+    for (u32 i = 0; i < iterations; ++i) {
+        f32 offset = (f32)(i + 1) * 0.001f;
+        for (Transform* node : nodes) {
+            node->SetPosition(glm::vec3(offset, 1.0f, 0.0f));
+        }
+        f64 start = Platform::GetAbsoluteTime();
+        system->Update();
+        all_dirty.Add((Platform::GetAbsoluteTime() - start) * 1000.0);
+
+        nodes[0]->SetPosition(glm::vec3(0.0f, offset, 0.0f));
+        start = Platform::GetAbsoluteTime();
+        system->Update();
+        root_dirty.Add((Platform::GetAbsoluteTime() - start) * 1000.0);
+
+        start = Platform::GetAbsoluteTime();
+        for (Transform* node : nodes) {
+            sink += glm::vec3(node->GetWorld()[3]);
+        }
+        read_worlds.Add((Platform::GetAbsoluteTime() - start) * 1000.0);
+    }
+
+    PrintTimes(hierarchy, "update, all dirty", all_dirty, iterations);
+    PrintTimes(hierarchy, "update, first root dirty", root_dirty, iterations);
+    PrintTimes(hierarchy, "read every world", read_worlds, iterations);
+    // Keeps the world reads from being optimized out.
+    DEBUG("TransformBench - %s checksum %f.", hierarchy, sink.x + sink.y + sink.z);
+}
+
+static void DestroyNodes(std::vector<Transform*>& nodes) {
+    // Children first, so no node outlives its parent.
+    for (u32 i = nodes.size(); i > 0; --i) {
+        delete nodes[i - 1];
+    }
+    nodes.clear();
+    TransformSystem::GetInstance()->Update();
+}
+
+i32 RunTransformBench(u32 node_count, u32 iterations) {
+    if (node_count < 2 || !iterations) {
+        return 1;
+    }
+
+    Logger::Initialize();
+    Platform::ClockSetup();
+    TransformSystem::Initialize();
+
+    printf("transforms: %u nodes, %u iterations\n", node_count, iterations);
+
+    std::vector<Transform*> nodes;
+    nodes.reserve(node_count);
+    for (u32 i = 0; i < node_count; ++i) {
+        Transform* parent = i % TRANSFORM_BENCH_DEPTH ? nodes.back() : nullptr;
+        nodes.push_back(new Transform(glm::vec3(0.0f, 1.0f, 0.0f), parent));
+    }
+    RunHierarchy("deep", nodes, iterations);
+    DestroyNodes(nodes);
+
+    nodes.push_back(new Transform());
+    for (u32 i = 1; i < node_count; ++i) {
+        nodes.push_back(new Transform(glm::vec3((f32)i, 0.0f, 0.0f), nodes[0]));
+    }
+    RunHierarchy("wide", nodes, iterations);
+    DestroyNodes(nodes);
+
+    TransformSystem::Shutdown();
+    Logger::Shutdown();
+    return 0;
+}
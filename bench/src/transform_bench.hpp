@@ -0,0 +1,9 @@
+#pragma once
+#include <defines.hpp>
+
+// Length of the chains in the deep hierarchy.
+#define TRANSFORM_BENCH_DEPTH 100
+
+// Times TransformSystem::Update and world reads on node_count transforms, laid out once as chains of
+// TRANSFORM_BENCH_DEPTH and once as a single root with every other node as its child. Needs no renderer.
+i32 RunTransformBench(u32 node_count, u32 iterations);
@@ -11,4 +11,14 @@ IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
 
 REM Sandbox
 make -f "Sandbox.makefile.mak" clean
+IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
+
+
+REM Packer
+make -f "Packer.makefile.mak" clean
+IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
+
+
+REM Bench
+make -f "Bench.makefile.mak" clean
 IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "camera_path.hpp"
+
+#include "core/logger/logger.hpp"
+#include "core/utils/string.hpp"
+#include "platform/filesystem.hpp"
+
+namespace Engine {
+
+    void CameraPath::Record(Camera* camera) {
+        keys.push_back({camera->camera_position, camera->camera_euler});
+    };
+
+    void CameraPath::Apply(u32 frame, Camera* camera) {
+        if (keys.empty()) {
+            return;
+        }
+        CameraPathKey& key = keys[std::min(frame, (u32)keys.size() - 1)];
+        camera->SetPosition(key.position);
+        camera->SetEuler(key.euler);
+        camera->OnUpdate();
+    };
+
+    b8 CameraPath::Save(const std::string& path) {
+        std::string text;
+        for (CameraPathKey& key : keys) {
+            text += StringFormat("%f %f %f | %f %f %f\n",
+                key.position.x, key.position.y, key.position.z, key.euler.x, key.euler.y, key.euler.z);
+        }
+
+        // Binary so an existing path is overwritten, text files only ever get appended to.
+        File* file = FileSystem::FileOpen(path, FileMode::WRITE, true);
+        b8 result = file->IsReady() && file->Write(text.size(), text.data());
+        FileSystem::FileClose(file);
+        if (!result) {
+            ERROR("CameraPath::Save - unable to write '%s'.", path.c_str());
+        }
+        return result;
+    };
+
+    b8 CameraPath::Load(const std::string& path) {
+        File* file = FileSystem::FileOpen(path, FileMode::READ, false);
+        if (!file->IsReady()) {
+            ERROR("CameraPath::Load - unable to open '%s'.", path.c_str());
+            FileSystem::FileClose(file);
+            return false;
+        }
+
+        keys.clear();
+        std::vector<std::string> lines = file->ReadAllLines();
+        FileSystem::FileClose(file);
+        for (u32 i = 0; i < lines.size(); ++i) {
+            std::string& line = Trim(lines[i]);
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::pair<std::string, std::string> parts = MidString(line, '|');
+            CameraPathKey key;
+            if (line.find('|') == std::string::npos || !Parse(parts.first, &key.position) || !Parse(parts.second, &key.euler)) {
+                ERROR("CameraPath::Load - malformed line %u in '%s'.", i + 1, path.c_str());
+                keys.clear();
+                return false;
+            }
+            keys.push_back(key);
+        }
+        return true;
+    };
+
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "defines.hpp"
+#include "camera.hpp"
+
+namespace Engine {
+
+    struct CameraPathKey {
+        glm::vec3 position;
+        glm::vec3 euler;
+    };
+
+    // Camera poses sampled once per frame, recorded in the sandbox and replayed by the benchmarks.
+    // Saved as text, one "x y z | pitch yaw roll" line per frame.
+    class ENGINE_API CameraPath {
+        public:
+            void Clear() { keys.clear(); };
+            void Record(Camera* camera);
+            // Frames past the end hold the last pose.
+            void Apply(u32 frame, Camera* camera);
+
+            b8 Save(const std::string& path);
+            b8 Load(const std::string& path);
+
+            u32 GetFrameCount() { return keys.size(); };
+
+        private:
+            std::vector<CameraPathKey> keys;
+    };
+
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "defines.hpp"
+
+namespace Engine {
+
+    // Append-only little helper for flat binary blobs, strings are u32 length prefixed.
+    class BinaryWriter {
+        public:
+            template<typename T>
+            void Write(const T& value) {
+                static_assert(std::is_trivially_copyable<T>::value, "BinaryWriter::Write needs a trivially copyable type");
+                const c8* bytes = (const c8*)&value;
+                data.insert(data.end(), bytes, bytes + sizeof(T));
+            };
+
+            void WriteString(const std::string& value) {
+                Write<u32>(value.size());
+                data.insert(data.end(), value.begin(), value.end());
+            };
+
+            std::vector<c8>& GetData() { return data; };
+
+        protected:
+            std::vector<c8> data;
+    };
+
+    class BinaryReader {
+        public:
+            BinaryReader(const c8* data, u64 size) : data(data), size(size), cursor(0), failed(false) {};
+
+            template<typename T>
+            b8 Read(T& value) {
+                static_assert(std::is_trivially_copyable<T>::value, "BinaryReader::Read needs a trivially copyable type");
+                if (failed || cursor + sizeof(T) > size) {
+                    failed = true;
+                    return false;
+                }
+                std::memcpy(&value, data + cursor, sizeof(T));
+                cursor += sizeof(T);
+                return true;
+            };
+
+            b8 ReadString(std::string& value) {
+                u32 length = 0;
+                if (!Read(length) || cursor + length > size) {
+                    failed = true;
+                    return false;
+                }
+                value.assign(data + cursor, length);
+                cursor += length;
+                return true;
+            };
+
+            b8 Failed() { return failed; };
+
+        protected:
+            const c8* data;
+            u64 size;
+            u64 cursor;
+            b8 failed;
+    };
+
+};
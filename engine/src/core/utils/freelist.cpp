@@ -35,41 +35,27 @@ namespace Engine {
 
     void FreelistNode::FreeBlock() {
         is_free = true;
-        b8 delete_this = false;
-        if (this->prev && this->prev->IsFree()) {
-            if (this->prev->prev) {
-                this->offset = this->offset - this->prev->size;
-                this->size += this->prev->size;
-                this->prev->prev->next = this;
-                FreelistNode* buffer = this->prev->prev;
-                delete this->prev;
-                this->prev = buffer;
-            } else {
-                this->prev->size += this->size;
-                if (this->next) {
-                    if (this->next->is_free) {
-                        this->prev->size += this->next->size;
-                        if (this->next->next) {
-                            this->prev->next = this->next->next;
-                            this->next->prev = this->prev;
-                        } else {
-                            this->prev->next = nullptr;
-                        }
-                        delete this->next;
-                    } else {
-                        this->next->prev = this->prev;
-                        this->prev->next = this->next;
-                    }
-                    
-                }
-                return delete this;
+
+        // Swallow a free neighbour after this node.
+        if (this->next && this->next->is_free) {
+            FreelistNode* absorbed = this->next;
+            this->size += absorbed->size;
+            this->next = absorbed->next;
+            if (this->next) {
+                this->next->prev = this;
             }
+            delete absorbed;
         }
-        if (this->next && this->next->IsFree()) {
-            this->size += this->next->size;
-            FreelistNode* buffer = this->next->next;
-            delete this->next;
-            this->next = buffer;
+
+        // Fold into a free neighbour before it, this node goes away. Never the first node, it has no previous.
+        if (this->prev && this->prev->is_free) {
+            FreelistNode* previous = this->prev;
+            previous->size += this->size;
+            previous->next = this->next;
+            if (this->next) {
+                this->next->prev = previous;
+            }
+            delete this;
         }
     };
 
@@ -145,7 +131,12 @@ namespace Engine {
         FreelistNode* current = first_node;
         while (current) {
            if (current->IsFree()) {
-                if (current->GetSize() >= size) {
+                if (current->GetSize() == size) {
+                    // Exact fit, taken whole so no empty node is left behind.
+                    current->is_free = false;
+                    return current;
+                }
+                if (current->GetSize() > size) {
                     FreelistNode* occupied = new FreelistNode(current->GetMemoryOffset(), size, false);
                     current->offset += size;
                     current->size -= size;
@@ -167,7 +158,7 @@ namespace Engine {
         FreelistNode* current = first_node;
 
         while (current) {
-            if (current->offset == offset) {
+            if (current->offset == offset && !current->is_free) {
                 current->FreeBlock();
                 return true;
             }
@@ -187,10 +178,31 @@ namespace Engine {
             buffer = next;
         }
         first_node->next = nullptr;
+        first_node->offset = 0;
         first_node->size = this->total_size;
         first_node->is_free = true;
     };
 
+    b8 Freelist::Grow(u64 new_size) {
+        if (new_size <= total_size) {
+            return false;
+        }
+
+        FreelistNode* last = first_node;
+        while (last->Next()) {
+            last = last->Next();
+        }
+
+        u64 added = new_size - total_size;
+        if (last->IsFree()) {
+            last->size += added;
+        } else {
+            last->InsertAfter(new FreelistNode(total_size, added));
+        }
+        total_size = new_size;
+        return true;
+    };
+
     u64 Freelist::FreeSpace() {
         u64 free_space = total_size;
         FreelistNode* node = first_node;
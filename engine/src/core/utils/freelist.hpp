@@ -53,6 +53,9 @@ namespace Engine {
             b8 FreeByOffset(u64 offset);
             void Clear();
             u64 FreeSpace();
+            u64 GetTotalSize() { return total_size; };
+            // Extends the list in place, existing nodes keep their offsets.
+            b8 Grow(u64 new_size);
 
             // FreelistNode* InsertByOffset(u64 offset, u64 size);
 
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "defines.hpp"
+
+namespace Engine {
+
+    #define FNV1A_OFFSET_BASIS 14695981039346656037ULL
+
+    // FNV-1a, used for content keys of cached data. Pass a previous hash as seed to chain buffers.
+    INLINE_API u64 HashFNV1a(const void* data, u64 size, u64 seed = FNV1A_OFFSET_BASIS) {
+        const u8* bytes = (const u8*)data;
+        u64 hash = seed;
+        for (u64 i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "defines.hpp"
+#include "core/utils/slot_map.hpp"
+
+#include <list>
+
+namespace Engine {
+
+    // Limits for unreferenced resources kept around for reuse, zero disables a limit.
+    struct InactiveCacheConfig {
+        u32 max_count = 0;
+        u64 max_bytes = 0;
+        f64 max_age = 0;
+    };
+
+    struct InactiveCacheStats {
+        u64 hits = 0;
+        u64 misses = 0;
+        u64 evictions = 0;
+        u32 count = 0;
+        u64 bytes = 0;
+    };
+
+    // LRU list of zero-ref resources. Systems push handles here instead of destroying them
+    // and take them back out on reacquire, Collect hands back what has to be destroyed.
+    template<typename T>
+    class InactiveCache {
+        public:
+            InactiveCache(InactiveCacheConfig config = InactiveCacheConfig()) : config(config) {};
+
+            void Push(Handle<T> handle, u64 size, f64 time) {
+                entries.push_front({handle, size, time});
+                lookup[handle.index] = entries.begin();
+                stats.count++;
+                stats.bytes += size;
+            };
+
+            // Removes the handle if it is inactive, counting a hit.
+            b8 Take(Handle<T> handle) {
+                auto it = lookup.find(handle.index);
+                if (it == lookup.end() || it->second->handle != handle) {
+                    return false;
+                }
+
+                Erase(it->second);
+                lookup.erase(it);
+                stats.hits++;
+                return true;
+            };
+
+            void RecordMiss() { stats.misses++; };
+
+            // Oldest entries that are over the count or byte budget or older than max_age.
+            void Collect(f64 now, std::vector<Handle<T>>& out_evicted) {
+                while (entries.size()) {
+                    Entry& oldest = entries.back();
+                    b8 over_count = config.max_count && stats.count > config.max_count;
+                    b8 over_bytes = config.max_bytes && stats.bytes > config.max_bytes;
+                    b8 too_old = config.max_age > 0 && now - oldest.time > config.max_age;
+                    if (!over_count && !over_bytes && !too_old) {
+                        break;
+                    }
+                    out_evicted.push_back(PopOldest());
+                }
+            };
+
+            // Memory pressure, drops the oldest entries until at least bytes were released.
+            void CollectBytes(u64 bytes, std::vector<Handle<T>>& out_evicted) {
+                u64 released = 0;
+                while (entries.size() && released < bytes) {
+                    released += entries.back().size;
+                    out_evicted.push_back(PopOldest());
+                }
+            };
+
+            void CollectAll(std::vector<Handle<T>>& out_evicted) {
+                while (entries.size()) {
+                    out_evicted.push_back(PopOldest());
+                }
+            };
+
+            void SetConfig(InactiveCacheConfig config) { this->config = config; };
+            InactiveCacheConfig& GetConfig() { return config; };
+            InactiveCacheStats& GetStats() { return stats; };
+
+        protected:
+            struct Entry {
+                Handle<T> handle;
+                u64 size;
+                f64 time;
+            };
+
+            Handle<T> PopOldest() {
+                Handle<T> handle = entries.back().handle;
+                lookup.erase(handle.index);
+                Erase(std::prev(entries.end()));
+                stats.evictions++;
+                return handle;
+            };
+
+            void Erase(typename std::list<Entry>::iterator it) {
+                stats.count--;
+                stats.bytes -= it->size;
+                entries.erase(it);
+            };
+
+            InactiveCacheConfig config;
+            InactiveCacheStats stats;
+            // Front is the most recently released.
+            std::list<Entry> entries;
+            std::unordered_map<u32, typename std::list<Entry>::iterator> lookup;
+    };
+
+};
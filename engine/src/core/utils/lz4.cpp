@@ -0,0 +1,169 @@
+#include "lz4.hpp"
+
+#include "platform/platform.hpp"
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_HASH_BITS 16
+#define LZ4_MAX_OFFSET 65535
+// Format rules: last match starts at least 12 bytes before the end, last 5 bytes are literals.
+#define LZ4_MF_LIMIT 12
+#define LZ4_LAST_LITERALS 5
+
+namespace Engine {
+
+    static u32 LZ4Read32(const u8* p) {
+        u32 value;
+        Platform::CpMemory(&value, p, sizeof(u32));
+        return value;
+    };
+
+    static u32 LZ4Hash(u32 sequence) {
+        return (sequence * 2654435761U) >> (32 - LZ4_HASH_BITS);
+    };
+
+    static void LZ4WriteLength(std::vector<u8>& out, u64 length) {
+        while (length >= 255) {
+            out.push_back(255);
+            length -= 255;
+        }
+        out.push_back((u8)length);
+    };
+
+    static void LZ4WriteSequence(std::vector<u8>& out, const u8* literals, u64 literal_length, u32 offset, u64 match_length) {
+        u8 token = (u8)((literal_length >= 15 ? 15 : literal_length) << 4);
+        if (offset) {
+            u64 ml = match_length - LZ4_MIN_MATCH;
+            token |= (u8)(ml >= 15 ? 15 : ml);
+        }
+        out.push_back(token);
+
+        if (literal_length >= 15) {
+            LZ4WriteLength(out, literal_length - 15);
+        }
+        out.insert(out.end(), literals, literals + literal_length);
+
+        if (!offset) {
+            return;
+        }
+
+        out.push_back((u8)(offset & 0xFF));
+        out.push_back((u8)(offset >> 8));
+
+        if (match_length - LZ4_MIN_MATCH >= 15) {
+            LZ4WriteLength(out, match_length - LZ4_MIN_MATCH - 15);
+        }
+    };
+
+    u64 LZ4::Compress(const u8* source, u64 size, std::vector<u8>& out) {
+        u64 start = out.size();
+        out.reserve(start + CompressBound(size));
+
+        u64 anchor = 0;
+
+        if (size > LZ4_MF_LIMIT) {
+            // Positions are stored +1 so zero means empty slot.
+            std::vector<u32> table(1 << LZ4_HASH_BITS, 0);
+
+            u64 limit = size - LZ4_MF_LIMIT;
+            u64 match_limit = size - LZ4_LAST_LITERALS;
+            u64 ip = 0;
+
+            while (ip < limit) {
+                u32 sequence = LZ4Read32(source + ip);
+                u32 hash = LZ4Hash(sequence);
+                u64 ref = table[hash];
+                table[hash] = (u32)(ip + 1);
+
+                if (!ref || ip - (ref - 1) > LZ4_MAX_OFFSET || LZ4Read32(source + ref - 1) != sequence) {
+                    ip++;
+                    continue;
+                }
+                ref--;
+
+                u64 match_length = LZ4_MIN_MATCH;
+                while (ip + match_length < match_limit && source[ref + match_length] == source[ip + match_length]) {
+                    match_length++;
+                }
+
+                LZ4WriteSequence(out, source + anchor, ip - anchor, (u32)(ip - ref), match_length);
+
+                ip += match_length;
+                anchor = ip;
+            }
+        }
+
+        LZ4WriteSequence(out, source + anchor, size - anchor, 0, 0);
+
+        return out.size() - start;
+    };
+
+    b8 LZ4::Decompress(const u8* source, u64 size, u8* destination, u64 destination_size) {
+        const u8* ip = source;
+        const u8* end = source + size;
+        u64 op = 0;
+
+        while (ip < end) {
+            u8 token = *ip++;
+
+            u64 literal_length = token >> 4;
+            if (literal_length == 15) {
+                u8 byte;
+                do {
+                    if (ip >= end) {
+                        return false;
+                    }
+                    byte = *ip++;
+                    literal_length += byte;
+                } while (byte == 255);
+            }
+
+            if (literal_length > (u64)(end - ip) || literal_length > destination_size - op) {
+                return false;
+            }
+            Platform::CpMemory(destination + op, ip, literal_length);
+            ip += literal_length;
+            op += literal_length;
+
+            // Last sequence has no match part.
+            if (ip >= end) {
+                break;
+            }
+
+            if (end - ip < 2) {
+                return false;
+            }
+            u64 offset = ip[0] | (ip[1] << 8);
+            ip += 2;
+            if (offset == 0 || offset > op) {
+                return false;
+            }
+
+            u64 match_length = token & 0x0F;
+            if (match_length == 15) {
+                u8 byte;
+                do {
+                    if (ip >= end) {
+                        return false;
+                    }
+                    byte = *ip++;
+                    match_length += byte;
+                } while (byte == 255);
+            }
+            match_length += LZ4_MIN_MATCH;
+
+            if (match_length > destination_size - op) {
+                return false;
+            }
+
+            // Byte by byte, matches are allowed to overlap the output.
+            u8* match = destination + op - offset;
+            for (u64 i = 0; i < match_length; ++i) {
+                destination[op + i] = match[i];
+            }
+            op += match_length;
+        }
+
+        return op == destination_size;
+    };
+
+};
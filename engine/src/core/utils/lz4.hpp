@@ -0,0 +1,19 @@
+#pragma once
+
+#include "defines.hpp"
+
+namespace Engine {
+
+    // Minimal LZ4 block format codec, output is readable by the reference lz4 implementation.
+    class LZ4 {
+        public:
+            // Appends compressed block to out. Returns compressed size.
+            static u64 Compress(const u8* source, u64 size, std::vector<u8>& out);
+
+            // Decompresses a whole block, destination_size has to be exactly the original size.
+            static b8 Decompress(const u8* source, u64 size, u8* destination, u64 destination_size);
+
+            static u64 CompressBound(u64 size) { return size + size / 255 + 16; };
+    };
+
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "defines.hpp"
+#include "core/logger/logger.hpp"
+
+namespace Engine {
+
+    // Index into a SlotMap plus the generation of the slot at the time it was handed out.
+    // A handle outlives its object safely: once the slot is reused the generations stop matching.
+    template<typename T>
+    struct Handle {
+        u32 index = INVALID_ID;
+        u32 generation = 0;
+
+        b8 IsValid() const { return index != INVALID_ID; };
+        b8 operator==(const Handle& other) const { return index == other.index && generation == other.generation; };
+        b8 operator!=(const Handle& other) const { return !(*this == other); };
+    };
+
+    // Values are kept packed in one vector, slots map stable handles to dense positions.
+    // Insert, Remove and Get are O(1), removal moves the last value into the hole.
+    template<typename T, typename Tag = T>
+    class SlotMap {
+        public:
+            typedef Handle<Tag> HandleType;
+
+            HandleType Insert(const T& value) {
+                return Insert(T(value));
+            };
+
+            HandleType Insert(T&& value) {
+                u32 slot_index;
+                if (free_head != INVALID_ID) {
+                    slot_index = free_head;
+                    free_head = slots[slot_index].dense_index;
+                } else {
+                    slot_index = slots.size();
+                    slots.push_back({INVALID_ID, 0});
+                }
+
+                slots[slot_index].dense_index = values.size();
+                values.push_back(std::move(value));
+                dense_to_slot.push_back(slot_index);
+
+                return {slot_index, slots[slot_index].generation};
+            };
+
+            b8 Remove(HandleType handle) {
+                if (!IsAlive(handle)) {
+                    ReportStale(handle, "Remove");
+                    return false;
+                }
+
+                u32 dense_index = slots[handle.index].dense_index;
+                u32 last_index = values.size() - 1;
+                if (dense_index != last_index) {
+                    values[dense_index] = std::move(values[last_index]);
+                    dense_to_slot[dense_index] = dense_to_slot[last_index];
+                    slots[dense_to_slot[dense_index]].dense_index = dense_index;
+                }
+                values.pop_back();
+                dense_to_slot.pop_back();
+
+                // Bumping the generation invalidates every handle still pointing at this slot.
+                slots[handle.index].generation++;
+                slots[handle.index].dense_index = free_head;
+                free_head = handle.index;
+                return true;
+            };
+
+            T* Get(HandleType handle) {
+                if (!IsAlive(handle)) {
+                    ReportStale(handle, "Get");
+                    return nullptr;
+                }
+                return &values[slots[handle.index].dense_index];
+            };
+
+            b8 IsAlive(HandleType handle) const {
+                return handle.index < slots.size() && slots[handle.index].generation == handle.generation && slots[handle.index].dense_index < values.size() && dense_to_slot[slots[handle.index].dense_index] == handle.index;
+            };
+
+            // Handle of the value stored at a dense position, for use while iterating.
+            HandleType GetHandle(u32 dense_index) const {
+                u32 slot_index = dense_to_slot[dense_index];
+                return {slot_index, slots[slot_index].generation};
+            };
+
+            void Clear() {
+                for (u32 i = 0; i < dense_to_slot.size(); ++i) {
+                    Slot& slot = slots[dense_to_slot[i]];
+                    slot.generation++;
+                    slot.dense_index = free_head;
+                    free_head = dense_to_slot[i];
+                }
+                values.clear();
+                dense_to_slot.clear();
+            };
+
+            u32 Size() const { return values.size(); };
+
+            typename std::vector<T>::iterator begin() { return values.begin(); };
+            typename std::vector<T>::iterator end() { return values.end(); };
+
+        protected:
+            struct Slot {
+                // Dense position while alive, next free slot while free.
+                u32 dense_index;
+                u32 generation;
+            };
+
+            void ReportStale(HandleType handle, const char* operation) const {
+                #if defined(_DEBUG)
+                    if (handle.IsValid()) {
+                        WARN("SlotMap::%s - stale handle (index: %u, generation: %u).", operation, handle.index, handle.generation);
+                    }
+                #endif
+            };
+
+            std::vector<T> values;
+            std::vector<u32> dense_to_slot;
+            std::vector<Slot> slots;
+            u32 free_head = INVALID_ID;
+    };
+
+};
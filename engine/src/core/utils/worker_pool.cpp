@@ -0,0 +1,92 @@
+#include "worker_pool.hpp"
+
+namespace Engine {
+
+    WorkerPool::WorkerPool(u32 thread_count) {
+        work_generation = 0;
+        workers_done = 0;
+        stopping = false;
+        job = nullptr;
+        job_count = 0;
+        next_job = 0;
+
+        // The calling thread is thread 0.
+        for (u32 i = 1; i < thread_count; ++i) {
+            workers.emplace_back(&WorkerPool::WorkerLoop, this, i);
+        }
+    };
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        work_condition.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    };
+
+    u32 WorkerPool::GetDefaultThreadCount(u32 max_count) {
+        return std::min(std::max(std::thread::hardware_concurrency(), 1u), std::max(max_count, 1u));
+    };
+
+    void WorkerPool::RunJobs(u32 thread_index) {
+        // Jobs are taken in order, a thread that finishes early picks up the next one.
+        for (u32 i = next_job.fetch_add(1); i < job_count; i = next_job.fetch_add(1)) {
+            (*job)(i, thread_index);
+        }
+    };
+
+    void WorkerPool::WorkerLoop(u32 thread_index) {
+        u64 seen_generation = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            work_condition.wait(lock, [&]() { return stopping || work_generation != seen_generation; });
+            if (stopping) {
+                return;
+            }
+            seen_generation = work_generation;
+
+            lock.unlock();
+            RunJobs(thread_index);
+            lock.lock();
+
+            if (++workers_done == workers.size()) {
+                done_condition.notify_one();
+            }
+        }
+    };
+
+    void WorkerPool::Run(u32 job_count, const WorkerJob& job) {
+        if (!job_count) {
+            return;
+        }
+
+        this->job = &job;
+        this->job_count = job_count;
+        this->next_job = 0;
+
+        // Not worth waking anybody for a single job.
+        b8 parallel = workers.size() && job_count > 1;
+        if (parallel) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                workers_done = 0;
+                work_generation++;
+            }
+            work_condition.notify_all();
+        }
+
+        RunJobs(0);
+
+        if (parallel) {
+            std::unique_lock<std::mutex> lock(mutex);
+            done_condition.wait(lock, [&]() { return workers_done == workers.size(); });
+        }
+
+        this->job = nullptr;
+    };
+
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "defines.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace Engine {
+
+    // Called once per job index, thread_index tells which thread runs it, 0 being the caller of Run.
+    using WorkerJob = std::function<void(u32 job, u32 thread_index)>;
+
+    // Fixed set of threads that split numbered jobs between them. The thread calling Run takes
+    // jobs as well and Run returns once all of them are done, so one thread means no workers.
+    // Run is not reentrant, jobs must not call it again.
+    class WorkerPool {
+        public:
+            WorkerPool(u32 thread_count);
+            ~WorkerPool();
+
+            void Run(u32 job_count, const WorkerJob& job);
+
+            u32 GetThreadCount() { return workers.size() + 1; };
+
+            // Hardware threads, at least 1 and at most max_count.
+            static u32 GetDefaultThreadCount(u32 max_count);
+
+        private:
+            void WorkerLoop(u32 thread_index);
+            void RunJobs(u32 thread_index);
+
+            std::vector<std::thread> workers;
+
+            std::mutex mutex;
+            std::condition_variable work_condition;
+            std::condition_variable done_condition;
+            u64 work_generation;
+            u32 workers_done;
+            b8 stopping;
+
+            // Job of the current Run call.
+            const WorkerJob* job;
+            u32 job_count;
+            std::atomic<u32> next_job;
+    };
+
+};
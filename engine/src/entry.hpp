@@ -11,6 +11,7 @@
 #include "systems/resource/resource_system.hpp"
 #include "systems/camera/camera_system.hpp"
 #include "systems/shader/shader_system.hpp"
+#include "systems/transform/transform_system.hpp"
 #include "renderer/renderer.hpp"
 #include "renderer/renderpass.hpp"
 
@@ -25,6 +26,10 @@ struct ApplicationSetup {
     u32 height;
     u32 start_x;
     u32 start_y;
+    // Renders offscreen without a swapchain, for benchmark and validation machines.
+    b8 headless = false;
+    // Renderer job threads, 0 takes one per hardware thread.
+    u32 worker_threads = 0;
 };
 
 struct ApplicationCommandLineArgs
@@ -185,6 +190,7 @@ void EngineRunner<T>::Shutdown () {
     //////////////////////////////////
 
     Engine::CameraSystem::Shutdown();
+    Engine::TransformSystem::Shutdown();
     Engine::GeometrySystem::Shutdown();
     Engine::TextureSystem::Shutdown();
     Engine::ShaderSystem::Shutdown();
@@ -232,7 +238,7 @@ bool EngineRunner<T>::InitializeEngineSystems() {
         return false;
 	}
 
-	if (!Engine::RendererFrontend::Initialize({m_setup.width, m_setup.height, m_setup.name}, Engine::RendererBackendType::VULKAN)) {
+	if (!Engine::RendererFrontend::Initialize({m_setup.width, m_setup.height, m_setup.name, m_setup.headless, m_setup.worker_threads}, Engine::RendererBackendType::VULKAN)) {
 		FATAL("Error during Renderer initialization.");
         return false;
 	}
@@ -257,6 +263,11 @@ bool EngineRunner<T>::InitializeEngineSystems() {
         return false;
     }
 
+    if (!Engine::TransformSystem::Initialize()) {
+        FATAL("Error during TransformSystem initialization.");
+        return false;
+    }
+
 	DEBUG("Application successfully initialized.");
 
 	return true;
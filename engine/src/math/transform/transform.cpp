@@ -2,122 +2,75 @@
 
 namespace Engine {
 
-    Transform::Transform() {
-        position = glm::vec3(0, 0, 0);
-        rotation = glm::identity<glm::quat>();
-        scale = glm::vec3(1, 1, 1);
-        model = glm::identity<glm::mat4>();
-        parent = nullptr;
-        Generate();
-    };
+    Transform::Transform()
+        : Transform(glm::vec3(0, 0, 0), glm::identity<glm::quat>(), glm::vec3(1, 1, 1), nullptr) {};
 
-    Transform::Transform(glm::vec3 position) {
-        this->position = position;
-        rotation = glm::identity<glm::quat>();
-        scale = glm::vec3(1, 1, 1);
-        model = glm::identity<glm::mat4>();
-        parent = nullptr;
-        Generate();
-    };
+    Transform::Transform(glm::vec3 position)
+        : Transform(position, glm::identity<glm::quat>(), glm::vec3(1, 1, 1), nullptr) {};
 
-    Transform::Transform(glm::vec3 position, glm::quat rotation) {
-        this->position = position;
-        this->rotation = rotation;
-        scale = glm::vec3(1, 1, 1);
-        model = glm::identity<glm::mat4>();
-        parent = nullptr;
-        Generate();
-    };
+    Transform::Transform(glm::vec3 position, glm::quat rotation)
+        : Transform(position, rotation, glm::vec3(1, 1, 1), nullptr) {};
 
-    Transform::Transform(glm::vec3 position, glm::quat rotation, glm::vec3 scale) {
-        this->position = position;
-        this->rotation = rotation;
-        this->scale = scale;
-        model = glm::identity<glm::mat4>();
-        parent = nullptr;
-        Generate();
-    };
+    Transform::Transform(glm::vec3 position, glm::quat rotation, glm::vec3 scale)
+        : Transform(position, rotation, scale, nullptr) {};
 
-    Transform::Transform(Transform* parent) {
-        position = glm::vec3(0, 0, 0);
-        rotation = glm::identity<glm::quat>();
-        scale = glm::vec3(1, 1, 1);
-        model = glm::identity<glm::mat4>();
-        this->parent = parent;
-        Generate();
-    };
+    Transform::Transform(Transform* parent)
+        : Transform(glm::vec3(0, 0, 0), glm::identity<glm::quat>(), glm::vec3(1, 1, 1), parent) {};
 
-    Transform::Transform(glm::vec3 position, Transform* parent) {
-        this->position = position;
-        rotation = glm::identity<glm::quat>();
-        scale = glm::vec3(1, 1, 1);
-        model = glm::identity<glm::mat4>();
-        this->parent = parent;
-        Generate();
-    };
+    Transform::Transform(glm::vec3 position, Transform* parent)
+        : Transform(position, glm::identity<glm::quat>(), glm::vec3(1, 1, 1), parent) {};
 
-    Transform::Transform(glm::vec3 position, glm::quat rotation, Transform* parent) {
-        this->position = position;
-        this->rotation = rotation;
-        scale = glm::vec3(1, 1, 1);
-        model = glm::identity<glm::mat4>();
-        this->parent = parent;
-        Generate();
-    };
+    Transform::Transform(glm::vec3 position, glm::quat rotation, Transform* parent)
+        : Transform(position, rotation, glm::vec3(1, 1, 1), parent) {};
 
     Transform::Transform(glm::vec3 position, glm::quat rotation, glm::vec3 scale, Transform* parent) {
-        this->position = position;
-        this->rotation = rotation;
-        this->scale = scale;
-        model = glm::identity<glm::mat4>();
-        this->parent = parent;
-        Generate();
+        id = TransformSystem::GetInstance()->Create(this, position, rotation, scale, parent);
     };
 
-    void Transform::Generate() {
-        model = glm::toMat4(rotation) *  glm::translate(glm::identity<glm::mat4>(), position) * glm::scale(glm::identity<glm::mat4>(), scale);
-        is_dirty = false;
+    Transform::~Transform() {
+        TransformSystem* system = TransformSystem::GetInstance();
+        if (system) {
+            system->Destroy(id);
+        }
     };
 
     void Transform::SetPosition(glm::vec3 position) {
-        this->position = position;
-        is_dirty = true;
+        TransformSystem::GetInstance()->SetPosition(id, position);
     };
 
     void Transform::Translate(glm::vec3 position) {
-        this->position += position;
-        is_dirty = true;
+        TransformSystem* system = TransformSystem::GetInstance();
+        system->SetPosition(id, system->GetPosition(id) + position);
     };
 
     void Transform::SetRotation(glm::quat rotation) {
-        this->rotation = rotation;
-        is_dirty = true;
+        TransformSystem::GetInstance()->SetRotation(id, rotation);
     };
 
     void Transform::Rotate(glm::quat rotation) {
-        this->rotation *= rotation;
-        is_dirty = true;
+        TransformSystem* system = TransformSystem::GetInstance();
+        system->SetRotation(id, system->GetRotation(id) * rotation);
     };
 
     void Transform::SetScale(glm::vec3 scale) {
-        this->scale = scale;
-        is_dirty = true;
+        TransformSystem::GetInstance()->SetScale(id, scale);
     };
 
     void Transform::SetPositionRotation(glm::vec3 position, glm::quat rotation) {
-        this->position = position;
-        this->rotation = rotation;
-        is_dirty = true;
+        TransformSystem* system = TransformSystem::GetInstance();
+        system->SetPosition(id, position);
+        system->SetRotation(id, rotation);
     };  
 
     void Transform::SetPositionRotationScale(glm::vec3 position, glm::quat rotation, glm::vec3 scale) {
-        this->position = position;
-        this->rotation = rotation;
-        is_dirty = true;
+        TransformSystem* system = TransformSystem::GetInstance();
+        system->SetPosition(id, position);
+        system->SetRotation(id, rotation);
+        system->SetScale(id, scale);
     };
 
     void Transform::SetParent(Transform* parent) {
-        this->parent = parent;
+        TransformSystem::GetInstance()->SetParent(id, parent);
     };
 
-}
\ No newline at end of file
+}
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "defines.hpp"
+#include "systems/transform/transform_system.hpp"
 
 namespace Engine {
 
+    // Handle into the TransformSystem, which keeps the actual TRS and matrices.
     class ENGINE_API Transform {
         public:
             Transform();
@@ -16,7 +18,10 @@ namespace Engine {
             Transform(glm::vec3 position, glm::quat rotation, Transform* parent);
             Transform(glm::vec3 position, glm::quat rotation, glm::vec3 scale, Transform* parent);
 
-            virtual ~Transform() {};
+            Transform(const Transform&) = delete;
+            Transform& operator=(const Transform&) = delete;
+
+            virtual ~Transform();
 
             void SetPosition(glm::vec3 position);
             void Translate(glm::vec3 position);
@@ -30,37 +35,20 @@ namespace Engine {
             void SetPositionRotation(glm::vec3 position, glm::quat rotation);
             void SetPositionRotationScale(glm::vec3 position, glm::quat rotation, glm::vec3 scale);
 
-            glm::vec3 GetPosition() { return position; };
-            glm::quat GetRotation() { return rotation; };
-            glm::vec3 GetScale() { return scale; };
+            glm::vec3 GetPosition() { return TransformSystem::GetInstance()->GetPosition(id); };
+            glm::quat GetRotation() { return TransformSystem::GetInstance()->GetRotation(id); };
+            glm::vec3 GetScale() { return TransformSystem::GetInstance()->GetScale(id); };
 
-            glm::mat4 GetLocal() {
-                if (is_dirty) {
-                    Generate();
-                }
-                return model;
-            };
+            glm::mat4 GetLocal() { return TransformSystem::GetInstance()->GetLocal(id); };
+            // Cached, only recomputed when this transform or one of its parents changed.
+            glm::mat4 GetWorld() { return TransformSystem::GetInstance()->GetWorld(id); };
 
-            glm::mat4 GetWorld() {
-                glm::mat4 local = GetLocal();
-                if (parent) {
-                    return parent->GetWorld() * local;
-                }
-                return local;
-            };
+            Transform* GetParent() { return TransformSystem::GetInstance()->GetParent(id); };
 
-            Transform* GetParent() { return parent; };
+            u32 GetId() { return id; };
 
         protected:
-            void Generate();
-
-            b8 is_dirty;
-            glm::mat4 model;
-            Transform* parent;
-            glm::vec3 position;
-            glm::quat rotation;
-            glm::vec3 scale;
-
+            u32 id;
     };
 
-}
\ No newline at end of file
+}
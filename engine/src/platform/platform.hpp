@@ -11,6 +11,8 @@ namespace Engine {
             static void ConsoleWriteError(std::string& text, u8 color);
             static void ConsoleWrite(std::string& text, u8 color);
             static f64 GetAbsoluteTime();
+            // Seconds of a raw counter value of the clock behind GetAbsoluteTime, as other APIs report it.
+            static f64 GetTimeFromCounter(u64 counter);
             static b8 ClockSetup();
             static void PSleep(u64 ms);
             static std::vector<char*> GetRequiredExtensionsVK();
@@ -28,5 +30,9 @@ namespace Engine {
             static void FrMemory(void* block);
             static void* AllocMemory(u64 size);
             static void SetMemory(void* block, i32 data, u64 size);
+
+            // Read-only memory mapping of a whole file. Returns nullptr if the file can't be mapped.
+            static void* MapFile(std::string path, u64* out_size, void** out_handle);
+            static void UnmapFile(void* memory, void* handle);
     };  
 };
\ No newline at end of file
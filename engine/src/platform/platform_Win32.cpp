@@ -186,6 +186,10 @@ namespace Engine {
         return (f64)now_time.QuadPart * clock_frequency;
     };
 
+    f64 Platform::GetTimeFromCounter(u64 counter) {
+        return (f64)counter * clock_frequency;
+    };
+
     void Platform::PSleep(u64 ms) {
         Sleep(ms);
     };
@@ -372,6 +376,45 @@ namespace Engine {
         memset(block, data, size);
     };
 
+    void* Platform::MapFile(std::string path, u64* out_size, void** out_handle) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+        if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        // Mapping keeps its own reference to the file, so the file handle can go right away.
+        HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+        CloseHandle(file);
+        if (!mapping) {
+            return nullptr;
+        }
+
+        void* memory = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!memory) {
+            CloseHandle(mapping);
+            return nullptr;
+        }
+
+        *out_size = file_size.QuadPart;
+        *out_handle = mapping;
+        return memory;
+    };
+
+    void Platform::UnmapFile(void* memory, void* handle) {
+        if (memory) {
+            UnmapViewOfFile(memory);
+        }
+        if (handle) {
+            CloseHandle((HANDLE)handle);
+        }
+    };
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "bindless.hpp"
+
+#include "vulkan.hpp"
+#include "helpers.hpp"
+#include "core/logger/logger.hpp"
+
+namespace Engine {
+
+    VulkanBindlessTable::VulkanBindlessTable() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VkDevice logical_device = backend->GetVulkanDevice()->logical_device;
+
+        ready = false;
+        layout = VK_NULL_HANDLE;
+        pool = VK_NULL_HANDLE;
+        set = VK_NULL_HANDLE;
+        texture_count = 0;
+        sampler_count = 0;
+
+        VkDescriptorSetLayoutBinding bindings[2] = {};
+        bindings[0].binding = 0;
+        bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        bindings[0].descriptorCount = VULKAN_BINDLESS_MAX_TEXTURES;
+        bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        bindings[1].binding = 1;
+        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+        bindings[1].descriptorCount = VULKAN_BINDLESS_MAX_SAMPLERS;
+        bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        // Slots are written while frames that don't use them are in flight, unused slots stay empty.
+        VkDescriptorBindingFlags binding_flags[2] = {
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT
+        };
+        VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO};
+        binding_flags_info.bindingCount = 2;
+        binding_flags_info.pBindingFlags = binding_flags;
+
+        VkDescriptorSetLayoutCreateInfo layout_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+        layout_info.pNext = &binding_flags_info;
+        layout_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layout_info.bindingCount = 2;
+        layout_info.pBindings = bindings;
+        VkResult result = vkCreateDescriptorSetLayout(logical_device, &layout_info, backend->GetVulkanAllocator(), &layout);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanBindlessTable - failed creating descriptor set layout: '%s'", VulkanResultString(result, true));
+            return;
+        }
+
+        VkDescriptorPoolSize pool_sizes[2] = {
+            {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VULKAN_BINDLESS_MAX_TEXTURES},
+            {VK_DESCRIPTOR_TYPE_SAMPLER, VULKAN_BINDLESS_MAX_SAMPLERS}
+        };
+        VkDescriptorPoolCreateInfo pool_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+        pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        pool_info.maxSets = 1;
+        pool_info.poolSizeCount = 2;
+        pool_info.pPoolSizes = pool_sizes;
+        result = vkCreateDescriptorPool(logical_device, &pool_info, backend->GetVulkanAllocator(), &pool);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanBindlessTable - failed creating descriptor pool: '%s'", VulkanResultString(result, true));
+            return;
+        }
+
+        VkDescriptorSetAllocateInfo alloc_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        alloc_info.descriptorPool = pool;
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &layout;
+        result = vkAllocateDescriptorSets(logical_device, &alloc_info, &set);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanBindlessTable - failed allocating descriptor set: '%s'", VulkanResultString(result, true));
+            return;
+        }
+
+        ready = true;
+    };
+
+    VulkanBindlessTable::~VulkanBindlessTable() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VkDevice logical_device = backend->GetVulkanDevice()->logical_device;
+
+        if (pool) {
+            vkDestroyDescriptorPool(logical_device, pool, backend->GetVulkanAllocator());
+            pool = VK_NULL_HANDLE;
+            set = VK_NULL_HANDLE;
+        }
+        if (layout) {
+            vkDestroyDescriptorSetLayout(logical_device, layout, backend->GetVulkanAllocator());
+            layout = VK_NULL_HANDLE;
+        }
+    };
+
+    u32 VulkanBindlessTable::AcquireSlot(std::vector<u32>& free_slots, u32& count, u32 max_count) {
+        if (free_slots.size()) {
+            u32 slot = free_slots.back();
+            free_slots.pop_back();
+            return slot;
+        }
+        if (count >= max_count) {
+            return INVALID_ID;
+        }
+        return count++;
+    };
+
+    u32 VulkanBindlessTable::RegisterTexture(VkImageView view) {
+        u32 slot = AcquireSlot(free_texture_slots, texture_count, VULKAN_BINDLESS_MAX_TEXTURES);
+        if (slot == INVALID_ID) {
+            WARN("VulkanBindlessTable::RegisterTexture - all %u texture slots are in use.", VULKAN_BINDLESS_MAX_TEXTURES);
+            return INVALID_ID;
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        VkDescriptorImageInfo image_info = {};
+        image_info.imageView = view;
+        image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        write.dstSet = set;
+        write.dstBinding = 0;
+        write.dstArrayElement = slot;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        write.descriptorCount = 1;
+        write.pImageInfo = &image_info;
+        vkUpdateDescriptorSets(backend->GetVulkanDevice()->logical_device, 1, &write, 0, 0);
+        return slot;
+    };
+
+    void VulkanBindlessTable::ReleaseTexture(u32 slot) {
+        if (slot != INVALID_ID) {
+            free_texture_slots.push_back(slot);
+        }
+    };
+
+    u32 VulkanBindlessTable::RegisterSampler(VkSampler sampler) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        u32 slot = AcquireSlot(free_sampler_slots, sampler_count, VULKAN_BINDLESS_MAX_SAMPLERS);
+        if (slot == INVALID_ID) {
+            WARN("VulkanBindlessTable::RegisterSampler - all %u sampler slots are in use.", VULKAN_BINDLESS_MAX_SAMPLERS);
+            return INVALID_ID;
+        }
+
+        VkDescriptorImageInfo image_info = {};
+        image_info.sampler = sampler;
+
+        VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        write.dstSet = set;
+        write.dstBinding = 1;
+        write.dstArrayElement = slot;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+        write.descriptorCount = 1;
+        write.pImageInfo = &image_info;
+        vkUpdateDescriptorSets(backend->GetVulkanDevice()->logical_device, 1, &write, 0, 0);
+        return slot;
+    };
+
+    void VulkanBindlessTable::ReleaseSampler(u32 slot) {
+        if (slot != INVALID_ID) {
+            free_sampler_slots.push_back(slot);
+        }
+    };
+
+    void VulkanBindlessTable::Bind(VkCommandBuffer command_buffer, VkPipelineLayout pipeline_layout) {
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, VULKAN_BINDLESS_SET_INDEX, 1, &set, 0, 0);
+    };
+
+};
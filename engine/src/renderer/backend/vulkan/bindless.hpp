@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+
+// Sizes of the device wide arrays, shaders declare them with the same counts.
+#define VULKAN_BINDLESS_MAX_TEXTURES 4096
+#define VULKAN_BINDLESS_MAX_SAMPLERS 256
+// Set the table is bound to in bindless shaders, after the global and material sets.
+#define VULKAN_BINDLESS_SET_INDEX 2
+
+namespace Engine {
+
+    // Packs a texture and sampler slot into the u32 a material record stores per map.
+    INLINE_API u32 VulkanBindlessPack(u32 texture_slot, u32 sampler_slot) {
+        return (texture_slot & 0xFFFF) | (sampler_slot << 16);
+    };
+
+    // One descriptor set for the whole device holding every sampled image and sampler in stable slots.
+    // Textures and samplers register themselves on creation, shaders index the arrays with slots
+    // read from their material buffer instead of binding a descriptor set per material.
+    class VulkanBindlessTable {
+        public:
+            VulkanBindlessTable();
+            ~VulkanBindlessTable();
+
+            u32 RegisterTexture(VkImageView view);
+            // Slots go straight back to the free list, callers release them through the deletion queue
+            // so no frame in flight samples a slot while it is rewritten.
+            void ReleaseTexture(u32 slot);
+
+            u32 RegisterSampler(VkSampler sampler);
+            void ReleaseSampler(u32 slot);
+
+            void Bind(VkCommandBuffer command_buffer, VkPipelineLayout pipeline_layout);
+
+            VkDescriptorSetLayout layout;
+            VkDescriptorPool pool;
+            VkDescriptorSet set;
+
+            b8 ready;
+
+        private:
+            u32 AcquireSlot(std::vector<u32>& free_slots, u32& count, u32 max_count);
+
+            std::vector<u32> free_texture_slots;
+            std::vector<u32> free_sampler_slots;
+            u32 texture_count;
+            u32 sampler_count;
+    };
+
+};
@@ -11,7 +11,6 @@ namespace Engine {
         u64 size,
         VkBufferUsageFlagBits usage,
         VkMemoryPropertyFlags memory_property_flags,
-        b8 bind_on_create,
         b8 use_freelist) {
         
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
@@ -19,6 +18,9 @@ namespace Engine {
         this->total_size = size;
         this->usage = usage;
         this->memory_property_flags = memory_property_flags;
+        this->is_locked = false;
+        this->freelist = nullptr;
+        this->handle = nullptr;
 
         VkBufferCreateInfo buffer_info = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
         buffer_info.size = size;
@@ -31,12 +33,8 @@ namespace Engine {
             backend->GetVulkanAllocator(),
             &this->handle));
 
-        // Gather memory requirements
-        VkMemoryRequirements requirements;
-        vkGetBufferMemoryRequirements(backend->GetVulkanDevice()->logical_device, this->handle, &requirements);
-        this->memory_index = backend->FindMemoryIndex(requirements.memoryTypeBits, this->memory_property_flags);
-        if (this->memory_index == -1) {
-            ERROR("Unable to create vulkan buffer because the required memory index was not found.");
+        if (!backend->GetMemoryAllocator()->AllocateBuffer(this->handle, this->memory_property_flags, &this->allocation)) {
+            ERROR("Unable to create vulkan buffer because the required memory allocation failed.");
             ready = false;
             return;
         }
@@ -44,27 +42,6 @@ namespace Engine {
         if (use_freelist) {
             freelist = new Freelist(total_size);
         }
-        
-
-        VkMemoryAllocateInfo allocate_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-        allocate_info.allocationSize = requirements.size;
-        allocate_info.memoryTypeIndex = (u32)this->memory_index;
-
-        VkResult result = vkAllocateMemory(
-            backend->GetVulkanDevice()->logical_device,
-            &allocate_info,
-            backend->GetVulkanAllocator(),
-            &this->memory);
-
-        if (result != VK_SUCCESS) {
-            ERROR("Unable to create vulkan buffer because the required memory allocation failed. Error: %s", VulkanResultString(result, false));
-            ready = false;
-            return;
-        }
-
-        if (bind_on_create) {
-            Bind(0);
-        }
 
         ready = true;
     };
@@ -72,13 +49,19 @@ namespace Engine {
     VulkanBuffer::~VulkanBuffer() {
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
 
-        if (this->memory) {
-            vkFreeMemory(
-                backend->GetVulkanDevice()->logical_device,
-                this->memory,
-                backend->GetVulkanAllocator());
-            this->memory = nullptr;
+        if (freelist) {
+            delete freelist;
+            freelist = nullptr;
         }
+
+        // Frames in flight may still read it, the handle and memory go once they are done.
+        if (backend->GetDeletionQueue() && this->handle) {
+            backend->GetDeletionQueue()->DestroyBuffer(this->handle, this->allocation);
+            this->allocation = {};
+            this->handle = nullptr;
+        }
+
+        backend->GetMemoryAllocator()->Free(&this->allocation);
         
         if (this->handle) {
             vkDestroyBuffer(
@@ -93,9 +76,13 @@ namespace Engine {
         this->is_locked = false;
     };
 
-    b8 VulkanBuffer::Resize(u64 new_size, VkQueue queue, VkCommandPool pool) {
+    b8 VulkanBuffer::Resize(u64 new_size) {
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
 
+        if (new_size <= this->total_size) {
+            return true;
+        }
+
         VkBufferCreateInfo buffer_info = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
         buffer_info.size = new_size;
         buffer_info.usage = this->usage;
@@ -108,123 +95,78 @@ namespace Engine {
             backend->GetVulkanAllocator(),
             &new_buffer));
 
-        // Gather memory requirements
-        VkMemoryRequirements requirements;
-        vkGetBufferMemoryRequirements(backend->GetVulkanDevice()->logical_device, new_buffer, &requirements);
-
-        VkMemoryAllocateInfo allocate_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-        allocate_info.allocationSize = requirements.size;
-        allocate_info.memoryTypeIndex = (u32)this->memory_index;
-
-        VkDeviceMemory new_memory;
-        VkResult result = vkAllocateMemory(
-            backend->GetVulkanDevice()->logical_device,
-            &allocate_info,
-            backend->GetVulkanAllocator(),
-            &new_memory);
-
-        if (result != VK_SUCCESS) {
-            ERROR("Unable to resize vulkan buffer because the required memory allocation failed. Error: %s", VulkanResultString(result, false));
+        VulkanAllocation new_allocation;
+        if (!backend->GetMemoryAllocator()->AllocateBuffer(new_buffer, this->memory_property_flags, &new_allocation)) {
+            ERROR("Unable to resize vulkan buffer because the required memory allocation failed.");
+            vkDestroyBuffer(backend->GetVulkanDevice()->logical_device, new_buffer, backend->GetVulkanAllocator());
             return false;
         }
 
-        VK_CHECK(vkBindBufferMemory(
-            backend->GetVulkanDevice()->logical_device,
-            new_buffer,
-            new_memory,
-            0));
-
-        this->CopyTo(pool, nullptr, queue, 0, new_buffer, 0, this->total_size);
-
-        vkDeviceWaitIdle(backend->GetVulkanDevice()->logical_device);
-
-        if (this->memory) {
-            vkFreeMemory(
-                backend->GetVulkanDevice()->logical_device,
-                this->memory,
-                backend->GetVulkanAllocator());
-            this->memory = nullptr;
+        // Copied on the upload queue after every upload already recorded into the old buffer and before
+        // any later one, nothing waits here.
+        if (!backend->GetUploader()->CopyBuffer(this->handle, new_buffer, this->total_size)) {
+            ERROR("Unable to resize vulkan buffer because the copy into the new buffer failed.");
+            backend->GetMemoryAllocator()->Free(&new_allocation);
+            vkDestroyBuffer(backend->GetVulkanDevice()->logical_device, new_buffer, backend->GetVulkanAllocator());
+            return false;
         }
 
-        if (this->handle) {
-            vkDestroyBuffer(
-                backend->GetVulkanDevice()->logical_device,
-                this->handle,
-                backend->GetVulkanAllocator());
-            this->handle = nullptr;
+        // Frames in flight still read the old buffer, it goes once they are done.
+        if (backend->GetDeletionQueue()) {
+            backend->GetDeletionQueue()->DestroyBuffer(this->handle, this->allocation);
+        } else {
+            // The copy is only recorded so far.
+            backend->GetUploader()->WaitIdle();
+            vkDeviceWaitIdle(backend->GetVulkanDevice()->logical_device);
+            backend->GetMemoryAllocator()->Free(&this->allocation);
+            vkDestroyBuffer(backend->GetVulkanDevice()->logical_device, this->handle, backend->GetVulkanAllocator());
         }
 
         this->total_size = new_size;
         this->handle = new_buffer;
-        this->memory = new_memory;
+        this->allocation = new_allocation;
 
-        return true;
-    };
+        // Ranges handed out keep their offsets, the new space is free at the end.
+        if (freelist) {
+            freelist->Grow(new_size);
+        }
 
-    void VulkanBuffer::Bind(u64 offset) {
-        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        VK_CHECK(vkBindBufferMemory(
-            backend->GetVulkanDevice()->logical_device,
-            this->handle,
-            this->memory,
-            offset));
+        return true;
     };
 
     void* VulkanBuffer::LockMemory(u64 offset, u64 size, u32 flags) {
-        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        void* data;
-        VK_CHECK(vkMapMemory(
-            backend->GetVulkanDevice()->logical_device,
-            this->memory, 
-            offset,
-            size,
-            flags,
-            &data));
-        return data;
+        if (!allocation.mapped) {
+            ERROR("VulkanBuffer::LockMemory - buffer memory is not host visible.");
+            return nullptr;
+        }
+        is_locked = true;
+        return allocation.mapped + offset;
     };
 
     void VulkanBuffer::UnlockMemory() {
-        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        vkUnmapMemory(
-            backend->GetVulkanDevice()->logical_device,
-            this->memory);
-        };
+        VulkanRendererBackend::GetInstance()->GetMemoryAllocator()->Flush(allocation, 0, VK_WHOLE_SIZE);
+        is_locked = false;
+    };
 
     FreelistNode* VulkanBuffer::LoadData(u64 size, u32 flags, const void* data) {
         if (!freelist) {
             return nullptr;
         }
         FreelistNode* node = freelist->AllocateBlock(size);
-        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        void* data_ptr;
-        VK_CHECK(vkMapMemory(
-            backend->GetVulkanDevice()->logical_device,
-            this->memory, 
-            node->GetMemoryOffset(),
-            node->GetSize(),
-            flags,
-            &data_ptr));
-        Platform::CpMemory(data_ptr, data, size);
-        vkUnmapMemory(
-            backend->GetVulkanDevice()->logical_device,
-            this->memory);
+        if (!node) {
+            return nullptr;
+        }
+        LoadData(node->GetMemoryOffset(), size, flags, data);
         return node;
     };
 
     b8 VulkanBuffer::LoadData(u64 offset, u64 size, u32 flags, const void* data) {
-        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        void* data_ptr;
-        VK_CHECK(vkMapMemory(
-            backend->GetVulkanDevice()->logical_device,
-            this->memory, 
-            offset,
-            size,
-            flags,
-            &data_ptr));
-        Platform::CpMemory(data_ptr, data, size);
-        vkUnmapMemory(
-            backend->GetVulkanDevice()->logical_device,
-            this->memory);
+        if (!allocation.mapped) {
+            ERROR("VulkanBuffer::LoadData - buffer memory is not host visible.");
+            return false;
+        }
+        Platform::CpMemory(allocation.mapped + offset, data, size);
+        VulkanRendererBackend::GetInstance()->GetMemoryAllocator()->Flush(allocation, offset, size);
         return true;
     };
 
@@ -235,32 +177,6 @@ namespace Engine {
         return freelist->AllocateBlock(size);
     };
 
-    void VulkanBuffer::CopyTo(
-        VkCommandPool pool,
-        VkFence fence,
-        VkQueue queue,
-        u64 source_offset,
-        VkBuffer dest,
-        u64 dest_offset,
-        u64 size) {
-        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        
-        vkQueueWaitIdle(queue);
-
-        VulkanCommandBuffer command_buffer = VulkanCommandBuffer(pool, true);
-
-        command_buffer.BeginSingleUse();
-
-        VkBufferCopy copy_region;
-        copy_region.srcOffset = source_offset;
-        copy_region.dstOffset = dest_offset;
-        copy_region.size = size;
-
-        vkCmdCopyBuffer(command_buffer.handle, handle, dest, 1, &copy_region);
-
-        command_buffer.EndSingleUse(queue);
-    };
-
     b8 VulkanBuffer::Free(u64 offset) {
         if (!freelist) {
             return false;
@@ -3,6 +3,10 @@
 #include <vulkan/vulkan.h>
 #include "defines.hpp"
 #include "core/utils/freelist.hpp"
+#include "memory_allocator.hpp"
+
+// Freelist buffers out of room grow by this factor.
+#define VULKAN_BUFFER_GROWTH_FACTOR 2
 
 namespace Engine {
 
@@ -12,8 +16,8 @@ namespace Engine {
             VkBuffer handle;
             VkBufferUsageFlagBits usage;
             b8 is_locked;
-            VkDeviceMemory memory;
-            i32 memory_index;
+            // Sub-allocated from the backend's memory allocator, bound on creation.
+            VulkanAllocation allocation;
             u32 memory_property_flags;
             Freelist* freelist;
 
@@ -23,16 +27,16 @@ namespace Engine {
                 u64 size,
                 VkBufferUsageFlagBits usage,
                 VkMemoryPropertyFlags memory_property_flags,
-                b8 bind_on_create,
                 b8 use_freelist
             );
 
             ~VulkanBuffer();
 
-            b8 Resize(u64 new_size, VkQueue queue, VkCommandPool pool);
-
-            void Bind(u64 offset);
+            // Grows the buffer keeping its contents and freelist ranges. The handle changes, the old one is
+            // retired through the deletion queue.
+            b8 Resize(u64 new_size);
 
+            // Host visible memory stays mapped, locking only hands out the pointer and unlocking flushes.
             void* LockMemory(u64 offset, u64 size, u32 flags);
             void UnlockMemory();
 
@@ -41,17 +45,6 @@ namespace Engine {
 
             FreelistNode* Allocate(u64 size);
             b8 Free(u64 offset);
-
-            void CopyTo(
-                VkCommandPool pool,
-                VkFence fence,
-                VkQueue queue,
-                u64 source_offset,
-                VkBuffer dest,
-                u64 dest_offset,
-                u64 size
-            );
-
     };
 
 };
\ No newline at end of file
@@ -65,6 +65,15 @@ namespace Engine {
         this->state = VulkanCommandBufferState::RECORDING;
     };
 
+    void VulkanCommandBuffer::BeginSecondary(const VkCommandBufferInheritanceInfo* inheritance) {
+        VkCommandBufferBeginInfo cb_begin_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        cb_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        cb_begin_info.pInheritanceInfo = inheritance;
+
+        VK_CHECK(vkBeginCommandBuffer(this->handle, &cb_begin_info));
+        this->state = VulkanCommandBufferState::IN_RENDER_PASS;
+    };
+
     void VulkanCommandBuffer::End() {
         VK_CHECK(vkEndCommandBuffer(this->handle));
         this->state = VulkanCommandBufferState::RECORDING_ENDED;
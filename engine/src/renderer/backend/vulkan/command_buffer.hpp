@@ -30,6 +30,9 @@ namespace Engine {
                        b8 is_renderpass_continue,
                        b8 is_simultaneous_use);
 
+            // Secondary buffer recording inside the renderpass and framebuffer of inheritance.
+            void BeginSecondary(const VkCommandBufferInheritanceInfo* inheritance);
+
             void End();
 
             void UpdateSubmitted();
@@ -0,0 +1,130 @@
+#include "deletion_queue.hpp"
+
+#include "vulkan.hpp"
+#include "buffer.hpp"
+#include "helpers.hpp"
+#include "core/logger/logger.hpp"
+
+namespace Engine {
+
+    VulkanDeletionQueue::VulkanDeletionQueue() {
+    };
+
+    VulkanDeletionQueue::~VulkanDeletionQueue() {
+        Flush();
+    };
+
+    void VulkanDeletionQueue::Push(std::function<void()> destroy) {
+        pending.push_back(std::move(destroy));
+    };
+
+    void VulkanDeletionQueue::DestroyBuffer(VkBuffer buffer, VulkanAllocation allocation) {
+        Push([buffer, allocation]() mutable {
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            backend->GetMemoryAllocator()->Free(&allocation);
+            vkDestroyBuffer(backend->GetVulkanDevice()->logical_device, buffer, backend->GetVulkanAllocator());
+        });
+    };
+
+    void VulkanDeletionQueue::DestroyImage(VkImage image, VulkanAllocation allocation) {
+        Push([image, allocation]() mutable {
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            backend->GetMemoryAllocator()->Free(&allocation);
+            vkDestroyImage(backend->GetVulkanDevice()->logical_device, image, backend->GetVulkanAllocator());
+        });
+    };
+
+    void VulkanDeletionQueue::DestroyImageView(VkImageView view) {
+        Push([view]() {
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            vkDestroyImageView(backend->GetVulkanDevice()->logical_device, view, backend->GetVulkanAllocator());
+        });
+    };
+
+    void VulkanDeletionQueue::FreeMemory(VulkanAllocation allocation) {
+        Push([allocation]() mutable {
+            VulkanRendererBackend::GetInstance()->GetMemoryAllocator()->Free(&allocation);
+        });
+    };
+
+    void VulkanDeletionQueue::DestroyPipeline(VkPipeline pipeline) {
+        Push([pipeline]() {
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            vkDestroyPipeline(backend->GetVulkanDevice()->logical_device, pipeline, backend->GetVulkanAllocator());
+        });
+    };
+
+    void VulkanDeletionQueue::DestroyPipelineLayout(VkPipelineLayout layout) {
+        Push([layout]() {
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            vkDestroyPipelineLayout(backend->GetVulkanDevice()->logical_device, layout, backend->GetVulkanAllocator());
+        });
+    };
+
+    void VulkanDeletionQueue::DestroyDescriptorSetLayout(VkDescriptorSetLayout layout) {
+        Push([layout]() {
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            vkDestroyDescriptorSetLayout(backend->GetVulkanDevice()->logical_device, layout, backend->GetVulkanAllocator());
+        });
+    };
+
+    void VulkanDeletionQueue::FreeDescriptorSets(VkDescriptorPool pool, u32 count, const VkDescriptorSet* sets) {
+        std::vector<VkDescriptorSet> copies(sets, sets + count);
+        Push([pool, copies]() {
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            VkResult result = vkFreeDescriptorSets(backend->GetVulkanDevice()->logical_device, pool, (u32)copies.size(), copies.data());
+            if (result != VK_SUCCESS) {
+                ERROR("VulkanDeletionQueue - failed freeing descriptor sets: '%s'", VulkanResultString(result, true));
+            }
+        });
+    };
+
+    void VulkanDeletionQueue::FreeRange(VulkanBuffer* buffer, u64 offset) {
+        Push([buffer, offset]() {
+            if (!buffer->Free(offset)) {
+                WARN("VulkanDeletionQueue - no range at offset %llu to free.", offset);
+            }
+        });
+    };
+
+    void VulkanDeletionQueue::Submit(u64 value) {
+        if (pending.empty()) {
+            return;
+        }
+        batches.push_back({value, {}});
+        batches.back().releases.swap(pending);
+    };
+
+    void VulkanDeletionQueue::Collect(u64 completed_value) {
+        while (!batches.empty() && batches.front().value <= completed_value) {
+            // Popped first, a destroy may release more.
+            std::vector<std::function<void()>> list;
+            list.swap(batches.front().releases);
+            batches.pop_front();
+            for (std::function<void()>& destroy : list) {
+                destroy();
+            }
+        }
+    };
+
+    void VulkanDeletionQueue::Flush() {
+        Collect(UINT64_MAX);
+        // Pending ones are the newest, they go last.
+        while (!pending.empty()) {
+            std::vector<std::function<void()>> list;
+            list.swap(pending);
+            for (std::function<void()>& destroy : list) {
+                destroy();
+            }
+        }
+    };
+
+    u32 VulkanDeletionQueue::GetPendingCount() {
+        u32 count = (u32)pending.size();
+        for (const Batch& batch : batches) {
+            count += (u32)batch.releases.size();
+        }
+        return count;
+    };
+
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <deque>
+#include "defines.hpp"
+#include "memory_allocator.hpp"
+
+namespace Engine {
+
+    class VulkanBuffer;
+
+    // Destroys GPU objects once no submitted frame can still use them instead of idling the device.
+    // Releases gather until the next frame is submitted and are run once the frame timeline reaches that
+    // submission's value, so they outlive every frame and upload batch submitted before the release. Main thread only.
+    class VulkanDeletionQueue {
+        public:
+            VulkanDeletionQueue();
+            ~VulkanDeletionQueue();
+
+            void Push(std::function<void()> destroy);
+
+            void DestroyBuffer(VkBuffer buffer, VulkanAllocation allocation);
+            void DestroyImage(VkImage image, VulkanAllocation allocation);
+            void DestroyImageView(VkImageView view);
+            // Memory whose resources were released on their own.
+            void FreeMemory(VulkanAllocation allocation);
+            void DestroyPipeline(VkPipeline pipeline);
+            void DestroyPipelineLayout(VkPipelineLayout layout);
+            void DestroyDescriptorSetLayout(VkDescriptorSetLayout layout);
+            void FreeDescriptorSets(VkDescriptorPool pool, u32 count, const VkDescriptorSet* sets);
+            // Gives a range of a freelist buffer back to its pool.
+            void FreeRange(VulkanBuffer* buffer, u64 offset);
+
+            // Hands what was released so far to the submission signaling the value.
+            void Submit(u64 value);
+            // Runs the releases of every submission up to the completed value.
+            void Collect(u64 completed_value);
+            // Runs everything, the device must be idle.
+            void Flush();
+
+            u32 GetPendingCount();
+
+        private:
+            std::vector<std::function<void()>> pending;
+            struct Batch {
+                u64 value;
+                std::vector<std::function<void()>> releases;
+            };
+            // Oldest first, values increase.
+            std::deque<Batch> batches;
+    };
+
+};
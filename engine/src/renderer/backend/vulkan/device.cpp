@@ -13,6 +13,11 @@ namespace Engine {
         Platform::ZrMemory(&memory, sizeof(VkPhysicalDeviceMemoryProperties));
         Platform::ZrMemory(&logical_device, sizeof(VkDevice));
         Platform::ZrMemory(&physical_device, sizeof(VkPhysicalDevice));
+        supports_descriptor_indexing = false;
+        graphics_timestamp_bits = 0;
+        transfer_timestamp_bits = 0;
+        supports_calibrated_timestamps = false;
+        host_time_domain = VK_TIME_DOMAIN_DEVICE_EXT;
     };
 
     VulkanDevice::~VulkanDevice() {
@@ -106,14 +111,42 @@ namespace Engine {
         // TODO: should be config driven
         VkPhysicalDeviceFeatures device_features = {};
         device_features.samplerAnisotropy = VK_TRUE;
+        // Optional, indirect submission checks device->features before using them.
+        device_features.multiDrawIndirect = new_device->features.multiDrawIndirect;
+        device_features.drawIndirectFirstInstance = new_device->features.drawIndirectFirstInstance;
+        device_features.shaderSampledImageArrayDynamicIndexing = new_device->features.shaderSampledImageArrayDynamicIndexing;
+
+        // Optional, the bindless table is only created if these were enabled.
+        VkPhysicalDeviceDescriptorIndexingFeatures indexing_features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
+        indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
+        indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        indexing_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+
+        // Required, frame and upload completion is tracked on a timeline semaphore.
+        VkPhysicalDeviceTimelineSemaphoreFeatures timeline_features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
+        timeline_features.timelineSemaphore = VK_TRUE;
+        timeline_features.pNext = new_device->supports_descriptor_indexing ? &indexing_features : nullptr;
+
+        // Required in 1.2 as well, GPU timer queries are reset from the host once their results are read.
+        VkPhysicalDeviceHostQueryResetFeatures host_query_reset_features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES};
+        host_query_reset_features.hostQueryReset = VK_TRUE;
+        host_query_reset_features.pNext = &timeline_features;
+
+        std::vector<const char*> extension_names;
+        if (!backend->IsHeadless()) {
+            extension_names.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        }
+        if (new_device->supports_calibrated_timestamps) {
+            extension_names.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+        }
 
         VkDeviceCreateInfo device_create_info = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
         device_create_info.queueCreateInfoCount = index_count;
         device_create_info.pQueueCreateInfos = queues_create_infos;
         device_create_info.pEnabledFeatures = &device_features;
-        device_create_info.enabledExtensionCount = 1;
-        const char* extension_names = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
-        device_create_info.ppEnabledExtensionNames = &extension_names;
+        device_create_info.pNext = &host_query_reset_features;
+        device_create_info.enabledExtensionCount = extension_names.size();
+        device_create_info.ppEnabledExtensionNames = extension_names.data();
 
         VK_CHECK(vkCreateDevice(
             new_device->physical_device, 
@@ -191,13 +224,16 @@ namespace Engine {
             // configuration.
             VulkanPhysicalDeviceRequirements requirements;
             requirements.graphics = true;
-            requirements.present = true;
+            requirements.present = !backend->IsHeadless();
             requirements.transfer = true;
             // NOTE: Enable this if compute will be required.
             // requirements.compute = true;
             requirements.sampler_anisotropy = true;
-            requirements.discrete_gpu = true;
-            requirements.device_extension_names.push_back((char*)VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+            // Headless runs on whatever is there, software drivers such as lavapipe included.
+            requirements.discrete_gpu = !backend->IsHeadless();
+            if (requirements.present) {
+                requirements.device_extension_names.push_back((char*)VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+            }
 
             VulkanPhysicalDeviceQueueFamilyInfo queue_info = {};
             b8 result = PhysicalDeviceMeetsRequirements(
@@ -262,7 +298,8 @@ namespace Engine {
 
                 physical_device = physical_devices[i];
                 graphics_queue_index = queue_info.graphics_family_index;
-                present_queue_index = queue_info.present_family_index;
+                // Nothing is presented headless, the graphics queue stands in.
+                present_queue_index = requirements.present ? queue_info.present_family_index : queue_info.graphics_family_index;
                 transfer_queue_index = queue_info.transfer_family_index;
                 // NOTE: set compute index here if needed.
 
@@ -271,6 +308,8 @@ namespace Engine {
                 this->features = features;
                 this->memory = memory;
                 supports_device_local_host_visible = supports_device_local_host_visible;
+                DetectDescriptorIndexing();
+                DetectTimestamps();
                 break;
             }
         }  
@@ -283,6 +322,91 @@ namespace Engine {
         return true;
     };
 
+    void VulkanDevice::DetectDescriptorIndexing() {
+        supports_descriptor_indexing = false;
+
+        // Core since 1.2, older devices keep the per material descriptor sets.
+        if (properties.apiVersion < VK_API_VERSION_1_2 || !features.shaderSampledImageArrayDynamicIndexing) {
+            DEBUG("Descriptor indexing is not available, bindless textures disabled.");
+            return;
+        }
+
+        VkPhysicalDeviceDescriptorIndexingFeatures indexing_features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
+        VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        features2.pNext = &indexing_features;
+        vkGetPhysicalDeviceFeatures2(physical_device, &features2);
+
+        VkPhysicalDeviceDescriptorIndexingProperties indexing_properties = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES};
+        VkPhysicalDeviceProperties2 properties2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+        properties2.pNext = &indexing_properties;
+        vkGetPhysicalDeviceProperties2(physical_device, &properties2);
+
+        supports_descriptor_indexing = 
+            indexing_features.descriptorBindingPartiallyBound &&
+            indexing_features.descriptorBindingSampledImageUpdateAfterBind &&
+            indexing_features.descriptorBindingUpdateUnusedWhilePending &&
+            indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages >= VULKAN_BINDLESS_MAX_TEXTURES &&
+            indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers >= VULKAN_BINDLESS_MAX_SAMPLERS;
+
+        DEBUG("Descriptor indexing %s.", supports_descriptor_indexing ? "supported, bindless textures enabled" : "incomplete, bindless textures disabled");
+    };
+
+    void VulkanDevice::DetectTimestamps() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        graphics_timestamp_bits = 0;
+        transfer_timestamp_bits = 0;
+        supports_calibrated_timestamps = false;
+
+        u32 queue_family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, nullptr);
+        std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, queue_families.data());
+
+        if (properties.limits.timestampPeriod > 0.0f) {
+            graphics_timestamp_bits = queue_families[graphics_queue_index].timestampValidBits;
+            if (transfer_queue_index >= 0) {
+                transfer_timestamp_bits = queue_families[transfer_queue_index].timestampValidBits;
+            }
+        }
+
+        u32 extension_count = 0;
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, nullptr);
+        std::vector<VkExtensionProperties> extensions(extension_count);
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, extensions.data());
+
+        b8 has_extension = false;
+        for (VkExtensionProperties& extension : extensions) {
+            has_extension |= strcmp(extension.extensionName, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) == 0;
+        }
+
+        PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT get_time_domains =
+            (PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT)vkGetInstanceProcAddr(
+                backend->GetVulkanInstance(), "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT");
+
+        // Calibration only helps if the host side is the clock the engine measures CPU time with.
+        if (graphics_timestamp_bits && has_extension && get_time_domains) {
+            u32 domain_count = 0;
+            get_time_domains(physical_device, &domain_count, nullptr);
+            std::vector<VkTimeDomainEXT> domains(domain_count);
+            get_time_domains(physical_device, &domain_count, domains.data());
+
+            b8 has_device_domain = false;
+            b8 has_host_domain = false;
+            for (VkTimeDomainEXT domain : domains) {
+                has_device_domain |= domain == VK_TIME_DOMAIN_DEVICE_EXT;
+                has_host_domain |= domain == VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+            }
+            host_time_domain = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+            supports_calibrated_timestamps = has_device_domain && has_host_domain;
+        }
+
+        DEBUG("GPU timestamps %s, %u valid bits, calibration %s.",
+            graphics_timestamp_bits ? "supported" : "not supported",
+            graphics_timestamp_bits,
+            supports_calibrated_timestamps ? "available" : "not available");
+    };
+
     b8 VulkanDevice::PhysicalDeviceMeetsRequirements(
         VkPhysicalDevice physical_device, 
         VkSurfaceKHR surface, 
@@ -305,6 +429,12 @@ namespace Engine {
             }
         }
 
+        // Timeline semaphores are core and always supported since 1.2.
+        if (properties->apiVersion < VK_API_VERSION_1_2) {
+            DEBUG("Device does not support Vulkan 1.2, timeline semaphores are required. Skipping");
+            return false;
+        }
+
         u32 queue_family_count = 0;
         const u32 max_queue_family_count = 32;
         vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, 0);
@@ -340,10 +470,12 @@ namespace Engine {
             }
 
             // Present queue?
-            VkBool32 supports_present = VK_FALSE;
-            VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(physical_device, i, surface, &supports_present));
-            if (supports_present) {
-                out_queue_info->present_family_index = i;
+            if (requirements->present) {
+                VkBool32 supports_present = VK_FALSE;
+                VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(physical_device, i, surface, &supports_present));
+                if (supports_present) {
+                    out_queue_info->present_family_index = i;
+                }
             }
 
         }
@@ -366,12 +498,14 @@ namespace Engine {
             TRACE("Compute Family Index:  %i", out_queue_info->compute_family_index);
 
             // Query swapchain support.
-            QuerySwapchainSupport(
-                physical_device,
-                surface,
-                out_swapchain_support);
+            if (requirements->present) {
+                QuerySwapchainSupport(
+                    physical_device,
+                    surface,
+                    out_swapchain_support);
+            }
 
-            if (out_swapchain_support->format_count < 1 || out_swapchain_support->present_mode_count < 1) {
+            if (requirements->present && (out_swapchain_support->format_count < 1 || out_swapchain_support->present_mode_count < 1)) {
                 if (out_swapchain_support->formats) {
                     Platform::FrMemory(out_swapchain_support->formats);
                 }
@@ -53,6 +53,8 @@ namespace Engine {
                 VulkanSwapchainSupportInfo* out_swapchain_support);
 
             b8 DetectDepthFormat();
+            void DetectDescriptorIndexing();
+            void DetectTimestamps();
 
             VkPhysicalDevice physical_device;
             VkDevice logical_device;
@@ -76,6 +78,14 @@ namespace Engine {
             u8 depth_channel_count;
 
             b8 supports_device_local_host_visible;
+            // Partially bound, update after bind sampled image arrays, needed for the bindless table.
+            b8 supports_descriptor_indexing;
+            // Meaningful bits of timestamps written on the graphics and transfer queues, 0 without timestamps.
+            u32 graphics_timestamp_bits;
+            u32 transfer_timestamp_bits;
+            // VK_EXT_calibrated_timestamps with the clock behind Platform::GetAbsoluteTime as host domain.
+            b8 supports_calibrated_timestamps;
+            VkTimeDomainEXT host_time_domain;
     };
 
 };
\ No newline at end of file
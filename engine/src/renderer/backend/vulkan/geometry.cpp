@@ -6,6 +6,7 @@ namespace Engine
 {
     VulkanGeometry::VulkanGeometry(GeometryCreateInfo& info, VulkanGeometryCreateInfo& vk_info) : Geometry(info) {
         vertex_count = vk_info.vertex_count;
+        vertex_element_size = vk_info.vertex_element_size;
         vertex_size = vk_info.vertex_size;
         vertex_memory = vk_info.vertex_memory;
 
@@ -15,12 +16,9 @@ namespace Engine
     };
 
     VulkanGeometry::~VulkanGeometry() {
+        // Ranges return to the buffers once the frames using them are done.
         VulkanRendererBackend::GetInstance()->FreeGeometry(this);
-        this->Free();
-    };
-
-    void VulkanGeometry::Free() {
-        this->index_memory->FreeBlock();
-        this->vertex_memory->FreeBlock();
+        vertex_memory = nullptr;
+        index_memory = nullptr;
     };
 } 
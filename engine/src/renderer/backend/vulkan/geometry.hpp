@@ -7,6 +7,7 @@ namespace Engine
 
     struct VulkanGeometryCreateInfo {
         u32 vertex_count;
+        u32 vertex_element_size;
         u32 vertex_size;
         FreelistNode* vertex_memory;
         u32 index_count;
@@ -20,6 +21,7 @@ namespace Engine
             ~VulkanGeometry();
 
             u32 GetVertexCount() { return vertex_count; };
+            u32 GetVertexElementSize() { return vertex_element_size; };
             u32 GetVertexSize() { return vertex_size; };
             u32 GetVertexBufferOffset() { return vertex_memory->GetMemoryOffset(); };
 
@@ -33,9 +35,11 @@ namespace Engine
             void SetIndexCount(u32 index_count) { this->index_count = index_count; };
             void SetIndexSize(u32 index_size) { this->index_size = index_size; };
 
-            void Free();
+            b8 HasVertexMemory() { return vertex_memory != nullptr; };
+            b8 HasIndexMemory() { return index_memory != nullptr; };
         protected:
             u32 vertex_count;
+            u32 vertex_element_size;
             u32 vertex_size;
             FreelistNode* vertex_memory;
             u32 index_count;
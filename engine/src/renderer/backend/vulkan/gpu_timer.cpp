@@ -0,0 +1,250 @@
+#include "gpu_timer.hpp"
+
+#include "vulkan.hpp"
+#include "helpers.hpp"
+#include "core/logger/logger.hpp"
+#include "platform/platform.hpp"
+
+namespace Engine {
+
+    VulkanGpuTimer::VulkanGpuTimer(u32 frame_count) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanDevice* device = backend->GetVulkanDevice();
+
+        this->ready = false;
+        this->current = 0;
+        this->recording = false;
+        this->frame_count = 0;
+        this->upload_gpu_ms = 0.0;
+        this->has_latest = false;
+        this->get_calibrated_timestamps = nullptr;
+
+        // Nanoseconds per tick from the device, only the valid low bits of a timestamp count.
+        u32 timestamp_bits = device->graphics_timestamp_bits;
+        this->period_ms = device->properties.limits.timestampPeriod / 1000000.0;
+        this->mask = timestamp_bits >= 64 ? UINT64_MAX : (1ull << timestamp_bits) - 1;
+
+        frames.resize(frame_count);
+        for (VulkanGpuTimerFrame& frame : frames) {
+            frame.pool = VK_NULL_HANDLE;
+            frame.query_count = 0;
+            frame.frame = 0;
+            frame.value = 0;
+            frame.cpu_begin_time = 0.0;
+            frame.cpu_submit_time = 0.0;
+            frame.pending = false;
+
+            if (!timestamp_bits) {
+                continue;
+            }
+
+            VkQueryPoolCreateInfo pool_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+            pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            pool_info.queryCount = VULKAN_GPU_TIMER_MAX_QUERIES;
+            VkResult result = vkCreateQueryPool(device->logical_device, &pool_info, backend->GetVulkanAllocator(), &frame.pool);
+            if (!IsVulkanResultSuccess(result)) {
+                ERROR("VulkanGpuTimer - failed creating query pool: '%s'", VulkanResultString(result, true));
+                frame.pool = VK_NULL_HANDLE;
+                return;
+            }
+            // Written before the first frame ever reads them.
+            vkResetQueryPool(device->logical_device, frame.pool, 0, VULKAN_GPU_TIMER_MAX_QUERIES);
+        }
+
+        if (device->supports_calibrated_timestamps) {
+            get_calibrated_timestamps = (PFN_vkGetCalibratedTimestampsEXT)vkGetDeviceProcAddr(
+                device->logical_device, "vkGetCalibratedTimestampsEXT");
+        }
+
+        ready = true;
+    };
+
+    VulkanGpuTimer::~VulkanGpuTimer() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        for (VulkanGpuTimerFrame& frame : frames) {
+            if (frame.pool) {
+                vkDestroyQueryPool(backend->GetVulkanDevice()->logical_device, frame.pool, backend->GetVulkanAllocator());
+                frame.pool = VK_NULL_HANDLE;
+            }
+        }
+        frames.clear();
+    };
+
+    void VulkanGpuTimer::BeginFrame(u32 frame_index, VulkanCommandBuffer* command_buffer) {
+        if (frame_index >= frames.size()) {
+            recording = false;
+            return;
+        }
+
+        Collect();
+
+        // The backend waited for the slot's last submission, its results were just read.
+        current = frame_index;
+        VulkanGpuTimerFrame& frame = frames[current];
+        if (frame.pending) {
+            WARN("VulkanGpuTimer - results of frame %llu were not available, dropping them.", frame.frame);
+            frame.pending = false;
+        }
+
+        frame.scopes.clear();
+        frame.query_count = 0;
+        frame.cpu_begin_time = Platform::GetAbsoluteTime();
+        recording = true;
+
+        if (frame.pool) {
+            VulkanDevice* device = VulkanRendererBackend::GetInstance()->GetVulkanDevice();
+            vkResetQueryPool(device->logical_device, frame.pool, 0, VULKAN_GPU_TIMER_MAX_QUERIES);
+            vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.pool, 0);
+            // Query 1 is the frame's end, written by EndFrame.
+            frame.query_count = 2;
+        }
+    };
+
+    u32 VulkanGpuTimer::BeginScope(VulkanCommandBuffer* command_buffer, const std::string& name) {
+        VulkanGpuTimerFrame& frame = frames[current];
+        // Room for the scope's end as well.
+        if (!recording || !frame.pool || frame.query_count + 2 > VULKAN_GPU_TIMER_MAX_QUERIES) {
+            return INVALID_ID;
+        }
+
+        VulkanGpuTimerScope scope;
+        scope.name = name;
+        scope.begin_query = frame.query_count++;
+        scope.end_query = INVALID_ID;
+        vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.pool, scope.begin_query);
+        frame.scopes.push_back(scope);
+        return (u32)frame.scopes.size() - 1;
+    };
+
+    void VulkanGpuTimer::EndScope(VulkanCommandBuffer* command_buffer, u32 scope) {
+        VulkanGpuTimerFrame& frame = frames[current];
+        if (!recording || scope >= frame.scopes.size() || frame.scopes[scope].end_query != INVALID_ID) {
+            return;
+        }
+
+        frame.scopes[scope].end_query = frame.query_count++;
+        vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.pool, frame.scopes[scope].end_query);
+    };
+
+    void VulkanGpuTimer::EndFrame(VulkanCommandBuffer* command_buffer) {
+        VulkanGpuTimerFrame& frame = frames[current];
+        if (!recording) {
+            return;
+        }
+
+        // Scopes still open would leave queries unwritten, their results would never become available.
+        for (u32 i = 0; i < frame.scopes.size(); ++i) {
+            EndScope(command_buffer, i);
+        }
+        if (frame.pool) {
+            vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.pool, 1);
+        }
+    };
+
+    void VulkanGpuTimer::Submitted(u64 value) {
+        if (!recording) {
+            return;
+        }
+
+        VulkanGpuTimerFrame& frame = frames[current];
+        frame.cpu_submit_time = Platform::GetAbsoluteTime();
+        frame.frame = frame_count++;
+        frame.value = value;
+        frame.pending = true;
+        recording = false;
+    };
+
+    void VulkanGpuTimer::Collect() {
+        VulkanTimeline* timeline = VulkanRendererBackend::GetInstance()->GetFrameTimeline();
+
+        while (true) {
+            VulkanGpuTimerFrame* oldest = nullptr;
+            for (VulkanGpuTimerFrame& frame : frames) {
+                if (frame.pending && (!oldest || frame.frame < oldest->frame)) {
+                    oldest = &frame;
+                }
+            }
+            if (!oldest || !timeline->IsComplete(oldest->value) || !Read(*oldest)) {
+                return;
+            }
+        }
+    };
+
+    b8 VulkanGpuTimer::Read(VulkanGpuTimerFrame& frame) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanDevice* device = backend->GetVulkanDevice();
+
+        RendererFrameTimings timings;
+        timings.frame = frame.frame;
+        timings.cpu_ms = (frame.cpu_submit_time - frame.cpu_begin_time) * 1000.0;
+        timings.cpu_submit_time = frame.cpu_submit_time;
+
+        if (frame.pool) {
+            u64 timestamps[VULKAN_GPU_TIMER_MAX_QUERIES];
+            VkResult result = vkGetQueryPoolResults(
+                device->logical_device, frame.pool, 0, frame.query_count,
+                sizeof(u64) * frame.query_count, timestamps, sizeof(u64), VK_QUERY_RESULT_64_BIT);
+            if (result == VK_NOT_READY) {
+                return false;
+            }
+            if (!IsVulkanResultSuccess(result)) {
+                ERROR("VulkanGpuTimer - vkGetQueryPoolResults failed: '%s'", VulkanResultString(result, true));
+            } else {
+                u64 begin = timestamps[0];
+                timings.gpu_ms = TicksToMs(timestamps[1] - begin);
+                timings.scopes.reserve(frame.scopes.size());
+                for (VulkanGpuTimerScope& scope : frame.scopes) {
+                    if (scope.end_query == INVALID_ID) {
+                        continue;
+                    }
+                    RendererGpuScope gpu_scope;
+                    gpu_scope.name = scope.name;
+                    gpu_scope.begin_ms = TicksToMs(timestamps[scope.begin_query] - begin);
+                    gpu_scope.duration_ms = TicksToMs(timestamps[scope.end_query] - timestamps[scope.begin_query]);
+                    timings.scopes.push_back(gpu_scope);
+                }
+
+                // Both clocks sampled together, the frame's timestamps are placed back from that point.
+                if (get_calibrated_timestamps) {
+                    VkCalibratedTimestampInfoEXT infos[2] = {
+                        {VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT},
+                        {VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT}};
+                    infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+                    infos[1].timeDomain = device->host_time_domain;
+                    u64 now[2];
+                    u64 max_deviation = 0;
+                    result = get_calibrated_timestamps(device->logical_device, 2, infos, now, &max_deviation);
+                    if (IsVulkanResultSuccess(result)) {
+                        f64 host_now = Platform::GetTimeFromCounter(now[1]);
+                        timings.gpu_begin_time = host_now - TicksToMs(now[0] - begin) / 1000.0;
+                        timings.gpu_end_time = host_now - TicksToMs(now[0] - timestamps[1]) / 1000.0;
+                        timings.calibrated = true;
+                    }
+                }
+            }
+        }
+
+        // Upload batches retired since the last read, they run between frames on their own submissions.
+        VulkanUploader* uploader = backend->GetUploader();
+        if (uploader) {
+            timings.upload_gpu_ms = uploader->GetStats().gpu_ms - upload_gpu_ms;
+            upload_gpu_ms = uploader->GetStats().gpu_ms;
+        }
+
+        frame.pending = false;
+        latest = std::move(timings);
+        has_latest = true;
+        return true;
+    };
+
+    b8 VulkanGpuTimer::GetFrameTimings(RendererFrameTimings* out_timings) {
+        Collect();
+        if (!has_latest) {
+            return false;
+        }
+        *out_timings = latest;
+        has_latest = false;
+        return true;
+    };
+
+};
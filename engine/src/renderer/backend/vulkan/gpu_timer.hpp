@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+#include "command_buffer.hpp"
+#include "renderer/renderer.hpp"
+
+// Timestamps per frame in flight, two for the frame itself and two per scope.
+#define VULKAN_GPU_TIMER_MAX_QUERIES 64
+
+namespace Engine {
+
+    struct VulkanGpuTimerScope {
+        std::string name;
+        u32 begin_query;
+        // INVALID_ID until the scope ends.
+        u32 end_query;
+    };
+
+    // Queries of one frame in flight, read once the frame timeline reaches value.
+    struct VulkanGpuTimerFrame {
+        // Null when the device has no timestamps, only CPU time is measured then.
+        VkQueryPool pool;
+        // Queries written so far, 0 and 1 are the frame's begin and end.
+        u32 query_count;
+        std::vector<VulkanGpuTimerScope> scopes;
+        u64 frame;
+        u64 value;
+        f64 cpu_begin_time;
+        f64 cpu_submit_time;
+        b8 pending;
+    };
+
+    // Timestamps around every frame and the scopes recorded in it, one query pool per frame in flight.
+    // Results are read without waiting once the frame timeline shows the frame complete, usually when
+    // its slot comes around again, and mapped to the Platform::GetAbsoluteTime clock when the device
+    // supports calibrated timestamps. Main thread only.
+    class VulkanGpuTimer {
+        public:
+            VulkanGpuTimer(u32 frame_count);
+            ~VulkanGpuTimer();
+
+            // Reads what finished, resets the slot's queries and writes the frame's first timestamp.
+            void BeginFrame(u32 frame, VulkanCommandBuffer* command_buffer);
+            // Outside of a render pass instance, timestamps are not allowed inside parallel ones.
+            // INVALID_ID when the frame ran out of queries or the device has no timestamps.
+            u32 BeginScope(VulkanCommandBuffer* command_buffer, const std::string& name);
+            void EndScope(VulkanCommandBuffer* command_buffer, u32 scope);
+            // Last command of the frame's command buffer.
+            void EndFrame(VulkanCommandBuffer* command_buffer);
+            // The frame is done once the frame timeline reaches value.
+            void Submitted(u64 value);
+
+            // The newest frame read since the last call, never waits on the device.
+            b8 GetFrameTimings(RendererFrameTimings* out_timings);
+
+            b8 ready;
+
+        private:
+            // Reads submitted frames the timeline shows complete, oldest first.
+            void Collect();
+            // False while the results are not available yet.
+            b8 Read(VulkanGpuTimerFrame& frame);
+            f64 TicksToMs(u64 ticks) { return (f64)(ticks & mask) * period_ms; };
+
+            f64 period_ms;
+            u64 mask;
+            u32 current;
+            b8 recording;
+            // Frames submitted since creation.
+            u64 frame_count;
+            // Uploader GPU time when the last frame was read.
+            f64 upload_gpu_ms;
+            std::vector<VulkanGpuTimerFrame> frames;
+
+            RendererFrameTimings latest;
+            b8 has_latest;
+
+            // Null without calibrated timestamps.
+            PFN_vkGetCalibratedTimestampsEXT get_calibrated_timestamps;
+    };
+
+};
@@ -10,18 +10,28 @@ namespace Engine {
     
     VulkanImage::~VulkanImage() {
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        
-        vkDeviceWaitIdle(backend->GetVulkanDevice()->logical_device);
+
+        // Frames in flight and uploads not yet submitted may still use it, handles go once they are done.
+        VulkanDeletionQueue* deletion_queue = backend->GetDeletionQueue();
+        if (deletion_queue) {
+            if (this->view) {
+                deletion_queue->DestroyImageView(this->view);
+                this->view = nullptr;
+            }
+            if (this->handle && this->own_image) {
+                deletion_queue->DestroyImage(this->handle, this->allocation);
+                this->allocation = {};
+            }
+            this->handle = nullptr;
+            return;
+        }
 
         if (this->view) {
             vkDestroyImageView(backend->GetVulkanDevice()->logical_device, this->view, backend->GetVulkanAllocator());
             this->view = nullptr;
         }
-        if (this->memory) {
-            if (this->own_image) {
-                vkFreeMemory(backend->GetVulkanDevice()->logical_device, this->memory, backend->GetVulkanAllocator());
-            }
-            this->memory = nullptr;
+        if (this->own_image) {
+            backend->GetMemoryAllocator()->Free(&this->allocation);
         }
         if (this->handle) {
             if (this->own_image) {
@@ -40,14 +50,18 @@ namespace Engine {
         VkImageUsageFlags usage,
         VkMemoryPropertyFlags memory_flags,
         b32 create_view,
-        VkImageAspectFlags view_aspect_flags) {
+        VkImageAspectFlags view_aspect_flags,
+        u32 mip_levels,
+        b8 allocate_memory) {
         
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
 
         this->own_image = true;
         this->height = height;
         this->width = width;
+        this->mip_levels = mip_levels;
         this->format = format;
+        this->view = nullptr;
 
         // Creation info.
         VkImageCreateInfo image_create_info = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
@@ -55,7 +69,7 @@ namespace Engine {
         image_create_info.extent.width = width;
         image_create_info.extent.height = height;
         image_create_info.extent.depth = 1;  // TODO: Support configurable depth.
-        image_create_info.mipLevels = 4;     // TODO: Support mip mapping
+        image_create_info.mipLevels = mip_levels;
         image_create_info.arrayLayers = 1;   // TODO: Support number of layers in the image.
         image_create_info.format = format;
         image_create_info.tiling = tiling;
@@ -69,27 +83,17 @@ namespace Engine {
             &image_create_info, backend->GetVulkanAllocator(), 
             &this->handle));
 
-         // Query memory requirements.
-        VkMemoryRequirements memory_requirements;
-        vkGetImageMemoryRequirements(backend->GetVulkanDevice()->logical_device, this->handle, &memory_requirements);
-
-        i32 memory_type = backend->FindMemoryIndex(memory_requirements.memoryTypeBits, memory_flags);
-        if (memory_type == -1) {
-            ERROR("Required memory type not found. Image not valid.");
+        if (!allocate_memory) {
+            return;
         }
 
-        // Allocate memory
-        VkMemoryAllocateInfo memory_allocate_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-        memory_allocate_info.allocationSize = memory_requirements.size;
-        memory_allocate_info.memoryTypeIndex = memory_type;
-        VK_CHECK(vkAllocateMemory(backend->GetVulkanDevice()->logical_device, &memory_allocate_info, backend->GetVulkanAllocator(), &this->memory));
-
-        // Bind the memory
-        VK_CHECK(vkBindImageMemory(backend->GetVulkanDevice()->logical_device, this->handle, this->memory, 0));  // TODO: configurable memory offset.
+        // Allocate and bind memory, large images and those the driver asks for get their own
+        if (!backend->GetMemoryAllocator()->AllocateImage(this->handle, tiling, memory_flags, &this->allocation)) {
+            ERROR("Failed to allocate image memory. Image not valid.");
+        }
 
         // Create view
         if (create_view) {
-            this->view = nullptr;
             VulkanImageViewCreate(format, view_aspect_flags);
         }
 
@@ -101,6 +105,8 @@ namespace Engine {
         this->own_image = false;
         this->height = height;
         this->width = width;
+        this->mip_levels = 1;
+        this->format = format;
         this->handle = image;
 
         // Create view
@@ -123,7 +129,7 @@ namespace Engine {
 
         // TODO: Make configurable
         view_create_info.subresourceRange.baseMipLevel = 0;
-        view_create_info.subresourceRange.levelCount = 1;
+        view_create_info.subresourceRange.levelCount = this->mip_levels;
         view_create_info.subresourceRange.baseArrayLayer = 0;
         view_create_info.subresourceRange.layerCount = 1;
 
@@ -150,7 +156,7 @@ namespace Engine {
         barrier.image = this->handle;
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.levelCount = this->mip_levels;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = 1;
 
@@ -185,22 +191,24 @@ namespace Engine {
 
     void VulkanImage::CopyFromBuffer(
             VkBuffer buffer,
-            VulkanCommandBuffer* command_buffer) {
+            VulkanCommandBuffer* command_buffer,
+            u32 mip_level,
+            u64 buffer_offset) {
         
         VkBufferImageCopy region;
         Platform::ZrMemory(&region, sizeof(region));
 
-        region.bufferOffset = 0;
+        region.bufferOffset = buffer_offset;
         region.bufferRowLength = 0;
         region.bufferImageHeight = 0;
 
         region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.mipLevel = mip_level;
         region.imageSubresource.baseArrayLayer = 0;
         region.imageSubresource.layerCount = 1;
         
-        region.imageExtent.width = this->width;
-        region.imageExtent.height = this->height;
+        region.imageExtent.width = this->width >> mip_level ? this->width >> mip_level : 1;
+        region.imageExtent.height = this->height >> mip_level ? this->height >> mip_level : 1;
         region.imageExtent.depth = 1;
         
         vkCmdCopyBufferToImage(
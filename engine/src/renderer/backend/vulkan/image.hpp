@@ -3,6 +3,7 @@
 #include <vulkan/vulkan.h>
 #include "command_buffer.hpp"
 #include "defines.hpp"
+#include "memory_allocator.hpp"
 
 
 namespace Engine {
@@ -13,10 +14,12 @@ namespace Engine {
             
         public:
             VkImage handle;
-            VkDeviceMemory memory;
+            // Empty for swapchain images, the swapchain owns their memory.
+            VulkanAllocation allocation;
             VkImageView view;
             u32 width;
             u32 height;
+            u32 mip_levels;
             VkFormat format;
 
         VulkanImage(
@@ -28,7 +31,10 @@ namespace Engine {
             VkImageUsageFlags usage,
             VkMemoryPropertyFlags memory_flags,
             b32 create_view,
-            VkImageAspectFlags view_aspect_flags
+            VkImageAspectFlags view_aspect_flags,
+            u32 mip_levels = 1,
+            // Without memory the caller binds it, and creates the view afterwards.
+            b8 allocate_memory = true
         );
 
         VulkanImage(
@@ -56,7 +62,9 @@ namespace Engine {
 
         void CopyFromBuffer(
             VkBuffer buffer,
-            VulkanCommandBuffer* command_buffer
+            VulkanCommandBuffer* command_buffer,
+            u32 mip_level = 0,
+            u64 buffer_offset = 0
         );
 
     };
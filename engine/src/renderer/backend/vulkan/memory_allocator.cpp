@@ -0,0 +1,314 @@
+#include "memory_allocator.hpp"
+
+#include "vulkan.hpp"
+#include "helpers.hpp"
+#include "core/logger/logger.hpp"
+
+namespace Engine {
+
+    static u64 AlignUp(u64 value, u64 alignment) {
+        return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+    };
+
+    VulkanMemoryAllocator::VulkanMemoryAllocator(VulkanDevice* device) {
+        this->device = device;
+    };
+
+    VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+        if (stats.allocations || stats.dedicated) {
+            DEBUG("|_%u memory allocations and %u dedicated allocations still alive on shutdown.", stats.allocations, stats.dedicated);
+        }
+        for (u32 type = 0; type < VK_MAX_MEMORY_TYPES; ++type) {
+            for (std::vector<VulkanMemoryBlock*>& kind_blocks : blocks[type]) {
+                for (VulkanMemoryBlock* block : kind_blocks) {
+                    DestroyBlock(block);
+                }
+                kind_blocks.clear();
+            }
+        }
+    };
+
+    b8 VulkanMemoryAllocator::IsCoherent(u32 memory_type) {
+        return device->memory.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    };
+
+    u64 VulkanMemoryAllocator::GetBlockSize(u32 memory_type) {
+        u64 heap_size = device->memory.memoryHeaps[device->memory.memoryTypes[memory_type].heapIndex].size;
+        if (heap_size <= (u64)VULKAN_MEMORY_SMALL_HEAP_SIZE) {
+            return heap_size / 8;
+        }
+        return VULKAN_MEMORY_BLOCK_SIZE;
+    };
+
+    b8 VulkanMemoryAllocator::AllocateBuffer(VkBuffer buffer, VkMemoryPropertyFlags property_flags, VulkanAllocation* out_allocation) {
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device->logical_device, buffer, &requirements);
+
+        if (!Allocate(requirements, property_flags, VulkanAllocationKind::LINEAR, false, nullptr, out_allocation)) {
+            return false;
+        }
+        VkResult result = vkBindBufferMemory(device->logical_device, buffer, out_allocation->memory, out_allocation->offset);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanMemoryAllocator::AllocateBuffer - failed binding memory: '%s'", VulkanResultString(result, true));
+            Free(out_allocation);
+            return false;
+        }
+        return true;
+    };
+
+    b8 VulkanMemoryAllocator::AllocateImage(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags property_flags, VulkanAllocation* out_allocation) {
+        // Ask whether the driver wants the image alone, render targets often do.
+        VkImageMemoryRequirementsInfo2 requirements_info = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2};
+        requirements_info.image = image;
+        VkMemoryDedicatedRequirements dedicated_requirements = {VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS};
+        VkMemoryRequirements2 requirements = {VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+        requirements.pNext = &dedicated_requirements;
+        vkGetImageMemoryRequirements2(device->logical_device, &requirements_info, &requirements);
+
+        VkMemoryDedicatedAllocateInfo dedicated_info = {VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO};
+        dedicated_info.image = image;
+        b8 dedicated = dedicated_requirements.prefersDedicatedAllocation || dedicated_requirements.requiresDedicatedAllocation;
+        VulkanAllocationKind kind = tiling == VK_IMAGE_TILING_OPTIMAL ? VulkanAllocationKind::OPTIMAL : VulkanAllocationKind::LINEAR;
+
+        if (!Allocate(requirements.memoryRequirements, property_flags, kind, dedicated, &dedicated_info, out_allocation)) {
+            return false;
+        }
+        VkResult result = vkBindImageMemory(device->logical_device, image, out_allocation->memory, out_allocation->offset);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanMemoryAllocator::AllocateImage - failed binding memory: '%s'", VulkanResultString(result, true));
+            Free(out_allocation);
+            return false;
+        }
+        return true;
+    };
+
+    b8 VulkanMemoryAllocator::AllocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags property_flags, VulkanAllocationKind kind, VulkanAllocation* out_allocation) {
+        return Allocate(requirements, property_flags, kind, false, nullptr, out_allocation);
+    };
+
+    b8 VulkanMemoryAllocator::Allocate(
+        const VkMemoryRequirements& requirements,
+        VkMemoryPropertyFlags property_flags,
+        VulkanAllocationKind kind,
+        b8 dedicated,
+        VkMemoryDedicatedAllocateInfo* dedicated_info,
+        VulkanAllocation* out_allocation) {
+
+        i32 memory_type = VulkanRendererBackend::GetInstance()->FindMemoryIndex(requirements.memoryTypeBits, property_flags);
+        if (memory_type == -1) {
+            ERROR("VulkanMemoryAllocator::Allocate - no memory type with the required properties.");
+            return false;
+        }
+
+        // Non coherent memory is flushed in whole atoms, allocations must not share one.
+        u64 alignment = requirements.alignment;
+        u64 size = requirements.size;
+        if (!IsCoherent(memory_type) && (device->memory.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+            u64 atom = device->properties.limits.nonCoherentAtomSize;
+            alignment = std::max(alignment, atom);
+            size = AlignUp(size, atom);
+        }
+
+        *out_allocation = {};
+        out_allocation->memory_type = memory_type;
+        out_allocation->kind = kind;
+        out_allocation->size = size;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        u64 block_size = GetBlockSize(memory_type);
+        if (dedicated || size > block_size / VULKAN_MEMORY_DEDICATED_FRACTION) {
+            if (!AllocateDeviceMemory(memory_type, size, dedicated_info, &out_allocation->memory, &out_allocation->mapped)) {
+                return false;
+            }
+            stats.device_allocations++;
+            stats.dedicated++;
+            stats.dedicated_bytes += size;
+            return true;
+        }
+
+        std::vector<VulkanMemoryBlock*>& kind_blocks = blocks[memory_type][(u32)kind];
+        VulkanMemoryBlock* block = nullptr;
+        u64 offset = 0;
+        for (VulkanMemoryBlock* candidate : kind_blocks) {
+            if (candidate->size - candidate->used >= size && AllocateFromBlock(candidate, size, alignment, &offset)) {
+                block = candidate;
+                break;
+            }
+        }
+        if (!block) {
+            block = CreateBlock(memory_type, block_size);
+            if (!block) {
+                return false;
+            }
+            kind_blocks.push_back(block);
+            AllocateFromBlock(block, size, alignment, &offset);
+        }
+
+        block->used += size;
+        block->allocation_count++;
+        stats.allocations++;
+        stats.used_bytes += size;
+
+        out_allocation->memory = block->memory;
+        out_allocation->offset = offset;
+        out_allocation->mapped = block->mapped ? block->mapped + offset : nullptr;
+        out_allocation->block = block;
+        return true;
+    };
+
+    void VulkanMemoryAllocator::Free(VulkanAllocation* allocation) {
+        if (!allocation->memory) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        VulkanMemoryBlock* block = allocation->block;
+        if (!block) {
+            // Unmapped implicitly by vkFreeMemory.
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            vkFreeMemory(device->logical_device, allocation->memory, backend->GetVulkanAllocator());
+            stats.device_allocations--;
+            stats.dedicated--;
+            stats.dedicated_bytes -= allocation->size;
+            *allocation = {};
+            return;
+        }
+
+        FreeToBlock(block, allocation->offset, allocation->size);
+        block->used -= allocation->size;
+        block->allocation_count--;
+        stats.allocations--;
+        stats.used_bytes -= allocation->size;
+
+        // Empty blocks go back to the device, except the last one of its list to avoid churn.
+        std::vector<VulkanMemoryBlock*>& kind_blocks = blocks[allocation->memory_type][(u32)allocation->kind];
+        if (!block->allocation_count && kind_blocks.size() > 1) {
+            kind_blocks.erase(std::find(kind_blocks.begin(), kind_blocks.end(), block));
+            DestroyBlock(block);
+        }
+        *allocation = {};
+    };
+
+    void VulkanMemoryAllocator::Flush(const VulkanAllocation& allocation, u64 offset, u64 size) {
+        if (!allocation.mapped || IsCoherent(allocation.memory_type)) {
+            return;
+        }
+        // The allocation is atom aligned on both ends, so rounding out stays inside it.
+        u64 atom = device->properties.limits.nonCoherentAtomSize;
+        u64 begin = offset / atom * atom;
+        u64 end = size == VK_WHOLE_SIZE ? allocation.size : std::min(AlignUp(offset + size, atom), allocation.size);
+
+        VkMappedMemoryRange range = {VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
+        range.memory = allocation.memory;
+        range.offset = allocation.offset + begin;
+        range.size = end - begin;
+        vkFlushMappedMemoryRanges(device->logical_device, 1, &range);
+    };
+
+    VulkanMemoryStats VulkanMemoryAllocator::GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    };
+
+    b8 VulkanMemoryAllocator::AllocateFromBlock(VulkanMemoryBlock* block, u64 size, u64 alignment, u64* out_offset) {
+        // First fit, the alignment padding in front stays free.
+        for (u32 i = 0; i < block->free_ranges.size(); ++i) {
+            VulkanMemoryRange range = block->free_ranges[i];
+            u64 offset = AlignUp(range.offset, alignment);
+            u64 end = range.offset + range.size;
+            if (offset + size > end) {
+                continue;
+            }
+
+            block->free_ranges.erase(block->free_ranges.begin() + i);
+            if (offset + size < end) {
+                block->free_ranges.insert(block->free_ranges.begin() + i, {offset + size, end - offset - size});
+            }
+            if (offset > range.offset) {
+                block->free_ranges.insert(block->free_ranges.begin() + i, {range.offset, offset - range.offset});
+            }
+            *out_offset = offset;
+            return true;
+        }
+        return false;
+    };
+
+    void VulkanMemoryAllocator::FreeToBlock(VulkanMemoryBlock* block, u64 offset, u64 size) {
+        std::vector<VulkanMemoryRange>& ranges = block->free_ranges;
+        auto next = std::lower_bound(ranges.begin(), ranges.end(), offset, [](const VulkanMemoryRange& range, u64 offset) {
+            return range.offset < offset;
+        });
+        u32 index = next - ranges.begin();
+        ranges.insert(next, {offset, size});
+
+        // Merge with the following range, then the preceding one.
+        if (index + 1 < ranges.size() && ranges[index].offset + ranges[index].size == ranges[index + 1].offset) {
+            ranges[index].size += ranges[index + 1].size;
+            ranges.erase(ranges.begin() + index + 1);
+        }
+        if (index > 0 && ranges[index - 1].offset + ranges[index - 1].size == ranges[index].offset) {
+            ranges[index - 1].size += ranges[index].size;
+            ranges.erase(ranges.begin() + index);
+        }
+    };
+
+    VulkanMemoryBlock* VulkanMemoryAllocator::CreateBlock(u32 memory_type, u64 size) {
+        VulkanMemoryBlock* block = new VulkanMemoryBlock();
+        if (!AllocateDeviceMemory(memory_type, size, nullptr, &block->memory, &block->mapped)) {
+            delete block;
+            return nullptr;
+        }
+        block->size = size;
+        block->used = 0;
+        block->allocation_count = 0;
+        block->free_ranges.push_back({0, size});
+
+        stats.device_allocations++;
+        stats.blocks++;
+        stats.block_bytes += size;
+        return block;
+    };
+
+    void VulkanMemoryAllocator::DestroyBlock(VulkanMemoryBlock* block) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        vkFreeMemory(device->logical_device, block->memory, backend->GetVulkanAllocator());
+
+        stats.device_allocations--;
+        stats.blocks--;
+        stats.block_bytes -= block->size;
+        delete block;
+    };
+
+    b8 VulkanMemoryAllocator::AllocateDeviceMemory(u32 memory_type, u64 size, VkMemoryDedicatedAllocateInfo* dedicated_info, VkDeviceMemory* out_memory, u8** out_mapped) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        VkMemoryAllocateInfo allocate_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+        allocate_info.pNext = dedicated_info;
+        allocate_info.allocationSize = size;
+        allocate_info.memoryTypeIndex = memory_type;
+
+        VkResult result = vkAllocateMemory(device->logical_device, &allocate_info, backend->GetVulkanAllocator(), out_memory);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanMemoryAllocator - failed allocating %llu bytes of device memory: '%s'", size, VulkanResultString(result, true));
+            *out_memory = VK_NULL_HANDLE;
+            return false;
+        }
+
+        *out_mapped = nullptr;
+        if (device->memory.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            void* mapped = nullptr;
+            result = vkMapMemory(device->logical_device, *out_memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+            if (!IsVulkanResultSuccess(result)) {
+                ERROR("VulkanMemoryAllocator - failed mapping device memory: '%s'", VulkanResultString(result, true));
+                vkFreeMemory(device->logical_device, *out_memory, backend->GetVulkanAllocator());
+                *out_memory = VK_NULL_HANDLE;
+                return false;
+            }
+            *out_mapped = (u8*)mapped;
+        }
+        return true;
+    };
+
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+
+#include <mutex>
+
+// Size of the device memory blocks sub-allocations are carved from.
+#define VULKAN_MEMORY_BLOCK_SIZE (64 MB)
+// Heaps up to this size get blocks of an eighth of the heap instead.
+#define VULKAN_MEMORY_SMALL_HEAP_SIZE (1024 MB)
+// Allocations bigger than this fraction of a block get their own device memory.
+#define VULKAN_MEMORY_DEDICATED_FRACTION 2
+
+namespace Engine {
+
+    class VulkanDevice;
+
+    // Buffers and linear images never share a block with optimal images, so neighbours
+    // can't violate bufferImageGranularity whatever their alignment.
+    enum class VulkanAllocationKind {
+        LINEAR = 0,
+        OPTIMAL = 1
+    };
+
+    struct VulkanMemoryRange {
+        u64 offset;
+        u64 size;
+    };
+
+    struct VulkanMemoryBlock {
+        VkDeviceMemory memory;
+        u64 size;
+        u64 used;
+        u32 allocation_count;
+        // Persistently mapped for host visible types.
+        u8* mapped;
+        // Sorted by offset, touching ranges are merged on free.
+        std::vector<VulkanMemoryRange> free_ranges;
+    };
+
+    struct VulkanAllocation {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        u64 offset = 0;
+        u64 size = 0;
+        // Start of the allocation when host visible, null otherwise.
+        u8* mapped = nullptr;
+        u32 memory_type = 0;
+        VulkanAllocationKind kind = VulkanAllocationKind::LINEAR;
+        // Null for dedicated allocations.
+        VulkanMemoryBlock* block = nullptr;
+    };
+
+    struct VulkanMemoryStats {
+        // vkAllocateMemory calls alive, blocks and dedicated together.
+        u32 device_allocations = 0;
+        u32 blocks = 0;
+        u32 dedicated = 0;
+        // Sub-allocations handed out from blocks.
+        u32 allocations = 0;
+        u64 block_bytes = 0;
+        u64 used_bytes = 0;
+        u64 dedicated_bytes = 0;
+    };
+
+    // Carves buffers and images out of large device memory blocks, one list of blocks per memory
+    // type and allocation kind. Large resources, and images the driver wants alone, get dedicated
+    // memory. Host visible memory is mapped once for its lifetime, callers write through mapped.
+    class VulkanMemoryAllocator {
+        public:
+            VulkanMemoryAllocator(VulkanDevice* device);
+            ~VulkanMemoryAllocator();
+
+            // Allocates and binds memory for the resource, false if no memory type fits or the device is out of memory.
+            b8 AllocateBuffer(VkBuffer buffer, VkMemoryPropertyFlags property_flags, VulkanAllocation* out_allocation);
+            b8 AllocateImage(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags property_flags, VulkanAllocation* out_allocation);
+            // Memory the caller binds resources to itself, such as images placed over each other.
+            b8 AllocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags property_flags, VulkanAllocationKind kind, VulkanAllocation* out_allocation);
+            void Free(VulkanAllocation* allocation);
+
+            // Makes host writes visible to the device, a no-op for coherent memory.
+            void Flush(const VulkanAllocation& allocation, u64 offset, u64 size);
+
+            VulkanMemoryStats GetStats();
+
+        private:
+            b8 Allocate(
+                const VkMemoryRequirements& requirements,
+                VkMemoryPropertyFlags property_flags,
+                VulkanAllocationKind kind,
+                b8 dedicated,
+                VkMemoryDedicatedAllocateInfo* dedicated_info,
+                VulkanAllocation* out_allocation
+            );
+            b8 AllocateFromBlock(VulkanMemoryBlock* block, u64 size, u64 alignment, u64* out_offset);
+            void FreeToBlock(VulkanMemoryBlock* block, u64 offset, u64 size);
+            VulkanMemoryBlock* CreateBlock(u32 memory_type, u64 size);
+            void DestroyBlock(VulkanMemoryBlock* block);
+            b8 AllocateDeviceMemory(u32 memory_type, u64 size, VkMemoryDedicatedAllocateInfo* dedicated_info, VkDeviceMemory* out_memory, u8** out_mapped);
+            u64 GetBlockSize(u32 memory_type);
+            b8 IsCoherent(u32 memory_type);
+
+            VulkanDevice* device;
+            std::mutex mutex;
+            std::vector<VulkanMemoryBlock*> blocks[VK_MAX_MEMORY_TYPES][2];
+            VulkanMemoryStats stats;
+    };
+
+};
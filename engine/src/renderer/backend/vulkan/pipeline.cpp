@@ -18,6 +18,7 @@ namespace Engine {
         u32 push_constant_range_count,
         MemoryRange* push_constant_ranges,
         u32 stride,
+        u32 instance_stride,
         VkViewport viewport, 
         VkRect2D scissor,
         b8 is_wireframe,
@@ -26,6 +27,8 @@ namespace Engine {
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
 
         this->renderpass = renderpass;
+        this->handle = nullptr;
+        this->pipeline_layout = nullptr;
 
         ready = false;
 
@@ -98,17 +101,24 @@ namespace Engine {
         dynamic_state_create_info.dynamicStateCount = dynamic_state_count;
         dynamic_state_create_info.pDynamicStates = dynamic_states;
 
-        // Vertex input 
-        VkVertexInputBindingDescription binding_description;
-        Platform::ZrMemory(&binding_description, sizeof(VkVertexInputBindingDescription));
-        binding_description.binding = 0;
-        binding_description.stride = stride;
-        binding_description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        // Vertex input, binding 1 carries per instance data when the pipeline is an instanced variant
+        // and binding 2 the material record index of each instance
+        VkVertexInputBindingDescription binding_descriptions[3];
+        Platform::ZrMemory(binding_descriptions, sizeof(VkVertexInputBindingDescription) * 3);
+        binding_descriptions[0].binding = 0;
+        binding_descriptions[0].stride = stride;
+        binding_descriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        binding_descriptions[1].binding = 1;
+        binding_descriptions[1].stride = instance_stride;
+        binding_descriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+        binding_descriptions[2].binding = 2;
+        binding_descriptions[2].stride = sizeof(u32);
+        binding_descriptions[2].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 
         // Attibutes
         VkPipelineVertexInputStateCreateInfo vertex_input_create_info = {VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
-        vertex_input_create_info.vertexBindingDescriptionCount = 1;
-        vertex_input_create_info.pVertexBindingDescriptions = &binding_description;
+        vertex_input_create_info.vertexBindingDescriptionCount = instance_stride ? 3 : 1;
+        vertex_input_create_info.pVertexBindingDescriptions = binding_descriptions;
         vertex_input_create_info.vertexAttributeDescriptionCount = attribute_count;
         vertex_input_create_info.pVertexAttributeDescriptions = attributes;
 
@@ -117,41 +127,67 @@ namespace Engine {
         input_assembly_create_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
         input_assembly_create_info.primitiveRestartEnable = VK_FALSE;
 
-        // Pipeline layout
-        VkPipelineLayoutCreateInfo pipeline_layout_create_info = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-
-
         // Push constants
+        VkPushConstantRange push_constants = {};
+        u32 push_constants_count = 0;
         if (push_constant_range_count > 0) {
             if (push_constant_range_count > 32) {
                 ERROR("VulkanPipeline::VulkanPipeline - cannot have more than 32 push constant ranges. Passed count: %i", push_constant_range_count);
                 return;
             }
 
-            // NOTE: 32 is the max number of ranges we can ever have, since spec only guarantees 128 bytes with 4-byte alignment.
-            VkPushConstantRange push_constants[32];
-            Platform::ZrMemory(push_constants, sizeof(VkPushConstantRange) * 32);
-            for (u32 i = 0; i < push_constant_range_count; ++i) {
-                push_constants[i].offset = push_constant_ranges[i].offset;
-                push_constants[i].size = push_constant_ranges[i].size;
-                push_constants[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-                
+            // Ranges may not share a stage, so every local uniform goes into one range covering all of them.
+            u64 range_begin = push_constant_ranges[0].offset;
+            u64 range_end = push_constant_ranges[0].offset + push_constant_ranges[0].size;
+            for (u32 i = 1; i < push_constant_range_count; ++i) {
+                range_begin = std::min(range_begin, push_constant_ranges[i].offset);
+                range_end = std::max(range_end, push_constant_ranges[i].offset + push_constant_ranges[i].size);
             }
-            pipeline_layout_create_info.pushConstantRangeCount = push_constant_range_count;
-            pipeline_layout_create_info.pPushConstantRanges = push_constants;
-        } else {
-            pipeline_layout_create_info.pushConstantRangeCount = 0;
-            pipeline_layout_create_info.pPushConstantRanges = nullptr;
+
+            push_constants.offset = range_begin;
+            push_constants.size = range_end - range_begin;
+            push_constants.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+            push_constants_count = 1;
         }
 
-        pipeline_layout_create_info.setLayoutCount = descriptor_set_layout_count;
-        pipeline_layout_create_info.pSetLayouts = descriptors_set_layouts;
+        // Pipeline layout, shared with every pipeline over the same sets and push constants
+        VulkanPipelineStateCache* state_cache = backend->GetPipelineStateCache();
+        this->pipeline_layout = state_cache->AcquirePipelineLayout(
+            descriptor_set_layout_count,
+            descriptors_set_layouts,
+            push_constants_count,
+            &push_constants);
+        if (!this->pipeline_layout) {
+            return;
+        }
 
-        VK_CHECK(vkCreatePipelineLayout(
-            backend->GetVulkanDevice()->logical_device,
-            &pipeline_layout_create_info,
-            backend->GetVulkanAllocator(),
-            &this->pipeline_layout));
+        // Everything the pipeline is built from besides the constant state above, viewport and scissor are dynamic.
+        VulkanStateKey key;
+        key.Add(this->pipeline_layout);
+        key.Add(renderpass->handle);
+        key.Add(stage_count);
+        for (u32 i = 0; i < stage_count; ++i) {
+            key.Add(stages[i].stage);
+            key.Add(stages[i].module);
+            key.Add(stages[i].pName);
+        }
+        key.Add(attribute_count);
+        for (u32 i = 0; i < attribute_count; ++i) {
+            key.Add(attributes[i].location);
+            key.Add(attributes[i].binding);
+            key.Add(attributes[i].format);
+            key.Add(attributes[i].offset);
+        }
+        key.Add(stride);
+        key.Add(instance_stride);
+        key.Add(is_wireframe);
+        key.Add(depth_test_enabled);
+
+        this->handle = state_cache->FindPipeline(key);
+        if (this->handle) {
+            ready = true;
+            return;
+        }
 
         // Pipeline
         VkGraphicsPipelineCreateInfo pipeline_create_info = {VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
@@ -177,7 +213,7 @@ namespace Engine {
 
         VkResult result = vkCreateGraphicsPipelines(
             backend->GetVulkanDevice()->logical_device,
-            VK_NULL_HANDLE,
+            backend->GetPipelineCache(),
             1,
             &pipeline_create_info,
             backend->GetVulkanAllocator(),
@@ -185,29 +221,24 @@ namespace Engine {
 
         if (IsVulkanResultSuccess(result)) {
             DEBUG("Graphics pipeline for renderpass '%s' created successfully.", renderpass->GetName().c_str());
+            state_cache->InsertPipeline(key, this->handle);
             ready = true;
             return;
         }
+        this->handle = nullptr;
 
         ERROR("vkCreateGraphicsPipelines failed with %s.", VulkanResultString(result, true));
     };
 
     VulkanPipeline::~VulkanPipeline() {
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        
-        if (this->handle) {
-            vkDestroyPipeline(
-                backend->GetVulkanDevice()->logical_device, 
-                this->handle, backend->GetVulkanAllocator());
-            this->handle = nullptr;
-        }
 
-        if (this->pipeline_layout) {
-            vkDestroyPipelineLayout(
-                backend->GetVulkanDevice()->logical_device, 
-                this->pipeline_layout, backend->GetVulkanAllocator());
-            this->pipeline_layout = 0;
-        }
+        // Shared with equivalent pipelines, the last release destroys once frames in flight are done.
+        VulkanPipelineStateCache* state_cache = backend->GetPipelineStateCache();
+        state_cache->ReleasePipeline(this->handle);
+        state_cache->ReleasePipelineLayout(this->pipeline_layout);
+        this->handle = nullptr;
+        this->pipeline_layout = 0;
     };
 
     void VulkanPipeline::Bind(VulkanCommandBuffer* command_buffer, VkPipelineBindPoint bind_point) {
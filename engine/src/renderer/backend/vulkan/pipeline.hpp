@@ -23,6 +23,7 @@ namespace Engine {
                 u32 push_constant_range_count,
                 MemoryRange* push_constant_ranges,
                 u32 stride,
+                u32 instance_stride,
                 VkViewport viewport, 
                 VkRect2D scissor,
                 b8 is_wireframe,
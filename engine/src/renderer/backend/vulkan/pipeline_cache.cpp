@@ -0,0 +1,149 @@
+#include "pipeline_cache.hpp"
+
+#include "vulkan.hpp"
+#include "helpers.hpp"
+#include "core/logger/logger.hpp"
+#include "core/utils/hash.hpp"
+#include "platform/filesystem.hpp"
+#include "platform/platform.hpp"
+
+namespace Engine {
+
+    VulkanPipelineCache::VulkanPipelineCache(std::string path) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        this->path = path;
+        this->handle = VK_NULL_HANDLE;
+
+        std::vector<c8> initial_data;
+        if (ReadInitialData(initial_data)) {
+            DEBUG("Pipeline cache '%s' loaded, %llu bytes.", path.c_str(), initial_data.size());
+        }
+
+        VkPipelineCacheCreateInfo create_info = {VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+        create_info.initialDataSize = initial_data.size();
+        create_info.pInitialData = initial_data.size() ? initial_data.data() : nullptr;
+
+        VkResult result = vkCreatePipelineCache(
+            backend->GetVulkanDevice()->logical_device,
+            &create_info,
+            backend->GetVulkanAllocator(),
+            &this->handle);
+
+        if (!IsVulkanResultSuccess(result) && initial_data.size()) {
+            WARN("Pipeline cache '%s' was rejected by the driver, starting empty.", path.c_str());
+            create_info.initialDataSize = 0;
+            create_info.pInitialData = nullptr;
+            result = vkCreatePipelineCache(
+                backend->GetVulkanDevice()->logical_device,
+                &create_info,
+                backend->GetVulkanAllocator(),
+                &this->handle);
+        }
+
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("vkCreatePipelineCache failed with %s.", VulkanResultString(result, true));
+            this->handle = VK_NULL_HANDLE;
+        }
+    };
+
+    VulkanPipelineCache::~VulkanPipelineCache() {
+        if (this->handle) {
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            vkDestroyPipelineCache(
+                backend->GetVulkanDevice()->logical_device,
+                this->handle,
+                backend->GetVulkanAllocator());
+            this->handle = VK_NULL_HANDLE;
+        }
+    };
+
+    b8 VulkanPipelineCache::ReadInitialData(std::vector<c8>& out_data) {
+        if (!FileSystem::FileExists(path)) {
+            return false;
+        }
+
+        File* file = FileSystem::FileOpen(path, FileMode::READ, true);
+        std::vector<c8> bytes = file->ReadAllBytes();
+        FileSystem::FileClose(file);
+
+        if (bytes.size() < sizeof(VulkanPipelineCacheHeader)) {
+            return false;
+        }
+
+        VulkanPipelineCacheHeader header;
+        Platform::CpMemory(&header, bytes.data(), sizeof(VulkanPipelineCacheHeader));
+
+        VkPhysicalDeviceProperties& properties = VulkanRendererBackend::GetInstance()->GetVulkanDevice()->properties;
+        if (header.magic != VULKAN_PIPELINE_CACHE_MAGIC || header.version != VULKAN_PIPELINE_CACHE_VERSION) {
+            return false;
+        }
+
+        if (header.vendor_id != properties.vendorID ||
+            header.device_id != properties.deviceID ||
+            header.driver_version != properties.driverVersion ||
+            std::memcmp(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            DEBUG("Pipeline cache '%s' was built for another device or driver, ignoring.", path.c_str());
+            return false;
+        }
+
+        const c8* data = bytes.data() + sizeof(VulkanPipelineCacheHeader);
+        if (header.data_size != bytes.size() - sizeof(VulkanPipelineCacheHeader) || HashFNV1a(data, header.data_size) != header.data_hash) {
+            WARN("Pipeline cache '%s' is corrupted, ignoring.", path.c_str());
+            return false;
+        }
+
+        out_data.assign(data, data + header.data_size);
+        return true;
+    };
+
+    b8 VulkanPipelineCache::Save() {
+        if (!this->handle) {
+            return false;
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VkDevice logical_device = backend->GetVulkanDevice()->logical_device;
+
+        size_t size = 0;
+        VK_CHECK(vkGetPipelineCacheData(logical_device, this->handle, &size, nullptr));
+        if (!size) {
+            return false;
+        }
+
+        std::vector<c8> data(size);
+        VkResult result = vkGetPipelineCacheData(logical_device, this->handle, &size, data.data());
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("vkGetPipelineCacheData failed with %s.", VulkanResultString(result, true));
+            return false;
+        }
+
+        VkPhysicalDeviceProperties& properties = backend->GetVulkanDevice()->properties;
+
+        VulkanPipelineCacheHeader header;
+        Platform::ZrMemory(&header, sizeof(VulkanPipelineCacheHeader));
+        header.magic = VULKAN_PIPELINE_CACHE_MAGIC;
+        header.version = VULKAN_PIPELINE_CACHE_VERSION;
+        header.vendor_id = properties.vendorID;
+        header.device_id = properties.deviceID;
+        header.driver_version = properties.driverVersion;
+        Platform::CpMemory(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+        header.data_size = size;
+        header.data_hash = HashFNV1a(data.data(), size);
+
+        File* file = FileSystem::FileOpen(path, FileMode::WRITE, true);
+        if (!file->IsReady()) {
+            ERROR("VulkanPipelineCache::Save - unable to write '%s'.", path.c_str());
+            FileSystem::FileClose(file);
+            return false;
+        }
+
+        file->Write(sizeof(VulkanPipelineCacheHeader), &header);
+        file->Write(size, data.data());
+        FileSystem::FileClose(file);
+
+        DEBUG("Pipeline cache saved to '%s', %llu bytes.", path.c_str(), (u64)size);
+        return true;
+    };
+
+};
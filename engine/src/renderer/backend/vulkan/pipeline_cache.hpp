@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+
+#define VULKAN_PIPELINE_CACHE_MAGIC 0x43505645U
+#define VULKAN_PIPELINE_CACHE_VERSION 1
+#define VULKAN_PIPELINE_CACHE_PATH "vulkan_pipeline.cache"
+
+namespace Engine {
+
+    // Written in front of the driver blob, the blob is only reused on the exact same device and driver.
+    struct VulkanPipelineCacheHeader {
+        u32 magic;
+        u32 version;
+        u32 vendor_id;
+        u32 device_id;
+        u32 driver_version;
+        u8 uuid[VK_UUID_SIZE];
+        u64 data_size;
+        u64 data_hash;
+    };
+
+    // One VkPipelineCache shared by every pipeline, loaded at backend init and saved on shutdown.
+    class VulkanPipelineCache {
+        public:
+            VkPipelineCache handle;
+
+            VulkanPipelineCache(std::string path);
+            ~VulkanPipelineCache();
+
+            b8 Save();
+
+        private:
+            b8 ReadInitialData(std::vector<c8>& out_data);
+
+            std::string path;
+    };
+
+};
@@ -0,0 +1,229 @@
+#include "pipeline_state_cache.hpp"
+
+#include "vulkan.hpp"
+#include "helpers.hpp"
+#include "core/logger/logger.hpp"
+#include "core/utils/hash.hpp"
+
+namespace Engine {
+
+    // Shared handle for the key, VK_NULL_HANDLE on a miss. A hash hit with a different key is a collision,
+    // the object created then is not shared.
+    template <typename T>
+    static T AcquireShared(std::unordered_map<u64, VulkanStateReference<T>>& references, u64 hash, const VulkanStateKey& key, b8* out_collision) {
+        *out_collision = false;
+        auto it = references.find(hash);
+        if (it == references.end()) {
+            return VK_NULL_HANDLE;
+        }
+        if (it->second.key != key.bytes) {
+            *out_collision = true;
+            return VK_NULL_HANDLE;
+        }
+        it->second.ref_count++;
+        return it->second.handle;
+    }
+
+    // True when the handle has to be destroyed, its last reference is gone or it was never shared.
+    template <typename T>
+    static b8 ReleaseShared(std::unordered_map<u64, VulkanStateReference<T>>& references, T handle) {
+        for (auto it = references.begin(); it != references.end(); ++it) {
+            if (it->second.handle != handle) {
+                continue;
+            }
+            if (--it->second.ref_count == 0) {
+                references.erase(it);
+                return true;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    VulkanPipelineStateCache::~VulkanPipelineStateCache() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VkDevice logical_device = backend->GetVulkanDevice()->logical_device;
+
+        DEBUG("Pipeline state cache: %u/%u set layouts, %u/%u pipeline layouts, %u/%u pipelines created/requested.",
+            stats.set_layouts_created, stats.set_layout_requests,
+            stats.pipeline_layouts_created, stats.pipeline_layout_requests,
+            stats.pipelines_created, stats.pipeline_requests);
+
+        for (auto& [hash, reference] : pipelines) {
+            WARN("Pipeline %llu still has %u references on shutdown.", hash, reference.ref_count);
+            vkDestroyPipeline(logical_device, reference.handle, backend->GetVulkanAllocator());
+        }
+        for (auto& [hash, reference] : pipeline_layouts) {
+            WARN("Pipeline layout %llu still has %u references on shutdown.", hash, reference.ref_count);
+            vkDestroyPipelineLayout(logical_device, reference.handle, backend->GetVulkanAllocator());
+        }
+        for (auto& [hash, reference] : set_layouts) {
+            WARN("Descriptor set layout %llu still has %u references on shutdown.", hash, reference.ref_count);
+            vkDestroyDescriptorSetLayout(logical_device, reference.handle, backend->GetVulkanAllocator());
+        }
+        pipelines.clear();
+        pipeline_layouts.clear();
+        set_layouts.clear();
+    };
+
+    VkDescriptorSetLayout VulkanPipelineStateCache::AcquireSetLayout(u32 binding_count, const VkDescriptorSetLayoutBinding* bindings) {
+        stats.set_layout_requests++;
+
+        VulkanStateKey key;
+        for (u32 i = 0; i < binding_count; ++i) {
+            key.Add(bindings[i].binding);
+            key.Add(bindings[i].descriptorType);
+            key.Add(bindings[i].descriptorCount);
+            key.Add(bindings[i].stageFlags);
+            key.Add((b8)(bindings[i].pImmutableSamplers != nullptr));
+            if (bindings[i].pImmutableSamplers) {
+                key.Add(bindings[i].pImmutableSamplers, sizeof(VkSampler) * bindings[i].descriptorCount);
+            }
+        }
+        u64 hash = HashFNV1a(key.bytes.data(), key.bytes.size());
+
+        b8 collision = false;
+        VkDescriptorSetLayout layout = AcquireShared(set_layouts, hash, key, &collision);
+        if (layout) {
+            return layout;
+        }
+        if (collision) {
+            ERROR("Descriptor set layout hash collision, layout is not shared.");
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        VkDescriptorSetLayoutCreateInfo layout_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+        layout_info.bindingCount = binding_count;
+        layout_info.pBindings = bindings;
+        VkResult result = vkCreateDescriptorSetLayout(
+            backend->GetVulkanDevice()->logical_device,
+            &layout_info, backend->GetVulkanAllocator(),
+            &layout);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanPipelineStateCache - failed creating descriptor set layout: '%s'", VulkanResultString(result, true));
+            return VK_NULL_HANDLE;
+        }
+
+        if (!collision) {
+            set_layouts[hash] = { layout, 1, std::move(key.bytes) };
+        }
+        stats.set_layouts_created++;
+        return layout;
+    };
+
+    void VulkanPipelineStateCache::ReleaseSetLayout(VkDescriptorSetLayout layout) {
+        if (!layout || !ReleaseShared(set_layouts, layout)) {
+            return;
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        if (backend->GetDeletionQueue()) {
+            backend->GetDeletionQueue()->DestroyDescriptorSetLayout(layout);
+            return;
+        }
+        vkDestroyDescriptorSetLayout(backend->GetVulkanDevice()->logical_device, layout, backend->GetVulkanAllocator());
+    };
+
+    VkPipelineLayout VulkanPipelineStateCache::AcquirePipelineLayout(
+        u32 set_layout_count,
+        const VkDescriptorSetLayout* set_layouts,
+        u32 push_constant_range_count,
+        const VkPushConstantRange* push_constant_ranges) {
+        
+        stats.pipeline_layout_requests++;
+
+        // Set layouts come from this cache, equal handles mean equal content.
+        VulkanStateKey key;
+        key.Add(set_layout_count);
+        for (u32 i = 0; i < set_layout_count; ++i) {
+            key.Add(set_layouts[i]);
+        }
+        for (u32 i = 0; i < push_constant_range_count; ++i) {
+            key.Add(push_constant_ranges[i].stageFlags);
+            key.Add(push_constant_ranges[i].offset);
+            key.Add(push_constant_ranges[i].size);
+        }
+        u64 hash = HashFNV1a(key.bytes.data(), key.bytes.size());
+
+        b8 collision = false;
+        VkPipelineLayout layout = AcquireShared(pipeline_layouts, hash, key, &collision);
+        if (layout) {
+            return layout;
+        }
+        if (collision) {
+            ERROR("Pipeline layout hash collision, layout is not shared.");
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        VkPipelineLayoutCreateInfo pipeline_layout_create_info = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+        pipeline_layout_create_info.setLayoutCount = set_layout_count;
+        pipeline_layout_create_info.pSetLayouts = set_layouts;
+        pipeline_layout_create_info.pushConstantRangeCount = push_constant_range_count;
+        pipeline_layout_create_info.pPushConstantRanges = push_constant_ranges;
+        VkResult result = vkCreatePipelineLayout(
+            backend->GetVulkanDevice()->logical_device,
+            &pipeline_layout_create_info,
+            backend->GetVulkanAllocator(),
+            &layout);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanPipelineStateCache - failed creating pipeline layout: '%s'", VulkanResultString(result, true));
+            return VK_NULL_HANDLE;
+        }
+
+        if (!collision) {
+            pipeline_layouts[hash] = { layout, 1, std::move(key.bytes) };
+        }
+        stats.pipeline_layouts_created++;
+        return layout;
+    };
+
+    void VulkanPipelineStateCache::ReleasePipelineLayout(VkPipelineLayout layout) {
+        if (!layout || !ReleaseShared(pipeline_layouts, layout)) {
+            return;
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        if (backend->GetDeletionQueue()) {
+            backend->GetDeletionQueue()->DestroyPipelineLayout(layout);
+            return;
+        }
+        vkDestroyPipelineLayout(backend->GetVulkanDevice()->logical_device, layout, backend->GetVulkanAllocator());
+    };
+
+    VkPipeline VulkanPipelineStateCache::FindPipeline(const VulkanStateKey& key) {
+        stats.pipeline_requests++;
+
+        b8 collision = false;
+        VkPipeline pipeline = AcquireShared(pipelines, HashFNV1a(key.bytes.data(), key.bytes.size()), key, &collision);
+        if (collision) {
+            ERROR("Pipeline hash collision, pipeline is not shared.");
+        }
+        return pipeline;
+    };
+
+    void VulkanPipelineStateCache::InsertPipeline(const VulkanStateKey& key, VkPipeline pipeline) {
+        stats.pipelines_created++;
+
+        // A colliding hash keeps the first pipeline, this one stays with its creator.
+        u64 hash = HashFNV1a(key.bytes.data(), key.bytes.size());
+        if (pipelines.find(hash) == pipelines.end()) {
+            pipelines[hash] = { pipeline, 1, key.bytes };
+        }
+    };
+
+    void VulkanPipelineStateCache::ReleasePipeline(VkPipeline pipeline) {
+        if (!pipeline || !ReleaseShared(pipelines, pipeline)) {
+            return;
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        if (backend->GetDeletionQueue()) {
+            backend->GetDeletionQueue()->DestroyPipeline(pipeline);
+            return;
+        }
+        vkDestroyPipeline(backend->GetVulkanDevice()->logical_device, pipeline, backend->GetVulkanAllocator());
+    };
+
+};
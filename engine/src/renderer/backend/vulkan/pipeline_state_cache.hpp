@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+
+namespace Engine {
+
+    // Content key of cached state, fields appended one by one in a fixed order so padding never leaks in.
+    struct VulkanStateKey {
+        std::vector<u8> bytes;
+
+        template <typename T>
+        void Add(const T& value) {
+            const u8* data = (const u8*)&value;
+            bytes.insert(bytes.end(), data, data + sizeof(T));
+        };
+        void Add(const c8* string) {
+            Add(string, string ? strlen(string) + 1 : 0);
+        };
+        void Add(const void* data, u64 size) {
+            bytes.insert(bytes.end(), (const u8*)data, (const u8*)data + size);
+        };
+    };
+
+    template <typename T>
+    struct VulkanStateReference {
+        T handle;
+        u32 ref_count;
+        std::vector<u8> key;
+    };
+
+    struct VulkanPipelineStateStats {
+        // Acquire calls against objects actually created, per kind.
+        u32 set_layout_requests = 0;
+        u32 set_layouts_created = 0;
+        u32 pipeline_layout_requests = 0;
+        u32 pipeline_layouts_created = 0;
+        u32 pipeline_requests = 0;
+        u32 pipelines_created = 0;
+    };
+
+    // Descriptor set layouts, pipeline layouts and graphics pipelines shared by content. Layouts are keyed
+    // by their bindings, so shaders declaring the same sets end up with the same layout handles, which in
+    // turn lets pipelines with the same stages, vertex input and fixed state over the same renderpass share
+    // one VkPipeline. The last release destroys through the deletion queue. Main thread only.
+    class VulkanPipelineStateCache {
+        public:
+            VulkanPipelineStateCache() {};
+            ~VulkanPipelineStateCache();
+
+            // Null on failure.
+            VkDescriptorSetLayout AcquireSetLayout(u32 binding_count, const VkDescriptorSetLayoutBinding* bindings);
+            void ReleaseSetLayout(VkDescriptorSetLayout layout);
+
+            VkPipelineLayout AcquirePipelineLayout(
+                u32 set_layout_count,
+                const VkDescriptorSetLayout* set_layouts,
+                u32 push_constant_range_count,
+                const VkPushConstantRange* push_constant_ranges);
+            void ReleasePipelineLayout(VkPipelineLayout layout);
+
+            // Pipelines are built by VulkanPipeline, key holds every input of its create info. A hit takes a
+            // reference, on a miss the caller creates the pipeline and inserts it.
+            VkPipeline FindPipeline(const VulkanStateKey& key);
+            void InsertPipeline(const VulkanStateKey& key, VkPipeline pipeline);
+            void ReleasePipeline(VkPipeline pipeline);
+
+            const VulkanPipelineStateStats& GetStats() { return stats; };
+
+        private:
+            std::unordered_map<u64, VulkanStateReference<VkDescriptorSetLayout>> set_layouts;
+            std::unordered_map<u64, VulkanStateReference<VkPipelineLayout>> pipeline_layouts;
+            std::unordered_map<u64, VulkanStateReference<VkPipeline>> pipelines;
+            VulkanPipelineStateStats stats;
+    };
+
+};
@@ -0,0 +1,120 @@
+#include "recorder.hpp"
+
+#include "vulkan.hpp"
+#include "render_target.hpp"
+#include "helpers.hpp"
+#include "core/logger/logger.hpp"
+
+namespace Engine {
+
+    thread_local VulkanRecordingContext* VulkanRecorder::thread_context = nullptr;
+
+    VulkanRecorder::VulkanRecorder(WorkerPool* workers, u32 frame_count) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanDevice* device = backend->GetVulkanDevice();
+
+        this->ready = false;
+        this->workers = workers;
+        this->thread_count = workers->GetThreadCount();
+        this->frame_count = frame_count;
+        this->frame_index = 0;
+
+        // Transient, the buffers are rerecorded every time their frame comes around.
+        VkCommandPoolCreateInfo pool_info = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+        pool_info.queueFamilyIndex = device->graphics_queue_index;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        pools.resize(thread_count * frame_count);
+        for (VulkanRecordingPool& pool : pools) {
+            pool.handle = VK_NULL_HANDLE;
+            pool.used = 0;
+        }
+        for (VulkanRecordingPool& pool : pools) {
+            VkResult result = vkCreateCommandPool(device->logical_device, &pool_info, backend->GetVulkanAllocator(), &pool.handle);
+            if (!IsVulkanResultSuccess(result)) {
+                ERROR("VulkanRecorder - failed creating command pool: '%s'", VulkanResultString(result, true));
+                return;
+            }
+        }
+
+        ready = true;
+    };
+
+    VulkanRecorder::~VulkanRecorder() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VkDevice logical_device = backend->GetVulkanDevice()->logical_device;
+
+        for (VulkanRecordingPool& pool : pools) {
+            for (VulkanCommandBuffer* command_buffer : pool.command_buffers) {
+                delete command_buffer;
+            }
+            pool.command_buffers.clear();
+            if (pool.handle) {
+                vkDestroyCommandPool(logical_device, pool.handle, backend->GetVulkanAllocator());
+                pool.handle = VK_NULL_HANDLE;
+            }
+        }
+    };
+
+    void VulkanRecorder::BeginFrame(u32 frame_index) {
+        VkDevice logical_device = VulkanRendererBackend::GetInstance()->GetVulkanDevice()->logical_device;
+
+        this->frame_index = frame_index % frame_count;
+        for (u32 i = 0; i < thread_count; ++i) {
+            VulkanRecordingPool& pool = pools[i * frame_count + this->frame_index];
+            if (pool.used) {
+                vkResetCommandPool(logical_device, pool.handle, 0);
+                pool.used = 0;
+            }
+        }
+    };
+
+    VulkanCommandBuffer* VulkanRecorder::AcquireCommandBuffer(u32 thread_index) {
+        // Only ever touched by its own thread, so the pool needs no lock.
+        VulkanRecordingPool& pool = pools[thread_index * frame_count + frame_index];
+        if (pool.used == pool.command_buffers.size()) {
+            pool.command_buffers.push_back(new VulkanCommandBuffer(pool.handle, false));
+        }
+        VulkanCommandBuffer* command_buffer = pool.command_buffers[pool.used++];
+        command_buffer->Reset();
+        return command_buffer;
+    };
+
+    b8 VulkanRecorder::Record(VulkanCommandBuffer* primary, VulkanRenderpass* renderpass, u32 job_count, const RendererRecordJob& job) {
+        if (!job_count) {
+            return true;
+        }
+        if (!renderpass) {
+            ERROR("VulkanRecorder::Record - called outside of a renderpass begun for parallel recording.");
+            return false;
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanRenderTarget* render_target = static_cast<VulkanRenderTarget*>(renderpass->render_targets[backend->GetImageIndex()]);
+
+        VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+        inheritance.renderPass = renderpass->handle;
+        inheritance.subpass = 0;
+        inheritance.framebuffer = render_target->GetFramebuffer()->handle;
+
+        recorded.resize(job_count);
+        workers->Run(job_count, [&](u32 i, u32 thread_index) {
+            VulkanCommandBuffer* command_buffer = AcquireCommandBuffer(thread_index);
+            command_buffer->BeginSecondary(&inheritance);
+            // Dynamic state is not inherited from the primary buffer.
+            backend->SetDynamicState(command_buffer);
+
+            VulkanRecordingContext context = {command_buffer, false, 0};
+            thread_context = &context;
+            job(i);
+            thread_context = nullptr;
+
+            command_buffer->End();
+            recorded[i] = command_buffer->handle;
+        });
+
+        vkCmdExecuteCommands(primary->handle, job_count, recorded.data());
+        return true;
+    };
+
+};
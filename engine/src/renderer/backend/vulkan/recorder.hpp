@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+#include "command_buffer.hpp"
+#include "renderer/renderer.hpp"
+#include "core/utils/worker_pool.hpp"
+
+namespace Engine {
+
+    class VulkanRenderpass;
+
+    // Where the commands of the calling thread go. Draw state that only holds within one command buffer lives here too.
+    struct VulkanRecordingContext {
+        VulkanCommandBuffer* command_buffer;
+        // Shared buffers bound at offset 0 for indirect draws, direct draws rebind per geometry.
+        b8 indirect_buffers_bound;
+        // Bindless record of the material recorded last, instanced draws hand it to every instance.
+        u32 material_index;
+    };
+
+    // Secondary command buffers of one thread for one frame in flight, reset together once the frame's fence signaled.
+    struct VulkanRecordingPool {
+        VkCommandPool handle;
+        std::vector<VulkanCommandBuffer*> command_buffers;
+        u32 used;
+    };
+
+    // Splits recording inside a renderpass over the renderer's worker threads. Every job records into
+    // a secondary command buffer taken from the pool of the thread running it, the primary buffer
+    // executes them in job order.
+    class VulkanRecorder {
+        public:
+            VulkanRecorder(WorkerPool* workers, u32 frame_count);
+            ~VulkanRecorder();
+
+            // Call after the frame fence wait, the frame's buffers go back to their pools.
+            void BeginFrame(u32 frame_index);
+
+            // Records job_count jobs inside renderpass and executes them from primary.
+            b8 Record(VulkanCommandBuffer* primary, VulkanRenderpass* renderpass, u32 job_count, const RendererRecordJob& job);
+
+            u32 GetThreadCount() { return thread_count; };
+
+            // Null outside of a job.
+            static VulkanRecordingContext* GetThreadContext() { return thread_context; };
+
+            b8 ready;
+
+        private:
+            VulkanCommandBuffer* AcquireCommandBuffer(u32 thread_index);
+
+            static thread_local VulkanRecordingContext* thread_context;
+
+            WorkerPool* workers;
+            u32 thread_count;
+            u32 frame_count;
+            u32 frame_index;
+            // thread_count * frame_count pools, indexed thread_index * frame_count + frame_index.
+            std::vector<VulkanRecordingPool> pools;
+            std::vector<VkCommandBuffer> recorded;
+    };
+
+};
@@ -19,6 +19,7 @@ namespace Engine {
 
         this->ready = false;
         this->name = name;
+        this->gpu_scope = INVALID_ID;
 
         this->render_area = render_area;
         this->clear_color = clear_color;
@@ -49,7 +50,7 @@ namespace Engine {
         // If coming from a previous pass, should already be VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL. Otherwise undefined.
         color_attachment.initialLayout = has_prev_pass ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
         // If going to another pass, use VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL. Otherwise VK_IMAGE_LAYOUT_PRESENT_SRC_KHR.
-        color_attachment.finalLayout = has_next_pass ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        color_attachment.finalLayout = has_next_pass ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : backend->GetPresentLayout();
 
         color_attachment.flags = 0;
 
@@ -128,6 +129,158 @@ namespace Engine {
         this->ready = true;
     };
 
+    static VkImageLayout GetUsageLayout(RenderAttachmentUsage usage) {
+        switch (usage) {
+            case RenderAttachmentUsage::COLOR:
+                return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            case RenderAttachmentUsage::DEPTH:
+                return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            case RenderAttachmentUsage::SAMPLED:
+                return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            case RenderAttachmentUsage::PRESENT:
+                return VulkanRendererBackend::GetInstance()->GetPresentLayout();
+            default:
+                return VK_IMAGE_LAYOUT_UNDEFINED;
+        }
+    };
+
+    static VkPipelineStageFlags GetUsageStages(RenderAttachmentUsage usage) {
+        switch (usage) {
+            // Presentation is ordered through the image acquire semaphore, which waits at color output.
+            case RenderAttachmentUsage::COLOR:
+            case RenderAttachmentUsage::PRESENT:
+                return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            case RenderAttachmentUsage::DEPTH:
+                return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            case RenderAttachmentUsage::SAMPLED:
+                return VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            default:
+                return VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        }
+    };
+
+    static VkAccessFlags GetUsageAccess(RenderAttachmentUsage usage, b8 writes_only) {
+        switch (usage) {
+            case RenderAttachmentUsage::COLOR:
+                return VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | (writes_only ? 0 : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT);
+            case RenderAttachmentUsage::DEPTH:
+                return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | (writes_only ? 0 : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT);
+            case RenderAttachmentUsage::SAMPLED:
+                return writes_only ? 0 : VK_ACCESS_SHADER_READ_BIT;
+            default:
+                return 0;
+        }
+    };
+
+    VulkanRenderpass::VulkanRenderpass(RenderpassCreateInfo& info) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        this->ready = false;
+        this->handle = VK_NULL_HANDLE;
+        this->name = info.name;
+        this->gpu_scope = INVALID_ID;
+        this->render_area = info.render_area;
+        this->clear_color = info.clear_color;
+        this->clear_flags = info.clear_flags;
+        this->has_prev_pass = !!info.prev_name.size();
+        this->has_next_pass = !!info.next_name.size();
+        this->depth = 1.0f;
+        this->stencil = 0;
+        this->attachments = info.attachments;
+
+        std::vector<VkAttachmentDescription> attachment_descriptions;
+        std::vector<VkAttachmentReference> color_references;
+        VkAttachmentReference depth_reference = {};
+        b8 has_depth = false;
+
+        // One external dependency in, ordering this pass after the previous use of each attachment,
+        // and one out if a later pass samples what this one wrote.
+        VkSubpassDependency dependencies[2] = {};
+        dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[0].dstSubpass = 0;
+        dependencies[1].srcSubpass = 0;
+        dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+        b8 has_sampled_output = false;
+
+        for (u32 i = 0; i < attachments.size(); ++i) {
+            RenderpassAttachmentInfo& attachment = attachments[i];
+            b8 is_depth = attachment.format == RenderAttachmentFormat::DEPTH;
+            RenderAttachmentUsage usage = is_depth ? RenderAttachmentUsage::DEPTH : RenderAttachmentUsage::COLOR;
+            VkImageLayout layout = GetUsageLayout(usage);
+
+            VkAttachmentDescription description = {};
+            description.format = is_depth ? backend->GetVulkanDevice()->depth_format : backend->GetVulkanSwapchain()->image_format.format;
+            description.samples = VK_SAMPLE_COUNT_1_BIT;
+            description.loadOp = 
+                attachment.load == RenderAttachmentLoad::CLEAR ? VK_ATTACHMENT_LOAD_OP_CLEAR :
+                attachment.load == RenderAttachmentLoad::LOAD ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            description.storeOp = attachment.store ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            // Loaded contents are in whatever layout the previous use left them, anything else can start undefined.
+            description.initialLayout = attachment.load == RenderAttachmentLoad::LOAD ? GetUsageLayout(attachment.prev_usage) : VK_IMAGE_LAYOUT_UNDEFINED;
+            // Left in the layout the next use wants, the transition comes for free with the pass.
+            description.finalLayout = attachment.next_usage == RenderAttachmentUsage::NONE ? layout : GetUsageLayout(attachment.next_usage);
+
+            VkAttachmentReference reference = {};
+            reference.attachment = i;
+            reference.layout = layout;
+            if (is_depth) {
+                depth_reference = reference;
+                has_depth = true;
+            } else {
+                color_references.push_back(reference);
+            }
+            attachment_descriptions.push_back(description);
+
+            dependencies[0].srcStageMask |= GetUsageStages(attachment.prev_usage);
+            dependencies[0].srcAccessMask |= GetUsageAccess(attachment.prev_usage, true);
+            dependencies[0].dstStageMask |= GetUsageStages(usage);
+            dependencies[0].dstAccessMask |= GetUsageAccess(usage, false);
+            // Aliasing barrier, the images placed over this one's memory before are done with it. The
+            // layout starts undefined either way since their first use never loads.
+            for (RenderAttachmentUsage alias_usage : attachment.alias_usages) {
+                dependencies[0].srcStageMask |= GetUsageStages(alias_usage);
+                dependencies[0].srcAccessMask |= GetUsageAccess(alias_usage, true);
+            }
+
+            if (attachment.next_usage == RenderAttachmentUsage::SAMPLED) {
+                has_sampled_output = true;
+                dependencies[1].srcStageMask |= GetUsageStages(usage);
+                dependencies[1].srcAccessMask |= GetUsageAccess(usage, true);
+                dependencies[1].dstStageMask |= GetUsageStages(RenderAttachmentUsage::SAMPLED);
+                dependencies[1].dstAccessMask |= GetUsageAccess(RenderAttachmentUsage::SAMPLED, false);
+            }
+        }
+
+        VkSubpassDescription subpass = {};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = color_references.size();
+        subpass.pColorAttachments = color_references.data();
+        subpass.pDepthStencilAttachment = has_depth ? &depth_reference : 0;
+
+        VkRenderPassCreateInfo render_pass_create_info = {VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
+        render_pass_create_info.attachmentCount = attachment_descriptions.size();
+        render_pass_create_info.pAttachments = attachment_descriptions.data();
+        render_pass_create_info.subpassCount = 1;
+        render_pass_create_info.pSubpasses = &subpass;
+        render_pass_create_info.dependencyCount = has_sampled_output ? 2 : 1;
+        render_pass_create_info.pDependencies = dependencies;
+
+        VkResult result = vkCreateRenderPass(
+            backend->GetVulkanDevice()->logical_device,
+            &render_pass_create_info,
+            backend->GetVulkanAllocator(),
+            &this->handle);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanRenderpass - failed creating renderpass '%s': '%s'", name.c_str(), VulkanResultString(result, true));
+            return;
+        }
+
+        DEBUG("Renderpass '%s' created successfully.", name.c_str());
+        this->ready = true;
+    };
+
     VulkanRenderpass::~VulkanRenderpass() {
         if (this->handle) {
             VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
@@ -154,7 +307,7 @@ namespace Engine {
         this->render_area = render_area;
     };
 
-    b8 VulkanRenderpass::Begin() {
+    b8 VulkanRenderpass::Begin(RenderpassContents contents) {
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
         VulkanCommandBuffer* command_buffer = backend->GetCurrentCommandBuffer();
         VkRenderPassBeginInfo begin_info = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
@@ -172,13 +325,25 @@ namespace Engine {
         begin_info.clearValueCount = clear_values.size();
         begin_info.pClearValues = nullptr;
 
-        if (this->clear_flags & RenderpassClearFlag::CLEAR_COLOR_BUFFER) {
+        // Clear values are indexed by attachment, give every attachment one.
+        for (RenderpassAttachmentInfo& attachment : attachments) {
+            VkClearValue clear_value;
+            if (attachment.format == RenderAttachmentFormat::DEPTH) {
+                clear_value.depthStencil.depth = this->depth;
+                clear_value.depthStencil.stencil = this->stencil;
+            } else {
+                Platform::CpMemory(clear_value.color.float32, &clear_color, sizeof(clear_color));
+            }
+            clear_values.push_back(clear_value);
+        }
+
+        if (!attachments.size() && this->clear_flags & RenderpassClearFlag::CLEAR_COLOR_BUFFER) {
             VkClearValue cb_clear;
             Platform::CpMemory(cb_clear.color.float32, &clear_color, sizeof(clear_color));
             clear_values.push_back(cb_clear);
         }
 
-        if (this->clear_flags & RenderpassClearFlag::CLEAR_COLOR_DEPTH_BUFER) {
+        if (!attachments.size() && this->clear_flags & RenderpassClearFlag::CLEAR_COLOR_DEPTH_BUFER) {
             VkClearValue db_clear;
             Platform::CpMemory(db_clear.color.float32, &clear_color, sizeof(clear_color));
             db_clear.depthStencil.depth = this->depth;
@@ -193,16 +358,33 @@ namespace Engine {
         begin_info.clearValueCount = clear_values.size();
         begin_info.pClearValues = clear_values.data();
 
-        vkCmdBeginRenderPass(command_buffer->handle, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+        // Timestamps go outside the pass instance, parallel passes allow nothing but secondary buffers inside.
+        if (backend->GetGpuTimer()) {
+            gpu_scope = backend->GetGpuTimer()->BeginScope(command_buffer, name);
+        }
+
+        // Parallel passes hold nothing but secondary buffers, the backend records them against this pass.
+        if (contents == RenderpassContents::PARALLEL) {
+            vkCmdBeginRenderPass(command_buffer->handle, &begin_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            backend->SetParallelRenderpass(this);
+        } else {
+            vkCmdBeginRenderPass(command_buffer->handle, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+        }
         command_buffer->InRenderPass();
 
         return true;
     };
 
     b8 VulkanRenderpass::End() {
-        VulkanCommandBuffer* command_buffer = VulkanRendererBackend::GetInstance()->GetCurrentCommandBuffer();
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanCommandBuffer* command_buffer = backend->GetCurrentCommandBuffer();
         vkCmdEndRenderPass(command_buffer->handle);
+        backend->SetParallelRenderpass(nullptr);
         command_buffer->Recording();
+        if (backend->GetGpuTimer() && gpu_scope != INVALID_ID) {
+            backend->GetGpuTimer()->EndScope(command_buffer, gpu_scope);
+            gpu_scope = INVALID_ID;
+        }
         return true;
     };
 
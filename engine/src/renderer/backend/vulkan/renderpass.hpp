@@ -31,6 +31,12 @@ namespace Engine {
 
             VulkanRenderPassState state;
 
+            // Empty for passes created from clear flags.
+            std::vector<RenderpassAttachmentInfo> attachments;
+
+            // GPU timer scope between Begin and End, INVALID_ID otherwise.
+            u32 gpu_scope;
+
             b8 ready;
 
             VulkanRenderpass(
@@ -40,10 +46,12 @@ namespace Engine {
                 f32 depth, u32 stencil,
                 RenderpassClearFlag clear_flags,
                 b8 has_prev_pass, b8 has_next_pass);
+            // Attachments, layouts and dependencies described by info.attachments.
+            VulkanRenderpass(RenderpassCreateInfo& info);
 
             ~VulkanRenderpass();   
 
-            b8 Begin() override;
+            b8 Begin(RenderpassContents contents = RenderpassContents::INLINE) override;
             b8 End() override;
 
             void OnResize(glm::vec4 render_area) override;
@@ -4,9 +4,12 @@
 #include "defines.hpp"
 #include "resources/texture/sampler.hpp"
 #include "resources/texture/texture_types.hpp"
+#include "sampler_cache.hpp"
 
 namespace Engine {
 
+    // Handle to a sampler shared through the backend's sampler cache, identical create parameters
+    // get the same VkSampler and bindless slot.
     class VulkanSampler : public Sampler {
         public:
             VulkanSampler(SamplerCreateInfo info);
@@ -16,12 +19,13 @@ namespace Engine {
                 return sampler;
             };
 
-            VkSamplerAddressMode ConvertRepeatType(TextureRepeat repeat);
-            VkFilter ConvertFilterMode(TextureFilterMode filter);
+            // Slot in the bindless table, INVALID_ID without one.
+            u32 GetBindlessSlot() { return bindless_slot; };
 
         protected:
             VkSampler sampler;
+            u32 bindless_slot;
+            VulkanSamplerReference* reference;
     };
 
 };
-
@@ -0,0 +1,177 @@
+#include "sampler_cache.hpp"
+
+#include "vulkan.hpp"
+#include "helpers.hpp"
+#include "core/logger/logger.hpp"
+#include "core/utils/hash.hpp"
+
+namespace Engine {
+
+    VulkanSamplerCache::~VulkanSamplerCache() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        DEBUG("Sampler cache: %u requests, %u samplers created.", stats.requests, stats.created);
+        for (auto& [hash, reference] : samplers) {
+            WARN("Sampler %llu still has %u references on shutdown.", hash, reference->ref_count);
+            if (backend->GetBindlessTable()) {
+                backend->GetBindlessTable()->ReleaseSampler(reference->bindless_slot);
+            }
+            vkDestroySampler(
+                backend->GetVulkanDevice()->logical_device,
+                reference->handle,
+                backend->GetVulkanAllocator());
+            delete reference;
+        }
+        samplers.clear();
+    };
+
+    VulkanSamplerReference* VulkanSamplerCache::Acquire(const SamplerCreateInfo& info) {
+        stats.requests++;
+
+        u64 hash = Hash(info);
+        auto it = samplers.find(hash);
+        if (it != samplers.end()) {
+            if (Equal(it->second->info, info)) {
+                it->second->ref_count++;
+                return it->second;
+            }
+            ERROR("Sampler hash collision, sampler is not shared.");
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        VkSamplerCreateInfo sampler_create_info = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+        
+        sampler_create_info.magFilter = ConvertFilterMode(info.filter_magnify);
+        sampler_create_info.minFilter = ConvertFilterMode(info.filter_minify);
+        sampler_create_info.addressModeU = ConvertRepeatType(info.repeat_u);
+        sampler_create_info.addressModeV = ConvertRepeatType(info.repeat_v);
+        sampler_create_info.addressModeW = ConvertRepeatType(info.repeat_w);
+
+        // TODO: make other params configurable, they have to join the hash then
+        sampler_create_info.anisotropyEnable = VK_TRUE;
+        sampler_create_info.maxAnisotropy = 16;
+        sampler_create_info.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        sampler_create_info.unnormalizedCoordinates = VK_FALSE;
+        sampler_create_info.compareEnable = VK_FALSE;
+        sampler_create_info.compareOp = VK_COMPARE_OP_ALWAYS;
+        sampler_create_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        sampler_create_info.mipLodBias = 0.0f;
+        sampler_create_info.minLod = 0.0f;
+        sampler_create_info.maxLod = VK_LOD_CLAMP_NONE;
+
+        VkSampler handle = VK_NULL_HANDLE;
+        VkResult result = vkCreateSampler(
+            backend->GetVulkanDevice()->logical_device,
+            &sampler_create_info,
+            backend->GetVulkanAllocator(),
+            &handle
+        );
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("Error occured during creation of texture sampler: %s", VulkanResultString(result, true));
+            return nullptr;
+        }
+
+        VulkanSamplerReference* reference = new VulkanSamplerReference{ handle, INVALID_ID, 1, info };
+        if (backend->GetBindlessTable()) {
+            reference->bindless_slot = backend->GetBindlessTable()->RegisterSampler(handle);
+        }
+
+        if (it == samplers.end()) {
+            samplers[hash] = reference;
+        }
+        stats.created++;
+        stats.live++;
+        return reference;
+    };
+
+    void VulkanSamplerCache::Release(VulkanSamplerReference* reference) {
+        if (!reference) {
+            return;
+        }
+
+        auto it = samplers.find(Hash(reference->info));
+        b8 shared = it != samplers.end() && it->second == reference;
+        if (shared && --reference->ref_count > 0) {
+            return;
+        }
+        if (shared) {
+            samplers.erase(it);
+        }
+        // Not shared (hash collision) ones are owned by the caller alone
+
+        VkSampler handle = reference->handle;
+        u32 bindless_slot = reference->bindless_slot;
+        delete reference;
+        stats.live--;
+
+        // Frames in flight may still sample with it, the slot is only reused once they are done.
+        std::function<void()> destroy = [handle, bindless_slot]() {
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            if (backend->GetBindlessTable()) {
+                backend->GetBindlessTable()->ReleaseSampler(bindless_slot);
+            }
+            vkDestroySampler(backend->GetVulkanDevice()->logical_device, handle, backend->GetVulkanAllocator());
+        };
+        VulkanDeletionQueue* deletion_queue = VulkanRendererBackend::GetInstance()->GetDeletionQueue();
+        if (deletion_queue) {
+            deletion_queue->Push(destroy);
+        } else {
+            destroy();
+        }
+    };
+
+    u64 VulkanSamplerCache::Hash(const SamplerCreateInfo& info) {
+        u32 fields[5] = {
+            (u32)info.filter_minify,
+            (u32)info.filter_magnify,
+            (u32)info.repeat_u,
+            (u32)info.repeat_v,
+            (u32)info.repeat_w
+        };
+        return HashFNV1a(fields, sizeof(fields));
+    };
+
+    b8 VulkanSamplerCache::Equal(const SamplerCreateInfo& a, const SamplerCreateInfo& b) {
+        return a.filter_minify == b.filter_minify &&
+            a.filter_magnify == b.filter_magnify &&
+            a.repeat_u == b.repeat_u &&
+            a.repeat_v == b.repeat_v &&
+            a.repeat_w == b.repeat_w;
+    };
+
+    VkSamplerAddressMode VulkanSamplerCache::ConvertRepeatType(TextureRepeat repeat) {
+        switch (repeat) {
+            case TextureRepeat::REPEAT:
+                return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+            
+            case TextureRepeat::MIRRORED_REPEAT:
+                return VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+
+            case TextureRepeat::CLAMP_TO_BORDER:
+                return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+
+            case TextureRepeat::CLAMP_TO_EDGE:
+                return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+            default:
+                WARN("VulkanSamplerCache::ConvertRepeatType: type '%x' is not supported.", repeat);
+                return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        }
+    }
+
+    VkFilter VulkanSamplerCache::ConvertFilterMode(TextureFilterMode filter) {
+        switch (filter) {
+            case TextureFilterMode::LINEAR:
+                return VK_FILTER_LINEAR;
+
+            case TextureFilterMode::NEAREST:
+                return VK_FILTER_NEAREST;
+
+            default:
+                WARN("VulkanSamplerCache::ConvertFilterMode: type '%x' is not supported.", filter);
+                return VK_FILTER_LINEAR;
+        }
+    };
+
+};
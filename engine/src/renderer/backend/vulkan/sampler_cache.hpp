@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+#include "resources/texture/sampler.hpp"
+
+namespace Engine {
+
+    struct VulkanSamplerReference {
+        VkSampler handle;
+        // Slot in the bindless table, INVALID_ID without one.
+        u32 bindless_slot;
+        u32 ref_count;
+        SamplerCreateInfo info;
+    };
+
+    struct VulkanSamplerCacheStats {
+        // CreateSampler calls against samplers actually created.
+        u32 requests = 0;
+        u32 created = 0;
+        u32 live = 0;
+    };
+
+    // Samplers shared by create parameters, every texture map with the same filtering and wrapping
+    // points at one VkSampler and one bindless slot. Drivers cap live samplers. Main thread only.
+    class VulkanSamplerCache {
+        public:
+            VulkanSamplerCache() {};
+            ~VulkanSamplerCache();
+
+            // Null if the sampler could not be created.
+            VulkanSamplerReference* Acquire(const SamplerCreateInfo& info);
+            // The last release destroys the sampler once no frame in flight can use it.
+            void Release(VulkanSamplerReference* reference);
+
+            const VulkanSamplerCacheStats& GetStats() { return stats; };
+
+        private:
+            static u64 Hash(const SamplerCreateInfo& info);
+            static b8 Equal(const SamplerCreateInfo& a, const SamplerCreateInfo& b);
+            static VkSamplerAddressMode ConvertRepeatType(TextureRepeat repeat);
+            static VkFilter ConvertFilterMode(TextureFilterMode filter);
+
+            // Entries are never moved, samplers keep pointers to them.
+            std::unordered_map<u64, VulkanSamplerReference*> samplers;
+            VulkanSamplerCacheStats stats;
+    };
+
+};
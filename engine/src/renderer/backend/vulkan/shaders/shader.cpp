@@ -36,10 +36,30 @@ namespace Engine {
         }
 
         this->renderpass = vk_config.renderpass;
+        pipeline = nullptr;
+        instanced_pipeline = nullptr;
+        material_buffer = nullptr;
+        mapped_material_buffer = nullptr;
+        material_set_layout = VK_NULL_HANDLE;
+        Platform::ZrMemory(material_sets, sizeof(material_sets));
+        material_copy_size = 0;
+        material_stride = 0;
+        material_texture_offset = 0;
+        instance_uniform_buffer = nullptr;
+        mapped_instance_uniform_buffer = nullptr;
+        instance_copy_count = 0;
+        sampler_update_template = VK_NULL_HANDLE;
+        Platform::ZrMemory(descriptor_set_layouts, (u32)ShaderScope::LENGTH * sizeof(VkDescriptorSetLayout));
+        global_ring_offset = 0;
+        global_ring_reserved = 0;
+        global_fallback = {};
+        global_fallback_frame = INVALID_ID_U64;
 
         // Creating shader stages
         for (u32 i = 0; i < config.stages.size(); ++i) {
             VulkanShaderStage stage;
+            stage.instanced = config.stages[i].instanced;
+            stage.bindless = config.stages[i].bindless;
             if (!CreateShaderStage(config.stages[i], &stage)) {
                 ERROR("VulkanShader::VulkanShader - failed to create shader stage '%s'", config.stages[i].name.c_str());
                 return;
@@ -62,22 +82,29 @@ namespace Engine {
             this->descriptor_sets[i].bindings.reserve(VULKAN_SHADER_MAX_BINDINGS);
         }
         
-        // Process attributes
-        u32 offset = 0;
+        // Process attributes, offsets and stride come precomputed with the config.
+        // Per instance attributes read from binding 1 and are only used by the instanced variant.
         for (u32 i = 0; i < config.attributes.size(); ++i) {
             VkVertexInputAttributeDescription attribute;
             attribute.location = i;
-            attribute.binding = 0;
-            attribute.offset = offset;
+            attribute.binding = config.attributes[i].per_instance ? 1 : 0;
+            attribute.offset = config.attributes[i].offset;
             attribute.format = attributes_formats[(u32)config.attributes[i].type];
-            offset += config.attributes[i].size;
-            attribute_stride += config.attributes[i].size;
             attributes.push_back(attribute);
         }
         
+        // Bindless needs the device table, a bindless stage variant and a local uniform selecting the material record.
+        auto material_index = uniforms_lookup.find("material_index");
+        material_index_uniform = material_index != uniforms_lookup.end() ? material_index->second : nullptr;
+        b8 has_bindless_stage = false;
+        for (VulkanShaderStage& stage : stages) {
+            has_bindless_stage |= stage.bindless;
+        }
+        bindless = use_instances && has_bindless_stage && material_index_uniform && backend->GetBindlessTable();
+
         // Descriptor pool.
         VkDescriptorPoolCreateInfo pool_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
-        pool_info.poolSizeCount = 2;
+        pool_info.poolSizeCount = pool_sizes.size();
         pool_info.pPoolSizes = pool_sizes.data();
         pool_info.maxSets = max_descriptor_set_count;
         pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
@@ -92,22 +119,22 @@ namespace Engine {
             return;
         }
 
-        // Create descriptor set layouts.
-        Platform::ZrMemory(descriptor_set_layouts, (u32)ShaderScope::LENGTH * sizeof(VkDescriptorSetLayout));
+        // Create descriptor set layouts, shared by content with other shaders.
         for (u32 i = 0; i < (u32)ShaderScope::LENGTH; ++i) {
-            VkDescriptorSetLayoutCreateInfo layout_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-            layout_info.bindingCount = descriptor_sets[i].bindings.size();
-            layout_info.pBindings = descriptor_sets[i].bindings.data();
-            result = vkCreateDescriptorSetLayout(
-                backend->GetVulkanDevice()->logical_device, 
-                &layout_info, backend->GetVulkanAllocator(), 
-                &descriptor_set_layouts[i]);
-            if (!IsVulkanResultSuccess(result)) {
-                ERROR("VulkanShader::VulkanShader - failed creating descriptor pool: '%s'", VulkanResultString(result, true));
+            descriptor_set_layouts[i] = backend->GetPipelineStateCache()->AcquireSetLayout(
+                descriptor_sets[i].bindings.size(),
+                descriptor_sets[i].bindings.data());
+            if (!descriptor_set_layouts[i]) {
+                ERROR("VulkanShader::VulkanShader - failed creating descriptor set layout for shader '%s'.", name.c_str());
                 return;
             }
         }
 
+        if (bindless && !CreateMaterialBuffer()) {
+            WARN("Failed to create material buffer for shader '%s', using per material descriptor sets.", name.c_str());
+            bindless = false;
+        }
+
         // TODO: This feels wrong to have these here, at least in this fashion. Should probably
         // Be configured to pull from someplace instead.
 
@@ -126,34 +153,26 @@ namespace Engine {
         scissor.extent.width = backend->GetFrameWidth();
         scissor.extent.height = backend->GetFrameHeight();
 
-        std::vector<VkPipelineShaderStageCreateInfo> pipeline_stage_create_info;
-        pipeline_stage_create_info.resize(stages.size());
-        for (u32 i = 0; i < stages.size(); ++i) {
-            pipeline_stage_create_info[i] = stages[i].shader_stage_create_info;
-        }
-
-        pipeline = new VulkanPipeline(
-            renderpass,
-            attributes.size(),
-            attributes.data(),
-            descriptor_set_count,
-            descriptor_set_layouts,
-            stages.size(),
-            pipeline_stage_create_info.data(),
-            push_constant_count,
-            push_constant_ranges,
-            attribute_stride,
-            viewport,
-            scissor,
-            false,
-            true
-        );
-        
+        pipeline = CreatePipeline(false, viewport, scissor);
         if (!pipeline->ready) {
             ERROR("Failed to load graphics pipeline for object shader '%s'.", name.c_str());
             return;
         }
 
+        b8 has_instanced_stage = false;
+        for (VulkanShaderStage& stage : stages) {
+            has_instanced_stage |= stage.instanced;
+        }
+        if (has_instanced_stage && instance_attribute_stride) {
+            instanced_pipeline = CreatePipeline(true, viewport, scissor);
+            if (!instanced_pipeline->ready) {
+                WARN("Failed to load instanced pipeline for shader '%s', drawing without instancing.", name.c_str());
+                delete instanced_pipeline;
+                instanced_pipeline = nullptr;
+            }
+        }
+        supports_instancing = instanced_pipeline != nullptr;
+
         // Get the UBO alignment
         VulkanDevice* device = backend->GetVulkanDevice();
         required_ubo_alignment = device->properties.limits.minUniformBufferOffsetAlignment;
@@ -162,25 +181,20 @@ namespace Engine {
         global_ubo_stride = GetAligned(global_ubo.size, required_ubo_alignment);
         ubo_stride = GetAligned(ubo.size, required_ubo_alignment);
 
-        u32 device_local_bits = device->supports_device_local_host_visible ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : 0;
-        u64 buffer_size = global_ubo_stride + (ubo_stride * VULKAN_SHADER_MAX_OBJECT_COUNT);
-        uniform_buffer = new VulkanBuffer(
-            buffer_size,
-            (VkBufferUsageFlagBits)(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT),
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | device_local_bits,
-            true,
-            true
-        );
-
-        global_ubo_block = uniform_buffer->Allocate(global_ubo_stride);
+        // Uniforms are set here on the CPU and copied to the GPU when applied, so a frame still in flight
+        // never sees them change. Globals go through the uniform ring, instance blocks through their frame copies.
+        uniform_shadow.resize(global_ubo_stride + (ubo_stride * VULKAN_SHADER_MAX_OBJECT_COUNT));
+        backend->GetUniformRing()->Reserve(global_ubo_stride);
+        global_ring_reserved = global_ubo_stride;
 
-        if (!uniform_buffer->ready) {
-            ERROR("Failed to create uniform_buffer for object shader '%s'.", name.c_str());
-            return;
+        if (use_instances && !bindless) {
+            if (!CreateInstanceUniformBuffer()) {
+                ERROR("VulkanShader::VulkanShader - failed creating instance uniform buffer for shader '%s'.", name.c_str());
+                return;
+            }
+            CreateSamplerUpdateTemplate();
         }
 
-        mapped_uniform_buffer_block = uniform_buffer->LockMemory(0, VK_WHOLE_SIZE, 0);
-
         VkDescriptorSetLayout global_layouts[3] = {
         descriptor_set_layouts[(u32)ShaderScope::GLOBAL],
         descriptor_set_layouts[(u32)ShaderScope::GLOBAL],
@@ -192,6 +206,24 @@ namespace Engine {
         alloc_info.pSetLayouts = global_layouts;
         VK_CHECK(vkAllocateDescriptorSets(device->logical_device, &alloc_info, global_descriptor_sets));
 
+        // The ring buffer never changes, only the dynamic offset does.
+        VkDescriptorBufferInfo buffer_info;
+        buffer_info.buffer = backend->GetUniformRing()->GetHandle();
+        buffer_info.offset = 0;
+        buffer_info.range = global_ubo_stride;
+
+        VkWriteDescriptorSet ubo_writes[3];
+        for (u32 i = 0; i < 3; ++i) {
+            ubo_writes[i] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+            ubo_writes[i].dstSet = global_descriptor_sets[i];
+            ubo_writes[i].dstBinding = (u32)VulkanShaderDescriptorBindingIndex::UBO;
+            ubo_writes[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+            ubo_writes[i].descriptorCount = 1;
+            ubo_writes[i].pBufferInfo = &buffer_info;
+        }
+        vkUpdateDescriptorSets(device->logical_device, 3, ubo_writes, 0, 0);
+        backend->GetStats().descriptor_writes += 3;
+
         this->ready = true;
     };
 
@@ -205,15 +237,37 @@ namespace Engine {
             }
         }
 
-        // Descriptor set layouts.
+        if (global_ring_reserved && backend->GetUniformRing()) {
+            backend->GetUniformRing()->Unreserve(global_ring_reserved);
+            global_ring_reserved = 0;
+        }
+
+        // Descriptor set layouts, shared with other shaders declaring the same sets.
+        VulkanPipelineStateCache* state_cache = backend->GetPipelineStateCache();
         for (u32 i = 0; i < 3; ++i) {
-            if (descriptor_set_layouts[i]) {
-                vkDestroyDescriptorSetLayout(
-                    device->logical_device, 
-                    descriptor_set_layouts[i], 
-                    backend->GetVulkanAllocator());
-                descriptor_set_layouts[i] = 0;
-            }
+            state_cache->ReleaseSetLayout(descriptor_set_layouts[i]);
+            descriptor_set_layouts[i] = 0;
+        }
+        state_cache->ReleaseSetLayout(material_set_layout);
+        material_set_layout = VK_NULL_HANDLE;
+
+        // Sets freed by released instances are still queued, the pool follows them.
+        VulkanDeletionQueue* deletion_queue = backend->GetDeletionQueue();
+        if (deletion_queue) {
+            VkDescriptorPool pool = descriptor_pool;
+            VkDescriptorUpdateTemplate update_template = sampler_update_template;
+            deletion_queue->Push([pool, update_template]() {
+                VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+                VkDevice logical_device = backend->GetVulkanDevice()->logical_device;
+                if (pool) {
+                    vkDestroyDescriptorPool(logical_device, pool, backend->GetVulkanAllocator());
+                }
+                if (update_template) {
+                    vkDestroyDescriptorUpdateTemplate(logical_device, update_template, backend->GetVulkanAllocator());
+                }
+            });
+            descriptor_pool = VK_NULL_HANDLE;
+            sampler_update_template = VK_NULL_HANDLE;
         }
 
         // Descriptor pool
@@ -224,26 +278,34 @@ namespace Engine {
                 backend->GetVulkanAllocator());
         }
 
-        // Uniform buffer.
-        if (uniform_buffer) {
-            global_ubo_block->FreeBlock();
-            uniform_buffer->UnlockMemory();
-            mapped_uniform_buffer_block = 0;
+        if (sampler_update_template) {
+            vkDestroyDescriptorUpdateTemplate(device->logical_device, sampler_update_template, backend->GetVulkanAllocator());
+            sampler_update_template = VK_NULL_HANDLE;
+        }
+        if (instance_uniform_buffer) {
+            instance_uniform_buffer->UnlockMemory();
+            mapped_instance_uniform_buffer = nullptr;
+            delete instance_uniform_buffer;
+        }
 
-            delete uniform_buffer;
+        // Material buffer, its descriptor sets go with the pool.
+        if (material_buffer) {
+            material_buffer->UnlockMemory();
+            mapped_material_buffer = nullptr;
+            delete material_buffer;
         }
-        
+
         // Pipeline
         if (pipeline) {
             delete pipeline;
         }
+        if (instanced_pipeline) {
+            delete instanced_pipeline;
+        }
         
         // Shader modules
         for (u32 i = 0; i < stages.size(); ++i) {
-            vkDestroyShaderModule(
-                device->logical_device, 
-                stages[i].handle, 
-                backend->GetVulkanAllocator());
+            backend->GetShaderModuleCache()->Release(stages[i].handle);
         }
 
     };
@@ -295,53 +357,272 @@ namespace Engine {
         
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
 
-        Platform::ZrMemory(&out_shader_stage->create_info, sizeof(VkShaderModuleCreateInfo));
+        out_shader_stage->handle = backend->GetShaderModuleCache()->Acquire(config.file_path);
+        if (!out_shader_stage->handle) {
+            ERROR("Unable to create shader module: %s.", config.file_path.c_str());
+            return false;
+        }
+
+        Platform::ZrMemory(&out_shader_stage->shader_stage_create_info, sizeof(VkPipelineShaderStageCreateInfo));
+        out_shader_stage->shader_stage_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        out_shader_stage->shader_stage_create_info.stage = GetVkStageType(config);
+        out_shader_stage->shader_stage_create_info.module = out_shader_stage->handle;
+        out_shader_stage->shader_stage_create_info.pName = "main";
+
+        return true;
+    };
+
+    void VulkanShader::Use() {
+        VulkanCommandBuffer* command_buffer = VulkanRendererBackend::GetInstance()->GetCurrentCommandBuffer();
+        this->pipeline->Bind(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+    };
+
+    void VulkanShader::UseInstanced() {
+        if (!instanced_pipeline) {
+            return Use();
+        }
+        VulkanCommandBuffer* command_buffer = VulkanRendererBackend::GetInstance()->GetCurrentCommandBuffer();
+        this->instanced_pipeline->Bind(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+    };
+
+    VulkanPipeline* VulkanShader::CreatePipeline(b8 instanced, VkViewport viewport, VkRect2D scissor) {
+        // Instanced and bindless stages replace the regular stage of the same type, the rest is shared.
+        std::vector<VkPipelineShaderStageCreateInfo> pipeline_stage_create_info;
+        for (u32 i = 0; i < stages.size(); ++i) {
+            if (stages[i].instanced || stages[i].bindless) {
+                continue;
+            }
+            VkPipelineShaderStageCreateInfo stage_info = stages[i].shader_stage_create_info;
+            for (u32 j = 0; j < stages.size(); ++j) {
+                b8 replaces = (instanced && stages[j].instanced) || (bindless && stages[j].bindless);
+                if (replaces && stages[j].shader_stage_create_info.stage == stage_info.stage) {
+                    stage_info = stages[j].shader_stage_create_info;
+                }
+            }
+            pipeline_stage_create_info.push_back(stage_info);
+        }
+
+        // Bindless swaps the per instance set for the material buffer and adds the device table.
+        VkDescriptorSetLayout set_layouts[3] = {
+            descriptor_set_layouts[(u32)ShaderScope::GLOBAL],
+            descriptor_set_layouts[(u32)ShaderScope::INSTANCE],
+            descriptor_set_layouts[(u32)ShaderScope::LOCAL]
+        };
+        u32 set_count = descriptor_set_count;
+        if (bindless) {
+            set_layouts[1] = material_set_layout;
+            set_layouts[VULKAN_BINDLESS_SET_INDEX] = VulkanRendererBackend::GetInstance()->GetBindlessTable()->layout;
+            set_count = VULKAN_BINDLESS_SET_INDEX + 1;
+        }
+
+        std::vector<VkVertexInputAttributeDescription> pipeline_attributes;
+        for (VkVertexInputAttributeDescription& attribute : attributes) {
+            if (instanced || attribute.binding == 0) {
+                pipeline_attributes.push_back(attribute);
+            }
+        }
+        // Lets one instanced or indirect draw mix bindless materials.
+        if (instanced) {
+            pipeline_attributes.push_back({VULKAN_SHADER_MATERIAL_INDEX_LOCATION, 2, VK_FORMAT_R32_UINT, 0});
+        }
 
-        std::string shader_name = config.file_path;
-        BinaryResource* b_resource = static_cast<BinaryResource*>(
-            ResourceSystem::GetInstance()->LoadResource(ResourceType::BINARY, shader_name)
+        return new VulkanPipeline(
+            renderpass,
+            pipeline_attributes.size(),
+            pipeline_attributes.data(),
+            set_count,
+            set_layouts,
+            pipeline_stage_create_info.size(),
+            pipeline_stage_create_info.data(),
+            push_constant_count,
+            push_constant_ranges,
+            attribute_stride,
+            instanced ? instance_attribute_stride : 0,
+            viewport,
+            scissor,
+            false,
+            true
         );
+    };
+
 
-        if (!b_resource) {
-            ERROR("Unable to read shader module: %s.", shader_name.c_str());
+    b8 VulkanShader::CreateInstanceUniformBuffer() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanDevice* device = backend->GetVulkanDevice();
+
+        instance_copy_count = std::min<u32>(backend->GetVulkanSwapchain()->max_frames_in_flight, 3);
+        u64 size = std::max<u64>(ubo_stride, required_ubo_alignment) * VULKAN_SHADER_MAX_OBJECT_COUNT * instance_copy_count;
+
+        u32 device_local_bits = device->supports_device_local_host_visible ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : 0;
+        instance_uniform_buffer = new VulkanBuffer(
+            size,
+            (VkBufferUsageFlagBits)(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT),
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | device_local_bits,
+            false
+        );
+        if (!instance_uniform_buffer->ready) {
+            delete instance_uniform_buffer;
+            instance_uniform_buffer = nullptr;
             return false;
         }
+        mapped_instance_uniform_buffer = (u8*)instance_uniform_buffer->LockMemory(0, VK_WHOLE_SIZE, 0);
+        return true;
+    };
 
-        std::vector<c8> bytes = b_resource->GetData();
+    void VulkanShader::CreateSamplerUpdateTemplate() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanDevice* device = backend->GetVulkanDevice();
 
-        if (bytes.size() == 0) {
-            ERROR("Unable to binary read shader module: %s.", shader_name.c_str());
-            return false;
+        VulkanShaderDescrptorSetConfig& instance_set = descriptor_sets[(u32)ShaderScope::INSTANCE];
+        if (!(instance_set.flags & VulkanShaderDescriptorBindingFlags::SAMPLER) || device->properties.apiVersion < VK_API_VERSION_1_1) {
+            return;
         }
-        
-        out_shader_stage->create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        out_shader_stage->create_info.codeSize = bytes.size();
-        out_shader_stage->create_info.pCode = (u32*)bytes.data();
 
-        VK_CHECK(vkCreateShaderModule(
-            backend->GetVulkanDevice()->logical_device,
-            &out_shader_stage->create_info,
-            backend->GetVulkanAllocator(),
-            &out_shader_stage->handle));
+        // Matches the image info array built by WriteInstanceSamplers.
+        VkDescriptorUpdateTemplateEntry entry = {};
+        entry.dstBinding = (u32)VulkanShaderDescriptorBindingIndex::SAMPLER;
+        entry.dstArrayElement = 0;
+        entry.descriptorCount = instance_set.bindings[(u32)VulkanShaderDescriptorBindingIndex::SAMPLER].descriptorCount;
+        entry.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        entry.offset = 0;
+        entry.stride = sizeof(VkDescriptorImageInfo);
+
+        VkDescriptorUpdateTemplateCreateInfo template_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO};
+        template_info.descriptorUpdateEntryCount = 1;
+        template_info.pDescriptorUpdateEntries = &entry;
+        template_info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        template_info.descriptorSetLayout = descriptor_set_layouts[(u32)ShaderScope::INSTANCE];
+        VkResult result = vkCreateDescriptorUpdateTemplate(device->logical_device, &template_info, backend->GetVulkanAllocator(), &sampler_update_template);
+        if (!IsVulkanResultSuccess(result)) {
+            WARN("VulkanShader::CreateSamplerUpdateTemplate - failed for shader '%s', using plain descriptor writes: '%s'", name.c_str(), VulkanResultString(result, true));
+            sampler_update_template = VK_NULL_HANDLE;
+        }
+    };
 
-        delete b_resource;
+    void VulkanShader::WriteInstanceSamplers(VulkanShaderInsanceState* state, VkDescriptorSet descriptor_set) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanDevice* device = backend->GetVulkanDevice();
 
-        Platform::ZrMemory(&out_shader_stage->shader_stage_create_info, sizeof(VkPipelineShaderStageCreateInfo));
-        out_shader_stage->shader_stage_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        out_shader_stage->shader_stage_create_info.stage = GetVkStageType(config);
-        out_shader_stage->shader_stage_create_info.module = out_shader_stage->handle;
-        out_shader_stage->shader_stage_create_info.pName = "main";
+        u32 sampler_count = descriptor_sets[(u32)ShaderScope::INSTANCE].bindings[(u32)VulkanShaderDescriptorBindingIndex::SAMPLER].descriptorCount;
+        VkDescriptorImageInfo image_infos[VULKAN_SHADER_MAX_INSTANCE_TEXTURES];
+        for (u32 i = 0; i < sampler_count; ++i) {
+            TextureMap* map = state->instance_texture_maps[i];
+            VulkanTexture* t = (VulkanTexture*)map->texture;
+            VulkanSampler* sampler = static_cast<VulkanSampler*>(map->sampler);
+            image_infos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            image_infos[i].imageView = t->GetImage()->view;
+            image_infos[i].sampler = sampler->GetSampler();
+        }
 
-        return true;
+        if (sampler_update_template) {
+            vkUpdateDescriptorSetWithTemplate(device->logical_device, descriptor_set, sampler_update_template, image_infos);
+        } else {
+            VkWriteDescriptorSet sampler_descriptor = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+            sampler_descriptor.dstSet = descriptor_set;
+            sampler_descriptor.dstBinding = (u32)VulkanShaderDescriptorBindingIndex::SAMPLER;
+            sampler_descriptor.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            sampler_descriptor.descriptorCount = sampler_count;
+            sampler_descriptor.pImageInfo = image_infos;
+            vkUpdateDescriptorSets(device->logical_device, 1, &sampler_descriptor, 0, 0);
+        }
+        backend->GetStats().descriptor_writes += sampler_count;
     };
 
-    void VulkanShader::Use() {
+    b8 VulkanShader::CreateMaterialBuffer() {
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        u32 image_index = backend->GetImageIndex();
-        VulkanCommandBuffer* command_buffer = backend->GetGraphicsCommandBufers()[image_index];
-        this->pipeline->Bind(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+        VulkanDevice* device = backend->GetVulkanDevice();
+
+        // Record layout matches a std430 struct of the instance uniforms in declaration order,
+        // followed by one uint per instance sampler.
+        u64 uniforms_end = 0;
+        for (ShaderUniformConfig& uniform : uniforms) {
+            if (uniform.scope == ShaderScope::INSTANCE && uniform.type != ShaderUniformType::SAMPLER) {
+                uniforms_end = std::max(uniforms_end, uniform.offset + uniform.size);
+            }
+        }
+        material_texture_offset = GetAligned(uniforms_end, sizeof(u32));
+        material_stride = GetAligned(material_texture_offset + sizeof(u32) * instance_texture_count, 16);
+        material_shadow.resize(material_stride * VULKAN_SHADER_MAX_OBJECT_COUNT);
+
+        // One copy of every record per frame in flight, a frame the GPU still draws never sees a record change.
+        instance_copy_count = std::min<u32>(backend->GetVulkanSwapchain()->max_frames_in_flight, 3);
+        material_copy_size = GetAligned(material_stride * VULKAN_SHADER_MAX_OBJECT_COUNT, device->properties.limits.minStorageBufferOffsetAlignment);
+
+        u32 device_local_bits = device->supports_device_local_host_visible ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : 0;
+        material_buffer = new VulkanBuffer(
+            material_copy_size * instance_copy_count,
+            (VkBufferUsageFlagBits)(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT),
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | device_local_bits,
+            false
+        );
+        if (!material_buffer->ready) {
+            delete material_buffer;
+            material_buffer = nullptr;
+            return false;
+        }
+        mapped_material_buffer = (u8*)material_buffer->LockMemory(0, VK_WHOLE_SIZE, 0);
+
+        VkDescriptorSetLayoutBinding binding = {};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        material_set_layout = backend->GetPipelineStateCache()->AcquireSetLayout(1, &binding);
+        if (!material_set_layout) {
+            ERROR("VulkanShader::CreateMaterialBuffer - failed creating descriptor set layout.");
+            return false;
+        }
+
+        VkDescriptorSetLayout layouts[3] = {material_set_layout, material_set_layout, material_set_layout};
+        VkDescriptorSetAllocateInfo alloc_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        alloc_info.descriptorPool = descriptor_pool;
+        alloc_info.descriptorSetCount = instance_copy_count;
+        alloc_info.pSetLayouts = layouts;
+        VkResult result = vkAllocateDescriptorSets(device->logical_device, &alloc_info, material_sets);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanShader::CreateMaterialBuffer - failed allocating descriptor sets: '%s'", VulkanResultString(result, true));
+            return false;
+        }
+
+        // Written once, records change through the mapping.
+        VkDescriptorBufferInfo buffer_infos[3];
+        VkWriteDescriptorSet writes[3];
+        for (u32 i = 0; i < instance_copy_count; ++i) {
+            buffer_infos[i].buffer = material_buffer->handle;
+            buffer_infos[i].offset = material_copy_size * i;
+            buffer_infos[i].range = material_stride * VULKAN_SHADER_MAX_OBJECT_COUNT;
+
+            writes[i] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+            writes[i].dstSet = material_sets[i];
+            writes[i].dstBinding = 0;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].descriptorCount = 1;
+            writes[i].pBufferInfo = &buffer_infos[i];
+        }
+        vkUpdateDescriptorSets(device->logical_device, instance_copy_count, writes, 0, 0);
+
+        return true;
     };
 
+    void VulkanShader::WriteMaterialTextures(u32 instance_id) {
+        u32* slots = (u32*)(material_shadow.data() + instance_id * material_stride + material_texture_offset);
+        VulkanTexture* default_texture = (VulkanTexture*)TextureSystem::GetInstance()->GetDefaultTexture();
+
+        std::vector<TextureMap*>& maps = instance_states[instance_id].instance_texture_maps;
+        for (u32 i = 0; i < maps.size(); ++i) {
+            VulkanTexture* texture = maps[i] ? (VulkanTexture*)maps[i]->texture : nullptr;
+            VulkanSampler* sampler = maps[i] ? static_cast<VulkanSampler*>(maps[i]->sampler) : nullptr;
+
+            u32 texture_slot = texture ? texture->GetBindlessSlot() : INVALID_ID;
+            if (texture_slot == INVALID_ID) {
+                texture_slot = default_texture->GetBindlessSlot();
+            }
+            u32 sampler_slot = sampler ? sampler->GetBindlessSlot() : INVALID_ID;
+            slots[i] = VulkanBindlessPack(texture_slot, sampler_slot == INVALID_ID ? 0 : sampler_slot);
+        }
+        instance_states[instance_id].uniform_generation++;
+    };
 
     u32 VulkanShader::GetInstanceId() {
         if (!instance_states.size()) {
@@ -367,136 +648,135 @@ namespace Engine {
     };
 
     void VulkanShader::ApplyGlobals() {
-        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        VulkanDevice* device = backend->GetVulkanDevice();
-        u32 image_index = backend->GetImageIndex();
-        VulkanCommandBuffer* command_buffer = backend->GetGraphicsCommandBufers()[image_index];
-        VkDescriptorSet* global_descriptor = &global_descriptor_sets[image_index];
-
-        // Apply UBO first
-        VkDescriptorBufferInfo buffer_info;
-        buffer_info.buffer = uniform_buffer->handle;
-        buffer_info.offset = global_ubo.offset;
-        buffer_info.range = global_ubo_stride;
-
-        // Update descriptor sets.
-        VkWriteDescriptorSet ubo_write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-        ubo_write.dstSet = global_descriptor_sets[image_index];
-        ubo_write.dstBinding = 0;
-        ubo_write.dstArrayElement = 0;
-        ubo_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        ubo_write.descriptorCount = 1;
-        ubo_write.pBufferInfo = &buffer_info;
-
-        VkWriteDescriptorSet descriptor_writes[2] = {};
-        descriptor_writes[0] = ubo_write;
+        UpdateGlobals();
+        RecordGlobals();
+    };
 
-        u32 global_set_binding_count = descriptor_sets[(u32)ShaderScope::GLOBAL].bindings.size();
+    void VulkanShader::UpdateGlobals() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
 
-        if (global_set_binding_count > 1) {
+        if (descriptor_sets[(u32)ShaderScope::GLOBAL].bindings.size() > 1) {
             // TODO: There are samplers to be written. Support this.
-            global_set_binding_count = 1;
             ERROR("Global image samplers are not yet supported.");
+        }
 
-            // VkWriteDescriptorSet sampler_write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-            // descriptor_writes[1] = ...
+        // Fresh copy of the globals for this frame, bound through the dynamic offset.
+        VulkanUniformRing* ring = backend->GetUniformRing();
+        VulkanUniformAllocation allocation;
+        if (!ring->Allocate(global_ubo_stride, &allocation)) {
+            // The region is full, the shader's reserved block takes the globals for the rest of the frame.
+            // Later updates overwrite it, so draws recorded earlier in the frame see the newest values.
+            if (global_fallback_frame != ring->GetFrameNumber()) {
+                if (!ring->AllocateReserved(global_ubo_stride, &global_fallback)) {
+                    FATAL("VulkanShader::UpdateGlobals - no uniform space left for shader '%s', globals are stale.", name.c_str());
+                    return;
+                }
+                global_fallback_frame = ring->GetFrameNumber();
+                ERROR("VulkanShader::UpdateGlobals - uniform ring is full, shader '%s' shares one globals block this frame.", name.c_str());
+            }
+            allocation = global_fallback;
         }
+        Platform::CpMemory(allocation.data, uniform_shadow.data() + global_ubo.offset, global_ubo.size);
+        backend->GetStats().uniform_bytes += global_ubo.size;
+        global_ring_offset = allocation.offset;
+    };
 
-        vkUpdateDescriptorSets(device->logical_device, global_set_binding_count, descriptor_writes, 0, 0);
+    void VulkanShader::RecordGlobals() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanCommandBuffer* command_buffer = backend->GetCurrentCommandBuffer();
+        VkDescriptorSet* global_descriptor = &global_descriptor_sets[backend->GetImageIndex()];
+
+        vkCmdBindDescriptorSets(command_buffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->pipeline_layout, 0, 1, global_descriptor, 1, &global_ring_offset);
 
-        // Bind the global descriptor set to be updated.
-        vkCmdBindDescriptorSets(command_buffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->pipeline_layout, 0, 1, global_descriptor, 0, 0);
+        // Material records and the texture table stay bound for every draw with this shader.
+        if (bindless) {
+            VkDescriptorSet* material_set = &material_sets[backend->GetCurrentFrame() % instance_copy_count];
+            vkCmdBindDescriptorSets(command_buffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->pipeline_layout, 1, 1, material_set, 0, 0);
+            backend->GetBindlessTable()->Bind(command_buffer->handle, pipeline->pipeline_layout);
+        }
     };
 
     void VulkanShader::ApplyInstance(b8 needs_update) {
+        UpdateInstance(needs_update);
+        RecordInstance(bound_instance_id);
+    };
+
+    void VulkanShader::UpdateInstance(b8 needs_update) {
         if (!use_instances) {
             ERROR("This shader does not use instances.");
             return;
         }
 
+        if (bindless) {
+            if (needs_update) {
+                WriteMaterialTextures(bound_instance_id);
+            }
+
+            // The record in this frame in flight's copy is only rewritten if it changed since that copy was made.
+            VulkanShaderInsanceState* state = &instance_states[bound_instance_id];
+            u32 copy_index = VulkanRendererBackend::GetInstance()->GetCurrentFrame() % instance_copy_count;
+            if (state->copy_generations[copy_index] != state->uniform_generation) {
+                u64 record_offset = bound_instance_id * material_stride;
+                Platform::CpMemory(mapped_material_buffer + copy_index * material_copy_size + record_offset, material_shadow.data() + record_offset, material_stride);
+                state->copy_generations[copy_index] = state->uniform_generation;
+                VulkanRendererBackend::GetInstance()->GetStats().uniform_bytes += material_stride;
+            }
+            return;
+        }
+
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-        VulkanDevice* device = backend->GetVulkanDevice();
         u32 image_index = backend->GetImageIndex();
-        VulkanCommandBuffer* command_buffer = backend->GetGraphicsCommandBufers()[image_index];
-
         VulkanShaderInsanceState* state = &instance_states[bound_instance_id];
         VkDescriptorSet object_descriptor_set = state->descriptor_set_state.descriptor_sets[image_index];
 
-        if (needs_update) {
-            VkWriteDescriptorSet descriptor_writes[2];  // TODO: Always a max of 2 descriptor sets, adding more needs to make it dynamic.
-            Platform::ZrMemory(descriptor_writes, sizeof(VkWriteDescriptorSet) * 2);
-            u32 descriptor_count = 0;
-            u32 descriptor_index = 0;
-
-            // Descriptor 0 - Uniform buffer
-            // Only do this if the descriptor has not yet been updated.
-            u8* instance_ubo_generation = &state->descriptor_set_state.descriptor_states[descriptor_index].generations[image_index];
-            // TODO: determine if update is required.
-            if (*instance_ubo_generation == INVALID_ID_U8 /*|| *global_ubo_generation != material->generation*/) {
-                VkDescriptorBufferInfo buffer_info;
-                buffer_info.buffer = uniform_buffer->handle;
-                buffer_info.offset = state->offset;
-                buffer_info.range = ubo_stride;
-
-                VkWriteDescriptorSet ubo_descriptor = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-                ubo_descriptor.dstSet = object_descriptor_set;
-                ubo_descriptor.dstBinding = descriptor_index;
-                ubo_descriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                ubo_descriptor.descriptorCount = 1;
-                ubo_descriptor.pBufferInfo = &buffer_info;
-
-                descriptor_writes[descriptor_count] = ubo_descriptor;
-                descriptor_count++;
-
-                // Update the frame generation. In this case it is only needed once since this is a buffer.
-                *instance_ubo_generation = 1;  // material->generation; TODO: some generation from... somewhere
+        // Descriptor 0 - Uniform buffer
+        // The copy for this frame in flight is only rewritten if the material set uniforms since it was made.
+        u32 copy_index = backend->GetCurrentFrame() % instance_copy_count;
+        u32 copy_offset = (u32)(((u64)copy_index * VULKAN_SHADER_MAX_OBJECT_COUNT + state->id) * ubo_stride);
+        if (state->copy_generations[copy_index] != state->uniform_generation) {
+            Platform::CpMemory(mapped_instance_uniform_buffer + copy_offset, uniform_shadow.data() + state->offset, ubo_stride);
+            state->copy_generations[copy_index] = state->uniform_generation;
+            backend->GetStats().uniform_bytes += ubo_stride;
+        }
+
+        // Descriptor 1 - Samplers
+        // Each image's set is rewritten once after the material changed its maps.
+        if (descriptor_sets[(u32)ShaderScope::INSTANCE].flags & VulkanShaderDescriptorBindingFlags::SAMPLER) {
+            u32* set_generation = &state->descriptor_set_state.descriptor_states[(u32)VulkanShaderDescriptorBindingIndex::SAMPLER].generations[image_index];
+            if (*set_generation != state->sampler_generation) {
+                WriteInstanceSamplers(state, object_descriptor_set);
+                *set_generation = state->sampler_generation;
             }
-            descriptor_index++;
-
-            // Samplers will always be in the binding. If the binding count is less than 2, there are no samplers.
-            if (descriptor_sets[(u32)ShaderScope::INSTANCE].flags & VulkanShaderDescriptorBindingFlags::SAMPLER) {
-                // Iterate samplers.
-                u32 total_sampler_count = descriptor_sets[(u32)ShaderScope::INSTANCE].bindings[(u32)VulkanShaderDescriptorBindingIndex::SAMPLER].descriptorCount;
-                u32 update_sampler_count = 0;
-                VkDescriptorImageInfo image_infos[VULKAN_SHADER_MAX_INSTANCE_TEXTURES];
-                for (u32 i = 0; i < total_sampler_count; ++i) {
-                    // TODO: only update in the list if actually needing an update.
-                    TextureMap* map = instance_states[bound_instance_id].instance_texture_maps[i];
-                    VulkanTexture* t = (VulkanTexture*)map->texture;
-                    VulkanSampler* sampler = static_cast<VulkanSampler*>(map->sampler);
-                    image_infos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                    image_infos[i].imageView = t->GetImage()->view;
-                    image_infos[i].sampler = sampler->GetSampler();
-
-                    // TODO: change up descriptor state to handle this properly.
-                    // Sync frame generation if not using a default texture.
-                    // if (t->generation != INVALID_ID) {
-                    //     *descriptor_generation = t->generation;
-                    //     *descriptor_id = t->id;
-                    // }
-
-                    update_sampler_count++;
-                }
-
-                VkWriteDescriptorSet sampler_descriptor = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-                sampler_descriptor.dstSet = object_descriptor_set;
-                sampler_descriptor.dstBinding = descriptor_index;
-                sampler_descriptor.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                sampler_descriptor.descriptorCount = update_sampler_count;
-                sampler_descriptor.pImageInfo = image_infos;
+        }
+    };
 
-                descriptor_writes[descriptor_count] = sampler_descriptor;
-                descriptor_count++;
-            }
+    void VulkanShader::RecordInstance(u32 instance_id) {
+        // UpdateInstance already reported it.
+        if (!use_instances) {
+            return;
+        }
 
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanCommandBuffer* command_buffer = backend->GetCurrentCommandBuffer();
 
-            if (descriptor_count > 0) {
-                vkUpdateDescriptorSets(device->logical_device, descriptor_count, descriptor_writes, 0, 0);
-            }
+        // Only the record index changes between materials, instanced draws take it from the context.
+        if (bindless) {
+            backend->GetRecordingContext()->material_index = instance_id;
+            vkCmdPushConstants(
+                command_buffer->handle,
+                pipeline->pipeline_layout,
+                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                material_index_uniform->offset, sizeof(u32), &instance_id);
+            return;
         }
- 
-        // Bind the descriptor set to be updated, or in case the shader changed.
-        vkCmdBindDescriptorSets(command_buffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->pipeline_layout, 1, 1, &object_descriptor_set, 0, 0);
+
+        // The copy UpdateInstance left for this frame in flight.
+        VulkanShaderInsanceState* state = &instance_states[instance_id];
+        VkDescriptorSet object_descriptor_set = state->descriptor_set_state.descriptor_sets[backend->GetImageIndex()];
+        u32 copy_index = backend->GetCurrentFrame() % instance_copy_count;
+        u32 copy_offset = (u32)(((u64)copy_index * VULKAN_SHADER_MAX_OBJECT_COUNT + state->id) * ubo_stride);
+
+        vkCmdBindDescriptorSets(command_buffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->pipeline_layout, 1, 1, &object_descriptor_set, 1, &copy_offset);
     };
 
     u32 VulkanShader::AcquireInstanceResources(std::vector<TextureMap*> texture_maps) {
@@ -509,16 +789,22 @@ namespace Engine {
                 instance_id = i;
             } 
         }
-        VulkanShaderInsanceState* instance_state;
         if (instance_id == INVALID_ID) {
-            VulkanShaderInsanceState inst_st = {};
-            inst_st.id = instance_states.size();
-            inst_st.offset = global_ubo_stride + ubo_stride * inst_st.id;
-            instance_states.push_back(inst_st);
-            instance_id = inst_st.id;
-            instance_state = &instance_states[inst_st.id];
-        } else {
-            instance_state = &instance_states[instance_id];
+            instance_id = instance_states.size();
+            if (instance_id >= VULKAN_SHADER_MAX_OBJECT_COUNT) {
+                ERROR("VulkanShader::AcquireInstanceResources - failed, shader '%s' is out of instance slots.", name.c_str());
+                return INVALID_ID;
+            }
+            instance_states.push_back({});
+        }
+
+        VulkanShaderInsanceState* instance_state = &instance_states[instance_id];
+        instance_state->id = instance_id;
+        instance_state->offset = global_ubo_stride + ubo_stride * instance_id;
+        instance_state->uniform_generation = 0;
+        instance_state->sampler_generation = 0;
+        for (u32 i = 0; i < 3; ++i) {
+            instance_state->copy_generations[i] = INVALID_ID;
         }
 
         u32 texture_count = descriptor_sets[(u32)ShaderScope::INSTANCE].bindings[(u32)VulkanShaderDescriptorBindingIndex::SAMPLER].descriptorCount;
@@ -527,20 +813,20 @@ namespace Engine {
         for (u32 i = 0; i < texture_count; ++i) {
             instance_state->instance_texture_maps[i] = texture_maps[i];
         }
-        
-        FreelistNode* node = uniform_buffer->Allocate(ubo_stride);
-        if (!node) {
-            ERROR("VulkanShader::AcquireInstanceResources - failed, can't allocate instance UBO in shader '%s", name.c_str());
-            return INVALID_ID;
+
+        // Bindless instances are a record in the material buffer, no UBO block or descriptor sets.
+        if (bindless) {
+            Platform::ZrMemory(material_shadow.data() + instance_id * material_stride, material_stride);
+            return instance_id;
         }
 
-        instance_state->allocated_block = node;
+        Platform::ZrMemory(uniform_shadow.data() + instance_state->offset, ubo_stride);
 
         VulkanShaderDescriptorSetState* set_state = &instance_state->descriptor_set_state;
         u32 binding_count = descriptor_sets[(u32)ShaderScope::INSTANCE].bindings.size();
         for (u32 i = 0; i < binding_count; ++i) {
             for (u32 j = 0; j < 3; ++j) {
-                set_state->descriptor_states[i].generations[j] = INVALID_ID_U8;
+                set_state->descriptor_states[i].generations[j] = INVALID_ID;
                 set_state->descriptor_states[i].ids[j] = INVALID_ID;
             }
         }
@@ -560,9 +846,28 @@ namespace Engine {
             instance_state->descriptor_set_state.descriptor_sets);
         if (result != VK_SUCCESS) {
             ERROR("Error allocating instance descriptor sets in shader: '%s'.", VulkanResultString(result, true));
-            return false;
+            instance_state->id = INVALID_ID;
+            return INVALID_ID;
         }
 
+        // Written once, the offset of the frame copy is passed when binding.
+        VkDescriptorBufferInfo buffer_info;
+        buffer_info.buffer = instance_uniform_buffer->handle;
+        buffer_info.offset = 0;
+        buffer_info.range = ubo_stride;
+
+        VkWriteDescriptorSet ubo_writes[3];
+        for (u32 i = 0; i < 3; ++i) {
+            ubo_writes[i] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+            ubo_writes[i].dstSet = instance_state->descriptor_set_state.descriptor_sets[i];
+            ubo_writes[i].dstBinding = (u32)VulkanShaderDescriptorBindingIndex::UBO;
+            ubo_writes[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+            ubo_writes[i].descriptorCount = 1;
+            ubo_writes[i].pBufferInfo = &buffer_info;
+        }
+        vkUpdateDescriptorSets(device->logical_device, 3, ubo_writes, 0, 0);
+        backend->GetStats().descriptor_writes += 3;
+
         return instance_id;
     };
 
@@ -572,26 +877,33 @@ namespace Engine {
 
         VulkanShaderInsanceState* state = &instance_states[instance_id];
 
-        vkDeviceWaitIdle(device->logical_device);
+        if (bindless) {
+            state->instance_texture_maps.clear();
+            state->offset = INVALID_ID;
+            state->id = INVALID_ID;
+            return;
+        }
 
-        // Free 3 descriptor sets (one per frame)
-        VkResult result = vkFreeDescriptorSets(
-            device->logical_device,
-            descriptor_pool,
-            3,
-            state->descriptor_set_state.descriptor_sets);
-        if (result != VK_SUCCESS) {
-            ERROR("Error freeing object shader descriptor sets!");
+        // Free 3 descriptor sets (one per frame), once the frames in flight stop binding them
+        if (backend->GetDeletionQueue()) {
+            backend->GetDeletionQueue()->FreeDescriptorSets(descriptor_pool, 3, state->descriptor_set_state.descriptor_sets);
+        } else {
+            VkResult result = vkFreeDescriptorSets(
+                device->logical_device,
+                descriptor_pool,
+                3,
+                state->descriptor_set_state.descriptor_sets);
+            if (result != VK_SUCCESS) {
+                ERROR("Error freeing object shader descriptor sets!");
+            }
         }
 
-        Platform::ZrMemory(state->descriptor_set_state.descriptor_states, sizeof(VulkanShaderDescriptorSetState) * VULKAN_SHADER_MAX_BINDINGS);
+        Platform::ZrMemory(state->descriptor_set_state.descriptor_states, sizeof(VulkanShaderDescriptorState) * VULKAN_SHADER_MAX_BINDINGS);
 
         if (state->instance_texture_maps.size()) {
             state->instance_texture_maps.clear();
         }
 
-        //uniform_buffer->Free(state->offset);
-        state->allocated_block->FreeBlock();
         state->offset = INVALID_ID;
         state->id = INVALID_ID;
     };
@@ -603,14 +915,12 @@ namespace Engine {
                 return true;
             } 
             instance_states[bound_instance_id].instance_texture_maps[uniform->location] = (TextureMap*)value;
+            instance_states[bound_instance_id].sampler_generation++;
             return true;
         } 
 
         if (uniform->scope == ShaderScope::LOCAL) {
-            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
-            VulkanDevice* device = backend->GetVulkanDevice();
-            u32 image_index = backend->GetImageIndex();
-            VulkanCommandBuffer* command_buffer = backend->GetGraphicsCommandBufers()[image_index];
+            VulkanCommandBuffer* command_buffer = VulkanRendererBackend::GetInstance()->GetCurrentCommandBuffer();
 
             vkCmdPushConstants(
                 command_buffer->handle, 
@@ -621,9 +931,19 @@ namespace Engine {
             return true;
         } 
         
-        u64 addr = (u64)mapped_uniform_buffer_block;
-        addr += bound_ubo_offset + uniform->offset;
-        Platform::CpMemory((void*)addr, value, uniform->size);
+        // Lands in the frame's copy of the record when the instance gets applied.
+        if (bindless && uniform->scope == ShaderScope::INSTANCE) {
+            u8* record = material_shadow.data() + bound_instance_id * material_stride;
+            Platform::CpMemory(record + uniform->offset, value, uniform->size);
+            instance_states[bound_instance_id].uniform_generation++;
+            return true;
+        }
+
+        // Lands on the GPU when the globals or the instance get applied.
+        Platform::CpMemory(uniform_shadow.data() + bound_ubo_offset + uniform->offset, value, uniform->size);
+        if (uniform->scope == ShaderScope::INSTANCE) {
+            instance_states[bound_instance_id].uniform_generation++;
+        }
 
         return true;
     };
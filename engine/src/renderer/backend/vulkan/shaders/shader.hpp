@@ -5,6 +5,7 @@
 #include "../pipeline.hpp"
 #include "../buffer.hpp"
 #include "../texture.hpp"
+#include "../uniform_ring.hpp"
 #include "renderer/renderer_types.hpp"
 #include "renderer/backend/vulkan/vulkan_types.inl"
 #include "resources/material/material.hpp"
@@ -18,6 +19,11 @@
 #define VULKAN_SHADER_MAX_INSTANCE_TEXTURES 31
 /** @brief The maximum number of vertex input attributes allowed. */
 #define VULKAN_SHADER_MAX_ATTRIBUTES 16
+/**
+ * @brief Location of the per instance material record index instanced variants
+ * read from binding 2, past the attributes a shader declares.
+ */
+#define VULKAN_SHADER_MATERIAL_INDEX_LOCATION (VULKAN_SHADER_MAX_ATTRIBUTES - 1)
 /**
  * @brief The maximum number of uniforms and samplers allowed at the
  * global, instance and local levels combined. It's probably more than
@@ -34,14 +40,16 @@
 namespace Engine {
 
     struct VulkanShaderStage {
-        VkShaderModuleCreateInfo create_info;
+        // Owned by the backend shader module cache
         VkShaderModule handle;
         VkPipelineShaderStageCreateInfo shader_stage_create_info;
+        b8 instanced;
+        b8 bindless;
     };
 
     struct VulkanShaderDescriptorState {
-        // One per frame
-        u8 generations[3];
+        // One per descriptor set, the instance generation the set was last written with.
+        u32 generations[3];
         u32 ids[3];
     };
 
@@ -52,8 +60,13 @@ namespace Engine {
 
     struct VulkanShaderInsanceState {
         u32 id;
+        // Offset of the instance block in uniform_shadow.
         u64 offset;
-        FreelistNode* allocated_block;
+        // Bumped whenever the material sets a uniform or a sampler.
+        u32 uniform_generation;
+        u32 sampler_generation;
+        // Uniform generation held by each frame in flight copy of the block.
+        u32 copy_generations[3];
         VulkanShaderDescriptorSetState descriptor_set_state;
         std::vector<TextureMap*> instance_texture_maps;
     };
@@ -97,12 +110,18 @@ namespace Engine {
             ~VulkanShader();
 
             void Use();
+            void UseInstanced();
             void BindGlobals();
             void BindInstance(u32 instance_id);
 
             void ApplyGlobals();
             void ApplyInstance(b8 needs_update);
 
+            void UpdateGlobals();
+            void UpdateInstance(b8 needs_update);
+            void RecordGlobals();
+            void RecordInstance(u32 instance_id);
+
             u32 AcquireInstanceResources(std::vector<TextureMap*> texture_maps);
             void ReleaseInstanceResources(u32 instance_id);
 
@@ -124,22 +143,56 @@ namespace Engine {
 
             std::vector<VulkanShaderStage> stages;
 
-            FreelistNode* global_ubo_block;
+            // CPU copy of the global block followed by every instance block, see ApplyGlobals and ApplyInstance.
+            std::vector<u8> uniform_shadow;
+
+            // Per material blocks, one copy per frame in flight, rewritten only when the material changed.
+            VulkanBuffer* instance_uniform_buffer;
+            u32 instance_copy_count;
+            // Writes every instance sampler in one call, null if the device can't use templates.
+            VkDescriptorUpdateTemplate sampler_update_template;
+
+            // Bindless mode, one record per instance holding its uniforms followed by a packed
+            // texture and sampler slot per instance sampler. Shaders index it with material_index.
+            // Like instance blocks, records are written to material_shadow and copied to the frame in
+            // flight's copy of the buffer when applied, each copy with its own set.
+            VulkanBuffer* material_buffer;
+            VkDescriptorSetLayout material_set_layout;
+            VkDescriptorSet material_sets[3];
+            std::vector<u8> material_shadow;
+            u64 material_copy_size;
+            u64 material_stride;
+            u64 material_texture_offset;
 
-            VulkanBuffer* uniform_buffer;
             VulkanPipeline* pipeline;
+            // Same layouts as pipeline, so descriptor sets stay bound when switching between the two.
+            VulkanPipeline* instanced_pipeline;
 
             u16 max_descriptor_set_count;
 
         private:
-            void* mapped_uniform_buffer_block;
+            u8* mapped_material_buffer;
+            u8* mapped_instance_uniform_buffer;
+            ShaderUniformConfig* material_index_uniform;
 
             std::vector<VulkanShaderInsanceState> instance_states;
 
             u64 bound_ubo_offset;
             u64 bound_instance_id;
+            // Ring offset of the globals last uploaded by UpdateGlobals, always a valid block to bind.
+            u32 global_ring_offset;
+            // Headroom reserved in the ring for when a frame region runs full, see UpdateGlobals.
+            u64 global_ring_reserved;
+            VulkanUniformAllocation global_fallback;
+            u64 global_fallback_frame;
 
             VkShaderStageFlagBits GetVkStageType (ShaderStageConfig& stage);
+            VulkanPipeline* CreatePipeline(b8 instanced, VkViewport viewport, VkRect2D scissor);
+            b8 CreateInstanceUniformBuffer();
+            void CreateSamplerUpdateTemplate();
+            void WriteInstanceSamplers(VulkanShaderInsanceState* state, VkDescriptorSet descriptor_set);
+            b8 CreateMaterialBuffer();
+            void WriteMaterialTextures(u32 instance_id);
             u32 GetInstanceId();
 
             u32 descriptor_set_count = 0;
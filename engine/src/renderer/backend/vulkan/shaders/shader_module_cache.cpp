@@ -0,0 +1,106 @@
+#include "shader_module_cache.hpp"
+
+#include "core/logger/logger.hpp"
+#include "core/utils/hash.hpp"
+#include "core/utils/string.hpp"
+#include "../helpers.hpp"
+#include "../vulkan.hpp"
+#include "systems/resource/resource_system.hpp"
+
+namespace Engine {
+
+    VulkanShaderModuleCache::~VulkanShaderModuleCache() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        for (auto& [hash, reference] : modules) {
+            WARN("Shader module %llu still has %u references on shutdown.", hash, reference.ref_count);
+            vkDestroyShaderModule(
+                backend->GetVulkanDevice()->logical_device,
+                reference.handle,
+                backend->GetVulkanAllocator());
+        }
+        modules.clear();
+        path_hashes.clear();
+    };
+
+    VkShaderModule VulkanShaderModuleCache::Acquire(const std::string& file_path) {
+        // Known path, skip reading and hashing the file again
+        auto path_it = path_hashes.find(file_path);
+        if (path_it != path_hashes.end()) {
+            auto module_it = modules.find(path_it->second);
+            if (module_it != modules.end()) {
+                module_it->second.ref_count++;
+                return module_it->second.handle;
+            }
+        }
+
+        ResourceSystem* resource_system = ResourceSystem::GetInstance();
+        std::string full_path = StringFormat("%s/%s", resource_system->CreateLoaderPath().c_str(), file_path.c_str());
+
+        std::vector<c8> code;
+        if (!resource_system->GetFileSystem()->ReadAll(full_path, code) || code.size() == 0) {
+            ERROR("Unable to read shader module: %s.", file_path.c_str());
+            return VK_NULL_HANDLE;
+        }
+
+        u64 hash = HashFNV1a(code.data(), code.size());
+        path_hashes[file_path] = hash;
+
+        auto module_it = modules.find(hash);
+        if (module_it != modules.end()) {
+            if (module_it->second.code == code) {
+                module_it->second.ref_count++;
+                return module_it->second.handle;
+            }
+            ERROR("Shader module hash collision for '%s', module is not shared.", file_path.c_str());
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        VkShaderModuleCreateInfo create_info = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+        create_info.codeSize = code.size();
+        create_info.pCode = (u32*)code.data();
+
+        VkShaderModule handle = VK_NULL_HANDLE;
+        VkResult result = vkCreateShaderModule(
+            backend->GetVulkanDevice()->logical_device,
+            &create_info,
+            backend->GetVulkanAllocator(),
+            &handle);
+
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("vkCreateShaderModule failed for '%s' with %s.", file_path.c_str(), VulkanResultString(result, true));
+            return VK_NULL_HANDLE;
+        }
+
+        if (module_it == modules.end()) {
+            modules[hash] = { handle, hash, 1, std::move(code) };
+        }
+        return handle;
+    };
+
+    void VulkanShaderModuleCache::Release(VkShaderModule module) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        for (auto it = modules.begin(); it != modules.end(); ++it) {
+            if (it->second.handle != module) {
+                continue;
+            }
+
+            if (--it->second.ref_count == 0) {
+                vkDestroyShaderModule(
+                    backend->GetVulkanDevice()->logical_device,
+                    it->second.handle,
+                    backend->GetVulkanAllocator());
+                modules.erase(it);
+            }
+            return;
+        }
+
+        // Not shared (hash collision), owned by the caller alone
+        vkDestroyShaderModule(
+            backend->GetVulkanDevice()->logical_device,
+            module,
+            backend->GetVulkanAllocator());
+    };
+
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+
+namespace Engine {
+
+    struct VulkanShaderModuleReference {
+        VkShaderModule handle;
+        u64 hash;
+        u32 ref_count;
+        std::vector<c8> code;
+    };
+
+    // Shader modules shared by SPIR-V content, several shaders and stages may point at the same .spv
+    // or at identical binaries under different names.
+    class VulkanShaderModuleCache {
+        public:
+            VulkanShaderModuleCache() {};
+            ~VulkanShaderModuleCache();
+
+            VkShaderModule Acquire(const std::string& file_path);
+            void Release(VkShaderModule module);
+
+        private:
+            std::unordered_map<std::string, u64> path_hashes;
+            std::unordered_map<u64, VulkanShaderModuleReference> modules;
+    };
+
+};
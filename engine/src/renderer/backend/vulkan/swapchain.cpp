@@ -8,12 +8,22 @@ namespace Engine {
 
     VulkanSwapchain::VulkanSwapchain(
         u32 width,
-        u32 height) {
+        u32 height,
+        b8 offscreen) {
             
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
 
         ready = false;
-        depth_texture = nullptr;
+        this->offscreen = offscreen;
+        this->handle = VK_NULL_HANDLE;
+        this->width = width;
+        this->height = height;
+        this->next_image = 0;
+        this->frame_count = 0;
+
+        if (offscreen) {
+            return CreateOffscreen(width, height);
+        }
  
         VkExtent2D swapchain_extent = {width, height};
 
@@ -149,28 +159,6 @@ namespace Engine {
             return;
         }
 
-        // Create depth buffer
-        VulkanImage* depth_image = new VulkanImage(
-            VK_IMAGE_TYPE_2D,
-            swapchain_extent.width,
-            swapchain_extent.height,
-            backend->GetVulkanDevice()->depth_format,
-            VK_IMAGE_TILING_OPTIMAL,
-            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            true,
-            VK_IMAGE_ASPECT_DEPTH_BIT
-        );
-
-        TextureCreateInfo create_info;
-        create_info.name = "__swapchain_default_depth_texture__";
-        create_info.channel_count = 4;
-        create_info.flags = TextureFlag::IS_WRITEABLE | TextureFlag::IS_WRAPPED;
-        create_info.height = height;
-        create_info.width = width;
-
-        this->depth_texture = new VulkanTexture(create_info, depth_image);
-
         DEBUG("Swapchain created successfully.");
         ready = true;
     }
@@ -180,20 +168,185 @@ namespace Engine {
 
         vkDeviceWaitIdle(backend->GetVulkanDevice()->logical_device);
 
-        // Destroying depth attachment
-        DEBUG("|_Destroying depth attachment...");
-        delete depth_texture;
-        
         // Destroying swapchain render textures
         DEBUG("|_Destroying swapchain render textures...");
         for (u32 i = 0; i < this->image_count; ++i) {
             delete this->render_textures[i];
         }
+        for (VulkanReadbackSlot& slot : readbacks) {
+            slot.buffer->UnlockMemory();
+            delete slot.buffer;
+        }
+        readbacks.clear();
 
-        vkDestroySwapchainKHR(
-            backend->GetVulkanDevice()->logical_device,
-            this->handle,
-            backend->GetVulkanAllocator());
+        // The device is idle, views of the presentable images must go before the swapchain does.
+        if (backend->GetDeletionQueue()) {
+            backend->GetDeletionQueue()->Flush();
+        }
+
+        if (this->handle) {
+            vkDestroySwapchainKHR(
+                backend->GetVulkanDevice()->logical_device,
+                this->handle,
+                backend->GetVulkanAllocator());
+        }
+    };
+
+    void VulkanSwapchain::CreateOffscreen(u32 width, u32 height) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        // Laid out like the preferred surface format so shaders and readbacks see the same bytes.
+        this->image_format.format = VK_FORMAT_B8G8R8A8_UNORM;
+        this->image_format.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+        this->image_count = VULKAN_OFFSCREEN_IMAGE_COUNT;
+        this->max_frames_in_flight = image_count - 1;
+
+        u64 readback_size = (u64)width * height * 4;
+        this->render_textures.resize(this->image_count);
+        this->readbacks.resize(this->image_count);
+        for (u32 i = 0; i < this->image_count; ++i) {
+            VulkanImage* image = new VulkanImage(
+                VK_IMAGE_TYPE_2D,
+                width,
+                height,
+                this->image_format.format,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                true, VK_IMAGE_ASPECT_COLOR_BIT
+            );
+
+            TextureCreateInfo create_info;
+            create_info.name = StringFormat("__offscreen_render_target_image_%u__", i);
+            create_info.channel_count = 4;
+            create_info.flags = TextureFlag::IS_WRITEABLE | TextureFlag::IS_WRAPPED;
+            create_info.height = height;
+            create_info.width = width;
+            this->render_textures[i] = new VulkanTexture(create_info, image);
+
+            VulkanReadbackSlot& slot = readbacks[i];
+            slot.buffer = new VulkanBuffer(
+                readback_size,
+                VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                false);
+            if (!slot.buffer->ready) {
+                ERROR("VulkanSwapchain - failed to create offscreen readback buffer.");
+                return;
+            }
+            slot.mapped = (u8*)slot.buffer->LockMemory(0, readback_size, 0);
+            slot.value = 0;
+            slot.frame = 0;
+            slot.pending = false;
+        }
+
+        if (!backend->GetVulkanDevice()->DetectDepthFormat()) {
+            FATAL("Failed to find supported depth format.");
+            return;
+        }
+
+        DEBUG("Offscreen swapchain created, %u images of %ux%u.", image_count, width, height);
+        ready = true;
+    };
+
+    void VulkanSwapchain::RecordReadback(VulkanCommandBuffer* command_buffer, u32 image_index) {
+        VulkanImage* image = render_textures[image_index]->GetImage();
+        VulkanReadbackSlot& slot = readbacks[image_index];
+
+        // The last pass left the image in TRANSFER_SRC_OPTIMAL, only its writes need to be made visible.
+        VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image->handle;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(
+            command_buffer->handle,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        VkBufferImageCopy region = {};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent.width = width;
+        region.imageExtent.height = height;
+        region.imageExtent.depth = 1;
+        vkCmdCopyImageToBuffer(command_buffer->handle, image->handle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.buffer->handle, 1, &region);
+
+        VkMemoryBarrier host_barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        host_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        host_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(
+            command_buffer->handle,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+            0, 1, &host_barrier, 0, nullptr, 0, nullptr);
+    };
+
+    void VulkanSwapchain::SubmitReadback(u32 image_index, u64 value) {
+        VulkanReadbackSlot& slot = readbacks[image_index];
+        slot.value = value;
+        slot.frame = frame_count++;
+        slot.pending = true;
+    };
+
+    b8 VulkanSwapchain::ReadFrame(RendererFrameReadback* out_readback, b8 wait) {
+        if (!offscreen) {
+            return false;
+        }
+        VulkanTimeline* timeline = VulkanRendererBackend::GetInstance()->GetFrameTimeline();
+
+        // Frames complete in order, the newest finished one wins and older unread ones are dropped.
+        VulkanReadbackSlot* newest = nullptr;
+        for (VulkanReadbackSlot& slot : readbacks) {
+            if (slot.pending && (!newest || slot.frame > newest->frame)) {
+                newest = &slot;
+            }
+        }
+        if (!newest) {
+            return false;
+        }
+        if (wait) {
+            if (!timeline->Wait(newest->value, UINT64_MAX)) {
+                return false;
+            }
+        } else {
+            u64 completed = timeline->GetCompleted();
+            newest = nullptr;
+            for (VulkanReadbackSlot& slot : readbacks) {
+                if (slot.pending && (!newest || slot.frame > newest->frame) && slot.value <= completed) {
+                    newest = &slot;
+                }
+            }
+            if (!newest) {
+                return false;
+            }
+        }
+
+        u64 frame = newest->frame;
+        for (VulkanReadbackSlot& slot : readbacks) {
+            if (slot.pending && slot.frame <= frame) {
+                slot.pending = false;
+            }
+        }
+
+        out_readback->frame = frame;
+        out_readback->width = width;
+        out_readback->height = height;
+        out_readback->pixels.resize((u64)width * height * 4);
+        Platform::CpMemory(out_readback->pixels.data(), newest->mapped, out_readback->pixels.size());
+        return true;
     };
 
     VkResult VulkanSwapchain::Present(
@@ -216,6 +369,13 @@ namespace Engine {
     VkResult VulkanSwapchain::AcquireNextImageIndex(u64 timeout_ns, VkSemaphore image_available_semaphore, VkFence fence, u32* out_index) {
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
 
+        // Round robin, the backend waits on the image's last frame before rendering into it again.
+        if (offscreen) {
+            *out_index = next_image;
+            next_image = (next_image + 1) % image_count;
+            return VK_SUCCESS;
+        }
+
         return vkAcquireNextImageKHR(
             backend->GetVulkanDevice()->logical_device,
             this->handle,
@@ -6,24 +6,42 @@
 #include "framebuffer.hpp"
 #include "texture.hpp"
 #include "render_target.hpp"
+#include "buffer.hpp"
+#include "timeline.hpp"
+#include "renderer/renderer.hpp"
+
+// Images rendered round robin without a surface, one less frame is kept in flight.
+#define VULKAN_OFFSCREEN_IMAGE_COUNT 3
 
 namespace Engine {
 
+    // Host copy of one offscreen image.
+    struct VulkanReadbackSlot {
+        VulkanBuffer* buffer;
+        u8* mapped;
+        // Frame timeline value of the submission that copied into the buffer.
+        u64 value;
+        u64 frame;
+        b8 pending;
+    };
+
     class VulkanSwapchain {
         public:
             VkSurfaceFormatKHR image_format;
             u8 max_frames_in_flight;
+            // Null when offscreen.
             VkSwapchainKHR handle;
             u32 image_count;
             std::vector<VulkanTexture*> render_textures;
-
-            VulkanTexture* depth_texture;
+            // Owns its images instead of presenting them, every frame is copied back to host memory.
+            b8 offscreen;
 
             b8 ready;
 
             VulkanSwapchain(
                 u32 width,
-                u32 height);
+                u32 height,
+                b8 offscreen = false);
 
             ~VulkanSwapchain();
 
@@ -35,6 +53,21 @@ namespace Engine {
             );
 
             VkResult AcquireNextImageIndex(u64 timeout_ns, VkSemaphore image_available_semaphore, VkFence fence, u32* out_index);
+
+            // Offscreen only. Copies the image into its readback buffer at the end of the frame's command buffer.
+            void RecordReadback(VulkanCommandBuffer* command_buffer, u32 image_index);
+            // Called once the frame is submitted, the copy is done when the frame timeline reaches the value.
+            void SubmitReadback(u32 image_index, u64 value);
+            b8 ReadFrame(RendererFrameReadback* out_readback, b8 wait);
+
+        private:
+            void CreateOffscreen(u32 width, u32 height);
+
+            u32 width;
+            u32 height;
+            u32 next_image;
+            u64 frame_count;
+            std::vector<VulkanReadbackSlot> readbacks;
     };
 
 };
\ No newline at end of file
@@ -8,12 +8,53 @@
 namespace Engine {
     VulkanTexture::VulkanTexture(TextureCreateInfo& info) : Texture(info) {
         image_format = ChannelCountToFormat(info.channel_count);
+        bindless_slot = INVALID_ID;
+
+        if (info.mip_chain) {
+            this->image = nullptr;
+            UploadMips(*info.mip_chain, info.resident_mip);
+            return;
+        }
 
         if (flags & TextureFlag::IS_WRITEABLE) {
             CreateWriteableTexture(info);
         }
 
         CreateReadonlyTexture(info);  
+        SyncBindlessSlot();
+    };
+
+    void VulkanTexture::SyncBindlessSlot() {
+        VulkanBindlessTable* table = VulkanRendererBackend::GetInstance()->GetBindlessTable();
+        if (!table || !image) {
+            return;
+        }
+
+        RetireBindlessSlot();
+        bindless_slot = table->RegisterTexture(image->view);
+    };
+
+    void VulkanTexture::RetireBindlessSlot() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        if (bindless_slot == INVALID_ID || !backend || !backend->GetBindlessTable()) {
+            bindless_slot = INVALID_ID;
+            return;
+        }
+
+        u32 slot = bindless_slot;
+        bindless_slot = INVALID_ID;
+        std::function<void()> release = [slot]() {
+            VulkanBindlessTable* table = VulkanRendererBackend::GetInstance()->GetBindlessTable();
+            if (table) {
+                table->ReleaseTexture(slot);
+            }
+        };
+        VulkanDeletionQueue* deletion_queue = backend->GetDeletionQueue();
+        if (deletion_queue) {
+            deletion_queue->Push(release);
+        } else {
+            release();
+        }
     };
 
     void VulkanTexture::CreateReadonlyTexture(TextureCreateInfo& info) {
@@ -54,6 +95,7 @@ namespace Engine {
 
     VulkanTexture::VulkanTexture(TextureCreateInfo& info, VulkanTextureImageInfo& image_info) : Texture(info) {
         this->image_format = image_info.format;
+        this->bindless_slot = INVALID_ID;
 
         this->image = new VulkanImage(
             width,
@@ -69,10 +111,13 @@ namespace Engine {
     VulkanTexture::VulkanTexture(TextureCreateInfo& info, VulkanImage* image) : Texture(info) {
         this->image_format = image->format;
         this->image = image;
+        this->bindless_slot = INVALID_ID;
         this->generation++;
     };
 
     VulkanTexture::~VulkanTexture() {
+        RetireBindlessSlot();
+
         if (this->image) {
             delete this->image;
         }
@@ -86,41 +131,67 @@ namespace Engine {
         VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
 
         VkDeviceSize image_size = width * height * channel_count;
-        VkBufferUsageFlagBits usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        VkMemoryPropertyFlags memory_prop_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        VulkanBuffer buffer = VulkanBuffer(
-            image_size, usage,
-            memory_prop_flags, true, false);
 
-        buffer.LoadData(0, image_size, 0, pixels);
+        // Copied with the next upload batch, before any frame that samples it.
+        if (!backend->GetUploader()->UploadImage(this->image, image_format, 1, nullptr, image_size, pixels)) {
+            ERROR("VulkanTexture::WriteData - failed to stage pixels for texture '%s'.", name.c_str());
+            return;
+        }
 
-        VkCommandPool pool = backend->GetVulkanDevice()->graphics_command_pool;
-        VkQueue queue = backend->GetVulkanDevice()->graphics_queue;
-        VulkanCommandBuffer command_buffer = VulkanCommandBuffer(pool, true);
-        command_buffer.BeginSingleUse();
+        this->generation++;
+    };
 
-        this->image->TransitionLayout(
-            &command_buffer,
-            image_format,
-            VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-        );
-        
-        this->image->CopyFromBuffer(
-            buffer.handle,
-            &command_buffer
-        );
+    b8 VulkanTexture::UploadMips(TextureMipChain& chain, u32 resident_mip) {
+        if (resident_mip >= chain.GetLevelCount()) {
+            ERROR("VulkanTexture::UploadMips - resident mip %u is out of range for texture '%s'.", resident_mip, name.c_str());
+            return false;
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        TextureMipLevel& base_level = chain.GetLevel(resident_mip);
+        u32 level_count = chain.GetLevelCount() - resident_mip;
 
-        this->image->TransitionLayout(
-            &command_buffer,
+        // Resident mips are a fresh image holding only the requested tail of the chain,
+        // so evicting detail actually gives the memory back.
+        VulkanImage* new_image = new VulkanImage(
+            VK_IMAGE_TYPE_2D,
+            base_level.width,
+            base_level.height,
             image_format,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_TRANSFER_SRC_BIT | 
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | 
+            VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            true, VK_IMAGE_ASPECT_COLOR_BIT,
+            level_count
         );
 
-        command_buffer.EndSingleUse(queue);
+        VkDeviceSize upload_size = chain.GetSize(resident_mip);
+        std::vector<u64> level_offsets(level_count);
+        u64 base_offset = base_level.offset;
+        for (u32 i = 0; i < level_count; ++i) {
+            level_offsets[i] = chain.GetLevel(resident_mip + i).offset - base_offset;
+        }
+
+        if (!backend->GetUploader()->UploadImage(new_image, image_format, level_count, level_offsets.data(), upload_size, chain.GetPixels(resident_mip))) {
+            ERROR("VulkanTexture::UploadMips - failed to stage mips for texture '%s'.", name.c_str());
+            delete new_image;
+            return false;
+        }
+
+        if (this->image) {
+            delete this->image;
+        }
+        this->image = new_image;
+        this->mip_levels = chain.GetLevelCount();
+        this->resident_mip = resident_mip;
+        SyncBindlessSlot();
 
         this->generation++;
+
+        return true;
     };
 
     void VulkanTexture::Resize(u32 width, u32 height) {
@@ -141,6 +212,7 @@ namespace Engine {
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             true, VK_IMAGE_ASPECT_COLOR_BIT
         );
+        SyncBindlessSlot();
 
         this->generation++;
     };
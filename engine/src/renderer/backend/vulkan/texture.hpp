@@ -20,18 +20,27 @@ namespace Engine {
             ~VulkanTexture();
 
             VulkanImage* GetImage() { return image; };
+            // Slot in the bindless table, INVALID_ID without one.
+            u32 GetBindlessSlot() { return bindless_slot; };
 
             void WriteData(const u8* pixels, u32 offset = 0, u32 size = 0) override;
             void Resize(u32 width, u32 height) override;
+            b8 UploadMips(TextureMipChain& chain, u32 resident_mip) override;
 
         protected:
             VulkanImage* image;
             VkFormat image_format;
+            u32 bindless_slot;
 
             VkFormat ChannelCountToFormat(u8 channel_count, VkFormat default_format = VK_FORMAT_R8G8B8A8_UNORM);
 
             void CreateReadonlyTexture(TextureCreateInfo& info);
             void CreateWriteableTexture(TextureCreateInfo& info);
+            // Registers the current image view in a fresh slot and retires the old one, a slot frames in
+            // flight may sample is never rewritten.
+            void SyncBindlessSlot();
+            // Frees the slot once submitted frames are done with it.
+            void RetireBindlessSlot();
     };
 
 };
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "timeline.hpp"
+
+#include "vulkan.hpp"
+#include "helpers.hpp"
+#include "core/logger/logger.hpp"
+
+namespace Engine {
+
+    VulkanTimeline::VulkanTimeline() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        this->submitted = 0;
+        this->completed = 0;
+
+        VkSemaphoreTypeCreateInfo type_create_info = {VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+        type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        type_create_info.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphore_create_info = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+        semaphore_create_info.pNext = &type_create_info;
+
+        VK_CHECK(vkCreateSemaphore(
+            backend->GetVulkanDevice()->logical_device,
+            &semaphore_create_info,
+            backend->GetVulkanAllocator(),
+            &this->handle));
+    };
+
+    VulkanTimeline::~VulkanTimeline() {
+        if (this->handle) {
+            VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+            vkDestroySemaphore(
+                backend->GetVulkanDevice()->logical_device,
+                this->handle,
+                backend->GetVulkanAllocator());
+            this->handle = nullptr;
+        }
+    };
+
+    u64 VulkanTimeline::GetCompleted() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        u64 value = 0;
+        VkResult result = vkGetSemaphoreCounterValue(backend->GetVulkanDevice()->logical_device, handle, &value);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("vkGetSemaphoreCounterValue failed: '%s'", VulkanResultString(result, true));
+            return completed;
+        }
+        completed = value;
+        return completed;
+    };
+
+    b8 VulkanTimeline::IsComplete(u64 value) {
+        if (value <= completed) {
+            return true;
+        }
+        return GetCompleted() >= value;
+    };
+
+    b8 VulkanTimeline::Wait(u64 value, u64 timeout_ns) {
+        if (value <= completed) {
+            return true;
+        }
+
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+
+        VkSemaphoreWaitInfo wait_info = {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &handle;
+        wait_info.pValues = &value;
+
+        VkResult result = vkWaitSemaphores(backend->GetVulkanDevice()->logical_device, &wait_info, timeout_ns);
+        switch (result) {
+            case VK_SUCCESS:
+                completed = value > completed ? value : completed;
+                return true;
+            case VK_TIMEOUT:
+                WARN("vkWaitSemaphores: Timed out.");
+                break;
+            default:
+                ERROR("vkWaitSemaphores failed: '%s'", VulkanResultString(result, true));
+                break;
+        }
+        return false;
+    };
+
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+
+namespace Engine {
+
+    // Timeline semaphore counting submissions on one queue. Every submission signals the next value, so
+    // "is submission N done" is a comparison against the counter instead of a fence per slot.
+    // Values only grow, 0 is complete from the start. Main thread only.
+    class VulkanTimeline {
+        public:
+            VkSemaphore handle;
+
+            VulkanTimeline();
+            ~VulkanTimeline();
+
+            // Value the next submission signals, handed out again until Submitted records it.
+            u64 GetNextValue() { return submitted + 1; };
+            void Submitted(u64 value) { submitted = value; };
+            u64 GetSubmitted() { return submitted; };
+
+            // Cached until a newer value is asked for, then read back from the device.
+            b8 IsComplete(u64 value);
+            b8 Wait(u64 value, u64 timeout_ns);
+            u64 GetCompleted();
+
+        private:
+            u64 submitted;
+            u64 completed;
+    };
+
+};
@@ -0,0 +1,98 @@
+#include "uniform_ring.hpp"
+
+#include "vulkan.hpp"
+#include "core/logger/logger.hpp"
+
+namespace Engine {
+
+    VulkanUniformRing::VulkanUniformRing(u64 frame_size, u32 frame_count, u64 alignment) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanDevice* device = backend->GetVulkanDevice();
+
+        this->ready = false;
+        this->alignment = alignment ? alignment : 1;
+        this->frame_size = GetAligned(frame_size, this->alignment);
+        this->frame_count = frame_count;
+        this->frame_base = 0;
+        this->frame_offset = 0;
+        this->reserved = 0;
+        this->frame_number = 0;
+        this->overflow_reported = false;
+        this->mapped = nullptr;
+
+        u32 device_local_bits = device->supports_device_local_host_visible ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : 0;
+        buffer = new VulkanBuffer(
+            this->frame_size * frame_count,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | device_local_bits,
+            false);
+
+        if (!buffer->ready) {
+            ERROR("VulkanUniformRing - failed to create the ring buffer.");
+            return;
+        }
+
+        // Stays mapped for the lifetime of the ring.
+        mapped = (u8*)buffer->LockMemory(0, VK_WHOLE_SIZE, 0);
+        this->ready = true;
+    };
+
+    VulkanUniformRing::~VulkanUniformRing() {
+        if (buffer) {
+            if (mapped) {
+                buffer->UnlockMemory();
+                mapped = nullptr;
+            }
+            delete buffer;
+            buffer = nullptr;
+        }
+    };
+
+    void VulkanUniformRing::BeginFrame(u32 frame_index) {
+        frame_base = (frame_index % frame_count) * frame_size;
+        frame_offset = 0;
+        frame_number++;
+    };
+
+    b8 VulkanUniformRing::Allocate(u64 size, VulkanUniformAllocation* out_allocation) {
+        u64 aligned_size = GetAligned(size, alignment);
+        if (frame_offset + aligned_size + reserved > frame_size) {
+            if (!overflow_reported) {
+                ERROR("VulkanUniformRing::Allocate - frame region of %llu bytes is full.", frame_size);
+                overflow_reported = true;
+            }
+            return false;
+        }
+
+        out_allocation->offset = frame_base + frame_offset;
+        out_allocation->data = mapped + frame_base + frame_offset;
+        frame_offset += aligned_size;
+        return true;
+    };
+
+    void VulkanUniformRing::Reserve(u64 size) {
+        reserved += GetAligned(size, alignment);
+        if (reserved > frame_size / 2) {
+            WARN("VulkanUniformRing::Reserve - %llu of %llu bytes per frame are reserved.", reserved, frame_size);
+        }
+    };
+
+    void VulkanUniformRing::Unreserve(u64 size) {
+        u64 aligned_size = GetAligned(size, alignment);
+        reserved = aligned_size < reserved ? reserved - aligned_size : 0;
+    };
+
+    b8 VulkanUniformRing::AllocateReserved(u64 size, VulkanUniformAllocation* out_allocation) {
+        u64 aligned_size = GetAligned(size, alignment);
+        if (frame_offset + aligned_size > frame_size) {
+            ERROR("VulkanUniformRing::AllocateReserved - reserved headroom of the frame region is exhausted.");
+            return false;
+        }
+
+        out_allocation->offset = frame_base + frame_offset;
+        out_allocation->data = mapped + frame_base + frame_offset;
+        frame_offset += aligned_size;
+        return true;
+    };
+
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+#include "buffer.hpp"
+
+// Uniform data per frame in flight, shared by every shader.
+#define VULKAN_UNIFORM_RING_FRAME_SIZE (4 MB)
+
+namespace Engine {
+
+    struct VulkanUniformAllocation {
+        // Dynamic offset to bind with, relative to the start of the ring buffer.
+        u32 offset;
+        u8* data;
+    };
+
+    // Persistently mapped uniform buffer split in one region per frame in flight. Uniform blocks
+    // are bump allocated from the current region and bound through dynamic offsets, the region
+    // is reused once the fence of the frame that last used it has signaled.
+    class VulkanUniformRing {
+        public:
+            VulkanUniformRing(u64 frame_size, u32 frame_count, u64 alignment);
+            ~VulkanUniformRing();
+
+            // Call after the frame fence wait, everything allocated the last time this region was used is dropped.
+            void BeginFrame(u32 frame_index);
+
+            b8 Allocate(u64 size, VulkanUniformAllocation* out_allocation);
+
+            // Headroom kept back from Allocate in every frame region. Shaders reserve one global block each
+            // so they can still bind valid globals once the region is full.
+            void Reserve(u64 size);
+            void Unreserve(u64 size);
+            // Allocates from the headroom, only after Allocate failed and at most once per reservation and frame.
+            b8 AllocateReserved(u64 size, VulkanUniformAllocation* out_allocation);
+
+            VkBuffer GetHandle() { return buffer->handle; };
+            // Counts frames, lets callers tell whether an allocation was made during the current one.
+            u64 GetFrameNumber() { return frame_number; };
+            u64 GetFrameUsed() { return frame_offset; };
+
+            b8 ready;
+
+        private:
+            VulkanBuffer* buffer;
+            u8* mapped;
+            u64 frame_size;
+            u64 alignment;
+            u64 frame_base;
+            u64 frame_offset;
+            u64 reserved;
+            u64 frame_number;
+            u32 frame_count;
+            b8 overflow_reported;
+    };
+
+};
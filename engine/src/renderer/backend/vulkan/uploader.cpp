@@ -0,0 +1,589 @@
+#include "uploader.hpp"
+
+#include "vulkan.hpp"
+#include "helpers.hpp"
+#include "core/logger/logger.hpp"
+#include "platform/platform.hpp"
+
+namespace Engine {
+
+    VulkanUploader::VulkanUploader(u64 ring_size, u32 batch_count) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanDevice* device = backend->GetVulkanDevice();
+
+        this->ready = false;
+        this->pool = VK_NULL_HANDLE;
+        this->acquire_pool = VK_NULL_HANDLE;
+        this->ring = nullptr;
+        this->mapped = nullptr;
+        this->ring_size = ring_size;
+        this->head = 0;
+        this->tail = 0;
+        this->current_batch = 0;
+        this->oldest_batch = 0;
+        this->timestamp_pool = VK_NULL_HANDLE;
+        this->timestamp_mask = 0;
+
+        // A family of its own lets copies overlap rendering, otherwise everything stays on graphics.
+        this->graphics_family = device->graphics_queue_index;
+        this->transfer_queue = device->transfer_queue_index >= 0 && device->transfer_queue_index != device->graphics_queue_index;
+        this->queue = transfer_queue ? device->transfer_queue : device->graphics_queue;
+        this->queue_family = transfer_queue ? device->transfer_queue_index : device->graphics_queue_index;
+        DEBUG("VulkanUploader - uploading on the %s queue family %u.", transfer_queue ? "transfer" : "graphics", queue_family);
+
+        VkCommandPoolCreateInfo pool_info = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+        pool_info.queueFamilyIndex = queue_family;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        VkResult result = vkCreateCommandPool(device->logical_device, &pool_info, backend->GetVulkanAllocator(), &pool);
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanUploader - failed creating command pool: '%s'", VulkanResultString(result, true));
+            return;
+        }
+
+        if (transfer_queue) {
+            pool_info.queueFamilyIndex = graphics_family;
+            result = vkCreateCommandPool(device->logical_device, &pool_info, backend->GetVulkanAllocator(), &acquire_pool);
+            if (!IsVulkanResultSuccess(result)) {
+                ERROR("VulkanUploader - failed creating acquire command pool: '%s'", VulkanResultString(result, true));
+                return;
+            }
+        }
+
+        ring = new VulkanBuffer(
+            ring_size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            false);
+        if (!ring->ready) {
+            ERROR("VulkanUploader - failed to create the staging ring.");
+            return;
+        }
+        mapped = (u8*)ring->LockMemory(0, VK_WHOLE_SIZE, 0);
+
+        u32 timestamp_bits = transfer_queue ? device->transfer_timestamp_bits : device->graphics_timestamp_bits;
+        if (timestamp_bits) {
+            VkQueryPoolCreateInfo query_pool_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+            query_pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            query_pool_info.queryCount = batch_count * 2;
+            result = vkCreateQueryPool(device->logical_device, &query_pool_info, backend->GetVulkanAllocator(), &timestamp_pool);
+            if (!IsVulkanResultSuccess(result)) {
+                // Uploads work without it, only their GPU time goes unmeasured.
+                WARN("VulkanUploader - failed creating timestamp query pool: '%s'", VulkanResultString(result, true));
+                timestamp_pool = VK_NULL_HANDLE;
+            }
+            timestamp_mask = timestamp_bits >= 64 ? UINT64_MAX : (1ull << timestamp_bits) - 1;
+        }
+
+        batches.resize(batch_count);
+        for (VulkanUploadBatch& batch : batches) {
+            batch.command_buffer = new VulkanCommandBuffer(pool, true);
+            batch.value = 0;
+            batch.semaphore = VK_NULL_HANDLE;
+            batch.acquire_command_buffer = nullptr;
+            batch.release_semaphore = VK_NULL_HANDLE;
+            batch.release_command_buffer = nullptr;
+            batch.wait_release = false;
+            batch.ring_end = 0;
+            batch.recording = false;
+            batch.pending = false;
+
+            if (transfer_queue) {
+                VkSemaphoreCreateInfo semaphore_info = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+                result = vkCreateSemaphore(device->logical_device, &semaphore_info, backend->GetVulkanAllocator(), &batch.semaphore);
+                if (!IsVulkanResultSuccess(result)) {
+                    ERROR("VulkanUploader - failed creating batch semaphore: '%s'", VulkanResultString(result, true));
+                    return;
+                }
+                result = vkCreateSemaphore(device->logical_device, &semaphore_info, backend->GetVulkanAllocator(), &batch.release_semaphore);
+                if (!IsVulkanResultSuccess(result)) {
+                    ERROR("VulkanUploader - failed creating release semaphore: '%s'", VulkanResultString(result, true));
+                    return;
+                }
+                batch.acquire_command_buffer = new VulkanCommandBuffer(acquire_pool, true);
+                batch.release_command_buffer = new VulkanCommandBuffer(acquire_pool, true);
+            }
+        }
+
+        ready = true;
+    };
+
+    VulkanUploader::~VulkanUploader() {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VkDevice logical_device = backend->GetVulkanDevice()->logical_device;
+
+        if (ready) {
+            WaitIdle();
+        }
+        for (VulkanUploadBatch& batch : batches) {
+            delete batch.command_buffer;
+            delete batch.acquire_command_buffer;
+            delete batch.release_command_buffer;
+            if (batch.semaphore) {
+                vkDestroySemaphore(logical_device, batch.semaphore, backend->GetVulkanAllocator());
+            }
+            if (batch.release_semaphore) {
+                vkDestroySemaphore(logical_device, batch.release_semaphore, backend->GetVulkanAllocator());
+            }
+        }
+        batches.clear();
+
+        if (ring) {
+            ring->UnlockMemory();
+            delete ring;
+            ring = nullptr;
+        }
+        if (pool) {
+            vkDestroyCommandPool(logical_device, pool, backend->GetVulkanAllocator());
+            pool = VK_NULL_HANDLE;
+        }
+        if (acquire_pool) {
+            vkDestroyCommandPool(logical_device, acquire_pool, backend->GetVulkanAllocator());
+            acquire_pool = VK_NULL_HANDLE;
+        }
+        if (timestamp_pool) {
+            vkDestroyQueryPool(logical_device, timestamp_pool, backend->GetVulkanAllocator());
+            timestamp_pool = VK_NULL_HANDLE;
+        }
+    };
+
+    b8 VulkanUploader::Retire(b8 wait) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanTimeline* timeline = backend->GetFrameTimeline();
+
+        b8 retired = false;
+        while (batches[oldest_batch].pending) {
+            VulkanUploadBatch& batch = batches[oldest_batch];
+            if (wait && !retired) {
+                if (!timeline->Wait(batch.value, UINT64_MAX)) {
+                    return false;
+                }
+            } else if (!timeline->IsComplete(batch.value)) {
+                break;
+            }
+
+            if (timestamp_pool) {
+                // Complete on the timeline, so the results are there without waiting.
+                u64 timestamps[2];
+                VkResult result = vkGetQueryPoolResults(
+                    backend->GetVulkanDevice()->logical_device, timestamp_pool,
+                    oldest_batch * 2, 2, sizeof(timestamps), timestamps, sizeof(u64), VK_QUERY_RESULT_64_BIT);
+                if (result == VK_SUCCESS) {
+                    u64 ticks = (timestamps[1] - timestamps[0]) & timestamp_mask;
+                    stats.gpu_ms += (f64)ticks * backend->GetVulkanDevice()->properties.limits.timestampPeriod / 1000000.0;
+                }
+            }
+
+            for (VulkanBuffer* buffer : batch.oversized_buffers) {
+                delete buffer;
+            }
+            batch.oversized_buffers.clear();
+            batch.pending = false;
+            tail = batch.ring_end;
+            oldest_batch = (oldest_batch + 1) % batches.size();
+            retired = true;
+        }
+        return retired;
+    };
+
+    VulkanUploadBatch& VulkanUploader::GetRecordingBatch() {
+        VulkanUploadBatch& batch = batches[current_batch];
+        if (batch.recording) {
+            return batch;
+        }
+
+        // Slots are reused in order, a pending one here is the oldest submission.
+        if (batch.pending) {
+            stats.stalls++;
+            Retire(true);
+        }
+        batch.command_buffer->Reset();
+        batch.command_buffer->BeginSingleUse();
+        if (timestamp_pool) {
+            // The slot's previous results were read when it retired.
+            vkResetQueryPool(VulkanRendererBackend::GetInstance()->GetVulkanDevice()->logical_device, timestamp_pool, current_batch * 2, 2);
+            vkCmdWriteTimestamp(batch.command_buffer->handle, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestamp_pool, current_batch * 2);
+        }
+        batch.recording = true;
+        return batch;
+    };
+
+    b8 VulkanUploader::Stage(u64 size, const void* data, VulkanBuffer** out_buffer, u64* out_offset) {
+        if (size > ring_size / 2) {
+            // Too big to share the ring, it gets a buffer of its own released with its batch.
+            VulkanBuffer* buffer = new VulkanBuffer(
+                size,
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                false);
+            if (!buffer->ready) {
+                delete buffer;
+                return false;
+            }
+            buffer->LoadData(0, size, 0, data);
+            GetRecordingBatch().oversized_buffers.push_back(buffer);
+            stats.oversized++;
+            *out_buffer = buffer;
+            *out_offset = 0;
+            return true;
+        }
+
+        u64 aligned_size = (size + VULKAN_STAGING_ALIGNMENT - 1) & ~(u64)(VULKAN_STAGING_ALIGNMENT - 1);
+        while (true) {
+            // Never wrap inside an upload, skip the rest of the ring instead.
+            u64 position = head % ring_size;
+            u64 padding = position + aligned_size > ring_size ? ring_size - position : 0;
+            if (head + padding + aligned_size - tail <= ring_size) {
+                head += padding;
+                break;
+            }
+
+            // Full, free whatever finished, submitting and waiting for the oldest batch if nothing did.
+            Retire(false);
+            if (head + padding + aligned_size - tail <= ring_size) {
+                continue;
+            }
+            if (batches[current_batch].recording && !batches[oldest_batch].pending) {
+                Flush();
+            }
+            stats.stalls++;
+            if (!Retire(true)) {
+                ERROR("VulkanUploader::Stage - staging ring is full and nothing is in flight.");
+                return false;
+            }
+        }
+
+        Platform::CpMemory(mapped + head % ring_size, data, size);
+        *out_buffer = ring;
+        *out_offset = head % ring_size;
+        head += aligned_size;
+        return true;
+    };
+
+    b8 VulkanUploader::UploadBuffer(VulkanBuffer* buffer, u64 offset, u64 size, const void* data) {
+        if (!size) {
+            return true;
+        }
+
+        VulkanBuffer* staging = nullptr;
+        u64 staging_offset = 0;
+        if (!Stage(size, data, &staging, &staging_offset)) {
+            return false;
+        }
+
+        VkBufferCopy copy_region;
+        copy_region.srcOffset = staging_offset;
+        copy_region.dstOffset = offset;
+        copy_region.size = size;
+        VulkanUploadBatch& batch = GetRecordingBatch();
+        vkCmdCopyBuffer(batch.command_buffer->handle, staging->handle, buffer->handle, 1, &copy_region);
+
+        if (transfer_queue) {
+            // Back to back writes into the same buffer share one ownership transfer, writes into a range a
+            // buffer copy of the batch releases need none of their own.
+            b8 released = false;
+            for (VkBufferMemoryBarrier& release : batch.buffer_releases) {
+                released |= release.buffer == buffer->handle && release.offset <= offset && offset + size <= release.offset + release.size;
+            }
+            if (!released && !batch.buffer_releases.empty()) {
+                VkBufferMemoryBarrier& last = batch.buffer_releases.back();
+                if (last.buffer == buffer->handle && last.offset + last.size == offset) {
+                    last.size += size;
+                    released = true;
+                }
+            }
+            if (released) {
+                stats.uploads++;
+                stats.bytes += size;
+                return true;
+            }
+
+            VkBufferMemoryBarrier release = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+            release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            release.dstAccessMask = 0;
+            release.srcQueueFamilyIndex = queue_family;
+            release.dstQueueFamilyIndex = graphics_family;
+            release.buffer = buffer->handle;
+            release.offset = offset;
+            release.size = size;
+            batch.buffer_releases.push_back(release);
+        }
+
+        stats.uploads++;
+        stats.bytes += size;
+        return true;
+    };
+
+    b8 VulkanUploader::UploadImage(VulkanImage* image, VkFormat format, u32 level_count, const u64* level_offsets, u64 size, const void* data) {
+        VulkanBuffer* staging = nullptr;
+        u64 staging_offset = 0;
+        if (!Stage(size, data, &staging, &staging_offset)) {
+            return false;
+        }
+
+        VulkanUploadBatch& batch = GetRecordingBatch();
+        VulkanCommandBuffer* command_buffer = batch.command_buffer;
+        image->TransitionLayout(command_buffer, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        for (u32 i = 0; i < level_count; ++i) {
+            image->CopyFromBuffer(staging->handle, command_buffer, i, staging_offset + (level_offsets ? level_offsets[i] : 0));
+        }
+
+        b8 released = false;
+        for (const VkImageMemoryBarrier& barrier : batch.image_releases) {
+            released |= barrier.image == image->handle;
+        }
+
+        if (transfer_queue && !released) {
+            // The layout change happens once, as part of the ownership transfer.
+            VkImageMemoryBarrier release = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+            release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            release.dstAccessMask = 0;
+            release.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            release.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            release.srcQueueFamilyIndex = queue_family;
+            release.dstQueueFamilyIndex = graphics_family;
+            release.image = image->handle;
+            release.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            release.subresourceRange.baseMipLevel = 0;
+            release.subresourceRange.levelCount = image->mip_levels;
+            release.subresourceRange.baseArrayLayer = 0;
+            release.subresourceRange.layerCount = 1;
+            batch.image_releases.push_back(release);
+        } else if (!transfer_queue) {
+            image->TransitionLayout(command_buffer, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+
+        stats.uploads++;
+        stats.bytes += size;
+        return true;
+    };
+
+    void VulkanUploader::Flush() {
+        VulkanUploadBatch& batch = batches[current_batch];
+        if (!batch.recording) {
+            return;
+        }
+
+        VkSubmitInfo submit_info = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &batch.command_buffer->handle;
+
+        // Covers the copies, not the barriers that follow.
+        if (timestamp_pool) {
+            vkCmdWriteTimestamp(batch.command_buffer->handle, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamp_pool, current_batch * 2 + 1);
+        }
+
+        if (transfer_queue) {
+            // Releases, the graphics queue acquires once the semaphore signals.
+            vkCmdPipelineBarrier(
+                batch.command_buffer->handle,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                0, 0, nullptr,
+                (u32)batch.buffer_releases.size(), batch.buffer_releases.data(),
+                (u32)batch.image_releases.size(), batch.image_releases.data());
+            batch.command_buffer->End();
+
+            submit_info.signalSemaphoreCount = 1;
+            submit_info.pSignalSemaphores = &batch.semaphore;
+            VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            if (batch.wait_release) {
+                submit_info.waitSemaphoreCount = 1;
+                submit_info.pWaitSemaphores = &batch.release_semaphore;
+                submit_info.pWaitDstStageMask = &wait_stage;
+                batch.wait_release = false;
+            }
+            VkResult result = vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE);
+            if (!IsVulkanResultSuccess(result)) {
+                ERROR("VulkanUploader::Flush - vkQueueSubmit failed: '%s'", VulkanResultString(result, true));
+            }
+            batch.command_buffer->UpdateSubmitted();
+            SubmitAcquire(batch);
+        } else {
+            // Buffer copies become visible to everything submitted after this batch, images carry their own barriers.
+            VkMemoryBarrier barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+            vkCmdPipelineBarrier(
+                batch.command_buffer->handle,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                0, 1, &barrier, 0, nullptr, 0, nullptr);
+            batch.command_buffer->End();
+
+            SubmitGraphics(&submit_info, &batch.value);
+            batch.command_buffer->UpdateSubmitted();
+        }
+
+        batch.ring_end = head;
+        batch.recording = false;
+        batch.pending = true;
+        current_batch = (current_batch + 1) % batches.size();
+        stats.submissions++;
+    };
+
+    b8 VulkanUploader::SubmitAcquire(VulkanUploadBatch& batch) {
+        // Mirrors of the releases, only the destination access differs. Buffers are vertex and index
+        // data, images are sampled.
+        for (VkBufferMemoryBarrier& barrier : batch.buffer_releases) {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+        }
+        for (VkImageMemoryBarrier& barrier : batch.image_releases) {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        }
+
+        // Only the stages reading uploads wait for the transfer queue, work reading none of them,
+        // like renderpass clears and frame transfers, starts before the copies finish.
+        VkPipelineStageFlags wait_stage = VULKAN_UPLOAD_CONSUMER_STAGES;
+        VulkanCommandBuffer* command_buffer = batch.acquire_command_buffer;
+        command_buffer->Reset();
+        command_buffer->BeginSingleUse();
+        vkCmdPipelineBarrier(
+            command_buffer->handle,
+            wait_stage, wait_stage,
+            0, 0, nullptr,
+            (u32)batch.buffer_releases.size(), batch.buffer_releases.data(),
+            (u32)batch.image_releases.size(), batch.image_releases.data());
+        command_buffer->End();
+        batch.buffer_releases.clear();
+        batch.image_releases.clear();
+
+        // Frames submitted after this one come later on the same queue, their reads see the uploads complete.
+        VkSubmitInfo submit_info = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submit_info.waitSemaphoreCount = 1;
+        submit_info.pWaitSemaphores = &batch.semaphore;
+        submit_info.pWaitDstStageMask = &wait_stage;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &command_buffer->handle;
+        if (!SubmitGraphics(&submit_info, &batch.value)) {
+            return false;
+        }
+        command_buffer->UpdateSubmitted();
+        return true;
+    };
+
+    b8 VulkanUploader::SubmitGraphics(VkSubmitInfo* submit_info, u64* out_value) {
+        VulkanRendererBackend* backend = VulkanRendererBackend::GetInstance();
+        VulkanTimeline* timeline = backend->GetFrameTimeline();
+
+        // Waits on binary semaphores need no values, a binary signal already set goes before the timeline.
+        u64 value = timeline->GetNextValue();
+        VkSemaphore signal_semaphores[2] = {VK_NULL_HANDLE, timeline->handle};
+        u64 signal_values[2] = {0, value};
+        u32 signal_count = 1;
+        if (submit_info->signalSemaphoreCount) {
+            signal_semaphores[0] = submit_info->pSignalSemaphores[0];
+            signal_count = 2;
+        }
+        VkTimelineSemaphoreSubmitInfo timeline_info = {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        timeline_info.signalSemaphoreValueCount = signal_count;
+        timeline_info.pSignalSemaphoreValues = &signal_values[2 - signal_count];
+        submit_info->pNext = &timeline_info;
+        submit_info->signalSemaphoreCount = signal_count;
+        submit_info->pSignalSemaphores = &signal_semaphores[2 - signal_count];
+
+        VkResult result = vkQueueSubmit(backend->GetVulkanDevice()->graphics_queue, 1, submit_info, VK_NULL_HANDLE);
+        submit_info->pNext = nullptr;
+        if (!IsVulkanResultSuccess(result)) {
+            ERROR("VulkanUploader - vkQueueSubmit failed: '%s'", VulkanResultString(result, true));
+            // Nothing signals it, waits on the value return right away.
+            *out_value = 0;
+            return false;
+        }
+        timeline->Submitted(value);
+        *out_value = value;
+        return true;
+    };
+
+    b8 VulkanUploader::CopyBuffer(VkBuffer source, VkBuffer dest, u64 size) {
+        // A batch of its own, uploads into the source are released to graphics before it is taken back.
+        Flush();
+        VulkanUploadBatch& batch = GetRecordingBatch();
+
+        VkBufferMemoryBarrier acquire = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+        if (transfer_queue) {
+            // The graphics queue owns the source, it hands it over after the acquires and frames before it.
+            VkBufferMemoryBarrier release = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+            release.srcAccessMask = 0;
+            release.dstAccessMask = 0;
+            release.srcQueueFamilyIndex = graphics_family;
+            release.dstQueueFamilyIndex = queue_family;
+            release.buffer = source;
+            release.offset = 0;
+            release.size = size;
+
+            VulkanCommandBuffer* command_buffer = batch.release_command_buffer;
+            command_buffer->Reset();
+            command_buffer->BeginSingleUse();
+            vkCmdPipelineBarrier(
+                command_buffer->handle,
+                VULKAN_UPLOAD_CONSUMER_STAGES, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                0, 0, nullptr, 1, &release, 0, nullptr);
+            command_buffer->End();
+
+            VkSubmitInfo submit_info = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+            submit_info.commandBufferCount = 1;
+            submit_info.pCommandBuffers = &command_buffer->handle;
+            submit_info.signalSemaphoreCount = 1;
+            submit_info.pSignalSemaphores = &batch.release_semaphore;
+            u64 value = 0;
+            if (!SubmitGraphics(&submit_info, &value)) {
+                return false;
+            }
+            command_buffer->UpdateSubmitted();
+            batch.wait_release = true;
+
+            acquire = release;
+            acquire.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        }
+
+        // Copies of earlier batches into the source finish before it is read. The new buffer was never
+        // used, its first owner is the upload queue.
+        VkMemoryBarrier barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(
+            batch.command_buffer->handle,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 1, &barrier, transfer_queue ? 1 : 0, &acquire, 0, nullptr);
+
+        VkBufferCopy copy_region;
+        copy_region.srcOffset = 0;
+        copy_region.dstOffset = 0;
+        copy_region.size = size;
+        vkCmdCopyBuffer(batch.command_buffer->handle, source, dest, 1, &copy_region);
+
+        // Later uploads into freed ranges of the copied part land after the copy, in this batch or a later one.
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(
+            batch.command_buffer->handle,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        if (transfer_queue) {
+            VkBufferMemoryBarrier release = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+            release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            release.dstAccessMask = 0;
+            release.srcQueueFamilyIndex = queue_family;
+            release.dstQueueFamilyIndex = graphics_family;
+            release.buffer = dest;
+            release.offset = 0;
+            release.size = size;
+            batch.buffer_releases.push_back(release);
+        }
+
+        stats.copies++;
+        stats.bytes += size;
+        return true;
+    };
+
+    void VulkanUploader::WaitIdle() {
+        Flush();
+        while (batches[oldest_batch].pending) {
+            if (!Retire(true)) {
+                break;
+            }
+        }
+    };
+
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "defines.hpp"
+#include "buffer.hpp"
+#include "image.hpp"
+#include "command_buffer.hpp"
+
+// Persistently mapped staging memory shared by all uploads.
+#define VULKAN_STAGING_RING_SIZE (64 MB)
+// Submissions that can be in flight before the uploader waits on the oldest.
+#define VULKAN_UPLOAD_BATCH_COUNT 4
+// Staging offsets stay aligned for any texel size.
+#define VULKAN_STAGING_ALIGNMENT 16
+// Stages of later graphics work that wait for a transfer queue batch, where vertex and index data
+// and sampled images are read.
+#define VULKAN_UPLOAD_CONSUMER_STAGES (VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+
+namespace Engine {
+
+    struct VulkanUploadStats {
+        u64 bytes = 0;
+        u32 uploads = 0;
+        u32 submissions = 0;
+        // Uploads bigger than the ring, staged through their own buffer.
+        u32 oversized = 0;
+        // Times an upload had to wait for an earlier submission to free ring space.
+        u32 stalls = 0;
+        // Buffer to buffer copies, from buffers growing.
+        u32 copies = 0;
+        // GPU time of retired batches, stays 0 when the upload queue has no timestamps.
+        f64 gpu_ms = 0.0;
+    };
+
+    // Copies recorded into one command buffer until Flush submits them together.
+    struct VulkanUploadBatch {
+        VulkanCommandBuffer* command_buffer;
+        // Frame timeline value of the acquire submission on a transfer queue, of the copies otherwise.
+        u64 value;
+        // Transfer queue only, the graphics side acquire waits on it.
+        VkSemaphore semaphore;
+        VulkanCommandBuffer* acquire_command_buffer;
+        // Transfer queue only, a buffer the batch copies from is released by the graphics queue first and
+        // the batch waits on the release.
+        VkSemaphore release_semaphore;
+        VulkanCommandBuffer* release_command_buffer;
+        b8 wait_release;
+        // Queue family ownership moves from transfer to graphics, the acquires mirror the releases.
+        std::vector<VkBufferMemoryBarrier> buffer_releases;
+        std::vector<VkImageMemoryBarrier> image_releases;
+        // Ring position at submission, the ring is free up to here once the value completes.
+        u64 ring_end;
+        std::vector<VulkanBuffer*> oversized_buffers;
+        b8 recording;
+        b8 pending;
+    };
+
+    // Stages buffer and image uploads through a ring and batches their copies into as few
+    // submissions as possible. Every graphics queue submission signals the backend's frame timeline,
+    // completion is a comparison against it and no queue is ever idled. When the device has a
+    // separate transfer family the copies run there, next to rendering, and each batch hands its
+    // resources to the graphics family through a release barrier, a semaphore and an acquire
+    // submitted on the graphics queue, so no later graphics work can read them before the copies
+    // complete. Only VULKAN_UPLOAD_CONSUMER_STAGES wait. Without one the copies go on the graphics
+    // queue and a barrier at the end of every batch orders them before later work. The backend
+    // flushes before submitting each frame. Main thread only.
+    class VulkanUploader {
+        public:
+            VulkanUploader(u64 ring_size, u32 batch_count);
+            ~VulkanUploader();
+
+            b8 UploadBuffer(VulkanBuffer* buffer, u64 offset, u64 size, const void* data);
+            // Writes level_count mips starting at level 0, level i read from level_offsets[i] within data.
+            // The image ends up in SHADER_READ_ONLY_OPTIMAL.
+            b8 UploadImage(VulkanImage* image, VkFormat format, u32 level_count, const u64* level_offsets, u64 size, const void* data);
+            // Copies the first size bytes of source into dest within the upload batch, after every upload
+            // recorded so far and before any later one or any later frame. Used to grow buffers without
+            // waiting on the device, dest must not have been used before.
+            b8 CopyBuffer(VkBuffer source, VkBuffer dest, u64 size);
+
+            // Submits what was recorded so far without waiting for it.
+            void Flush();
+            // Submits and waits for every upload to finish.
+            void WaitIdle();
+
+            const VulkanUploadStats& GetStats() { return stats; };
+            // True when copies run on a dedicated transfer queue family.
+            b8 IsTransferQueue() { return transfer_queue; };
+
+            b8 ready;
+
+        private:
+            // Copies data into staging memory, out_buffer is the ring or a buffer of its own for oversized uploads.
+            b8 Stage(u64 size, const void* data, VulkanBuffer** out_buffer, u64* out_offset);
+            VulkanUploadBatch& GetRecordingBatch();
+            // Releases finished batches in submission order, waiting for the oldest one if wait is set.
+            b8 Retire(b8 wait);
+            // Hands the batch's resources to the graphics family, waiting on its copies.
+            b8 SubmitAcquire(VulkanUploadBatch& batch);
+            // Submits to the graphics queue signaling the next frame timeline value, after any semaphore
+            // the submission signals already.
+            b8 SubmitGraphics(VkSubmitInfo* submit_info, u64* out_value);
+
+            b8 transfer_queue;
+            VkQueue queue;
+            u32 queue_family;
+            u32 graphics_family;
+            VkCommandPool pool;
+            // Graphics family pool for the acquire side of ownership transfers.
+            VkCommandPool acquire_pool;
+            VulkanBuffer* ring;
+            u8* mapped;
+            u64 ring_size;
+            // Monotonic byte positions, head is where staging writes next and tail where used space begins.
+            u64 head;
+            u64 tail;
+
+            std::vector<VulkanUploadBatch> batches;
+            u32 current_batch;
+            u32 oldest_batch;
+
+            // Two timestamps per batch around its copies, null when the upload queue family has none.
+            VkQueryPool timestamp_pool;
+            u64 timestamp_mask;
+
+            VulkanUploadStats stats;
+    };
+
+};
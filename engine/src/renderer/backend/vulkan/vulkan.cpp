@@ -12,22 +12,39 @@ namespace Engine {
 
     VulkanRendererBackend* VulkanRendererBackend::instance = nullptr;
 
-    FreelistNode* VulkanRendererBackend::UploadDataRange(VkCommandPool pool, VkFence fence, VkQueue queue, VulkanBuffer* buffer, u64 size, void* data) {
-        // Create a host-visible staging buffer to upload to. Mark it as the source of the transfer.
-        VkBufferUsageFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        VulkanBuffer staging = VulkanBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, flags, true, false);
-
-        // Load the data into the staging buffer.
-        staging.LoadData(0, size, 0, data);
-
-        // Perform the copy from staging to the device local buffer.
+    FreelistNode* VulkanRendererBackend::UploadDataRange(VulkanBuffer* buffer, u64 size, void* data) {
         FreelistNode* allocation = buffer->Allocate(size);
-        staging.CopyTo(pool, fence, queue, 0, buffer->handle, allocation->GetMemoryOffset(), allocation->GetSize());
+        if (!allocation) {
+            // Out of room, grow geometrically so loading a large scene reallocates only a few times.
+            u64 new_size = buffer->total_size * VULKAN_BUFFER_GROWTH_FACTOR;
+            while (new_size - buffer->total_size < size) {
+                new_size *= VULKAN_BUFFER_GROWTH_FACTOR;
+            }
+            DEBUG("VulkanRendererBackend::UploadDataRange - growing buffer from %llu to %llu bytes.", buffer->total_size, new_size);
+            if (!buffer->Resize(new_size)) {
+                ERROR("VulkanRendererBackend::UploadDataRange - failed to grow buffer to %llu bytes.", new_size);
+                return nullptr;
+            }
+            allocation = buffer->Allocate(size);
+            if (!allocation) {
+                return nullptr;
+            }
+        }
+
+        // Staged and copied with the next upload batch, no wait here.
+        if (!uploader->UploadBuffer(buffer, allocation->GetMemoryOffset(), size, data)) {
+            ERROR("VulkanRendererBackend::UploadDataRange - failed to stage %llu bytes.", size);
+        }
         return allocation;
     }
 
     void VulkanRendererBackend::FreeDataRange(VulkanBuffer* buffer, u64 offset, u64 size) {
-        return;
+        // Frames in flight may still read the range, it goes back to the pool once they are done.
+        if (deletion_queue) {
+            deletion_queue->FreeRange(buffer, offset);
+        } else {
+            buffer->Free(offset);
+        }
     };
 
     VKAPI_ATTR VkBool32 VKAPI_CALL VulkanDebugCallback (
@@ -59,9 +76,24 @@ namespace Engine {
     VulkanRendererBackend::VulkanRendererBackend(RendererSetup setup) : RendererBackend(setup) {
         object_vertex_buffer = nullptr;
         object_index_buffer = nullptr;
+        instance_material_buffer = nullptr;
         allocator = nullptr;
         device = nullptr;
+        memory_allocator = nullptr;
         swapchain = nullptr;
+        uploader = nullptr;
+        deletion_queue = nullptr;
+        gpu_timer = nullptr;
+        frame_timeline = nullptr;
+        pipeline_cache = nullptr;
+        shader_module_cache = nullptr;
+        pipeline_state_cache = nullptr;
+        sampler_cache = nullptr;
+        bindless_table = nullptr;
+        uniform_ring = nullptr;
+        recorder = nullptr;
+        parallel_renderpass = nullptr;
+        primary_context = {nullptr, false, 0};
         current_frame = INVALID_ID;
     };
 
@@ -81,8 +113,12 @@ namespace Engine {
         VkInstanceCreateInfo create_info = {VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
         create_info.pApplicationInfo = &app_info;
 
-        std::vector<char*> extensions = Platform::GetRequiredExtensionsVK();
-        extensions.push_back((char*)VK_KHR_SURFACE_EXTENSION_NAME);
+        // Headless needs no window system integration, so it also runs on software drivers without one.
+        std::vector<char*> extensions;
+        if (!headless) {
+            extensions = Platform::GetRequiredExtensionsVK();
+            extensions.push_back((char*)VK_KHR_SURFACE_EXTENSION_NAME);
+        }
 
         #if defined(_DEBUG)
             extensions.push_back((char*)VK_EXT_DEBUG_UTILS_EXTENSION_NAME); // debug utilities
@@ -171,11 +207,16 @@ namespace Engine {
         #endif
 
         // Surface
-        if (!Platform::CreateVulkanSurface(this)) {
-            ERROR("Failed to create Vulkan surface!");
-            return false;
+        if (headless) {
+            surface = VK_NULL_HANDLE;
+            DEBUG("Headless, no Vulkan surface created.");
+        } else {
+            if (!Platform::CreateVulkanSurface(this)) {
+                ERROR("Failed to create Vulkan surface!");
+                return false;
+            }
+            DEBUG("Vulkan surface created successfully.");
         }
-        DEBUG("Vulkan surface created successfully.");
         
         // Device
         device = VulkanDevice::CreateDevice(this);
@@ -184,6 +225,27 @@ namespace Engine {
             return false;
         }
 
+        // Device memory sub-allocator, has to exist before the first buffer or image
+        memory_allocator = new VulkanMemoryAllocator(device);
+
+        // Pipeline, pipeline state and shader module caches, shared by all shaders
+        pipeline_cache = new VulkanPipelineCache(VULKAN_PIPELINE_CACHE_PATH);
+        pipeline_state_cache = new VulkanPipelineStateCache();
+        shader_module_cache = new VulkanShaderModuleCache();
+
+        // Bindless texture table, has to exist before the first texture or sampler is created
+        if (device->supports_descriptor_indexing) {
+            bindless_table = new VulkanBindlessTable();
+            if (!bindless_table->ready) {
+                WARN("Failed to create bindless texture table, using per material descriptor sets.");
+                delete bindless_table;
+                bindless_table = nullptr;
+            }
+        }
+
+        // Samplers register with the bindless table on creation
+        sampler_cache = new VulkanSamplerCache();
+
         // Swapchain
         if (!SwapchainCreate(width, height)) {
             ERROR("Failed to create Vulkan swapchain!");
@@ -200,10 +262,35 @@ namespace Engine {
         DEBUG("Creating command buffers...");
         CreateCommandBuffers();
 
-        // Sync objects (fences and semaphores)
+        // Releases wait for the frames in flight that may still use them
+        deletion_queue = new VulkanDeletionQueue();
+
+        // Recording runs on the renderer's worker threads, each with its own command pools per frame in flight
+        recorder = new VulkanRecorder(setup.workers, swapchain->max_frames_in_flight);
+        if (!recorder->ready) {
+            ERROR("Failed to create Vulkan recorder!");
+            return false;
+        }
+        DEBUG("Recording with %u threads.", recorder->GetThreadCount());
+
+        // Sync objects (semaphores and the frame timeline)
         DEBUG("Creating sync objects...");
         CreateSyncObjects();
 
+        // Staging ring and upload batches for geometry and textures
+        uploader = new VulkanUploader(VULKAN_STAGING_RING_SIZE, VULKAN_UPLOAD_BATCH_COUNT);
+        if (!uploader->ready) {
+            ERROR("Failed to create Vulkan uploader!");
+            return false;
+        }
+
+        // Timestamp queries per frame in flight, read a few frames later
+        gpu_timer = new VulkanGpuTimer(swapchain->max_frames_in_flight);
+        if (!gpu_timer->ready) {
+            ERROR("Failed to create Vulkan GPU timer!");
+            return false;
+        }
+
         // Buffers
         DEBUG("Creating buffers...");
         CreateBuffers();
@@ -221,17 +308,60 @@ namespace Engine {
         }
         vkDeviceWaitIdle(device->logical_device);
 
+        // Destroy GPU timer
+        if (gpu_timer) {
+            DEBUG("Destroying Vulkan GPU timer...");
+            delete gpu_timer;
+            gpu_timer = nullptr;
+        }
+
+        // Destroy uploader, waits for the uploads still in flight
+        if (uploader) {
+            DEBUG("Destroying Vulkan uploader...");
+            delete uploader;
+            uploader = nullptr;
+        }
+
+        // Render graph attachments were released with the graph, their memory goes with them
+        deletion_queue->FreeMemory(attachment_memory);
+        attachment_memory = {};
+
+        // Run what was released so far, geometry ranges still point at the object buffers
+        deletion_queue->Flush();
+
         // Destroy buffers
         DEBUG("Destroying Vulkan buffers...");
         DestroyBuffers();
         
+        // Destroy bindless table
+        if (bindless_table) {
+            DEBUG("Destroying Vulkan bindless table...");
+            delete bindless_table;
+            bindless_table = nullptr;
+        }
+
         // Destroy shader module
         DEBUG("Destroying Vulkan shader modules...");
+        delete shader_module_cache;
+        shader_module_cache = nullptr;
+
+        // Save and destroy pipeline cache
+        DEBUG("Saving Vulkan pipeline cache...");
+        pipeline_cache->Save();
+        delete pipeline_cache;
+        pipeline_cache = nullptr;
 
         // Destroy sync objects
         DEBUG("Destroying Vulkan sync objects...");
         DestroySyncObjects();
 
+        // Destroy recorder
+        if (recorder) {
+            DEBUG("Destroying Vulkan recorder...");
+            delete recorder;
+            recorder = nullptr;
+        }
+
         // Destroy command buffers
         DEBUG("Destroying Vulkan command buffers...");
         DestroyCommandBuffers();
@@ -247,12 +377,40 @@ namespace Engine {
         DEBUG("Destroying Vulkan swapchain...");
         delete swapchain;
 
+        // Destroy deletion queue, the device is idle so everything left goes now
+        if (deletion_queue) {
+            DEBUG("Destroying Vulkan deletion queue...");
+            delete deletion_queue;
+            deletion_queue = nullptr;
+        }
+
+        // Destroy sampler and pipeline state caches, whatever is still referenced goes with them
+        if (sampler_cache) {
+            DEBUG("Destroying Vulkan sampler cache...");
+            delete sampler_cache;
+            sampler_cache = nullptr;
+        }
+        if (pipeline_state_cache) {
+            DEBUG("Destroying Vulkan pipeline state cache...");
+            delete pipeline_state_cache;
+            pipeline_state_cache = nullptr;
+        }
+
+        // Destroy memory allocator, frees the blocks left
+        if (memory_allocator) {
+            DEBUG("Destroying Vulkan memory allocator...");
+            delete memory_allocator;
+            memory_allocator = nullptr;
+        }
+
         DEBUG("Destroying device...");
         delete device;
 
         // Destroy surface
-        DEBUG("Destroying Vulkan surface...");
-        Platform::DestroyVulkanSurface(this);
+        if (!headless) {
+            DEBUG("Destroying Vulkan surface...");
+            Platform::DestroyVulkanSurface(this);
+        }
     };
 
     void VulkanRendererBackend::Resized(u16 width, u16 height) {
@@ -299,11 +457,19 @@ namespace Engine {
             return false;
         }
 
-        if (!in_flight_fences[current_frame]->Wait(UINT64_MAX)) {
-            WARN("In flight fence wait failure!");
+        if (!frame_timeline->Wait(frame_values[current_frame], UINT64_MAX)) {
+            WARN("In flight frame wait failure!");
             return false;
         }
 
+        // The GPU is done with this frame's instance, indirect and uniform regions, and with what was released before it.
+        deletion_queue->Collect(frame_timeline->GetCompleted());
+        instance_frame_offset = 0;
+        indirect_frame_offset = 0;
+        uniform_ring->BeginFrame(current_frame);
+        recorder->BeginFrame(current_frame);
+        stats = {};
+
         VkResult result = 
         swapchain->AcquireNextImageIndex(
             UINT64_MAX,
@@ -319,7 +485,18 @@ namespace Engine {
         VulkanCommandBuffer* command_buffer = graphics_command_buffers[image_index];
         command_buffer->Reset();
         command_buffer->Begin(false, false, false);
+        primary_context = {command_buffer, false, 0};
+        gpu_timer->BeginFrame(current_frame, command_buffer);
+
+        SetDynamicState(command_buffer);
+
+        // world_renderpass->render_area.z = width;
+        // world_renderpass->render_area.w = height;
+
+        return true;
+    };
 
+    void VulkanRendererBackend::SetDynamicState(VulkanCommandBuffer* command_buffer) {
         // Dynamic state
         VkViewport viewport;
         viewport.x = 0.0f;
@@ -337,27 +514,25 @@ namespace Engine {
 
         vkCmdSetViewport(command_buffer->handle, 0, 1, &viewport);
         vkCmdSetScissor(command_buffer->handle, 0, 1, &scissor);
-
-        // world_renderpass->render_area.z = width;
-        // world_renderpass->render_area.w = height;
-
-        return true;
     };
 
     b8 VulkanRendererBackend::EndFrame(f32 delta_time) {
         VulkanCommandBuffer* command_buffer = graphics_command_buffers[image_index];
+        if (headless) {
+            swapchain->RecordReadback(command_buffer, image_index);
+        }
+        gpu_timer->EndFrame(command_buffer);
         command_buffer->End();
 
-        // Make sure the previous frame is not using this image (i.e. its fence is being waited on)
-        if (images_in_flight[image_index] != VK_NULL_HANDLE) { 
-            images_in_flight[image_index]->Wait(UINT64_MAX);
+        // Make sure the previous frame is not using this image
+        if (!frame_timeline->Wait(image_values[image_index], UINT64_MAX)) {
+            WARN("Swapchain image wait failure!");
+            return false;
         }
 
-        // Mark the image fence as in-use by this frame.
-        images_in_flight[image_index] = in_flight_fences[current_frame];
-
-        // Reset the fence for use on the next frame
-        in_flight_fences[current_frame]->Reset();
+        // Uploads recorded since the last frame go first, their barriers (or acquires waiting on the
+        // transfer queue) order them before this frame.
+        uploader->Flush();
         
         // Submit the queue and wait for the operation to complete.
         // Begin queue submission
@@ -367,12 +542,23 @@ namespace Engine {
         submit_info.commandBufferCount = 1;
         submit_info.pCommandBuffers = &command_buffer->handle;
 
-        // The semaphore(s) to be signaled when the queue is complete.
-        submit_info.signalSemaphoreCount = 1;
-        submit_info.pSignalSemaphores = &queue_complete_semaphores[current_frame];
+        // The semaphore(s) to be signaled when the queue is complete, the timeline always goes last.
+        // Headless frames are never acquired or presented, the timeline alone tracks them.
+        u64 frame_value = frame_timeline->GetNextValue();
+        VkSemaphore signal_semaphores[2] = {queue_complete_semaphores[current_frame], frame_timeline->handle};
+        u64 signal_values[2] = {0, frame_value};
+        u32 signal_count = headless ? 1 : 2;
+
+        VkTimelineSemaphoreSubmitInfo timeline_info = {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        timeline_info.signalSemaphoreValueCount = signal_count;
+        timeline_info.pSignalSemaphoreValues = &signal_values[2 - signal_count];
+        submit_info.pNext = &timeline_info;
+
+        submit_info.signalSemaphoreCount = signal_count;
+        submit_info.pSignalSemaphores = &signal_semaphores[2 - signal_count];
 
         // Wait semaphore ensures that the operation cannot begin until the image is available.
-        submit_info.waitSemaphoreCount = 1;
+        submit_info.waitSemaphoreCount = headless ? 0 : 1;
         submit_info.pWaitSemaphores = &image_available_semaphores[current_frame];
 
         // Each semaphore waits on the corresponding pipeline stage to complete. 1:1 ratio.
@@ -385,13 +571,23 @@ namespace Engine {
             device->graphics_queue,
             1,
             &submit_info,
-            in_flight_fences[current_frame]->handle);
+            VK_NULL_HANDLE);
         if (result != VK_SUCCESS) {
             ERROR("vkQueueSubmit failed with result: %s", VulkanResultString(result, true));
             return false;
         }
 
         command_buffer->UpdateSubmitted();
+        frame_timeline->Submitted(frame_value);
+        frame_values[current_frame] = frame_value;
+        image_values[image_index] = frame_value;
+        deletion_queue->Submit(frame_value);
+        gpu_timer->Submitted(frame_value);
+
+        if (headless) {
+            swapchain->SubmitReadback(image_index, frame_value);
+            return true;
+        }
 
         VkResult present_result = swapchain->Present(
             device->graphics_queue, 
@@ -426,7 +622,7 @@ namespace Engine {
     };
 
     b8 VulkanRendererBackend::SwapchainCreate(u16 width, u16 height) {
-        swapchain = new VulkanSwapchain(width, height);
+        swapchain = new VulkanSwapchain(width, height, headless);
         return swapchain->ready;
     };
 
@@ -437,7 +633,12 @@ namespace Engine {
         if (swapchain) {
             delete swapchain;
         }
-        return SwapchainCreate(width, height);
+        if (!SwapchainCreate(width, height)) {
+            return false;
+        }
+        // Nothing submitted uses the new images, the count may differ too
+        image_values.assign(swapchain->image_count, 0);
+        return true;
     };
 
     b8 VulkanRendererBackend::SwapchainFullRecreate() {
@@ -458,10 +659,6 @@ namespace Engine {
         // Wait for any operations to complete.
         vkDeviceWaitIdle(device->logical_device);
 
-        for (u32 i = 0; i < swapchain->image_count; ++i) {
-            images_in_flight[i] = nullptr;
-        }
-
         SwapchainRecreate(cached_width, cached_height);
 
         width = cached_width;
@@ -484,15 +681,7 @@ namespace Engine {
     b8 VulkanRendererBackend::RenderpassesCreate(std::vector<RenderpassCreateInfo> renderpasses_config) {
         for (u32 i = 0; i < renderpasses_config.size(); ++i) {
             RenderpassCreateInfo& config = renderpasses_config[i];
-            VulkanRenderpass* pass = new VulkanRenderpass(
-                config.name,
-                config.render_area,
-                config.clear_color,
-                1.0f, 0, 
-                (RenderpassClearFlag)config.clear_flags,
-                !!config.prev_name.size(),
-                !!config.next_name.size()
-            );
+            VulkanRenderpass* pass = static_cast<VulkanRenderpass*>(CreateRenderpass(config));
 
             if (!pass || !pass->ready) {
                 delete pass;
@@ -510,7 +699,6 @@ namespace Engine {
     void VulkanRendererBackend::CreateSyncObjects() {
         image_available_semaphores.resize(swapchain->max_frames_in_flight);
         queue_complete_semaphores.resize(swapchain->max_frames_in_flight);
-        in_flight_fences.reserve(swapchain->max_frames_in_flight);
 
         for (u8 i = 0; i < swapchain->max_frames_in_flight; ++i) {
             VkSemaphoreCreateInfo image_sp_create_info = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
@@ -527,14 +715,12 @@ namespace Engine {
                 &image_sp_create_info,
                 allocator,
                 &queue_complete_semaphores[i]);
-
-            in_flight_fences.push_back(new VulkanFence(true));
         }
 
-        images_in_flight.resize(swapchain->image_count);
-        for (u32 i = 0; i < swapchain->image_count; ++i) {
-            images_in_flight[i] = nullptr;
-        }
+        // Value 0 is complete from the start, unused slots and images never block
+        frame_timeline = new VulkanTimeline();
+        frame_values.assign(swapchain->max_frames_in_flight, 0);
+        image_values.assign(swapchain->image_count, 0);
 
         DEBUG("Sync objects successfully created.");
     };
@@ -561,12 +747,13 @@ namespace Engine {
         image_available_semaphores.clear();
         queue_complete_semaphores.clear();
 
-        for (u32 i = 0; i < in_flight_fences.size(); ++i) {
-            delete in_flight_fences[i];
+        if (frame_timeline) {
+            delete frame_timeline;
+            frame_timeline = nullptr;
         }
- 
-        in_flight_fences.clear();
-        images_in_flight.clear();
+
+        frame_values.clear();
+        image_values.clear();
     };
 
     void VulkanRendererBackend::CreateCommandBuffers() {
@@ -604,7 +791,7 @@ namespace Engine {
         object_vertex_buffer = new VulkanBuffer(
             vertex_buffer_size,
             (VkBufferUsageFlagBits)(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT),
-            memory_property_flags, true, true);
+            memory_property_flags, true);
 
         if (!object_vertex_buffer->ready) {
             ERROR("Failed to create object_vertex_buffer ... ");
@@ -616,13 +803,68 @@ namespace Engine {
         object_index_buffer = new VulkanBuffer(
             index_buffer_size,
             (VkBufferUsageFlagBits)(VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT),
-            memory_property_flags, true, true);
+            memory_property_flags, true);
 
         if (!object_index_buffer->ready) {
             ERROR("Failed to create object_index_buffer ... ");
             return false;
         }
 
+        // Instance data, rewritten every frame so it stays host visible.
+        instance_frame_size = VULKAN_MAX_INSTANCES_PER_FRAME * sizeof(glm::mat4);
+        instance_frame_offset = 0;
+        instance_frame_count = swapchain->max_frames_in_flight;
+        u32 device_local_bits = device->supports_device_local_host_visible ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : 0;
+        instance_buffer = new VulkanBuffer(
+            instance_frame_size * instance_frame_count,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | device_local_bits,
+            false);
+
+        if (!instance_buffer->ready) {
+            ERROR("Failed to create instance_buffer ... ");
+            return false;
+        }
+        mapped_instance_buffer = (u8*)instance_buffer->LockMemory(0, VK_WHOLE_SIZE, 0);
+
+        // Material record index of every instance slot, read next to the model from binding 2.
+        instance_material_frame_size = VULKAN_MAX_INSTANCES_PER_FRAME * sizeof(u32);
+        instance_material_buffer = new VulkanBuffer(
+            instance_material_frame_size * instance_frame_count,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | device_local_bits,
+            false);
+
+        if (!instance_material_buffer->ready) {
+            ERROR("Failed to create instance_material_buffer ... ");
+            return false;
+        }
+        mapped_instance_material_buffer = (u8*)instance_material_buffer->LockMemory(0, VK_WHOLE_SIZE, 0);
+
+        indirect_frame_size = VULKAN_MAX_INDIRECT_DRAWS_PER_FRAME * sizeof(VkDrawIndexedIndirectCommand);
+        indirect_frame_offset = 0;
+        indirect_buffer = new VulkanBuffer(
+            indirect_frame_size * instance_frame_count,
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | device_local_bits,
+            false);
+
+        if (!indirect_buffer->ready) {
+            ERROR("Failed to create indirect_buffer ... ");
+            return false;
+        }
+        mapped_indirect_buffer = (u8*)indirect_buffer->LockMemory(0, VK_WHOLE_SIZE, 0);
+
+        uniform_ring = new VulkanUniformRing(
+            VULKAN_UNIFORM_RING_FRAME_SIZE,
+            swapchain->max_frames_in_flight,
+            device->properties.limits.minUniformBufferOffsetAlignment);
+
+        if (!uniform_ring->ready) {
+            ERROR("Failed to create uniform_ring ... ");
+            return false;
+        }
+
         DEBUG("Vulkan buffers created successfully.");
         return true;
     };
@@ -635,6 +877,25 @@ namespace Engine {
         if (object_index_buffer) {
             delete object_index_buffer;
         }
+        if (instance_buffer) {
+            instance_buffer->UnlockMemory();
+            mapped_instance_buffer = nullptr;
+            delete instance_buffer;
+        }
+        if (instance_material_buffer) {
+            instance_material_buffer->UnlockMemory();
+            mapped_instance_material_buffer = nullptr;
+            delete instance_material_buffer;
+        }
+        if (indirect_buffer) {
+            indirect_buffer->UnlockMemory();
+            mapped_indirect_buffer = nullptr;
+            delete indirect_buffer;
+        }
+        if (uniform_ring) {
+            delete uniform_ring;
+            uniform_ring = nullptr;
+        }
     };
     
     void VulkanRendererBackend::DrawGeometry(GeometryRenderData data) {
@@ -642,7 +903,8 @@ namespace Engine {
             return;
         }
         VulkanGeometry* geometry = static_cast<VulkanGeometry*>(data.geometry);
-        VulkanCommandBuffer* command_buffer = graphics_command_buffers[image_index];
+        VulkanRecordingContext* context = GetRecordingContext();
+        VulkanCommandBuffer* command_buffer = context->command_buffer;
 
         // Material* material = data.geometry->GetMaterial();
 
@@ -663,6 +925,7 @@ namespace Engine {
 
         VkDeviceSize offsets[1] = {geometry->GetVertexBufferOffset()};
         vkCmdBindVertexBuffers(command_buffer->handle, 0, 1, &object_vertex_buffer->handle, (VkDeviceSize*)offsets);
+        context->indirect_buffers_bound = false;
 
         if (geometry->GetIndexCount()) {
             // Bind index buffer at offset.
@@ -675,6 +938,129 @@ namespace Engine {
         }
     };
 
+    b8 VulkanRendererBackend::DrawGeometryInstanced(Geometry* geometry_base, const glm::mat4* models, u32 count) {
+        if (!geometry_base || geometry_base->GetInternalId() == INVALID_ID || !count) {
+            return true;
+        }
+
+        // A range that doesn't fit stays reserved, the frame is out of instance space either way.
+        u64 size = sizeof(glm::mat4) * count;
+        u64 frame_offset = instance_frame_offset.fetch_add(size);
+        if (frame_offset + size > instance_frame_size) {
+            return false;
+        }
+
+        u32 frame_index = current_frame % instance_frame_count;
+        u64 offset = frame_index * instance_frame_size + frame_offset;
+        Platform::CpMemory(mapped_instance_buffer + offset, (void*)models, size);
+
+        VulkanGeometry* geometry = static_cast<VulkanGeometry*>(geometry_base);
+        VulkanRecordingContext* context = GetRecordingContext();
+        VulkanCommandBuffer* command_buffer = context->command_buffer;
+
+        // Every instance draws with the material recorded last.
+        u64 material_offset = frame_index * instance_material_frame_size + frame_offset / sizeof(glm::mat4) * sizeof(u32);
+        u32* material_indices = (u32*)(mapped_instance_material_buffer + material_offset);
+        for (u32 i = 0; i < count; ++i) {
+            material_indices[i] = context->material_index;
+        }
+
+        VkBuffer buffers[3] = {object_vertex_buffer->handle, instance_buffer->handle, instance_material_buffer->handle};
+        VkDeviceSize offsets[3] = {geometry->GetVertexBufferOffset(), offset, material_offset};
+        vkCmdBindVertexBuffers(command_buffer->handle, 0, 3, buffers, offsets);
+        context->indirect_buffers_bound = false;
+
+        if (geometry->GetIndexCount()) {
+            vkCmdBindIndexBuffer(command_buffer->handle, object_index_buffer->handle, geometry->GetIndexBufferOffset(), VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexed(command_buffer->handle, geometry->GetIndexCount(), count, 0, 0, 0);
+        } else {
+            vkCmdDraw(command_buffer->handle, geometry->GetVertexCount(), count, 0, 0);
+        }
+        return true;
+    };
+
+    b8 VulkanRendererBackend::SupportsIndirectDraw() {
+        // Per draw transforms are found through firstInstance.
+        return device->features.drawIndirectFirstInstance;
+    };
+
+    b8 VulkanRendererBackend::DrawGeometryIndirect(const GeometryDrawGroup* groups, u32 group_count, const glm::mat4* models, const u32* material_indices, u32 model_count) {
+        if (!SupportsIndirectDraw() || !group_count) {
+            return false;
+        }
+
+        u64 models_size = sizeof(glm::mat4) * model_count;
+        u64 commands_size = sizeof(VkDrawIndexedIndirectCommand) * group_count;
+        if (instance_frame_offset + models_size > instance_frame_size || indirect_frame_offset + commands_size > indirect_frame_size) {
+            return false;
+        }
+
+        // Everything has to be addressable from offset 0 of the shared buffers.
+        for (u32 i = 0; i < group_count; ++i) {
+            if (!groups[i].geometry || groups[i].geometry->GetInternalId() == INVALID_ID) {
+                return false;
+            }
+            VulkanGeometry* geometry = static_cast<VulkanGeometry*>(groups[i].geometry);
+            if (!geometry->GetIndexCount() || 
+                geometry->GetVertexBufferOffset() % geometry->GetVertexElementSize() || 
+                geometry->GetIndexBufferOffset() % sizeof(u32)) {
+                return false;
+            }
+        }
+
+        // Other recording threads may have taken the space since the check above, the caller then draws directly.
+        u64 models_offset = instance_frame_offset.fetch_add(models_size);
+        u64 commands_offset = indirect_frame_offset.fetch_add(commands_size);
+        if (models_offset + models_size > instance_frame_size || commands_offset + commands_size > indirect_frame_size) {
+            return false;
+        }
+
+        u32 frame_index = current_frame % instance_frame_count;
+        u64 instance_base = frame_index * instance_frame_size;
+        u32 first_instance = models_offset / sizeof(glm::mat4);
+        Platform::CpMemory(mapped_instance_buffer + instance_base + models_offset, (void*)models, models_size);
+        u64 material_base = frame_index * instance_material_frame_size;
+        Platform::CpMemory(mapped_instance_material_buffer + material_base + first_instance * sizeof(u32), (void*)material_indices, sizeof(u32) * model_count);
+
+        u64 indirect_offset = frame_index * indirect_frame_size + commands_offset;
+        VkDrawIndexedIndirectCommand* commands = (VkDrawIndexedIndirectCommand*)(mapped_indirect_buffer + indirect_offset);
+        for (u32 i = 0; i < group_count; ++i) {
+            VulkanGeometry* geometry = static_cast<VulkanGeometry*>(groups[i].geometry);
+            commands[i].indexCount = geometry->GetIndexCount();
+            commands[i].instanceCount = groups[i].instance_count;
+            commands[i].firstIndex = geometry->GetIndexBufferOffset() / sizeof(u32);
+            commands[i].vertexOffset = geometry->GetVertexBufferOffset() / geometry->GetVertexElementSize();
+            commands[i].firstInstance = first_instance + groups[i].first_instance;
+        }
+
+        VulkanRecordingContext* context = GetRecordingContext();
+        VulkanCommandBuffer* command_buffer = context->command_buffer;
+        if (!context->indirect_buffers_bound) {
+            VkBuffer buffers[3] = {object_vertex_buffer->handle, instance_buffer->handle, instance_material_buffer->handle};
+            VkDeviceSize offsets[3] = {0, instance_base, material_base};
+            vkCmdBindVertexBuffers(command_buffer->handle, 0, 3, buffers, offsets);
+            vkCmdBindIndexBuffer(command_buffer->handle, object_index_buffer->handle, 0, VK_INDEX_TYPE_UINT32);
+            context->indirect_buffers_bound = true;
+        }
+
+        if (device->features.multiDrawIndirect) {
+            vkCmdDrawIndexedIndirect(command_buffer->handle, indirect_buffer->handle, indirect_offset, group_count, sizeof(VkDrawIndexedIndirectCommand));
+        } else {
+            for (u32 i = 0; i < group_count; ++i) {
+                vkCmdDrawIndexedIndirect(command_buffer->handle, indirect_buffer->handle, indirect_offset + i * sizeof(VkDrawIndexedIndirectCommand), 1, sizeof(VkDrawIndexedIndirectCommand));
+            }
+        }
+        return true;
+    };
+
+    b8 VulkanRendererBackend::RecordParallel(u32 job_count, const RendererRecordJob& job) {
+        return recorder->Record(graphics_command_buffers[image_index], parallel_renderpass, job_count, job);
+    };
+
+    u32 VulkanRendererBackend::GetRecordingThreadCount() {
+        return recorder ? recorder->GetThreadCount() : 1;
+    };
+
     Texture* VulkanRendererBackend::CreateTexture(TextureCreateInfo& info) {
         return new VulkanTexture(info);
     };
@@ -697,24 +1083,16 @@ namespace Engine {
         VulkanGeometryCreateInfo create_info = {};
         
         create_info.vertex_count = info.vertex_count;
+        create_info.vertex_element_size = info.vertex_element_size;
         create_info.vertex_size = info.vertex_element_size * info.vertex_count;
 
         create_info.index_count = info.index_count;
         create_info.index_size = info.index_element_size * info.index_count;
         
-        create_info.vertex_memory = UploadDataRange(
-            device->graphics_command_pool, 
-            0, device->graphics_queue, 
-            object_vertex_buffer, 
-            create_info.vertex_size, info.vertices);  
-        
+        create_info.vertex_memory = UploadDataRange(object_vertex_buffer, create_info.vertex_size, info.vertices);
 
         if (info.indices) {
-            create_info.index_memory = UploadDataRange(
-                device->graphics_command_pool, 
-                0, device->graphics_queue, 
-                object_index_buffer, 
-                create_info.index_size, info.indices);
+            create_info.index_memory = UploadDataRange(object_index_buffer, create_info.index_size, info.indices);
         }
 
         VulkanGeometry* g = new VulkanGeometry(info, create_info);
@@ -725,10 +1103,11 @@ namespace Engine {
     };
 
     void VulkanRendererBackend::FreeGeometry(VulkanGeometry* geometry) {
-        vkDeviceWaitIdle(device->logical_device);
-        FreeDataRange(object_vertex_buffer, geometry->GetVertexBufferOffset(), geometry->GetVertexSize());
-        if (geometry->GetIndexSize()) {
-            FreeDataRange(object_index_buffer, geometry->GetIndexBufferOffset(), geometry->GetVertexSize());
+        if (geometry->HasVertexMemory()) {
+            FreeDataRange(object_vertex_buffer, geometry->GetVertexBufferOffset(), geometry->GetVertexSize());
+        }
+        if (geometry->HasIndexMemory()) {
+            FreeDataRange(object_index_buffer, geometry->GetIndexBufferOffset(), geometry->GetIndexSize());
         }
     };
 
@@ -746,15 +1125,17 @@ namespace Engine {
         
         
         // HACK: не хорошо хардкоженые использовать
-        vk_config.pool_sizes.push_back((VkDescriptorPoolSize){VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1024});
+        vk_config.pool_sizes.push_back((VkDescriptorPoolSize){VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1024});
         vk_config.pool_sizes.push_back((VkDescriptorPoolSize){VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4096});
+        // Material buffer sets of bindless shaders, one per frame in flight copy.
+        vk_config.pool_sizes.push_back((VkDescriptorPoolSize){VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3});
 
         VulkanShaderDescrptorSetConfig global_descriptor = {};
 
         VkDescriptorSetLayoutBinding global_ubo_binding = {};
         global_ubo_binding.binding = (u32)VulkanShaderDescriptorBindingIndex::UBO;
         global_ubo_binding.descriptorCount = 1;
-        global_ubo_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        global_ubo_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         global_ubo_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
         global_descriptor.bindings.push_back(global_ubo_binding);
@@ -767,7 +1148,7 @@ namespace Engine {
             VkDescriptorSetLayoutBinding instance_ubo_binding = {};
             instance_ubo_binding.binding = (u32)VulkanShaderDescriptorBindingIndex::UBO;
             instance_ubo_binding.descriptorCount = 1;
-            instance_ubo_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            instance_ubo_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
             instance_ubo_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
             instance_descriptor.bindings.push_back(instance_ubo_binding);
@@ -806,6 +1187,9 @@ namespace Engine {
     };
 
     Renderpass* VulkanRendererBackend::CreateRenderpass(RenderpassCreateInfo& info) {
+        if (info.attachments.size()) {
+            return new VulkanRenderpass(info);
+        }
         return new VulkanRenderpass(
             info.name, info.render_area,
             info.clear_color, 1.0f, 0,
@@ -819,7 +1203,115 @@ namespace Engine {
         return swapchain->render_textures[index];
     };
 
-    Texture* VulkanRendererBackend::GetDepthAttachment() {
-         return swapchain->depth_texture;
+    b8 VulkanRendererBackend::CreateAttachments(const std::vector<RenderAttachmentCreateInfo>& infos, u32 width, u32 height, std::vector<Texture*>& out_textures) {
+        // The previous attachments were released already, their memory goes once frames still drawing to it are done.
+        deletion_queue->FreeMemory(attachment_memory);
+        attachment_memory = {};
+
+        // Images first, unbound, so the memory can be sized from their requirements.
+        std::vector<VulkanImage*> images;
+        std::vector<b8> shared(infos.size(), false);
+        std::vector<VkMemoryRequirements> slots;
+        u32 memory_type_bits = UINT32_MAX;
+        u64 unaliased_size = 0;
+        for (u32 i = 0; i < infos.size(); ++i) {
+            const RenderAttachmentCreateInfo& info = infos[i];
+            b8 is_depth = info.format == RenderAttachmentFormat::DEPTH;
+            VkImageUsageFlags usage = is_depth ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            // Contents that never leave the renderpass don't need backing memory on tiled GPUs.
+            usage |= info.sampled ? VK_IMAGE_USAGE_SAMPLED_BIT : VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+            VulkanImage* image = new VulkanImage(
+                VK_IMAGE_TYPE_2D,
+                width,
+                height,
+                is_depth ? device->depth_format : swapchain->image_format.format,
+                VK_IMAGE_TILING_OPTIMAL,
+                usage,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                false,
+                is_depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT,
+                1,
+                false
+            );
+            images.push_back(image);
+
+            VkImageMemoryRequirementsInfo2 requirements_info = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2};
+            requirements_info.image = image->handle;
+            VkMemoryDedicatedRequirements dedicated_requirements = {VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS};
+            VkMemoryRequirements2 requirements = {VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+            requirements.pNext = &dedicated_requirements;
+            vkGetImageMemoryRequirements2(device->logical_device, &requirements_info, &requirements);
+            VkMemoryRequirements& image_requirements = requirements.memoryRequirements;
+            unaliased_size += image_requirements.size;
+
+            // Images the driver wants alone, or that can't live in the same memory type as the rest, get their own.
+            if (dedicated_requirements.requiresDedicatedAllocation || !(memory_type_bits & image_requirements.memoryTypeBits)) {
+                if (!memory_allocator->AllocateImage(image->handle, VK_IMAGE_TILING_OPTIMAL, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &image->allocation)) {
+                    ERROR("VulkanRendererBackend::CreateAttachments - failed allocating attachment memory.");
+                    break;
+                }
+                continue;
+            }
+            shared[i] = true;
+            memory_type_bits &= image_requirements.memoryTypeBits;
+            if (info.memory_slot >= slots.size()) {
+                slots.resize(info.memory_slot + 1, {0, 1, 0});
+            }
+            slots[info.memory_slot].size = std::max(slots[info.memory_slot].size, image_requirements.size);
+            slots[info.memory_slot].alignment = std::max(slots[info.memory_slot].alignment, image_requirements.alignment);
+        }
+
+        // Slots one after another, the images of a slot overlap at its offset.
+        std::vector<u64> slot_offsets(slots.size());
+        VkMemoryRequirements memory_requirements = {0, 1, memory_type_bits};
+        for (u32 slot = 0; slot < slots.size(); ++slot) {
+            slot_offsets[slot] = GetAligned(memory_requirements.size, slots[slot].alignment);
+            memory_requirements.size = slot_offsets[slot] + slots[slot].size;
+            memory_requirements.alignment = std::max(memory_requirements.alignment, slots[slot].alignment);
+        }
+
+        b8 success = images.size() == infos.size();
+        if (success && memory_requirements.size) {
+            success = memory_allocator->AllocateMemory(memory_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VulkanAllocationKind::OPTIMAL, &attachment_memory);
+        }
+        for (u32 i = 0; success && i < images.size(); ++i) {
+            if (!shared[i]) {
+                continue;
+            }
+            u64 offset = attachment_memory.offset + slot_offsets[infos[i].memory_slot];
+            VkResult result = vkBindImageMemory(device->logical_device, images[i]->handle, attachment_memory.memory, offset);
+            if (!IsVulkanResultSuccess(result)) {
+                ERROR("VulkanRendererBackend::CreateAttachments - failed binding attachment memory: '%s'", VulkanResultString(result, true));
+                success = false;
+            }
+        }
+        if (!success) {
+            for (VulkanImage* image : images) {
+                delete image;
+            }
+            deletion_queue->FreeMemory(attachment_memory);
+            attachment_memory = {};
+            return false;
+        }
+
+        for (u32 i = 0; i < images.size(); ++i) {
+            b8 is_depth = infos[i].format == RenderAttachmentFormat::DEPTH;
+            images[i]->VulkanImageViewCreate(images[i]->format, is_depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT);
+
+            TextureCreateInfo create_info;
+            create_info.name = is_depth ? "__render_graph_depth_attachment__" : "__render_graph_color_attachment__";
+            create_info.channel_count = 4;
+            create_info.flags = TextureFlag::IS_WRITEABLE | TextureFlag::IS_WRAPPED;
+            create_info.width = width;
+            create_info.height = height;
+            create_info.pixels = nullptr;
+
+            out_textures.push_back(new VulkanTexture(create_info, images[i]));
+        }
+
+        DEBUG("Render graph attachments - %u images, %llu bytes shared in %u slots, %llu bytes without aliasing.",
+            (u32)images.size(), attachment_memory.size, (u32)slots.size(), unaliased_size);
+        return true;
     };
 };  
\ No newline at end of file
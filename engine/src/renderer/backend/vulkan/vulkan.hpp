@@ -6,12 +6,24 @@
 #include "swapchain.hpp"
 #include "renderpass.hpp"
 #include "fence.hpp"
+#include "timeline.hpp"
 #include "buffer.hpp"
 #include "material.hpp"
 #include "resources/texture/texture.hpp"
 #include "texture.hpp"
 #include "geometry.hpp"
 #include "shaders/shader.hpp"
+#include "shaders/shader_module_cache.hpp"
+#include "pipeline_cache.hpp"
+#include "pipeline_state_cache.hpp"
+#include "sampler_cache.hpp"
+#include "bindless.hpp"
+#include "uniform_ring.hpp"
+#include "recorder.hpp"
+#include "memory_allocator.hpp"
+#include "uploader.hpp"
+#include "deletion_queue.hpp"
+#include "gpu_timer.hpp"
 #include "core/utils/freelist.hpp"
 
 #include <vulkan/vulkan.h>
@@ -19,6 +31,11 @@
 #define WORLD_RENDERPASS_NAME "WorldRenderpass"
 #define UI_RENDERPASS_NAME "UIRenderpass"
 
+// Model matrices per frame for instanced draws.
+#define VULKAN_MAX_INSTANCES_PER_FRAME 16384
+// Indirect draw records per frame.
+#define VULKAN_MAX_INDIRECT_DRAWS_PER_FRAME 8192
+
 namespace Engine {
 
     class VulkanRendererBackend : public RendererBackend {
@@ -52,13 +69,46 @@ namespace Engine {
             VkAllocationCallbacks* GetVulkanAllocator() { return allocator; };
             VulkanDevice* GetVulkanDevice() { return device; };
             VulkanSwapchain* GetVulkanSwapchain () { return swapchain; };
+            // Where the frame's final pass leaves the swapchain image, ready for the readback copy when headless.
+            VkImageLayout GetPresentLayout() { return headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; };
+            VkPipelineCache GetPipelineCache() { return pipeline_cache ? pipeline_cache->handle : VK_NULL_HANDLE; };
+            VulkanShaderModuleCache* GetShaderModuleCache() { return shader_module_cache; };
+            // Set layouts, pipeline layouts and pipelines shared by content.
+            VulkanPipelineStateCache* GetPipelineStateCache() { return pipeline_state_cache; };
+            // Samplers shared by create parameters, null outside of the backend's lifetime.
+            VulkanSamplerCache* GetSamplerCache() { return sampler_cache; };
+            // Null when the device lacks descriptor indexing, shaders then keep per material descriptor sets.
+            VulkanBindlessTable* GetBindlessTable() { return bindless_table; };
+            VulkanUniformRing* GetUniformRing() { return uniform_ring; };
+            // Every buffer and image allocates device memory through it.
+            VulkanMemoryAllocator* GetMemoryAllocator() { return memory_allocator; };
+            // Null before initialization and after shutdown.
+            VulkanUploader* GetUploader() { return uploader; };
+            // Null outside of the backend's lifetime, releases then destroy right away.
+            VulkanDeletionQueue* GetDeletionQueue() { return deletion_queue; };
+            // Signaled with an increasing value by every graphics queue submission, frames and uploads alike.
+            // Null outside of the backend's lifetime.
+            VulkanTimeline* GetFrameTimeline() { return frame_timeline; };
+            // Timestamps of the frame and its renderpasses, null outside of the backend's lifetime.
+            VulkanGpuTimer* GetGpuTimer() { return gpu_timer; };
+            // The job's context on recording threads, the frame command buffer everywhere else.
+            VulkanRecordingContext* GetRecordingContext() {
+                VulkanRecordingContext* context = VulkanRecorder::GetThreadContext();
+                return context ? context : &primary_context;
+            };
+            // Set by renderpasses begun with RenderpassContents::PARALLEL until they end.
+            void SetParallelRenderpass(VulkanRenderpass* renderpass) { parallel_renderpass = renderpass; };
+            // Viewport and scissor covering the frame.
+            void SetDynamicState(VulkanCommandBuffer* command_buffer);
 
             void SetImageIndex(u32 index) { image_index = index; };
             u32 GetImageIndex() { return image_index; };
             u32 GetImageCount() { return swapchain->image_count; };
 
             Texture* GetWindowAttachment(u32 index);
-            Texture* GetDepthAttachment();
+            b8 CreateAttachments(const std::vector<RenderAttachmentCreateInfo>& infos, u32 width, u32 height, std::vector<Texture*>& out_textures);
+            b8 ReadFrame(RendererFrameReadback* out_readback, b8 wait) { return swapchain->ReadFrame(out_readback, wait); };
+            b8 GetFrameTimings(RendererFrameTimings* out_timings) { return gpu_timer ? gpu_timer->GetFrameTimings(out_timings) : false; };
 
             void SetCurrentFrame(u32 index) { current_frame = index; };
             u32 GetCurrentFrame() { return current_frame; };
@@ -76,7 +126,8 @@ namespace Engine {
 
             Renderpass* GetRenderpass(std::string name) { return renderpasses[name]; };
 
-            FreelistNode* UploadDataRange(VkCommandPool pool, VkFence fence, VkQueue queue, VulkanBuffer* buffer, u64 size, void* data);
+            // Takes a range of buffer and queues data for it on the uploader.
+            FreelistNode* UploadDataRange(VulkanBuffer* buffer, u64 size, void* data);
             void FreeDataRange(VulkanBuffer* buffer, u64 offset, u64 size);
 
             Texture* CreateTexture(TextureCreateInfo& info);
@@ -89,9 +140,14 @@ namespace Engine {
 
             void FreeGeometry(VulkanGeometry* geometry);
 
-            VulkanCommandBuffer* GetCurrentCommandBuffer() { return graphics_command_buffers[image_index]; };
+            VulkanCommandBuffer* GetCurrentCommandBuffer() { return GetRecordingContext()->command_buffer; };
         private:
             void DrawGeometry(GeometryRenderData data);
+            b8 DrawGeometryInstanced(Geometry* geometry, const glm::mat4* models, u32 count);
+            b8 DrawGeometryIndirect(const GeometryDrawGroup* groups, u32 group_count, const glm::mat4* models, const u32* material_indices, u32 model_count);
+            b8 SupportsIndirectDraw();
+            b8 RecordParallel(u32 job_count, const RendererRecordJob& job);
+            u32 GetRecordingThreadCount();
 
             b8 SwapchainCreate(u16 width, u16 height);
             b8 SwapchainRecreate(u16 width, u16 height);
@@ -124,18 +180,56 @@ namespace Engine {
             std::vector<VkSemaphore> image_available_semaphores;
             std::vector<VkSemaphore> queue_complete_semaphores;
 
-            u32 in_flight_fence_count;
-            std::vector<VulkanFence*> in_flight_fences;
-            std::vector<VulkanFence*> images_in_flight;
+            // Timeline value of the last submission per frame in flight and per swapchain image, 0 when unused.
+            VulkanTimeline* frame_timeline;
+            std::vector<u64> frame_values;
+            std::vector<u64> image_values;
 
             VulkanBuffer* object_vertex_buffer;
             VulkanBuffer* object_index_buffer;
 
+            // Host visible ring, one region per frame in flight, written by DrawGeometryInstanced.
+            // Offsets are atomic, recording threads reserve their ranges concurrently.
+            VulkanBuffer* instance_buffer;
+            u8* mapped_instance_buffer;
+            u64 instance_frame_size;
+            std::atomic<u64> instance_frame_offset;
+            u32 instance_frame_count;
+            // Bindless material record of each instance slot, same per frame layout with a u32 per slot.
+            VulkanBuffer* instance_material_buffer;
+            u8* mapped_instance_material_buffer;
+            u64 instance_material_frame_size;
+
+            // Indirect records, same per frame layout as the instance buffer.
+            VulkanBuffer* indirect_buffer;
+            u8* mapped_indirect_buffer;
+            u64 indirect_frame_size;
+            std::atomic<u64> indirect_frame_offset;
+
+            // Recording state of the frame command buffer.
+            VulkanRecordingContext primary_context;
+            VulkanRecorder* recorder;
+            VulkanRenderpass* parallel_renderpass;
+
+            // Global uniform blocks of every shader, bound with dynamic offsets.
+            VulkanUniformRing* uniform_ring;
+
             u32 image_index;
             u32 current_frame;
 
             VulkanDevice* device;
+            VulkanMemoryAllocator* memory_allocator;
+            // Render graph attachments placed over each other, see CreateAttachments.
+            VulkanAllocation attachment_memory;
+            VulkanUploader* uploader;
+            VulkanDeletionQueue* deletion_queue;
+            VulkanGpuTimer* gpu_timer;
             VulkanSwapchain* swapchain;
+            VulkanPipelineCache* pipeline_cache;
+            VulkanShaderModuleCache* shader_module_cache;
+            VulkanPipelineStateCache* pipeline_state_cache;
+            VulkanSamplerCache* sampler_cache;
+            VulkanBindlessTable* bindless_table;
             VulkanRenderpass* world_renderpass;
             VulkanRenderpass* ui_renderpass;
 
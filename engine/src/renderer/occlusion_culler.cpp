@@ -0,0 +1,349 @@
+#include "occlusion_culler.hpp"
+
+#include "platform/platform.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <xmmintrin.h>
+    #define OCCLUSION_CULLER_SSE
+#endif
+
+namespace Engine {
+
+    #define OCCLUSION_TILES_X (OCCLUSION_BUFFER_WIDTH / OCCLUSION_TILE_WIDTH)
+    #define OCCLUSION_TILES_Y (OCCLUSION_BUFFER_HEIGHT / OCCLUSION_TILE_HEIGHT)
+
+    OcclusionCuller::OcclusionCuller() {
+        view_projection = glm::mat4(1.0f);
+
+        // Halve down to a single texel, the shorter side stays at 1 once it gets there.
+        u32 width = OCCLUSION_BUFFER_WIDTH;
+        u32 height = OCCLUSION_BUFFER_HEIGHT;
+        while (true) {
+            Level level;
+            level.width = width;
+            level.height = height;
+            level.min_depth.resize(width * height, 0.0f);
+            if (levels.size()) {
+                level.max_depth.resize(width * height, 0.0f);
+            }
+            levels.push_back(std::move(level));
+
+            if (width == 1 && height == 1) {
+                break;
+            }
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+    };
+
+    void OcclusionCuller::Begin(const glm::mat4& view_projection) {
+        this->view_projection = view_projection;
+        occluders.clear();
+        stats = {};
+        std::fill(levels[0].min_depth.begin(), levels[0].min_depth.end(), 0.0f);
+    };
+
+    void OcclusionCuller::AddOccluder(const glm::mat4& model, const std::vector<glm::vec3>* positions, const std::vector<u32>* indices) {
+        occluders.push_back({model, positions, indices});
+    };
+
+    void OcclusionCuller::Rasterize(WorkerPool* workers) {
+        f64 start = Platform::GetAbsoluteTime();
+
+        u32 thread_count = workers->GetThreadCount();
+        if (thread_bins.size() < thread_count) {
+            thread_bins.resize(thread_count);
+        }
+        for (ThreadBins& bins : thread_bins) {
+            bins.triangles.clear();
+            bins.bins.resize(OCCLUSION_TILES_X * OCCLUSION_TILES_Y);
+            for (std::vector<u32>& bin : bins.bins) {
+                bin.clear();
+            }
+        }
+
+        // Occluders are transformed and binned in parallel, then every tile is filled by one thread.
+        workers->Run(occluders.size(), [&](u32 job, u32 thread_index) {
+            BinOccluder(occluders[job], thread_bins[thread_index]);
+        });
+        workers->Run(OCCLUSION_TILES_X * OCCLUSION_TILES_Y, [&](u32 tile, u32 thread_index) {
+            RasterizeTile(tile);
+        });
+        BuildHierarchy();
+
+        stats.occluders = occluders.size();
+        for (ThreadBins& bins : thread_bins) {
+            stats.triangles += bins.triangles.size();
+        }
+        stats.raster_ms = (Platform::GetAbsoluteTime() - start) * 1000.0;
+    };
+
+    void OcclusionCuller::BinOccluder(const Occluder& occluder, ThreadBins& thread_bins) {
+        const std::vector<glm::vec3>& positions = *occluder.positions;
+        const std::vector<u32>& indices = *occluder.indices;
+        glm::mat4 mvp = view_projection * occluder.model;
+
+        std::vector<glm::vec3>& vertices = thread_bins.vertices;
+        vertices.resize(positions.size());
+        for (u32 i = 0; i < positions.size(); ++i) {
+            glm::vec4 clip = mvp * glm::vec4(positions[i], 1.0f);
+            if (clip.w < OCCLUSION_MIN_W) {
+                vertices[i] = glm::vec3(0.0f, 0.0f, -1.0f);
+                continue;
+            }
+            f32 inv_w = 1.0f / clip.w;
+            vertices[i] = glm::vec3(
+                (clip.x * inv_w * 0.5f + 0.5f) * OCCLUSION_BUFFER_WIDTH,
+                (clip.y * inv_w * 0.5f + 0.5f) * OCCLUSION_BUFFER_HEIGHT,
+                inv_w
+            );
+        }
+
+        for (u32 i = 0; i + 2 < indices.size(); i += 3) {
+            if (indices[i] >= vertices.size() || indices[i + 1] >= vertices.size() || indices[i + 2] >= vertices.size()) {
+                continue;
+            }
+            glm::vec3 v[3] = {vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]};
+
+            // Clipping is skipped, a triangle crossing the near plane or far outside the screen just doesn't occlude.
+            b8 usable = true;
+            for (u32 j = 0; j < 3; ++j) {
+                if (v[j].z < 0.0f ||
+                    v[j].x < -OCCLUSION_GUARD_BAND || v[j].x > OCCLUSION_BUFFER_WIDTH + OCCLUSION_GUARD_BAND ||
+                    v[j].y < -OCCLUSION_GUARD_BAND || v[j].y > OCCLUSION_BUFFER_HEIGHT + OCCLUSION_GUARD_BAND) {
+                    usable = false;
+                }
+            }
+            if (!usable) {
+                continue;
+            }
+
+            // Both windings are drawn, flipped to counter clockwise so the edge functions are positive inside.
+            f32 area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+            if (area == 0.0f) {
+                continue;
+            }
+            if (area < 0.0f) {
+                std::swap(v[1], v[2]);
+                area = -area;
+            }
+
+            Triangle triangle;
+            triangle.min_x = std::max((i32)std::floor(std::min(v[0].x, std::min(v[1].x, v[2].x))), 0);
+            triangle.min_y = std::max((i32)std::floor(std::min(v[0].y, std::min(v[1].y, v[2].y))), 0);
+            triangle.max_x = std::min((i32)std::floor(std::max(v[0].x, std::max(v[1].x, v[2].x))), OCCLUSION_BUFFER_WIDTH - 1);
+            triangle.max_y = std::min((i32)std::floor(std::max(v[0].y, std::max(v[1].y, v[2].y))), OCCLUSION_BUFFER_HEIGHT - 1);
+            if (triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y) {
+                continue;
+            }
+
+            // Edge k runs opposite vertex k, its function over the area is that vertex's barycentric weight.
+            for (u32 k = 0; k < 3; ++k) {
+                const glm::vec3& a = v[(k + 1) % 3];
+                const glm::vec3& b = v[(k + 2) % 3];
+                triangle.edge_a[k] = a.y - b.y;
+                triangle.edge_b[k] = b.x - a.x;
+                triangle.edge_c[k] = -(triangle.edge_a[k] * a.x + triangle.edge_b[k] * a.y);
+            }
+
+            // Inverse w is linear in screen space, so it interpolates as a plane.
+            f32 inv_area = 1.0f / area;
+            triangle.depth_a = (triangle.edge_a[0] * v[0].z + triangle.edge_a[1] * v[1].z + triangle.edge_a[2] * v[2].z) * inv_area;
+            triangle.depth_b = (triangle.edge_b[0] * v[0].z + triangle.edge_b[1] * v[1].z + triangle.edge_b[2] * v[2].z) * inv_area;
+            triangle.depth_c = (triangle.edge_c[0] * v[0].z + triangle.edge_c[1] * v[1].z + triangle.edge_c[2] * v[2].z) * inv_area;
+
+            u32 index = thread_bins.triangles.size();
+            thread_bins.triangles.push_back(triangle);
+            for (i32 ty = triangle.min_y / OCCLUSION_TILE_HEIGHT; ty <= triangle.max_y / OCCLUSION_TILE_HEIGHT; ++ty) {
+                for (i32 tx = triangle.min_x / OCCLUSION_TILE_WIDTH; tx <= triangle.max_x / OCCLUSION_TILE_WIDTH; ++tx) {
+                    thread_bins.bins[ty * OCCLUSION_TILES_X + tx].push_back(index);
+                }
+            }
+        }
+    };
+
+    void OcclusionCuller::RasterizeTile(u32 tile) {
+        i32 tile_x = (tile % OCCLUSION_TILES_X) * OCCLUSION_TILE_WIDTH;
+        i32 tile_y = (tile / OCCLUSION_TILES_X) * OCCLUSION_TILE_HEIGHT;
+        f32* depth = levels[0].min_depth.data();
+
+        for (ThreadBins& bins : thread_bins) {
+            for (u32 index : bins.bins[tile]) {
+                const Triangle& triangle = bins.triangles[index];
+                // Columns go in groups of 4 from a multiple of 4, tiles are multiples of 4 wide so groups stay inside.
+                i32 x0 = std::max(triangle.min_x, tile_x) & ~3;
+                i32 x1 = std::min(triangle.max_x, tile_x + OCCLUSION_TILE_WIDTH - 1);
+                i32 y0 = std::max(triangle.min_y, tile_y);
+                i32 y1 = std::min(triangle.max_y, tile_y + OCCLUSION_TILE_HEIGHT - 1);
+
+#ifdef OCCLUSION_CULLER_SSE
+                __m128 zero = _mm_setzero_ps();
+                __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+                __m128 edge_a0 = _mm_set1_ps(triangle.edge_a[0]);
+                __m128 edge_a1 = _mm_set1_ps(triangle.edge_a[1]);
+                __m128 edge_a2 = _mm_set1_ps(triangle.edge_a[2]);
+                __m128 depth_a = _mm_set1_ps(triangle.depth_a);
+#endif
+                for (i32 y = y0; y <= y1; ++y) {
+                    // Pixel centers, the row's y terms are constant across it.
+                    f32 py = y + 0.5f;
+                    f32 row0 = triangle.edge_b[0] * py + triangle.edge_c[0];
+                    f32 row1 = triangle.edge_b[1] * py + triangle.edge_c[1];
+                    f32 row2 = triangle.edge_b[2] * py + triangle.edge_c[2];
+                    f32 row_depth = triangle.depth_b * py + triangle.depth_c;
+                    f32* row = depth + y * OCCLUSION_BUFFER_WIDTH;
+#ifdef OCCLUSION_CULLER_SSE
+                    __m128 row_e0 = _mm_set1_ps(row0);
+                    __m128 row_e1 = _mm_set1_ps(row1);
+                    __m128 row_e2 = _mm_set1_ps(row2);
+                    __m128 row_z = _mm_set1_ps(row_depth);
+                    for (i32 x = x0; x <= x1; x += 4) {
+                        __m128 px = _mm_add_ps(_mm_set1_ps((f32)x), offsets);
+                        __m128 e0 = _mm_add_ps(_mm_mul_ps(edge_a0, px), row_e0);
+                        __m128 e1 = _mm_add_ps(_mm_mul_ps(edge_a1, px), row_e1);
+                        __m128 e2 = _mm_add_ps(_mm_mul_ps(edge_a2, px), row_e2);
+                        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+                        if (!_mm_movemask_ps(inside)) {
+                            continue;
+                        }
+                        __m128 z = _mm_add_ps(_mm_mul_ps(depth_a, px), row_z);
+                        __m128 old = _mm_loadu_ps(row + x);
+                        __m128 nearer = _mm_max_ps(old, z);
+                        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+                    }
+#else
+                    for (i32 x = x0; x <= x1; ++x) {
+                        f32 px = x + 0.5f;
+                        if (triangle.edge_a[0] * px + row0 < 0.0f ||
+                            triangle.edge_a[1] * px + row1 < 0.0f ||
+                            triangle.edge_a[2] * px + row2 < 0.0f) {
+                            continue;
+                        }
+                        row[x] = std::max(row[x], triangle.depth_a * px + row_depth);
+                    }
+#endif
+                }
+            }
+        }
+    };
+
+    void OcclusionCuller::BuildHierarchy() {
+        for (u32 i = 1; i < levels.size(); ++i) {
+            const Level& source = levels[i - 1];
+            Level& level = levels[i];
+            // Level 0 holds a single depth per texel.
+            const std::vector<f32>& source_max = i == 1 ? source.min_depth : source.max_depth;
+            for (u32 y = 0; y < level.height; ++y) {
+                u32 sy0 = std::min(y * 2, source.height - 1);
+                u32 sy1 = std::min(y * 2 + 1, source.height - 1);
+                for (u32 x = 0; x < level.width; ++x) {
+                    u32 sx0 = std::min(x * 2, source.width - 1);
+                    u32 sx1 = std::min(x * 2 + 1, source.width - 1);
+                    u32 a = sy0 * source.width + sx0;
+                    u32 b = sy0 * source.width + sx1;
+                    u32 c = sy1 * source.width + sx0;
+                    u32 d = sy1 * source.width + sx1;
+                    level.min_depth[y * level.width + x] = std::min(std::min(source.min_depth[a], source.min_depth[b]), std::min(source.min_depth[c], source.min_depth[d]));
+                    level.max_depth[y * level.width + x] = std::max(std::max(source_max[a], source_max[b]), std::max(source_max[c], source_max[d]));
+                }
+            }
+        }
+    };
+
+    b8 OcclusionCuller::IsVisible(const glm::mat4& model, const GeometryExtent& extent) {
+        glm::mat4 mvp = view_projection * model;
+
+        f32 min_x = std::numeric_limits<f32>::max();
+        f32 min_y = std::numeric_limits<f32>::max();
+        f32 max_x = -std::numeric_limits<f32>::max();
+        f32 max_y = -std::numeric_limits<f32>::max();
+        f32 nearest = 0.0f;
+        for (u32 i = 0; i < 8; ++i) {
+            glm::vec3 corner(
+                (i & 1) ? extent.max_extents.x : extent.min_extents.x,
+                (i & 2) ? extent.max_extents.y : extent.min_extents.y,
+                (i & 4) ? extent.max_extents.z : extent.min_extents.z
+            );
+            glm::vec4 clip = mvp * glm::vec4(corner, 1.0f);
+            // Reaches the camera, nothing in front of it can hide it.
+            if (clip.w < OCCLUSION_MIN_W) {
+                return true;
+            }
+            f32 inv_w = 1.0f / clip.w;
+            f32 x = (clip.x * inv_w * 0.5f + 0.5f) * OCCLUSION_BUFFER_WIDTH;
+            f32 y = (clip.y * inv_w * 0.5f + 0.5f) * OCCLUSION_BUFFER_HEIGHT;
+            min_x = std::min(min_x, x);
+            min_y = std::min(min_y, y);
+            max_x = std::max(max_x, x);
+            max_y = std::max(max_y, y);
+            nearest = std::max(nearest, inv_w);
+        }
+
+        // Off screen is frustum culling's business, not ours.
+        if (max_x < 0.0f || max_y < 0.0f || min_x >= OCCLUSION_BUFFER_WIDTH || min_y >= OCCLUSION_BUFFER_HEIGHT) {
+            return true;
+        }
+        i32 x0 = (i32)std::max(min_x, 0.0f);
+        i32 y0 = (i32)std::max(min_y, 0.0f);
+        i32 x1 = (i32)std::min(max_x, OCCLUSION_BUFFER_WIDTH - 1.0f);
+        i32 y1 = (i32)std::min(max_y, OCCLUSION_BUFFER_HEIGHT - 1.0f);
+
+        // Start where the rect spans about two texels a side.
+        u32 size = std::max(x1 - x0, y1 - y0) + 1;
+        u32 level = 0;
+        while ((size >> level) > 2 && level + 1 < levels.size()) {
+            level++;
+        }
+        return IsRegionVisible(level, x0, y0, x1, y1, nearest * OCCLUSION_DEPTH_SLACK);
+    };
+
+    b8 OcclusionCuller::IsRegionVisible(u32 level, i32 x0, i32 y0, i32 x1, i32 y1, f32 nearest) {
+        const Level& current = levels[level];
+        const f32* max_depth = level ? current.max_depth.data() : current.min_depth.data();
+
+        for (i32 ty = y0 >> level; ty <= (y1 >> level); ++ty) {
+            for (i32 tx = x0 >> level; tx <= (x1 >> level); ++tx) {
+                u32 index = ty * current.width + tx;
+                // In front of everything under the texel.
+                if (nearest >= max_depth[index]) {
+                    return true;
+                }
+                // Behind everything under the texel.
+                if (nearest < current.min_depth[index]) {
+                    continue;
+                }
+                // Somewhere in between, look at the part of the rect under this texel one level down.
+                if (!level) {
+                    return true;
+                }
+                i32 sx0 = std::max(x0, tx << level);
+                i32 sy0 = std::max(y0, ty << level);
+                i32 sx1 = std::min(x1, ((tx + 1) << level) - 1);
+                i32 sy1 = std::min(y1, ((ty + 1) << level) - 1);
+                if (IsRegionVisible(level - 1, sx0, sy0, sx1, sy1, nearest)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    void OcclusionCuller::Test(WorkerPool* workers, u32 count, const OcclusionQuery* queries, u8* out_visible) {
+        f64 start = Platform::GetAbsoluteTime();
+
+        u32 job_count = (count + OCCLUSION_TESTS_PER_JOB - 1) / OCCLUSION_TESTS_PER_JOB;
+        workers->Run(job_count, [&](u32 job, u32 thread_index) {
+            u32 end = std::min((job + 1) * OCCLUSION_TESTS_PER_JOB, count);
+            for (u32 i = job * OCCLUSION_TESTS_PER_JOB; i < end; ++i) {
+                out_visible[i] = IsVisible(*queries[i].model, *queries[i].extent) ? 1 : 0;
+            }
+        });
+
+        stats.candidates += count;
+        for (u32 i = 0; i < count; ++i) {
+            stats.culled += out_visible[i] ? 0 : 1;
+        }
+        stats.test_ms += (Platform::GetAbsoluteTime() - start) * 1000.0;
+    };
+
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "defines.hpp"
+#include "core/utils/worker_pool.hpp"
+#include "systems/resource/resources/mesh/mesh_resource.hpp"
+
+namespace Engine {
+
+    // Resolution of the software depth buffer, both powers of two and multiples of the tile size.
+    #define OCCLUSION_BUFFER_WIDTH 256
+    #define OCCLUSION_BUFFER_HEIGHT 128
+    // Triangles are binned per tile so tiles can be rasterized on separate threads.
+    #define OCCLUSION_TILE_WIDTH 32
+    #define OCCLUSION_TILE_HEIGHT 16
+    // Largest occluders, by projected size, rasterized per frame.
+    #define OCCLUSION_MAX_OCCLUDERS 64
+    // Boxes tested per job.
+    #define OCCLUSION_TESTS_PER_JOB 256
+    // Vertices closer than this (in clip w) are treated as crossing the near plane.
+    #define OCCLUSION_MIN_W 0.01f
+    // Boxes count as nearer by this factor, so an occluder never hides itself through rounding.
+    #define OCCLUSION_DEPTH_SLACK 1.0001f
+    // Occluder triangles reaching further off screen than this many pixels are dropped.
+    #define OCCLUSION_GUARD_BAND 16384.0f
+
+    struct OcclusionStats {
+        u32 occluders = 0;
+        u32 triangles = 0;
+        // Boxes tested and boxes found hidden.
+        u32 candidates = 0;
+        u32 culled = 0;
+        f64 raster_ms = 0.0;
+        f64 test_ms = 0.0;
+    };
+
+    struct OcclusionQuery {
+        const glm::mat4* model;
+        const GeometryExtent* extent;
+    };
+
+    // Conservative CPU occlusion culling. Occluders are rasterized depth only into a small buffer
+    // of inverse clip w (0 is empty, bigger is nearer), a min/max hierarchy is built on top and
+    // bounding boxes are tested against it. Anything the buffer can't prove hidden is visible.
+    class OcclusionCuller {
+        public:
+            OcclusionCuller();
+
+            // Clears the buffer for a frame seen through view_projection.
+            void Begin(const glm::mat4& view_projection);
+            // Positions and indices are kept by pointer until Rasterize returns.
+            void AddOccluder(const glm::mat4& model, const std::vector<glm::vec3>* positions, const std::vector<u32>* indices);
+            // Bins and rasterizes the occluders on the workers, then builds the hierarchy.
+            void Rasterize(WorkerPool* workers);
+
+            // False only if the box is hidden behind the occluders. Safe to call from several threads after Rasterize.
+            b8 IsVisible(const glm::mat4& model, const GeometryExtent& extent);
+            // IsVisible for every query, spread over the workers. out_visible gets 1 or 0 per query.
+            void Test(WorkerPool* workers, u32 count, const OcclusionQuery* queries, u8* out_visible);
+
+            OcclusionStats& GetStats() { return stats; };
+
+        private:
+            struct Occluder {
+                glm::mat4 model;
+                const std::vector<glm::vec3>* positions;
+                const std::vector<u32>* indices;
+            };
+
+            // Edge functions and depth plane in pixel coordinates, set up once at binning.
+            struct Triangle {
+                f32 edge_a[3];
+                f32 edge_b[3];
+                f32 edge_c[3];
+                f32 depth_a;
+                f32 depth_b;
+                f32 depth_c;
+                i32 min_x;
+                i32 min_y;
+                i32 max_x;
+                i32 max_y;
+            };
+
+            // Triangles binned by one thread, bins hold indices into triangles per tile.
+            struct ThreadBins {
+                // Pixel x, y and inverse w of the occluder being binned, negative w where it crosses the near plane.
+                std::vector<glm::vec3> vertices;
+                std::vector<Triangle> triangles;
+                std::vector<std::vector<u32>> bins;
+            };
+
+            struct Level {
+                u32 width;
+                u32 height;
+                // Farthest and nearest depth under each texel, level 0 only has min_depth.
+                std::vector<f32> min_depth;
+                std::vector<f32> max_depth;
+            };
+
+            void BinOccluder(const Occluder& occluder, ThreadBins& thread_bins);
+            void RasterizeTile(u32 tile);
+            void BuildHierarchy();
+            // Pixel rect x0..x1, y0..y1 tested at level and refined below where it is inconclusive.
+            b8 IsRegionVisible(u32 level, i32 x0, i32 y0, i32 x1, i32 y1, f32 nearest);
+
+            glm::mat4 view_projection;
+            std::vector<Occluder> occluders;
+            std::vector<ThreadBins> thread_bins;
+            std::vector<Level> levels;
+            OcclusionStats stats;
+    };
+
+};
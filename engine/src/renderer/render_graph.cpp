@@ -0,0 +1,497 @@
+#include "render_graph.hpp"
+
+#include "renderer.hpp"
+#include "core/logger/logger.hpp"
+
+namespace Engine {
+
+    u32 RenderGraph::AddResource(const std::string& name, RenderAttachmentFormat format, RenderGraphImport import) {
+        RenderGraphResource resource;
+        resource.name = name;
+        resource.format = format;
+        resource.import = import;
+        resource.output = false;
+        resource.physical = INVALID_ID;
+        resources.push_back(resource);
+        return resources.size() - 1;
+    };
+
+    void RenderGraph::SetOutput(u32 resource) {
+        resources[resource].output = true;
+    };
+
+    u32 RenderGraph::AddPass(const std::string& name, glm::vec4 clear_color, RenderGraphExecute execute, RenderpassContents contents) {
+        RenderGraphPass pass;
+        pass.name = name;
+        pass.clear_color = clear_color;
+        pass.execute = execute;
+        pass.contents = contents;
+        pass.culled = false;
+        pass.renderpass = nullptr;
+        passes.push_back(pass);
+        return passes.size() - 1;
+    };
+
+    void RenderGraph::Write(u32 pass, u32 resource, b8 clear) {
+        RenderAttachmentUsage usage = resources[resource].format == RenderAttachmentFormat::DEPTH ? RenderAttachmentUsage::DEPTH : RenderAttachmentUsage::COLOR;
+        passes[pass].attachments.push_back(resource);
+        resources[resource].accesses.push_back({pass, usage, clear});
+    };
+
+    void RenderGraph::Read(u32 pass, u32 resource) {
+        passes[pass].reads.push_back(resource);
+        resources[resource].accesses.push_back({pass, RenderAttachmentUsage::SAMPLED, false});
+    };
+
+    b8 RenderGraph::Compile(glm::vec4 render_area, std::vector<RenderpassCreateInfo>& out_renderpasses) {
+        stats = {};
+
+        for (RenderGraphResource& resource : resources) {
+            std::stable_sort(resource.accesses.begin(), resource.accesses.end(), [](const RenderGraphAccess& a, const RenderGraphAccess& b) {
+                return a.pass < b.pass;
+            });
+        }
+        if (!SortPasses()) {
+            return false;
+        }
+
+        for (RenderGraphResource& resource : resources) {
+            std::stable_sort(resource.accesses.begin(), resource.accesses.end(), [&](const RenderGraphAccess& a, const RenderGraphAccess& b) {
+                return rank[a.pass] < rank[b.pass];
+            });
+            b8 written = resource.import != RenderGraphImport::NONE;
+            for (RenderGraphAccess& access : resource.accesses) {
+                if (access.usage == RenderAttachmentUsage::SAMPLED && !written) {
+                    ERROR("RenderGraph::Compile - pass '%s' reads '%s' before any pass writes it.", passes[access.pass].name.c_str(), resource.name.c_str());
+                    return false;
+                }
+                written |= access.usage != RenderAttachmentUsage::SAMPLED;
+            }
+        }
+
+        Cull();
+        AssignPhysical();
+
+        for (u32 i : order) {
+            RenderGraphPass& pass = passes[i];
+            stats.passes++;
+            if (pass.culled) {
+                stats.culled_passes++;
+                continue;
+            }
+
+            RenderpassCreateInfo info;
+            info.name = pass.name;
+            info.render_area = render_area;
+            info.clear_color = pass.clear_color;
+            info.clear_flags = RenderpassClearFlag::CLEAR_NONE;
+
+            b8 has_sampled_output = false;
+            for (u32 resource_id : pass.attachments) {
+                RenderGraphResource& resource = resources[resource_id];
+
+                RenderpassAttachmentInfo attachment;
+                attachment.format = resource.format;
+                attachment.load = RenderAttachmentLoad::DONT_CARE;
+                attachment.store = resource.output;
+                RenderAttachmentUsage usage = RenderAttachmentUsage::NONE;
+                for (RenderGraphAccess& access : resource.accesses) {
+                    if (passes[access.pass].culled) {
+                        continue;
+                    }
+                    // Keeps what earlier passes wrote unless it clears, later uses need it stored.
+                    if (rank[access.pass] < rank[i] && access.usage != RenderAttachmentUsage::SAMPLED) {
+                        attachment.load = RenderAttachmentLoad::LOAD;
+                    } else if (access.pass == i && access.usage != RenderAttachmentUsage::SAMPLED) {
+                        usage = access.usage;
+                        if (access.clear) {
+                            attachment.load = RenderAttachmentLoad::CLEAR;
+                        }
+                    } else if (rank[access.pass] > rank[i]) {
+                        attachment.store = true;
+                    }
+                }
+                attachment.prev_usage = GetNeighbourUsage(resource_id, i, -1);
+                attachment.next_usage = GetNeighbourUsage(resource_id, i, 1);
+
+                // First use of the image, whatever else lives in its memory slot has to be done with it.
+                if (resource.physical != INVALID_ID && physicals[resource.physical].first_pass == rank[i]) {
+                    for (u32 p = 0; p < physicals.size(); ++p) {
+                        if (p != resource.physical && physicals[p].memory_slot == physicals[resource.physical].memory_slot) {
+                            attachment.alias_usages.push_back(physicals[p].last_usage);
+                        }
+                    }
+                    stats.aliasing_barriers += attachment.alias_usages.size() ? 1 : 0;
+                }
+
+                if (attachment.load != RenderAttachmentLoad::LOAD) {
+                    stats.layout_transitions++;
+                }
+                if (attachment.next_usage != usage && attachment.next_usage != RenderAttachmentUsage::NONE) {
+                    stats.layout_transitions++;
+                }
+                has_sampled_output |= attachment.next_usage == RenderAttachmentUsage::SAMPLED;
+
+                if (attachment.load == RenderAttachmentLoad::CLEAR) {
+                    info.clear_flags |= resource.format == RenderAttachmentFormat::DEPTH ?
+                        RenderpassClearFlag::CLEAR_COLOR_DEPTH_BUFER : RenderpassClearFlag::CLEAR_COLOR_BUFFER;
+                }
+                info.attachments.push_back(attachment);
+            }
+            stats.dependencies += has_sampled_output ? 2 : 1;
+
+            out_renderpasses.push_back(info);
+        }
+
+        DEBUG("RenderGraph - %u passes (%u culled), %u transient attachments on %u images in %u memory slots, %u layout transitions, %u dependencies, %u aliasing barriers.",
+            stats.passes, stats.culled_passes, stats.transient_resources, stats.transient_images, stats.memory_slots,
+            stats.layout_transitions, stats.dependencies, stats.aliasing_barriers);
+        return true;
+    };
+
+    b8 RenderGraph::SortPasses() {
+        // Edges between passes from each resource's accesses, which are in declaration order here.
+        std::vector<std::vector<u32>> edges(passes.size());
+        std::vector<u32> incoming(passes.size(), 0);
+        auto add_edge = [&](u32 from, u32 to) {
+            if (from != to) {
+                edges[from].push_back(to);
+                incoming[to]++;
+            }
+        };
+
+        for (RenderGraphResource& resource : resources) {
+            u32 last_writer = INVALID_ID;
+            for (RenderGraphAccess& access : resource.accesses) {
+                if (access.usage != RenderAttachmentUsage::SAMPLED) {
+                    last_writer = access.pass;
+                }
+            }
+
+            u32 writer = INVALID_ID;
+            std::vector<u32> readers;
+            for (RenderGraphAccess& access : resource.accesses) {
+                if (access.usage == RenderAttachmentUsage::SAMPLED) {
+                    // Declared before any write it reads the final contents, and no write waits for it.
+                    if (writer != INVALID_ID) {
+                        add_edge(writer, access.pass);
+                        readers.push_back(access.pass);
+                    } else if (last_writer != INVALID_ID) {
+                        add_edge(last_writer, access.pass);
+                    }
+                    continue;
+                }
+
+                if (writer != INVALID_ID) {
+                    add_edge(writer, access.pass);
+                }
+                for (u32 reader : readers) {
+                    add_edge(reader, access.pass);
+                }
+                readers.clear();
+                writer = access.pass;
+            }
+        }
+
+        // Kahn's algorithm, the lowest declared pass that is ready goes next.
+        order.clear();
+        rank.assign(passes.size(), INVALID_ID);
+        while (order.size() < passes.size()) {
+            u32 next = INVALID_ID;
+            for (u32 i = 0; i < passes.size(); ++i) {
+                if (rank[i] == INVALID_ID && !incoming[i]) {
+                    next = i;
+                    break;
+                }
+            }
+            if (next == INVALID_ID) {
+                for (u32 i = 0; i < passes.size(); ++i) {
+                    if (rank[i] == INVALID_ID) {
+                        ERROR("RenderGraph::Compile - pass '%s' is part of a dependency cycle.", passes[i].name.c_str());
+                        break;
+                    }
+                }
+                return false;
+            }
+
+            rank[next] = order.size();
+            order.push_back(next);
+            for (u32 to : edges[next]) {
+                incoming[to]--;
+            }
+        }
+        return true;
+    };
+
+    void RenderGraph::Cull() {
+        // Walk back from the outputs, a pass survives if a later pass or the output needs something it writes.
+        std::vector<b8> needed(resources.size());
+        for (u32 i = 0; i < resources.size(); ++i) {
+            needed[i] = resources[i].output;
+        }
+
+        for (i32 position = order.size() - 1; position >= 0; --position) {
+            u32 i = order[position];
+            RenderGraphPass& pass = passes[i];
+            pass.culled = true;
+            for (u32 resource : pass.attachments) {
+                pass.culled &= !needed[resource];
+            }
+            if (pass.culled) {
+                continue;
+            }
+
+            // Cleared attachments make earlier writes dead, loaded ones keep them alive.
+            for (u32 resource : pass.attachments) {
+                for (RenderGraphAccess& access : resources[resource].accesses) {
+                    if (access.pass == i && access.usage != RenderAttachmentUsage::SAMPLED) {
+                        needed[resource] = !access.clear;
+                    }
+                }
+            }
+            for (u32 resource : pass.reads) {
+                needed[resource] = true;
+            }
+        }
+    };
+
+    void RenderGraph::AssignPhysical() {
+        // Lifetimes of transient resources over the passes that survived culling, as execution positions.
+        std::vector<u32> sorted;
+        std::vector<u32> first_pass(resources.size(), INVALID_ID);
+        std::vector<u32> last_pass(resources.size(), 0);
+        for (u32 i = 0; i < resources.size(); ++i) {
+            RenderGraphResource& resource = resources[i];
+            resource.physical = INVALID_ID;
+            if (resource.import != RenderGraphImport::NONE) {
+                continue;
+            }
+            for (RenderGraphAccess& access : resource.accesses) {
+                if (!passes[access.pass].culled) {
+                    first_pass[i] = std::min(first_pass[i], rank[access.pass]);
+                    last_pass[i] = std::max(last_pass[i], rank[access.pass]);
+                }
+            }
+            if (first_pass[i] == INVALID_ID) {
+                continue;
+            }
+            if (resource.output) {
+                last_pass[i] = passes.size();
+            }
+            sorted.push_back(i);
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [&](u32 a, u32 b) { return first_pass[a] < first_pass[b]; });
+
+        // Greedy, every resource takes the first compatible image that is free again by its first use.
+        std::vector<RenderGraphPhysical> assigned;
+        for (u32 resource_id : sorted) {
+            RenderGraphResource& resource = resources[resource_id];
+            b8 sampled = false;
+            u32 last_rank = 0;
+            RenderAttachmentUsage last_usage = RenderAttachmentUsage::NONE;
+            for (RenderGraphAccess& access : resource.accesses) {
+                sampled |= access.usage == RenderAttachmentUsage::SAMPLED;
+                if (!passes[access.pass].culled && rank[access.pass] >= last_rank) {
+                    last_rank = rank[access.pass];
+                    last_usage = access.usage;
+                }
+            }
+
+            u32 physical = INVALID_ID;
+            for (u32 i = 0; i < assigned.size(); ++i) {
+                if (assigned[i].format == resource.format && assigned[i].last_pass < first_pass[resource_id]) {
+                    physical = i;
+                    break;
+                }
+            }
+            if (physical == INVALID_ID) {
+                physical = assigned.size();
+                assigned.push_back({resource.format, false, first_pass[resource_id], 0, RenderAttachmentUsage::NONE, INVALID_ID, nullptr});
+            }
+            assigned[physical].sampled |= sampled;
+            assigned[physical].last_pass = last_pass[resource_id];
+            assigned[physical].last_usage = last_usage;
+            resource.physical = physical;
+            stats.transient_resources++;
+        }
+
+        // Same again one level down, images are in first use order and each takes the first memory slot
+        // free again by then, whatever the format. The backend sizes a slot for its largest image.
+        std::vector<u32> slot_last_pass;
+        for (RenderGraphPhysical& physical : assigned) {
+            for (u32 slot = 0; slot < slot_last_pass.size(); ++slot) {
+                if (slot_last_pass[slot] < physical.first_pass) {
+                    physical.memory_slot = slot;
+                    break;
+                }
+            }
+            if (physical.memory_slot == INVALID_ID) {
+                physical.memory_slot = slot_last_pass.size();
+                slot_last_pass.push_back(0);
+            }
+            slot_last_pass[physical.memory_slot] = physical.last_pass;
+        }
+
+        // Images are created for the new assignment by CreateTargets.
+        Destroy();
+        physicals = assigned;
+        stats.transient_images = physicals.size();
+        stats.memory_slots = slot_last_pass.size();
+    };
+
+    RenderAttachmentUsage RenderGraph::GetNeighbourUsage(u32 resource_id, u32 pass, i32 direction) {
+        RenderGraphResource& resource = resources[resource_id];
+
+        // Uses of the underlying image, aliased resources included.
+        std::vector<RenderGraphAccess> chain;
+        for (u32 i = 0; i < resources.size(); ++i) {
+            b8 same_image = i == resource_id || (resource.physical != INVALID_ID && resources[i].physical == resource.physical);
+            if (!same_image) {
+                continue;
+            }
+            for (RenderGraphAccess& access : resources[i].accesses) {
+                if (!passes[access.pass].culled) {
+                    chain.push_back(access);
+                }
+            }
+        }
+        std::stable_sort(chain.begin(), chain.end(), [&](const RenderGraphAccess& a, const RenderGraphAccess& b) {
+            return rank[a.pass] < rank[b.pass];
+        });
+
+        i32 index = -1;
+        for (u32 i = 0; i < chain.size(); ++i) {
+            if (chain[i].pass == pass && chain[i].usage != RenderAttachmentUsage::SAMPLED) {
+                index = i;
+                break;
+            }
+        }
+        if (index < 0) {
+            return RenderAttachmentUsage::NONE;
+        }
+
+        i32 neighbour = index + direction;
+        if (neighbour >= 0 && neighbour < (i32)chain.size()) {
+            return chain[neighbour].usage;
+        }
+
+        // The window image comes from and goes back to presentation, transient images wrap
+        // around to their uses in the previous or next frame.
+        if (resource.import == RenderGraphImport::WINDOW_COLOR) {
+            return RenderAttachmentUsage::PRESENT;
+        }
+        return chain[(neighbour + chain.size()) % chain.size()].usage;
+    };
+
+    b8 RenderGraph::BindRenderpasses(RendererBackend* backend) {
+        this->backend = backend;
+        for (RenderGraphPass& pass : passes) {
+            if (pass.culled) {
+                continue;
+            }
+            pass.renderpass = backend->GetRenderpass(pass.name);
+            if (!pass.renderpass) {
+                ERROR("RenderGraph::BindRenderpasses - backend has no renderpass '%s'.", pass.name.c_str());
+                return false;
+            }
+        }
+        return true;
+    };
+
+    b8 RenderGraph::CreateTargets(RendererBackend* backend, u32 width, u32 height, u32 image_count) {
+        this->backend = backend;
+
+        Destroy();
+        std::vector<RenderAttachmentCreateInfo> infos;
+        for (RenderGraphPhysical& physical : physicals) {
+            infos.push_back({physical.format, physical.sampled, physical.memory_slot});
+        }
+        std::vector<Texture*> textures;
+        if (!backend->CreateAttachments(infos, width, height, textures)) {
+            ERROR("RenderGraph::CreateTargets - failed creating the transient attachments.");
+            return false;
+        }
+        for (u32 i = 0; i < physicals.size(); ++i) {
+            physicals[i].texture = textures[i];
+        }
+
+        for (RenderGraphPass& pass : passes) {
+            if (pass.culled || !pass.renderpass) {
+                continue;
+            }
+
+            Renderpass* renderpass = pass.renderpass;
+            if (renderpass->render_targets.size() < image_count) {
+                renderpass->render_targets.resize(image_count);
+            }
+
+            for (u32 i = 0; i < image_count; ++i) {
+                delete renderpass->render_targets[i];
+
+                RenderTargetCreateInfo create_info;
+                create_info.name = pass.name;
+                for (u32 resource : pass.attachments) {
+                    create_info.attachments.push_back(GetTexture(resource, i));
+                }
+                create_info.width = width;
+                create_info.height = height;
+                create_info.manage_attachments = false;
+                create_info.renderpass = renderpass;
+
+                renderpass->render_targets[i] = backend->CreateRenderTarget(create_info);
+            }
+        }
+
+        return true;
+    };
+
+    void RenderGraph::OnResize(glm::vec4 render_area) {
+        for (RenderGraphPass& pass : passes) {
+            if (!pass.culled && pass.renderpass) {
+                pass.renderpass->OnResize(render_area);
+            }
+        }
+    };
+
+    void RenderGraph::Destroy() {
+        for (RenderGraphPhysical& physical : physicals) {
+            delete physical.texture;
+            physical.texture = nullptr;
+        }
+    };
+
+    b8 RenderGraph::Execute() {
+        for (u32 i : order) {
+            RenderGraphPass& pass = passes[i];
+            if (pass.culled) {
+                continue;
+            }
+
+            if (!pass.renderpass->Begin(pass.contents)) {
+                ERROR("RenderGraph::Execute - '%s' begin failed.", pass.name.c_str());
+                return false;
+            }
+
+            b8 result = pass.execute ? pass.execute() : true;
+
+            if (!pass.renderpass->End()) {
+                ERROR("RenderGraph::Execute - '%s' end failed.", pass.name.c_str());
+                return false;
+            }
+            if (!result) {
+                ERROR("RenderGraph::Execute - '%s' failed.", pass.name.c_str());
+                return false;
+            }
+        }
+        return true;
+    };
+
+    Texture* RenderGraph::GetTexture(u32 resource, u32 image_index) {
+        if (resources[resource].import == RenderGraphImport::WINDOW_COLOR) {
+            return backend ? backend->GetWindowAttachment(image_index) : nullptr;
+        }
+        u32 physical = resources[resource].physical;
+        return physical != INVALID_ID ? physicals[physical].texture : nullptr;
+    };
+
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "defines.hpp"
+#include "renderpass.hpp"
+
+namespace Engine {
+
+    class RendererBackend;
+
+    using RenderGraphExecute = std::function<b8()>;
+
+    enum class RenderGraphImport {
+        // Created and aliased by the graph.
+        NONE,
+        // The swapchain image of the frame.
+        WINDOW_COLOR
+    };
+
+    struct RenderGraphAccess {
+        u32 pass;
+        RenderAttachmentUsage usage;
+        b8 clear;
+    };
+
+    struct RenderGraphResource {
+        std::string name;
+        RenderAttachmentFormat format;
+        RenderGraphImport import;
+        // Kept alive to the end of the frame, passes writing it are never culled.
+        b8 output;
+        // Declared reads and writes, in execution order after Compile.
+        std::vector<RenderGraphAccess> accesses;
+        // Image backing a transient resource, shared by resources whose lifetimes don't overlap.
+        u32 physical;
+    };
+
+    struct RenderGraphPhysical {
+        RenderAttachmentFormat format;
+        b8 sampled;
+        u32 first_pass;
+        u32 last_pass;
+        // How the last resource on the image uses it last, images sharing its memory wait for it.
+        RenderAttachmentUsage last_usage;
+        // Images whose lifetimes don't overlap share a slot, placed at the same memory offset.
+        u32 memory_slot;
+        Texture* texture;
+    };
+
+    struct RenderGraphPass {
+        std::string name;
+        glm::vec4 clear_color;
+        RenderGraphExecute execute;
+        RenderpassContents contents;
+        // Resource ids in attachment order.
+        std::vector<u32> attachments;
+        std::vector<u32> reads;
+        b8 culled;
+        Renderpass* renderpass;
+    };
+
+    struct RenderGraphStats {
+        u32 passes = 0;
+        u32 culled_passes = 0;
+        // Layout changes folded into renderpass begin and end, and external dependencies between passes.
+        u32 layout_transitions = 0;
+        u32 dependencies = 0;
+        u32 transient_resources = 0;
+        u32 transient_images = 0;
+        u32 memory_slots = 0;
+        // First uses of an image waiting on the others placed over its memory.
+        u32 aliasing_barriers = 0;
+    };
+
+    // Describes the frame as passes reading and writing named attachments. Compile culls passes
+    // nothing depends on, aliases transient attachments with disjoint lifetimes onto the same image,
+    // places images of any format with disjoint lifetimes over each other in memory and works out per
+    // attachment load/store ops, layouts and the neighbouring uses the backend turns into renderpass
+    // dependencies, aliasing ones included, so no pass issues barriers of its own.
+    // Passes run in an order sorted from their accesses: writes to a resource keep their declaration
+    // order, a read sees the writes declared before it, or all of them when it is declared first,
+    // and later writes wait for it. Independent passes keep declaration order.
+    class RenderGraph {
+        public:
+            u32 AddResource(const std::string& name, RenderAttachmentFormat format, RenderGraphImport import = RenderGraphImport::NONE);
+            void SetOutput(u32 resource);
+
+            // PARALLEL passes may only record through RendererBackend::RecordParallel.
+            u32 AddPass(const std::string& name, glm::vec4 clear_color, RenderGraphExecute execute, RenderpassContents contents = RenderpassContents::INLINE);
+            // Attachment of the pass, cleared first or keeping what earlier passes wrote.
+            void Write(u32 pass, u32 resource, b8 clear);
+            // Sampled by the pass shaders, see GetTexture.
+            void Read(u32 pass, u32 resource);
+
+            // Fills one renderpass config per pass that survived culling.
+            b8 Compile(glm::vec4 render_area, std::vector<RenderpassCreateInfo>& out_renderpasses);
+            // Resolves the renderpasses the backend created from the configs.
+            b8 BindRenderpasses(RendererBackend* backend);
+            // Transient images and per window image render targets, again after every resize.
+            b8 CreateTargets(RendererBackend* backend, u32 width, u32 height, u32 image_count);
+            void OnResize(glm::vec4 render_area);
+            void Destroy();
+
+            b8 Execute();
+
+            Texture* GetTexture(u32 resource, u32 image_index);
+            const RenderGraphStats& GetStats() { return stats; };
+
+        private:
+            // Fills order and rank, false when the accesses form a cycle.
+            b8 SortPasses();
+            void Cull();
+            void AssignPhysical();
+            RenderAttachmentUsage GetNeighbourUsage(u32 resource, u32 pass, i32 direction);
+
+            std::vector<RenderGraphResource> resources;
+            std::vector<RenderGraphPass> passes;
+            std::vector<RenderGraphPhysical> physicals;
+            // Pass ids in execution order, and each pass's position in it.
+            std::vector<u32> order;
+            std::vector<u32> rank;
+            RendererBackend* backend = nullptr;
+            RenderGraphStats stats;
+    };
+
+};
@@ -0,0 +1,140 @@
+#include "render_queue.hpp"
+
+#include "resources/geometry/geometry.hpp"
+#include "resources/material/material.hpp"
+#include "platform/platform.hpp"
+
+namespace Engine {
+
+    #define RENDER_QUEUE_PASS_SHIFT 62
+    #define RENDER_QUEUE_TRANSPARENT_BIT (1ULL << 61)
+    #define RENDER_QUEUE_DEPTH_BITS 24
+    // Opaque keys split depth in a coarse band above the geometry and the fine rest below it.
+    #define RENDER_QUEUE_DEPTH_BAND_BITS 8
+    #define RENDER_QUEUE_DEPTH_FINE_BITS (RENDER_QUEUE_DEPTH_BITS - RENDER_QUEUE_DEPTH_BAND_BITS)
+    #define RENDER_QUEUE_SHADER_BITS 8
+    #define RENDER_QUEUE_MATERIAL_BITS 14
+    #define RENDER_QUEUE_GEOMETRY_BITS 15
+    #define RENDER_QUEUE_SEQUENCE_MASK ((1ULL << 61) - 1)
+
+    INLINE_API u64 KeyField(u32 value, u32 bits) {
+        return (u64)value & ((1ULL << bits) - 1);
+    };
+
+    void RenderQueue::Clear() {
+        items.clear();
+        sorted.clear();
+        sequence = 0;
+    };
+
+    void RenderQueue::Push(RenderQueuePass pass, u32 object_id, const glm::mat4& model, Geometry* geometry, Material* material, f32 depth) {
+        Texture* diffuse = material->GetDiffuseMap().texture;
+        b8 transparent = diffuse && diffuse->HasTransparency();
+        Shader* shader = material->GetShader();
+
+        u64 key = MakeKey(pass, transparent, shader ? shader->GetId() : 0, material->GetInternalId(), geometry->GetInternalId(), depth);
+        items.push_back({key, object_id, model, geometry, material});
+    };
+
+    void RenderQueue::PushOrdered(RenderQueuePass pass, u32 object_id, const glm::mat4& model, Geometry* geometry, Material* material) {
+        u64 key = ((u64)pass << RENDER_QUEUE_PASS_SHIFT) | (sequence++ & RENDER_QUEUE_SEQUENCE_MASK);
+        items.push_back({key, object_id, model, geometry, material});
+    };
+
+    u64 RenderQueue::MakeKey(RenderQueuePass pass, b8 transparent, u32 shader_id, u32 material_id, u32 geometry_id, f32 depth) {
+        u64 key = (u64)pass << RENDER_QUEUE_PASS_SHIFT;
+        u64 shader = KeyField(shader_id, RENDER_QUEUE_SHADER_BITS);
+        u64 material = KeyField(material_id, RENDER_QUEUE_MATERIAL_BITS);
+        u64 geometry = KeyField(geometry_id, RENDER_QUEUE_GEOMETRY_BITS);
+        u64 quantized = QuantizeDepth(depth);
+
+        if (!transparent) {
+            // The band is the exponent of the squared distance, so draws of a material go front to back
+            // across geometries while same geometry draws within a band still form instanced runs.
+            u64 band = quantized >> RENDER_QUEUE_DEPTH_FINE_BITS;
+            u64 fine = quantized & ((1ULL << RENDER_QUEUE_DEPTH_FINE_BITS) - 1);
+            key |= shader << (RENDER_QUEUE_MATERIAL_BITS + RENDER_QUEUE_DEPTH_BITS + RENDER_QUEUE_GEOMETRY_BITS);
+            key |= material << (RENDER_QUEUE_DEPTH_BITS + RENDER_QUEUE_GEOMETRY_BITS);
+            key |= band << (RENDER_QUEUE_GEOMETRY_BITS + RENDER_QUEUE_DEPTH_FINE_BITS);
+            key |= geometry << RENDER_QUEUE_DEPTH_FINE_BITS;
+            key |= fine;
+            return key;
+        }
+
+        // Blending needs the far ones first, depth wins over state changes here.
+        u64 inverted = ((1ULL << RENDER_QUEUE_DEPTH_BITS) - 1) - quantized;
+        key |= RENDER_QUEUE_TRANSPARENT_BIT;
+        key |= inverted << (RENDER_QUEUE_SHADER_BITS + RENDER_QUEUE_MATERIAL_BITS + RENDER_QUEUE_GEOMETRY_BITS);
+        key |= shader << (RENDER_QUEUE_MATERIAL_BITS + RENDER_QUEUE_GEOMETRY_BITS);
+        key |= material << RENDER_QUEUE_GEOMETRY_BITS;
+        key |= geometry;
+        return key;
+    };
+
+    u32 RenderQueue::QuantizeDepth(f32 depth) {
+        if (!(depth > 0.0f)) {
+            return 0;
+        }
+        // Positive floats order the same as their bit patterns, keep the top 24 of the 31 used bits.
+        u32 bits;
+        Platform::CpMemory(&bits, &depth, sizeof(u32));
+        return bits >> (31 - RENDER_QUEUE_DEPTH_BITS);
+    };
+
+    void RenderQueue::Sort() {
+        u32 count = items.size();
+        order.resize(count);
+        scratch.resize(count);
+        for (u32 i = 0; i < count; ++i) {
+            order[i] = i;
+        }
+
+        // LSD radix sort on the keys, 8 bits per pass. Digits that are the same for
+        // every item are skipped, which drops most passes for small scenes.
+        u32 histogram[256];
+        for (u32 shift = 0; shift < 64; shift += 8) {
+            Platform::ZrMemory(histogram, sizeof(histogram));
+            for (u32 i = 0; i < count; ++i) {
+                histogram[(items[i].key >> shift) & 0xFF]++;
+            }
+
+            if (!count || histogram[(items[0].key >> shift) & 0xFF] == count) {
+                continue;
+            }
+
+            u32 offset = 0;
+            for (u32 digit = 0; digit < 256; ++digit) {
+                u32 digit_count = histogram[digit];
+                histogram[digit] = offset;
+                offset += digit_count;
+            }
+
+            for (u32 i = 0; i < count; ++i) {
+                u32 index = order[i];
+                scratch[histogram[(items[index].key >> shift) & 0xFF]++] = index;
+            }
+            order.swap(scratch);
+        }
+
+        sorted.resize(count);
+        for (u32 i = 0; i < count; ++i) {
+            sorted[i] = items[order[i]];
+        }
+    };
+
+    RenderQueueItem* RenderQueue::GetPass(RenderQueuePass pass, u32* out_count) {
+        u64 pass_bits = (u64)pass;
+        u32 first = 0;
+        while (first < sorted.size() && (sorted[first].key >> RENDER_QUEUE_PASS_SHIFT) < pass_bits) {
+            first++;
+        }
+        u32 last = first;
+        while (last < sorted.size() && (sorted[last].key >> RENDER_QUEUE_PASS_SHIFT) == pass_bits) {
+            last++;
+        }
+
+        *out_count = last - first;
+        return *out_count ? &sorted[first] : nullptr;
+    };
+
+};
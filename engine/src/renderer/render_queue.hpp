@@ -0,0 +1,81 @@
+#pragma once
+
+#include "defines.hpp"
+#include "renderer_types.hpp"
+
+namespace Engine {
+
+    class Geometry;
+    class Material;
+
+    enum class RenderQueuePass {
+        WORLD = 0,
+        UI = 1
+    };
+
+    struct RenderQueueItem {
+        u64 key;
+        u32 object_id;
+        glm::mat4 model;
+        Geometry* geometry;
+        Material* material;
+    };
+
+    struct RenderQueueStats {
+        // Draw calls issued, instances counts every object drawn by them.
+        u32 draws = 0;
+        u32 instances = 0;
+        // Records written for indirect draw calls.
+        u32 indirect_records = 0;
+        u32 pipeline_binds = 0;
+        u32 descriptor_binds = 0;
+        // Copied from the backend, uniform bytes uploaded and descriptors written for the frame.
+        u64 uniform_bytes = 0;
+        u32 descriptor_writes = 0;
+        // Command buffers parallel passes were split into.
+        u32 recording_jobs = 0;
+
+        void Accumulate(const RenderQueueStats& other) {
+            draws += other.draws;
+            instances += other.instances;
+            indirect_records += other.indirect_records;
+            pipeline_binds += other.pipeline_binds;
+            descriptor_binds += other.descriptor_binds;
+        };
+    };
+
+    // Flat list of draws for one frame, sorted on a packed 64 bit key so that
+    // draws sharing a shader and material end up next to each other.
+    //
+    // Opaque:      pass(2) | 0 | shader(8) | material(14) | depth band(8) | geometry(15) | depth(16)
+    // Transparent: pass(2) | 1 | inverted depth(24) | shader(8) | material(14) | geometry(15)
+    // Ordered:     pass(2) | 0 | sequence(61)
+    class RenderQueue {
+        public:
+            void Clear();
+
+            // Sorted by state, opaque front to back, transparent back to front.
+            void Push(RenderQueuePass pass, u32 object_id, const glm::mat4& model, Geometry* geometry, Material* material, f32 depth);
+            // Keeps submission order inside the pass, for UI drawn with the painter's algorithm.
+            void PushOrdered(RenderQueuePass pass, u32 object_id, const glm::mat4& model, Geometry* geometry, Material* material);
+
+            void Sort();
+
+            // Sorted items of one pass, valid after Sort until the next Clear.
+            RenderQueueItem* GetPass(RenderQueuePass pass, u32* out_count);
+
+            u32 Size() { return items.size(); };
+
+            static u64 MakeKey(RenderQueuePass pass, b8 transparent, u32 shader_id, u32 material_id, u32 geometry_id, f32 depth);
+
+        protected:
+            static u32 QuantizeDepth(f32 depth);
+
+            std::vector<RenderQueueItem> items;
+            std::vector<RenderQueueItem> sorted;
+            std::vector<u32> order;
+            std::vector<u32> scratch;
+            u32 sequence = 0;
+    };
+
+};
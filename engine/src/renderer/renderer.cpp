@@ -8,8 +8,11 @@
 
 #include "systems/shader/shader_system.hpp"
 #include "systems/camera/camera_system.hpp"
+#include "systems/transform/transform_system.hpp"
 // TODO: TEMP
 #include "systems/material/material_system.hpp"
+#include "systems/geometry/geometry_system.hpp"
+#include "systems/texture/texture_system.hpp"
 #include "core/event/event.hpp"
 // TODO: TEMP END
 
@@ -19,12 +22,15 @@ namespace Engine {
 
     RendererFrontend::RendererFrontend(RendererSetup* setup) {
         shader_debug_mode = 0;
+        submit_mode = RendererSubmitMode::INDIRECT;
+        occlusion_culling = true;
 
         framebuffer_height = setup->height;
         framebuffer_width = setup->width;
         frames_since_resizing = 0;
         resizing = false;
         camera_system = nullptr;
+        workers = nullptr;
 
         CreateEventListeners();
     };
@@ -80,22 +86,13 @@ namespace Engine {
     };
 
     void RendererFrontend::GetRenderpasses() {
-        world_renderpass = backend->GetRenderpass(world_renderpass_name);
-        ui_renderpass = backend->GetRenderpass(ui_renderpass_name);
+        if (!render_graph.BindRenderpasses(backend)) {
+            ERROR("RendererFrontend::GetRenderpasses - backend is missing render graph passes.");
+            return;
+        }
 
         RegenerateRenderTargets();
- 
-        // Update the main/world renderpass dimensions.
-        world_renderpass->render_area.x = 0;
-        world_renderpass->render_area.y = 0;
-        world_renderpass->render_area.z = framebuffer_width;
-        world_renderpass->render_area.w = framebuffer_height;
-    
-        // Also update the UI renderpass dimensions.
-        ui_renderpass->render_area.x = 0;
-        ui_renderpass->render_area.y = 0;
-        ui_renderpass->render_area.z = framebuffer_width;
-        ui_renderpass->render_area.w = framebuffer_height;
+        render_graph.OnResize(glm::vec4(0, 0, framebuffer_width, framebuffer_height));
     };
 
     void RendererFrontend::GetCameraSystem() {
@@ -110,30 +107,25 @@ namespace Engine {
         ambient_color = {0.25f, 0.25f, 0.25f, 1.0f};
     };
 
-    RendererInitializationSetup RendererFrontend::CreateInitSetup() {
-        RendererInitializationSetup setup;
+    void RendererFrontend::BuildRenderGraph() {
+        u32 window = render_graph.AddResource("window", RenderAttachmentFormat::COLOR, RenderGraphImport::WINDOW_COLOR);
+        u32 depth = render_graph.AddResource("depth", RenderAttachmentFormat::DEPTH);
+        render_graph.SetOutput(window);
 
-        std::vector<Engine::RenderpassCreateInfo> renderpass_config;
-        renderpass_config.resize(2);
+        glm::vec4 clear_color = glm::vec4(0.0f, 0.0f, 0.2f, 1.0f);
 
-        renderpass_config[0].name = world_renderpass_name;
-        renderpass_config[0].clear_color = glm::vec4(0.0f, 0.0f, 0.2f, 1.0f);
-        renderpass_config[0].render_area = glm::vec4(0, 0, framebuffer_width, framebuffer_height);
-        renderpass_config[0].next_name = ui_renderpass_name;
-        renderpass_config[0].clear_flags = 
-            Engine::RenderpassClearFlag::CLEAR_COLOR_BUFFER | 
-            Engine::RenderpassClearFlag::CLEAR_COLOR_DEPTH_BUFER | 
-            Engine::RenderpassClearFlag::CLEAR_COLOR_STENCIL_BUFFER;
+        // The world pass is recorded in parallel, the UI pass is small and drawn in submission order.
+        u32 world = render_graph.AddPass(world_renderpass_name, clear_color, [this]() { return ExecuteWorldPass(); }, RenderpassContents::PARALLEL);
+        render_graph.Write(world, window, true);
+        render_graph.Write(world, depth, true);
 
-        renderpass_config[1].name = ui_renderpass_name;
-        renderpass_config[1].clear_color = glm::vec4(0.0f, 0.0f, 0.2f, 1.0f);
-        renderpass_config[1].render_area = glm::vec4(0, 0, framebuffer_width, framebuffer_height);
-        renderpass_config[1].prev_name = world_renderpass_name;
-        renderpass_config[1].clear_flags = Engine::RenderpassClearFlag::CLEAR_NONE;
-
-        setup.renderpasses = renderpass_config;
+        u32 ui = render_graph.AddPass(ui_renderpass_name, clear_color, [this]() { return ExecuteUIPass(); });
+        render_graph.Write(ui, window, false);
+    };
 
-        return setup;
+    b8 RendererFrontend::CreateInitSetup(RendererInitializationSetup& out_setup) {
+        BuildRenderGraph();
+        return render_graph.Compile(glm::vec4(0, 0, framebuffer_width, framebuffer_height), out_setup.renderpasses);
     };
 
     b8 RendererFrontend::CreateBackend(RendererSetup setup, RendererBackendType type) {
@@ -151,7 +143,16 @@ namespace Engine {
             } break;
         }
 
-        RendererInitializationSetup init_setup = CreateInitSetup();
+        u32 thread_count = setup.worker_threads ? std::min(setup.worker_threads, (u32)RENDERER_MAX_WORKER_THREADS) : WorkerPool::GetDefaultThreadCount(RENDERER_MAX_WORKER_THREADS);
+        workers = new WorkerPool(thread_count);
+        DEBUG("Renderer running jobs on %u threads.", workers->GetThreadCount());
+
+        RendererInitializationSetup init_setup;
+        init_setup.workers = workers;
+        if (!CreateInitSetup(init_setup)) {
+            ERROR("RendererFrontend::CreateBackend - failed to compile the render graph.");
+            return false;
+        }
         if (!backend->Initialize(init_setup)) {
             return false;
         }
@@ -170,9 +171,14 @@ namespace Engine {
 
     void RendererFrontend::ShutdownBackend() {
         if (backend) {
+            render_graph.Destroy();
             backend->Shutdown();
             delete backend;
         }
+        if (workers) {
+            delete workers;
+            workers = nullptr;
+        }
     };
 
     void RendererFrontend::Resized(u16 width, u16 height) {
@@ -200,8 +206,7 @@ namespace Engine {
                f32 height = framebuffer_height;
                camera_system->GetActive()->OnResize(width, height);
                backend->Resized(width, height);
-               world_renderpass->OnResize(glm::vec4(0, 0, width, height));
-               ui_renderpass->OnResize(glm::vec4(0, 0, width, height));
+               render_graph.OnResize(glm::vec4(0, 0, width, height));
     
                frames_since_resizing = 0;
                resizing = false;
@@ -211,103 +216,336 @@ namespace Engine {
             }
         }
 
-        ShaderSystem* shader_system = ShaderSystem::GetInstance();
+        // Age out released resources, then do mip streaming and eviction outside of command recording.
+        GeometrySystem::GetInstance()->TrimInactive();
+        MaterialSystem::GetInstance()->TrimInactive();
+        TextureSystem::GetInstance()->UpdateResidency();
+
         backend->NextFrame();
         if (BeginFrame(packet->delta_time)) {
             
             camera_system->GetActive()->OnUpdate();
 
-            // World renderpass begin
-            if (!world_renderpass->Begin()) {
-                ERROR("world_renderpass->Begin: BuiltinRenderpasses::WORLD failed. Application shutting down...");
-                return false;
-            }
+            // One linear pass over the hierarchy, GetWorld below only reads the cached matrices.
+            TransformSystem::GetInstance()->Update();
 
-            shader_system->UseShader(BUILTIN_MATERIAL_SHADER_NAME);
-            
-            ParamsData data(5);
-            data[0] = (Param){"projection", &camera_system->GetActive()->projection};
-            data[1] = (Param){"view", &camera_system->GetActive()->view};
-            data[2] = (Param){"ambient_color", &ambient_color};
-            data[3] = (Param){"view_position", &camera_system->GetActive()->camera_position};
-            data[4] = (Param){"mode", &shader_debug_mode};
-
-            shader_system->ApplyGlobals(BUILTIN_MATERIAL_SHADER_NAME, data);
-            u32 backend_frame = backend->GetFrame();
+            // Collect both passes into the queue, sorted so binds only happen when state changes. World
+            // geometry with known bounds goes through the occlusion test first.
+            frame_stats = {};
+            render_queue.Clear();
+            occlusion_candidates.clear();
+            MaterialSystem* material_system = MaterialSystem::GetInstance();
+            glm::vec3 view_position = camera_system->GetActive()->camera_position;
             for (u32 i = 0; i < meshes.size(); ++i) {
                 if (!meshes[i]) {
                     ERROR("RendererFrontend::DrawFrame - something wrong with a mesh at meshes[%i], skipping...", i);
                     continue;
                 }
                 Mesh* mesh = meshes[i];
+                glm::mat4 model = mesh->transform->GetWorld();
+                glm::vec3 offset = glm::vec3(model[3]) - view_position;
+                f32 depth = glm::dot(offset, offset);
                 for (u32 j = 0; j < mesh->geometries.size(); ++j) {
                     Material* material = mesh->geometries[j]->GetMaterial();
                     if (!material) {
-                        material = MaterialSystem::GetInstance()->GetDefaultMaterial();
+                        material = material_system->GetDefaultMaterial();
                     }
-
-                    material->ApplyInstance(backend_frame);
-
-                    glm::mat4 model = mesh->transform->GetWorld();
-                    material->ApplyLocal(&model);
-
-                    backend->DrawGeometry({j, mesh->transform->GetWorld(), mesh->geometries[j]});
+                    if (occlusion_culling && mesh->geometries[j]->HasExtent()) {
+                        occlusion_candidates.push_back({model, mesh->geometries[j], material, j, depth});
+                        continue;
+                    }
+                    render_queue.Push(RenderQueuePass::WORLD, j, model, mesh->geometries[j], material, depth);
                 }
+            }
+            PushVisibleCandidates();
 
+            for (u32 i = 0; i < packet->ui_geometries.size(); ++i) {
+                GeometryRenderData& ui_geometry = packet->ui_geometries[i];
+                if (!ui_geometry.geometry) {
+                    ERROR("RendererFrontend::DrawFrame - something wrong with geometry at packet->ui_geometries[%i], skipping...", i);
+                    continue;
+                }
+                Material* material = ui_geometry.geometry->GetMaterial();
+                if (!material) {
+                    material = material_system->GetDefaultMaterial();
+                }
+                render_queue.PushOrdered(RenderQueuePass::UI, ui_geometry.object_id, ui_geometry.model, ui_geometry.geometry, material);
             }
-            
-            if (!world_renderpass->End()) {
-                ERROR("world_renderpass->End: BuiltinRenderpasses::WORLD failed. Application shutting down...");
+
+            render_queue.Sort();
+
+            // World then UI, as compiled by the render graph.
+            if (!render_graph.Execute()) {
+                ERROR("RendererFrontend::DrawFrame - render graph execution failed. Application shutting down...");
                 return false;
             }
-            // World renderpass end
 
-            // UI renderpass begin
-            if (!ui_renderpass->Begin()) {
-                ERROR("ui_renderpass->Begin: BuiltinRenderpasses::UI failed. Application shutting down...");
+            frame_stats.uniform_bytes = backend->GetStats().uniform_bytes;
+            frame_stats.descriptor_writes = backend->GetStats().descriptor_writes;
+
+            b8 result = EndFrame(packet->delta_time);
+            if (!result) {
+                ERROR("RendererFrontend::EndFrame failed. Application shutting down...");
                 return false;
             }
+        }
 
-            shader_system->UseShader(BUILTIN_UI_SHADER_NAME);
-            
-            ParamsData ui_data(2);
-            ui_data[0] = (Param){"projection", &camera_system->GetActive()->ui_projection};
-            ui_data[1] = (Param){"view", &camera_system->GetActive()->ui_view};
+        return true;
+    };
 
-            shader_system->ApplyGlobals(BUILTIN_UI_SHADER_NAME, ui_data);
+    void RendererFrontend::PushVisibleCandidates() {
+        Camera* camera = camera_system->GetActive();
+        occlusion_culler.Begin(camera->projection * camera->view);
+        if (occlusion_candidates.empty()) {
+            return;
+        }
 
-            for (u32 i = 0; i < packet->ui_geometries.size(); ++i) {
-                if (!packet->ui_geometries[i].geometry) {
-                    ERROR("RendererFrontend::DrawFrame - something wrong with geometry at packet->ui_geometries[%i], skipping...", i);
-                    continue;
+        // Opaque geometry with a CPU copy can occlude, the ones covering the most screen are used.
+        occluder_order.clear();
+        occluder_scores.resize(occlusion_candidates.size());
+        for (u32 i = 0; i < occlusion_candidates.size(); ++i) {
+            RendererOcclusionCandidate& candidate = occlusion_candidates[i];
+            if (!candidate.geometry->IsOccluder()) {
+                continue;
+            }
+            Texture* diffuse = candidate.material->GetDiffuseMap().texture;
+            if (diffuse && diffuse->HasTransparency()) {
+                continue;
+            }
+            const GeometryExtent& extent = candidate.geometry->GetExtent();
+            glm::vec3 size = glm::vec3(candidate.model * glm::vec4(extent.max_extents - extent.min_extents, 0.0f));
+            occluder_scores[i] = glm::dot(size, size) / std::max(candidate.depth, FLOAT_EPSILON);
+            occluder_order.push_back(i);
+        }
+        u32 occluder_count = std::min((u32)occluder_order.size(), (u32)OCCLUSION_MAX_OCCLUDERS);
+        std::partial_sort(occluder_order.begin(), occluder_order.begin() + occluder_count, occluder_order.end(), [&](u32 a, u32 b) {
+            return occluder_scores[a] > occluder_scores[b];
+        });
+        for (u32 i = 0; i < occluder_count; ++i) {
+            RendererOcclusionCandidate& occluder = occlusion_candidates[occluder_order[i]];
+            occlusion_culler.AddOccluder(occluder.model, &occluder.geometry->GetOccluderPositions(), &occluder.geometry->GetOccluderIndices());
+        }
+        occlusion_culler.Rasterize(workers);
+
+        occlusion_queries.resize(occlusion_candidates.size());
+        occlusion_visible.resize(occlusion_candidates.size());
+        for (u32 i = 0; i < occlusion_candidates.size(); ++i) {
+            occlusion_queries[i] = {&occlusion_candidates[i].model, &occlusion_candidates[i].geometry->GetExtent()};
+        }
+        occlusion_culler.Test(workers, occlusion_candidates.size(), occlusion_queries.data(), occlusion_visible.data());
+
+        for (u32 i = 0; i < occlusion_candidates.size(); ++i) {
+            if (!occlusion_visible[i]) {
+                continue;
+            }
+            RendererOcclusionCandidate& candidate = occlusion_candidates[i];
+            render_queue.Push(RenderQueuePass::WORLD, candidate.object_id, candidate.model, candidate.geometry, candidate.material, candidate.depth);
+        }
+    };
+
+    b8 RendererFrontend::ExecuteWorldPass() {
+        ParamsData data(5);
+        data[0] = (Param){"projection", &camera_system->GetActive()->projection};
+        data[1] = (Param){"view", &camera_system->GetActive()->view};
+        data[2] = (Param){"ambient_color", &ambient_color};
+        data[3] = (Param){"view_position", &camera_system->GetActive()->camera_position};
+        data[4] = (Param){"mode", &shader_debug_mode};
+
+        DrawQueuePass(RenderQueuePass::WORLD, BUILTIN_MATERIAL_SHADER_NAME, data, RenderpassContents::PARALLEL);
+        return true;
+    };
+
+    b8 RendererFrontend::ExecuteUIPass() {
+        ParamsData ui_data(2);
+        ui_data[0] = (Param){"projection", &camera_system->GetActive()->ui_projection};
+        ui_data[1] = (Param){"view", &camera_system->GetActive()->ui_view};
+
+        DrawQueuePass(RenderQueuePass::UI, BUILTIN_UI_SHADER_NAME, ui_data, RenderpassContents::INLINE);
+        return true;
+    };
+
+    void RendererFrontend::DrawQueuePass(RenderQueuePass pass, const std::string& shader_name, ParamsData& globals, RenderpassContents contents) {
+        ShaderSystem* shader_system = ShaderSystem::GetInstance();
+
+        Shader* pass_shader = shader_system->LookupShader(shader_name);
+        if (!pass_shader) {
+            ERROR("RendererFrontend::DrawQueuePass - shader '%s' not found.", shader_name.c_str());
+            return;
+        }
+
+        u32 count = 0;
+        RenderQueueItem* items = render_queue.GetPass(pass, &count);
+
+        // Everything that writes shader or material state happens here on this thread, recording only binds.
+        shader_system->UpdateGlobals(shader_name, globals);
+        Shader* updated_shader = pass_shader;
+        Material* updated_material = nullptr;
+        for (u32 i = 0; i < count; ++i) {
+            Material* material = items[i].material;
+            if (material == updated_material) {
+                continue;
+            }
+            Shader* shader = material->GetShader();
+            if (shader && shader != updated_shader) {
+                shader_system->UpdateGlobals(shader->GetName(), globals);
+                updated_shader = shader;
+            }
+            material->UpdateInstance();
+            updated_material = material;
+        }
+
+        if (contents == RenderpassContents::INLINE) {
+            record_jobs.resize(std::max((u32)record_jobs.size(), 1u));
+            record_jobs[0].stats = {};
+            RecordQueueRange(items, 0, count, pass_shader, record_jobs[0]);
+            frame_stats.Accumulate(record_jobs[0].stats);
+            return;
+        }
+
+        // One slice per recording thread unless there are too few draws to go around. Slices are cut
+        // at material changes, so material runs keep their instanced and indirect draws. Bindless runs
+        // spanning several materials may still be split at a slice bound.
+        u32 job_count = std::min(backend->GetRecordingThreadCount(), std::max(count / RENDERER_MIN_DRAWS_PER_JOB, 1u));
+        record_jobs.resize(std::max((u32)record_jobs.size(), job_count));
+        record_bounds.resize(job_count + 1);
+        record_bounds[0] = 0;
+        for (u32 i = 1; i < job_count; ++i) {
+            u32 bound = std::max((u64)count * i / job_count, (u64)record_bounds[i - 1]);
+            while (bound > 0 && bound < count && items[bound].material == items[bound - 1].material) {
+                bound++;
+            }
+            record_bounds[i] = bound;
+        }
+        record_bounds[job_count] = count;
+
+        backend->RecordParallel(job_count, [&](u32 job) {
+            record_jobs[job].stats = {};
+            RecordQueueRange(items, record_bounds[job], record_bounds[job + 1], pass_shader, record_jobs[job]);
+        });
+
+        for (u32 i = 0; i < job_count; ++i) {
+            frame_stats.Accumulate(record_jobs[i].stats);
+        }
+        frame_stats.recording_jobs += job_count;
+    };
+
+    void RendererFrontend::RecordQueueRange(RenderQueueItem* items, u32 begin, u32 end, Shader* pass_shader, RendererRecordJobState& job) {
+        RenderQueueStats& stats = job.stats;
+
+        // The pass shader is bound up front like before, so an empty pass still has its globals bound.
+        Shader* bound_shader = pass_shader;
+        bound_shader->Use();
+        bound_shader->RecordGlobals();
+        stats.pipeline_binds++;
+        stats.descriptor_binds++;
+
+        Material* bound_material = nullptr;
+        b8 instanced_bound = false;
+        b8 use_indirect = submit_mode == RendererSubmitMode::INDIRECT && backend->SupportsIndirectDraw();
+        // Runs the backend refused as indirect are drawn directly up to here.
+        u32 direct_until = begin;
+        for (u32 i = begin; i < end;) {
+            RenderQueueItem& item = items[i];
+
+            Shader* shader = item.material->GetShader();
+            if (shader && shader != bound_shader) {
+                shader->Use();
+                shader->RecordGlobals();
+                stats.pipeline_binds++;
+                stats.descriptor_binds++;
+                bound_shader = shader;
+                bound_material = nullptr;
+                instanced_bound = false;
+            }
+
+            if (item.material != bound_material) {
+                item.material->RecordInstance();
+                // Bindless materials only push their record index.
+                if (!bound_shader->UsesBindless()) {
+                    stats.descriptor_binds++;
                 }
+                bound_material = item.material;
+            }
 
-                Material* material = packet->ui_geometries[i].geometry->GetMaterial();
-                if (!material) {
-                    material = MaterialSystem::GetInstance()->GetDefaultMaterial();
+            // Whole material run in one indirect call, transforms are picked up per draw through firstInstance.
+            // Bindless materials are too, so their run goes on for as long as the pipeline stays the same.
+            if (use_indirect && i >= direct_until && bound_shader->SupportsInstancing()) {
+                b8 bindless = bound_shader->UsesBindless();
+                u32 run = 1;
+                while (i + run < end && (items[i + run].material == item.material || (bindless && items[i + run].material->GetShader() == bound_shader))) {
+                    run++;
+                }
+
+                job.indirect_groups.clear();
+                job.instance_models.resize(run);
+                job.instance_materials.resize(run);
+                for (u32 j = 0; j < run; ++j) {
+                    job.instance_models[j] = items[i + j].model;
+                    job.instance_materials[j] = items[i + j].material->GetInternalId();
+                    if (!job.indirect_groups.size() || job.indirect_groups.back().geometry != items[i + j].geometry) {
+                        job.indirect_groups.push_back({items[i + j].geometry, j, 0});
+                    }
+                    job.indirect_groups.back().instance_count++;
+                }
+
+                if (!instanced_bound) {
+                    bound_shader->UseInstanced();
+                    stats.pipeline_binds++;
+                    instanced_bound = true;
+                }
+
+                if (backend->DrawGeometryIndirect(job.indirect_groups.data(), job.indirect_groups.size(), job.instance_models.data(), job.instance_materials.data(), run)) {
+                    stats.draws++;
+                    stats.indirect_records += job.indirect_groups.size();
+                    stats.instances += run;
+                    i += run;
+                    continue;
                 }
+                direct_until = i + run;
+            }
 
-                material->ApplyInstance(backend_frame);
+            // The sort keys put copies of the same geometry and material next to each other.
+            u32 group = 1;
+            while (i + group < end && items[i + group].geometry == item.geometry && items[i + group].material == item.material) {
+                group++;
+            }
 
-                material->ApplyLocal(&packet->ui_geometries[i].model);
+            if (group >= RENDERER_MIN_INSTANCED_GROUP && bound_shader->SupportsInstancing()) {
+                job.instance_models.resize(group);
+                for (u32 j = 0; j < group; ++j) {
+                    job.instance_models[j] = items[i + j].model;
+                }
 
-                backend->DrawGeometry(packet->ui_geometries[i]);
+                if (!instanced_bound) {
+                    bound_shader->UseInstanced();
+                    stats.pipeline_binds++;
+                    instanced_bound = true;
+                }
+
+                if (backend->DrawGeometryInstanced(item.geometry, job.instance_models.data(), group)) {
+                    stats.draws++;
+                    stats.instances += group;
+                    i += group;
+                    continue;
+                }
             }
 
-            if (!ui_renderpass->End()) {
-                ERROR("ui_renderpass->End: BuiltinRenderpasses::UI failed. Application shutting down...");
-                return false;
+            // Too small a group, no instanced variant or the instance buffer ran out for this frame.
+            if (instanced_bound) {
+                bound_shader->Use();
+                stats.pipeline_binds++;
+                instanced_bound = false;
             }
-            // UI renderpass end
 
-            b8 result = EndFrame(packet->delta_time);
-            if (!result) {
-                ERROR("RendererFrontend::EndFrame failed. Application shutting down...");
-                return false;
+            for (u32 j = 0; j < group; ++j) {
+                RenderQueueItem& draw = items[i + j];
+                draw.material->ApplyLocal(&draw.model);
+                backend->DrawGeometry({draw.object_id, draw.model, draw.geometry});
+                stats.draws++;
+                stats.instances++;
             }
+            i += group;
         }
-
-        return true;
     };
 
     b8 RendererFrontend::BeginFrame(f32 delta_time) {
@@ -405,39 +643,6 @@ namespace Engine {
     };
 
     b8 RendererFrontend::RegenerateRenderTargets() {
-        if (world_renderpass->render_targets.size() < image_count) {
-            world_renderpass->render_targets.resize(image_count);
-        }
-        if (ui_renderpass->render_targets.size() < image_count) {
-            ui_renderpass->render_targets.resize(image_count);
-        }
-
-        for (u32 i = 0; i < image_count; ++i) {
-            delete world_renderpass->render_targets[i];
-            delete ui_renderpass->render_targets[i];
-
-            Texture* window_target_texture = backend->GetWindowAttachment(i);
-            Texture* depth_target_texture = backend->GetDepthAttachment();
-
-            RenderTargetCreateInfo world_create_info;
-            world_create_info.attachments = {window_target_texture, depth_target_texture};
-            world_create_info.height = framebuffer_height;
-            world_create_info.width = framebuffer_width;
-            world_create_info.manage_attachments = false;
-            world_create_info.renderpass = world_renderpass;
-
-            world_renderpass->render_targets[i] = backend->CreateRenderTarget(world_create_info);
-
-            RenderTargetCreateInfo ui_create_info;
-            ui_create_info.attachments = {window_target_texture};
-            ui_create_info.height = framebuffer_height;
-            ui_create_info.width = framebuffer_width;
-            ui_create_info.manage_attachments = false;
-            ui_create_info.renderpass = ui_renderpass;
-
-            ui_renderpass->render_targets[i] = backend->CreateRenderTarget(ui_create_info);
-        }
-
-        return true;
+        return render_graph.CreateTargets(backend, framebuffer_width, framebuffer_height, image_count);
     }
 };
\ No newline at end of file
@@ -8,12 +8,31 @@
 #include "resources/shader/shader.hpp"
 #include "renderer_types.hpp"
 #include "renderer/renderpass.hpp"
+#include "renderer/render_queue.hpp"
+#include "renderer/render_graph.hpp"
+#include "renderer/occlusion_culler.hpp"
 #include "systems/camera/camera_system.hpp"
+#include "systems/shader/shader_system.hpp"
+#include "core/utils/worker_pool.hpp"
 // temp
 #include "resources/mesh/mesh.hpp"
 
 namespace Engine {
 
+    // Runs of at least this many draws sharing geometry and material go out as one instanced draw.
+    #define RENDERER_MIN_INSTANCED_GROUP 2
+    // Parallel passes give each recording thread at least this many draws.
+    #define RENDERER_MIN_DRAWS_PER_JOB 256
+    // Upper bound on worker threads, the render thread included.
+    #define RENDERER_MAX_WORKER_THREADS 8
+
+    enum class RendererSubmitMode {
+        // One draw call per geometry run, instanced where the shader allows it.
+        DIRECT,
+        // One indirect call per material run, falls back to DIRECT where the backend can't.
+        INDIRECT
+    };
+
     enum RendererBackendType {
         VULKAN,
         OPEN_GL,
@@ -24,10 +43,76 @@ namespace Engine {
         u32 width;
         u32 height;
         std::string name;
+        // No surface or swapchain, frames render into backend owned images and are read back to host memory.
+        b8 headless = false;
+        // Threads for recording and culling, 0 takes one per hardware thread. Capped at RENDERER_MAX_WORKER_THREADS.
+        u32 worker_threads = 0;
+    };
+
+    // A rendered frame copied back to host memory, 4 bytes per pixel in BGRA order.
+    struct RendererFrameReadback {
+        // Frames submitted before this one since initialization.
+        u64 frame = 0;
+        u32 width = 0;
+        u32 height = 0;
+        std::vector<u8> pixels;
+    };
+
+    // GPU time of one renderpass, begin is relative to the start of the frame's command buffer.
+    struct RendererGpuScope {
+        std::string name;
+        f64 begin_ms = 0.0;
+        f64 duration_ms = 0.0;
+    };
+
+    // CPU and GPU time of a completed frame, read a few frames after submission without waiting on the GPU.
+    struct RendererFrameTimings {
+        // Frames submitted before this one since initialization.
+        u64 frame = 0;
+        // Recording time from the beginning of the frame to its submission.
+        f64 cpu_ms = 0.0;
+        // Execution time of the frame's command buffer, 0 when the device has no timestamps.
+        f64 gpu_ms = 0.0;
+        // GPU time of upload batches retired since the previous timings.
+        f64 upload_gpu_ms = 0.0;
+        // Set when GPU times below were mapped to the Platform::GetAbsoluteTime clock, needs calibrated timestamps.
+        b8 calibrated = false;
+        f64 cpu_submit_time = 0.0;
+        f64 gpu_begin_time = 0.0;
+        f64 gpu_end_time = 0.0;
+        std::vector<RendererGpuScope> scopes;
+    };
+
+    // Upload work done by the backend since the frame began.
+    struct RendererBackendStats {
+        u64 uniform_bytes = 0;
+        u32 descriptor_writes = 0;
+    };
+
+    // Records one slice of a pass, called on a recording thread with the slice index.
+    using RendererRecordJob = std::function<void(u32 job)>;
+
+    // Scratch and counters of one recording job, jobs never share them.
+    struct RendererRecordJobState {
+        RenderQueueStats stats;
+        std::vector<glm::mat4> instance_models;
+        std::vector<u32> instance_materials;
+        std::vector<GeometryDrawGroup> indirect_groups;
+    };
+
+    // World draw waiting on the occlusion test.
+    struct RendererOcclusionCandidate {
+        glm::mat4 model;
+        Geometry* geometry;
+        Material* material;
+        u32 object_id;
+        f32 depth;
     };
 
     struct RendererInitializationSetup {
         std::vector<RenderpassCreateInfo> renderpasses;
+        // Shared with the frontend, outlives the backend.
+        WorkerPool* workers;
     };
 
     class RendererBackend {
@@ -36,6 +121,7 @@ namespace Engine {
                 name = setup.name;
                 width = setup.width;
                 height = setup.height;
+                headless = setup.headless;
             };
 
             virtual ~RendererBackend() = default;
@@ -46,16 +132,38 @@ namespace Engine {
             virtual b8 BeginFrame(f32 delta_time) = 0;
             virtual b8 EndFrame(f32 delta_time) = 0;
             virtual void DrawGeometry(GeometryRenderData data) = 0;
+            // One draw for count copies of the geometry, returns false if the frame's instance buffer is full.
+            virtual b8 DrawGeometryInstanced(Geometry* geometry, const glm::mat4* models, u32 count) = 0;
+            // All groups in one indirect call from the shared vertex and index buffers, models and the bindless material
+            // record of each instance are read by instance index. Returns false without drawing if a group can't be
+            // expressed that way or the frame's buffers are full.
+            virtual b8 DrawGeometryIndirect(const GeometryDrawGroup* groups, u32 group_count, const glm::mat4* models, const u32* material_indices, u32 model_count) = 0;
+            virtual b8 SupportsIndirectDraw() = 0;
+            // Runs job_count jobs spread over the recording threads, each recording into its own command buffer,
+            // executed in job order. Only valid inside a pass begun with RenderpassContents::PARALLEL.
+            virtual b8 RecordParallel(u32 job_count, const RendererRecordJob& job) = 0;
+            // Recording threads, the calling one included.
+            virtual u32 GetRecordingThreadCount() = 0;
             virtual void NextFrame() = 0;
             virtual u32 GetFrame() = 0;
             virtual Renderpass* GetRenderpass(std::string name) = 0;
             virtual u32 GetImageCount() = 0;
             virtual Texture* GetWindowAttachment(u32 index) = 0;
-            virtual Texture* GetDepthAttachment() = 0;
+            // Render graph attachments in one allocation, those in the same memory slot placed over each other.
+            // Replaces the memory of the previous call, sampled ones can be read by later passes.
+            virtual b8 CreateAttachments(const std::vector<RenderAttachmentCreateInfo>& infos, u32 width, u32 height, std::vector<Texture*>& out_textures) = 0;
+            // Headless only. The newest completed frame not read yet, false if there is none. With wait set it
+            // blocks for the last submitted frame instead.
+            virtual b8 ReadFrame(RendererFrameReadback* out_readback, b8 wait) = 0;
+            // The newest frame whose timestamps are available, false if none completed since the last call.
+            virtual b8 GetFrameTimings(RendererFrameTimings* out_timings) = 0;
+            b8 IsHeadless() { return headless; };
 
             u32 GetFrameWidth() { return width; };
             u32 GetFrameHeight() { return height; };
 
+            RendererBackendStats& GetStats() { return stats; };
+
             virtual Texture* CreateTexture(TextureCreateInfo& info) = 0;
             virtual Material* CreateMaterial(MaterialCreateInfo& info) = 0;
             virtual Geometry* CreateGeometry(GeometryCreateInfo& info) = 0;
@@ -70,6 +178,8 @@ namespace Engine {
             u32 height;
             u32 cached_width;
             u32 cached_height;
+            b8 headless;
+            RendererBackendStats stats;
 
         friend class RendererFrontend;
     };
@@ -91,6 +201,25 @@ namespace Engine {
 
             u32 GetFrameWidth() { return backend->GetFrameWidth(); };
             u32 GetFrameHeight() { return backend->GetFrameHeight(); };
+
+            // Draw and bind counts of the last rendered frame.
+            RenderQueueStats& GetFrameStats() { return frame_stats; };
+            // Pass, transition and transient attachment counts of the compiled frame graph.
+            const RenderGraphStats& GetRenderGraphStats() { return render_graph.GetStats(); };
+
+            void SetSubmitMode(RendererSubmitMode mode) { submit_mode = mode; };
+            RendererSubmitMode GetSubmitMode() { return submit_mode; };
+
+            // Occluders, tested boxes, culled boxes and CPU cost of the last frame's occlusion culling.
+            const OcclusionStats& GetOcclusionStats() { return occlusion_culler.GetStats(); };
+            void SetOcclusionCulling(b8 enabled) { occlusion_culling = enabled; };
+            b8 GetOcclusionCulling() { return occlusion_culling; };
+
+            // Headless rendering, frames can be read back for comparison against golden images.
+            b8 IsHeadless() { return backend->IsHeadless(); };
+            b8 ReadFrame(RendererFrameReadback* out_readback, b8 wait) { return backend->ReadFrame(out_readback, wait); };
+            // Per pass GPU timings next to the CPU frame time, never blocks.
+            b8 GetFrameTimings(RendererFrameTimings* out_timings) { return backend->GetFrameTimings(out_timings); };
             
             Texture* CreateTexture(TextureCreateInfo& info);
             Material* CreateMaterial(MaterialCreateInfo& info);
@@ -109,7 +238,10 @@ namespace Engine {
             void DrawGeometry(GeometryRenderData data);
             
             void CreateEventListeners();
-            RendererInitializationSetup CreateInitSetup();
+            b8 CreateInitSetup(RendererInitializationSetup& out_setup);
+            void BuildRenderGraph();
+            b8 ExecuteWorldPass();
+            b8 ExecuteUIPass();
 
             void InitializeRenderer();
             void GetRenderpasses();
@@ -122,17 +254,39 @@ namespace Engine {
             void ShutdownBackend();
 
             b8 _DrawFrame(RenderPacket* packet);
+            void DrawQueuePass(RenderQueuePass pass, const std::string& shader_name, ParamsData& globals, RenderpassContents contents);
+            // Binds and draws items [begin, end) into the calling thread's command buffer, uploads are done by then.
+            void RecordQueueRange(RenderQueueItem* items, u32 begin, u32 end, Shader* pass_shader, RendererRecordJobState& job);
+            // Rasterizes the biggest candidates as occluders and pushes the candidates that survive into the queue.
+            void PushVisibleCandidates();
 
             void GetCameraSystem();
 
             static RendererFrontend* instance;
             RendererBackend* backend;
+            // Job threads for recording and culling, owned by the frontend.
+            WorkerPool* workers;
 
-            Renderpass* world_renderpass;
-            Renderpass* ui_renderpass;
+            RenderGraph render_graph;
 
             CameraSystem* camera_system;
 
+            RenderQueue render_queue;
+            RenderQueueStats frame_stats;
+            std::vector<RendererRecordJobState> record_jobs;
+            // Item ranges of the jobs of the pass being recorded.
+            std::vector<u32> record_bounds;
+            RendererSubmitMode submit_mode;
+
+            b8 occlusion_culling;
+            OcclusionCuller occlusion_culler;
+            std::vector<RendererOcclusionCandidate> occlusion_candidates;
+            // Scratch of PushVisibleCandidates.
+            std::vector<u32> occluder_order;
+            std::vector<f32> occluder_scores;
+            std::vector<OcclusionQuery> occlusion_queries;
+            std::vector<u8> occlusion_visible;
+
             glm::vec4 ambient_color;
             u32 shader_debug_mode;
 
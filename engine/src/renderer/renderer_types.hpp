@@ -40,6 +40,13 @@ namespace Engine {
         class Geometry* geometry;
     };
     
+    // One record of an indirect batch, instances index into the models handed over with the batch.
+    struct GeometryDrawGroup {
+        class Geometry* geometry;
+        u32 first_instance;
+        u32 instance_count;
+    };
+
     struct RenderPacket {
         f32 delta_time;
         std::vector<GeometryRenderData> geometries;
@@ -13,6 +13,53 @@ namespace Engine {
 
     ENABLE_BITMASK_OPERATORS(RenderpassClearFlag)
 
+    enum class RenderAttachmentFormat {
+        // Same format as the window images.
+        COLOR,
+        DEPTH
+    };
+
+    // How a pass touches an image, backends derive layouts and synchronization from it.
+    enum class RenderAttachmentUsage {
+        NONE,
+        COLOR,
+        DEPTH,
+        SAMPLED,
+        PRESENT
+    };
+
+    enum class RenderAttachmentLoad {
+        DONT_CARE,
+        CLEAR,
+        LOAD
+    };
+
+    enum class RenderpassContents {
+        // Commands are recorded straight into the frame command buffer.
+        INLINE,
+        // Everything inside the pass comes from RendererBackend::RecordParallel.
+        PARALLEL
+    };
+
+    struct RenderpassAttachmentInfo {
+        RenderAttachmentFormat format;
+        RenderAttachmentLoad load;
+        b8 store;
+        // Uses of the same image right before and after this pass, NONE if there are none.
+        RenderAttachmentUsage prev_usage;
+        RenderAttachmentUsage next_usage;
+        // Last uses of the other images placed over this one's memory, set on its first use in the frame,
+        // which waits for them before overwriting the memory.
+        std::vector<RenderAttachmentUsage> alias_usages;
+    };
+
+    struct RenderAttachmentCreateInfo {
+        RenderAttachmentFormat format;
+        b8 sampled;
+        // Attachments in the same slot share memory, the render graph never has two of them in use at once.
+        u32 memory_slot;
+    };
+
     struct RenderpassCreateInfo {
         std::string name;
         std::string prev_name;
@@ -20,13 +67,15 @@ namespace Engine {
         glm::vec4 render_area;
         glm::vec4 clear_color;
         RenderpassClearFlag clear_flags;
+        // Filled by the render graph, when empty the attachments follow clear_flags and prev/next names.
+        std::vector<RenderpassAttachmentInfo> attachments;
     };
 
     class Renderpass {
         public:
             virtual ~Renderpass() = default;
 
-            virtual b8 Begin() = 0;
+            virtual b8 Begin(RenderpassContents contents = RenderpassContents::INLINE) = 0;
             virtual b8 End() = 0;
             virtual void OnResize(glm::vec4 render_area) = 0;
 
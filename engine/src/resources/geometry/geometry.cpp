@@ -11,6 +11,32 @@ namespace Engine {
         generation = INVALID_ID;
         name = info.name;
         material = info.material;
+
+        has_extent = false;
+        extent = {};
+        if (info.vertex_element_size != sizeof(Vertex3D) || !info.vertex_count || !info.vertices) {
+            return;
+        }
+
+        Vertex3D* vertices = (Vertex3D*)info.vertices;
+        extent.min_extents = vertices[0].position;
+        extent.max_extents = vertices[0].position;
+        for (u32 i = 1; i < info.vertex_count; ++i) {
+            extent.min_extents = glm::min(extent.min_extents, vertices[i].position);
+            extent.max_extents = glm::max(extent.max_extents, vertices[i].position);
+        }
+        extent.center = (extent.min_extents + extent.max_extents) * 0.5f;
+        has_extent = true;
+
+        if (info.index_element_size != sizeof(u32) || !info.indices || info.index_count < 3 || info.index_count / 3 > GEOMETRY_MAX_OCCLUDER_TRIANGLES) {
+            return;
+        }
+        occluder_positions.resize(info.vertex_count);
+        for (u32 i = 0; i < info.vertex_count; ++i) {
+            occluder_positions[i] = vertices[i].position;
+        }
+        u32* indices = (u32*)info.indices;
+        occluder_indices.assign(indices, indices + info.index_count - info.index_count % 3);
     }
 
     Geometry::~Geometry() {
@@ -9,6 +9,8 @@ namespace Engine
 {
     
     #define DEFAULT_GEOMETRY_NAME "default_geometry"
+    // Geometries with more triangles keep no CPU copy and are never used as occluders.
+    #define GEOMETRY_MAX_OCCLUDER_TRIANGLES 8192
 
     struct GeometryCreateInfo {
         u32 vertex_count;
@@ -46,6 +48,15 @@ namespace Engine
             void SetGeneration(u32 gen) { generation = gen; };
             void SetId(u32 id) { id = id; };
 
+            // Object space bounds, only known for 3D geometry.
+            b8 HasExtent() { return has_extent; };
+            const GeometryExtent& GetExtent() { return extent; };
+
+            // Object space triangles for the occlusion culler, empty unless the geometry is small enough.
+            b8 IsOccluder() { return !occluder_indices.empty(); };
+            const std::vector<glm::vec3>& GetOccluderPositions() { return occluder_positions; };
+            const std::vector<u32>& GetOccluderIndices() { return occluder_indices; };
+
             static void GenerateTangents(u32 vertex_count, Vertex3D* vertices, u32 index_count, u32* indices);
             static void GenerateNormals(u32 vertex_count, Vertex3D* vertices, u32 index_count, u32* indices);
             static u32 DeduplicateVertices(u32 vertex_count, Vertex3D* vertices, u32 index_count, u32* indices, Vertex3D** out_vertices);
@@ -58,6 +69,11 @@ namespace Engine
             u32 generation;
             u32 internal_id;
             Material* material;
+
+            b8 has_extent;
+            GeometryExtent extent;
+            std::vector<glm::vec3> occluder_positions;
+            std::vector<u32> occluder_indices;
     };
 
 };
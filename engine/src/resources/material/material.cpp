@@ -2,6 +2,7 @@
 
 #include "core/logger/logger.hpp"
 #include "systems/shader/shader_system.hpp"
+#include "systems/texture/texture_system.hpp"
 #include "platform/platform.hpp"
 
 namespace Engine {
@@ -12,7 +13,9 @@ namespace Engine {
         id = INVALID_ID;
         generation = INVALID_ID;
         internal_id = INVALID_ID;
-        current_frame = INVALID_ID;
+        parameter_generation = 0;
+        applied_generation = INVALID_ID;
+        applied_texture_generation = INVALID_ID;
         diffuse_color = info.diffuse_color;
         shininess = info.shininess;
         memory = nullptr;
@@ -62,21 +65,36 @@ namespace Engine {
         return true;
     };
 
-    b8 Material::ApplyInstance(u32 frame) {
+    b8 Material::ApplyInstance() {
+        return UpdateInstance() && RecordInstance();
+    };
+
+    b8 Material::UpdateInstance() {
         if (!shader) {
-            ERROR("Material::ApplyInstance - no shader provided in material, can't apply instance");
+            ERROR("Material::UpdateInstance - no shader provided in material, can't apply instance");
             return false;
         }
 
         if (internal_id == INVALID_ID) {
-            ERROR("Material::ApplyInstance - material resources not acquired from shader.");
+            ERROR("Material::UpdateInstance - material resources not acquired from shader.");
             return false;
         }
 
-        b8 needs_update = current_frame != frame;
-        
         shader->BindInstance(internal_id);
 
+        // Feeds texture residency, so used textures get their detail mips streamed in.
+        TextureSystem* texture_system = TextureSystem::GetInstance();
+        u32 texture_generation = 0;
+        for (TextureMap* map : texture_maps) {
+            if (map && map->texture) {
+                texture_system->TouchTexture(map->texture);
+                texture_generation += map->texture->GetGeneration();
+            }
+        }
+
+        // The shader keeps the values between frames, only push them again when something changed.
+        b8 needs_update = applied_generation != parameter_generation || applied_texture_generation != texture_generation;
+
         if (needs_update) {
             shader->SetUniformByName("diffuse_color", &diffuse_color);
 
@@ -95,11 +113,20 @@ namespace Engine {
                 shader->SetUniformByName("shininess", &shininess);
             }
 
-            current_frame = frame;
+            applied_generation = parameter_generation;
+            applied_texture_generation = texture_generation;
         }
         
-        shader->ApplyInstance(needs_update);
+        shader->UpdateInstance(needs_update);
+
+        return true;
+    };
 
+    b8 Material::RecordInstance() {
+        if (!shader || internal_id == INVALID_ID) {
+            return false;
+        }
+        shader->RecordInstance(internal_id);
         return true;
     };
 
@@ -32,11 +32,17 @@ namespace Engine {
             TextureMap& GetDiffuseMap() { return diffuse_map; };
             TextureMap& GetSpecularMap() { return specular_map; };
 
-            void SetFrame(u32 frame) { current_frame = frame; };
-            u32 GetFrame() { return current_frame; }; 
+            void SetDiffuseColor(glm::vec4 color) { diffuse_color = color; MarkDirty(); };
+            void SetShininess(f32 value) { shininess = value; MarkDirty(); };
+            // Call after changing a texture map in place, parameters are only pushed to the shader when dirty.
+            void MarkDirty() { parameter_generation++; };
+            u32 GetParameterGeneration() { return parameter_generation; };
 
             b8 AcquireInstanceResources();
-            b8 ApplyInstance(u32 frame);
+            b8 ApplyInstance();
+            // ApplyInstance in two steps, UpdateInstance on the main thread then RecordInstance from any recording thread.
+            b8 UpdateInstance();
+            b8 RecordInstance();
             b8 ApplyLocal(const glm::mat4* model);
 
             void SetInternalId(u32 id) { internal_id = id; };
@@ -58,7 +64,11 @@ namespace Engine {
             TextureMap normals_map;
             std::vector<TextureMap*> texture_maps;
             FreelistNode* memory;
-            u32 current_frame;
             f32 shininess;
+            // Bumped on every parameter change, compared against what was last pushed to the shader.
+            u32 parameter_generation;
+            u32 applied_generation;
+            // Sum of the map texture generations when last pushed, catches streamed or reloaded textures.
+            u32 applied_texture_generation;
     };
 };
\ No newline at end of file
@@ -4,7 +4,15 @@ namespace Engine {
 
 
     Mesh::Mesh(MeshCreateConfig config) {
-        geometries = config.geometries;
+        GeometrySystem* gs = GeometrySystem::GetInstance();
+        for (GeometryHandle handle : config.geometries) {
+            Geometry* geometry = gs->GetGeometry(handle);
+            if (!geometry) {
+                continue;
+            }
+            handles.push_back(handle);
+            geometries.push_back(geometry);
+        }
         transform = config.transform;
         if (!transform) {
             transform = new Transform();
@@ -12,6 +20,13 @@ namespace Engine {
     };
 
     Mesh::~Mesh() {
+        GeometrySystem* gs = GeometrySystem::GetInstance();
+        if (gs) {
+            for (GeometryHandle handle : handles) {
+                gs->ReleaseGeometry(handle);
+            }
+        }
+        handles.clear();
         geometries.clear();
         delete transform;
     };
@@ -4,19 +4,24 @@
 
 #include "resources/geometry/geometry.hpp"
 #include "math/transform/transform.hpp"
+#include "systems/geometry/geometry_system.hpp"
 
 namespace Engine {
     
     struct ENGINE_API MeshCreateConfig {
         Transform* transform;
-        std::vector<Geometry*> geometries;
+        // Acquired from the GeometrySystem, the mesh takes over the references.
+        std::vector<GeometryHandle> geometries;
     };
 
     class ENGINE_API Mesh {
         public:
             Mesh(MeshCreateConfig config);
+            // Releases the mesh's geometry references.
             virtual ~Mesh();
 
+            std::vector<GeometryHandle> handles;
+            // Resolved from handles once, the references keep them alive for the mesh's lifetime.
             std::vector<Geometry*> geometries;
             Transform* transform;
     };
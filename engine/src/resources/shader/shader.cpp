@@ -11,6 +11,7 @@ namespace Engine {
 
     Shader::Shader(ShaderConfig& config) {
         name = config.name;
+        id = INVALID_ID;
         state = ShaderState::CREATED;
         use_instances = config.use_instances;
         use_locals = config.use_local;
@@ -31,6 +32,9 @@ namespace Engine {
         push_constant_size = 0;
         push_constant_count = 0;
         attribute_stride = 0;
+        instance_attribute_stride = 0;
+        supports_instancing = false;
+        bindless = false;
         required_ubo_alignment = 0;
         instance_texture_count = 0;
 
@@ -38,73 +42,116 @@ namespace Engine {
         bound_instance_id = 0;
         bound_ubo_offset = 0;
 
-        // Process uniforms
+        if (!config.layout_computed) {
+            ComputeLayout(config);
+        }
+        uniforms = config.uniforms;
+
+        // Offsets and sizes are precomputed, only runtime objects are created here
         for (u32 i = 0; i < uniforms.size(); ++i) {
             ShaderUniformConfig* uniform = &uniforms[i];
+            uniforms_lookup[uniform->name] = &uniforms[i];
+
+            if (uniform->type == ShaderUniformType::SAMPLER && uniform->scope == ShaderScope::GLOBAL) {
+                ProcessSamplerUniform(uniform);
+            }
+
+            if (uniform->scope == ShaderScope::LOCAL) {
+                if (!use_locals) {
+                    // TODO: обработка нормальная, если не создался
+                    ERROR("Shader::Shader - Error during creation shader '%s'. Cannot add local uniform to shader that doesn't use locals.", config.name.c_str());
+                    continue;
+                }
+
+                push_constant_ranges[push_constant_count] = (MemoryRange){ uniform->offset, uniform->size };
+                push_constant_count++;
+            }
+        }
+
+        global_ubo.size = config.global_ubo_size;
+        ubo.size = config.ubo_size;
+        ubo.offset = global_ubo.size;
+        push_constant_size = config.push_constant_size;
+        instance_texture_count = config.instance_texture_count;
+        attribute_stride = config.attribute_stride;
+        instance_attribute_stride = config.instance_attribute_stride;
+    }
+
+    void Shader::ComputeLayout(ShaderConfig& config) {
+        u64 global_ubo_size = 0;
+        u64 ubo_size = 0;
+        u64 push_constant_size = 0;
+        u8 global_texture_count = 0;
+        u8 instance_texture_count = 0;
+
+        for (u32 i = 0; i < config.uniforms.size(); ++i) {
+            ShaderUniformConfig* uniform = &config.uniforms[i];
             b8 is_sampler = uniform->type == ShaderUniformType::SAMPLER;
             b8 is_global = uniform->scope == ShaderScope::GLOBAL;
 
             uniform->id = i;
-            uniforms_lookup[uniform->name] = &uniforms[i];
 
             if (is_sampler) {
-                ProcessSamplerUniform(uniform, is_global);
+                uniform->offset = 0;
+                uniform->location = is_global ? global_texture_count++ : instance_texture_count++;
             } else {
                 uniform->location = i;
-                uniform->offset = ubo.size;
+                uniform->offset = ubo_size;
             }
-            
+
             if (uniform->scope == ShaderScope::LOCAL) {
-                if (uniform->scope == ShaderScope::LOCAL && !use_locals) {
-                    // TODO: обработка нормальная, если не создался
-                    ERROR("Shader::Shader - Error during creation shader '%s'. Cannot add local uniform to shader that doesn't use locals.", config.name.c_str());
+                if (!config.use_local) {
                     continue;
                 }
-                
+
                 MemoryRange range = GetAlignedMemory(push_constant_size, uniform->size, 4);
                 uniform->offset = range.offset;
                 uniform->size = range.size;
-
-                push_constant_ranges[push_constant_count] = range;
-                push_constant_count++;
-
-                push_constant_size+=uniform->size;
+                push_constant_size += uniform->size;
             }
 
             if (!is_sampler) {
                 if (is_global) {
-                    uniform->offset = global_ubo.size;
-                    global_ubo.size += uniform->size;
+                    uniform->offset = global_ubo_size;
+                    global_ubo_size += uniform->size;
                 } else {
-                    ubo.size += uniform->size;
+                    ubo_size += uniform->size;
                 }
             }
         }
 
-        ubo.offset = global_ubo.size;
-    }
-
-    void Shader::ProcessSamplerUniform(ShaderUniformConfig* uniform, b8 is_global) {
-        uniform->offset = 0;
-        if (is_global) {
-            uniform->location = global_texture_maps.size();
-            global_texture_maps.push_back(
-                (TextureMap){
-                    TextureSystem::GetInstance()->GetDefaultTexture(),
-                        TextureUse::UNKNOWN,
-                        RendererFrontend::GetInstance()->CreateSampler((SamplerCreateInfo){
-                        TextureFilterMode::LINEAR,
-                        TextureFilterMode::LINEAR,
-                        TextureRepeat::REPEAT,
-                        TextureRepeat::REPEAT,
-                        TextureRepeat::REPEAT
-                    })
-                }
-            );
-        } else {
-            uniform->location = instance_texture_count;
-            instance_texture_count++;
+        // Per vertex and per instance attributes come from separate buffers, each packed on its own.
+        u16 attribute_stride = 0;
+        u16 instance_attribute_stride = 0;
+        for (ShaderAttrConfig& attribute : config.attributes) {
+            u16& stride = attribute.per_instance ? instance_attribute_stride : attribute_stride;
+            attribute.offset = stride;
+            stride += attribute.size;
         }
+
+        config.global_ubo_size = global_ubo_size;
+        config.ubo_size = ubo_size;
+        config.push_constant_size = push_constant_size;
+        config.attribute_stride = attribute_stride;
+        config.instance_attribute_stride = instance_attribute_stride;
+        config.instance_texture_count = instance_texture_count;
+        config.layout_computed = true;
+    };
+
+    void Shader::ProcessSamplerUniform(ShaderUniformConfig* uniform) {
+        global_texture_maps.push_back(
+            (TextureMap){
+                TextureSystem::GetInstance()->GetDefaultTexture(),
+                    TextureUse::UNKNOWN,
+                    RendererFrontend::GetInstance()->CreateSampler((SamplerCreateInfo){
+                    TextureFilterMode::LINEAR,
+                    TextureFilterMode::LINEAR,
+                    TextureRepeat::REPEAT,
+                    TextureRepeat::REPEAT,
+                    TextureRepeat::REPEAT
+                })
+            }
+        );
     };
 
     Shader::~Shader() {
@@ -118,7 +165,9 @@ namespace Engine {
     };
 
     ShaderUniformConfig* Shader::GetUniform(std::string name) {
-        return uniforms_lookup[name];
+        // Lookup only, recording threads call this concurrently.
+        auto uniform = uniforms_lookup.find(name);
+        return uniform != uniforms_lookup.end() ? uniform->second : nullptr;
     };
 
     b8 Shader::SetUniformByName(std::string name, const void* value) {
@@ -65,12 +65,19 @@ namespace Engine {
         std::string name;
         std::string file_path;
         ShaderStage stage;
+        // Replaces the stage of the same type in the instanced pipeline variant.
+        b8 instanced = false;
+        // Replaces the stage of the same type when the backend reads textures through a bindless table.
+        b8 bindless = false;
     };
 
     struct ShaderAttrConfig {
         std::string name;
         u8 size;
         ShaderAttributeType type;
+        u16 offset;
+        // Read once per instance from the instance buffer instead of the vertex buffer.
+        b8 per_instance = false;
     };
 
     struct ShaderUniformConfig {
@@ -92,6 +99,15 @@ namespace Engine {
         std::vector<ShaderUniformConfig> uniforms;
         std::string renderpass_name;
         std::vector<ShaderStageConfig> stages;
+
+        // Filled by Shader::ComputeLayout, compiled shader configs ship with it already done.
+        b8 layout_computed = false;
+        u64 global_ubo_size = 0;
+        u64 ubo_size = 0;
+        u64 push_constant_size = 0;
+        u16 attribute_stride = 0;
+        u16 instance_attribute_stride = 0;
+        u8 instance_texture_count = 0;
     };
 
 
@@ -100,27 +116,47 @@ namespace Engine {
             Shader(ShaderConfig& config);
             virtual ~Shader();
 
+            static void ComputeLayout(ShaderConfig& config);
+
             virtual b8 SetUniform(ShaderUniformConfig* uniform, const void* value) = 0;
             b8 SetUniformByName(std::string name, const void* value);
             virtual ShaderUniformConfig* GetUniform(std::string name);
             std::string& GetName() { return name; };
+            u32 GetId() { return id; };
+            void SetId(u32 id) { this->id = id; };
 
             virtual void Use() = 0;
+            // Binds the variant that takes per instance attributes, only valid if SupportsInstancing.
+            virtual void UseInstanced() = 0;
+            b8 SupportsInstancing() { return supports_instancing; };
+            u16 GetInstanceStride() { return instance_attribute_stride; };
+            // Instance data lives in a material buffer, ApplyInstance only selects a record and binds nothing.
+            b8 UsesBindless() { return bindless; };
+
             virtual void BindGlobals() = 0;
             virtual void BindInstance(u32 instance_id) = 0;
 
             virtual void ApplyGlobals() = 0;
             virtual void ApplyInstance(b8 needs_update) = 0;
 
+            // Apply split in two. Update uploads what the bound globals or instance need this frame and
+            // must run on the main thread, Record only binds it into the command buffer of the calling
+            // thread and is safe on recording threads once Update ran.
+            virtual void UpdateGlobals() = 0;
+            virtual void UpdateInstance(b8 needs_update) = 0;
+            virtual void RecordGlobals() = 0;
+            virtual void RecordInstance(u32 instance_id) = 0;
+
             virtual u32 AcquireInstanceResources(std::vector<TextureMap*> texture_maps) = 0;
             virtual void ReleaseInstanceResources(u32 instance_id) = 0;
 
             b8 ready;
             
         protected:
-            void ProcessSamplerUniform(ShaderUniformConfig* uniform, b8 is_global);
+            void ProcessSamplerUniform(ShaderUniformConfig* uniform);
 
             std::string name;
+            u32 id;
             b8 use_instances;
             b8 use_locals;
             
@@ -150,6 +186,9 @@ namespace Engine {
             u64 bound_ubo_offset;
 
             u16 attribute_stride;
+            u16 instance_attribute_stride;
+            b8 supports_instancing;
+            b8 bindless;
 
             ShaderState state;
     };
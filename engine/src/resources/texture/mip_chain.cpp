@@ -0,0 +1,80 @@
+#include "mip_chain.hpp"
+
+#include "platform/platform.hpp"
+
+namespace Engine {
+
+    TextureMipChain::TextureMipChain(const u8* source, u32 width, u32 height, u8 channel_count) {
+        this->channel_count = channel_count;
+
+        u32 level_count = CalculateLevelCount(width, height);
+        levels.resize(level_count);
+
+        u64 total_size = 0;
+        u32 w = width;
+        u32 h = height;
+        for (u32 i = 0; i < level_count; ++i) {
+            levels[i].width = w;
+            levels[i].height = h;
+            levels[i].offset = total_size;
+            levels[i].size = (u64)w * h * channel_count;
+            total_size += levels[i].size;
+            w = w > 1 ? w >> 1 : 1;
+            h = h > 1 ? h >> 1 : 1;
+        }
+
+        pixels.resize(total_size);
+        Platform::CpMemory(pixels.data(), source, levels[0].size);
+
+        // Box filter every level from the previous one, clamping on odd or 1 pixel edges.
+        for (u32 i = 1; i < level_count; ++i) {
+            TextureMipLevel& src = levels[i - 1];
+            TextureMipLevel& dst = levels[i];
+            const u8* src_pixels = pixels.data() + src.offset;
+            u8* dst_pixels = pixels.data() + dst.offset;
+
+            for (u32 y = 0; y < dst.height; ++y) {
+                u32 y0 = y * 2 < src.height ? y * 2 : src.height - 1;
+                u32 y1 = y * 2 + 1 < src.height ? y * 2 + 1 : src.height - 1;
+                for (u32 x = 0; x < dst.width; ++x) {
+                    u32 x0 = x * 2 < src.width ? x * 2 : src.width - 1;
+                    u32 x1 = x * 2 + 1 < src.width ? x * 2 + 1 : src.width - 1;
+                    for (u32 c = 0; c < channel_count; ++c) {
+                        u32 sum = src_pixels[((u64)y0 * src.width + x0) * channel_count + c] +
+                                  src_pixels[((u64)y0 * src.width + x1) * channel_count + c] +
+                                  src_pixels[((u64)y1 * src.width + x0) * channel_count + c] +
+                                  src_pixels[((u64)y1 * src.width + x1) * channel_count + c];
+                        dst_pixels[((u64)y * dst.width + x) * channel_count + c] = (u8)((sum + 2) / 4);
+                    }
+                }
+            }
+        }
+    };
+
+    u64 TextureMipChain::GetSize(u32 base_level) {
+        if (base_level >= levels.size()) {
+            return 0;
+        }
+        return pixels.size() - levels[base_level].offset;
+    };
+
+    u32 TextureMipChain::GetLevelForDimension(u32 max_dimension) {
+        for (u32 i = 0; i < levels.size(); ++i) {
+            if (levels[i].width <= max_dimension && levels[i].height <= max_dimension) {
+                return i;
+            }
+        }
+        return levels.size() ? levels.size() - 1 : 0;
+    };
+
+    u32 TextureMipChain::CalculateLevelCount(u32 width, u32 height) {
+        u32 largest = width > height ? width : height;
+        u32 count = 1;
+        while (largest > 1) {
+            largest >>= 1;
+            count++;
+        }
+        return count;
+    };
+
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "defines.hpp"
+
+namespace Engine {
+
+    struct TextureMipLevel {
+        u32 width;
+        u32 height;
+        u64 offset;
+        u64 size;
+    };
+
+    // CPU side copy of a full mip chain, tightly packed from the most detailed level down to 1x1.
+    class TextureMipChain {
+        public:
+            TextureMipChain() {};
+            TextureMipChain(const u8* pixels, u32 width, u32 height, u8 channel_count);
+
+            u32 GetLevelCount() { return levels.size(); };
+            u8 GetChannelCount() { return channel_count; };
+            TextureMipLevel& GetLevel(u32 level) { return levels[level]; };
+            const u8* GetPixels(u32 level) { return pixels.data() + levels[level].offset; };
+
+            // Size in bytes of levels [base_level, level_count).
+            u64 GetSize(u32 base_level);
+
+            // First level that fits into max_dimension on both axes.
+            u32 GetLevelForDimension(u32 max_dimension);
+
+            static u32 CalculateLevelCount(u32 width, u32 height);
+
+        protected:
+            u8 channel_count;
+            std::vector<TextureMipLevel> levels;
+            std::vector<u8> pixels;
+    };
+
+};
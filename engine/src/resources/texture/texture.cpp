@@ -10,6 +10,9 @@ namespace Engine {
         this->channel_count = info.channel_count;
         this->generation = INVALID_ID;
         this->id = INVALID_ID;
+        this->mip_levels = info.mip_chain ? info.mip_chain->GetLevelCount() : 1;
+        this->resident_mip = info.mip_chain ? info.resident_mip : 0;
+        this->last_used_frame = 0;
     };
 
     Texture::~Texture() {
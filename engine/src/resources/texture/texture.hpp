@@ -6,6 +6,7 @@
 #include "core/logger/logger.hpp"
 #include "sampler.hpp"
 #include "texture_types.hpp"
+#include "mip_chain.hpp"
 
 namespace Engine {
 
@@ -25,6 +26,9 @@ namespace Engine {
         u8 channel_count;
         TextureFlag flags;
         u8* pixels;
+        // Optional full mip chain, only levels starting from resident_mip are uploaded.
+        TextureMipChain* mip_chain = nullptr;
+        u32 resident_mip = 0;
     };
 
     class Texture {
@@ -66,6 +70,18 @@ namespace Engine {
                 WARN("Texture::Resize is not implemented");
             };
 
+            // Replaces resident mips with levels [resident_mip, level_count) of the chain.
+            virtual b8 UploadMips(TextureMipChain& chain, u32 resident_mip) {
+                WARN("Texture::UploadMips is not implemented");
+                return false;
+            };
+
+            u32 GetMipLevels() { return mip_levels; };
+            u32 GetResidentMip() { return resident_mip; };
+
+            u64 GetLastUsedFrame() { return last_used_frame; };
+            void MarkUsed(u64 frame) { last_used_frame = frame; };
+
         protected:
             std::string name;
             u32 id;
@@ -75,6 +91,9 @@ namespace Engine {
             u8 channel_count;
             TextureFlag flags;
             u32 generation;
+            u32 mip_levels;
+            u32 resident_mip;
+            u64 last_used_frame;
     };
 
     struct TextureMap {
@@ -5,24 +5,29 @@
 #include "systems/material/material_system.hpp"
 #include "renderer/renderer.hpp"
 #include "platform/platform.hpp"
+#include "core/utils/hash.hpp"
 
 namespace Engine {
     GeometrySystem* GeometrySystem::instance = nullptr;
 
     GeometrySystem::GeometrySystem() {
+        InactiveCacheConfig inactive_config;
+        inactive_config.max_bytes = GEOMETRY_INACTIVE_CACHE_BUDGET;
+        inactive_config.max_age = GEOMETRY_INACTIVE_CACHE_MAX_AGE;
+        inactive.SetConfig(inactive_config);
+
         CreateDefaultGeometries();
     };
 
     GeometrySystem::~GeometrySystem() {
         DestroyDefaultGeometries();
 
-        for (GeometryReference& geometry_ref : registered_geometries) { 
+        for (GeometryReference& geometry_ref : registered_geometries) {
             delete geometry_ref.geometry;
-            geometry_ref.ref_count = 0;
-            geometry_ref.auto_release = false;
         }
 
-        registered_geometries.clear();
+        registered_geometries.Clear();
+        geometry_keys.clear();
     };
 
     b8 GeometrySystem::Initialize() {
@@ -37,39 +42,74 @@ namespace Engine {
     void GeometrySystem::Shutdown() {
         if (instance) {
             DEBUG("Shutting down GeometrySystem.");
-            return delete instance;
+            delete instance;
+            instance = nullptr;
+            return;
         }
         ERROR("GeometrySystem is not initialized.");
     };
 
-    Geometry* GeometrySystem::AcquireGeometryById(u32 id) {
-        if (registered_geometries.size() < id) {
-            ERROR("GeometrySystem::AcquireGeometryById: Invalid out of bounds ID. Array size: '%u', ID: '%u'.", registered_geometries.size(), id);
+    Geometry* GeometrySystem::AcquireGeometry(GeometryHandle handle) {
+        GeometryReference* geometry_ref = registered_geometries.Get(handle);
+        if (!geometry_ref) {
+            ERROR("GeometrySystem::AcquireGeometry: Invalid or stale handle (index: %u, generation: %u).", handle.index, handle.generation);
             return nullptr;
         }
 
-        return registered_geometries[id].geometry;
+        // Parked geometries leave the inactive cache before they are used again.
+        if (geometry_ref->ref_count == 0) {
+            inactive.Take(handle);
+        }
+        geometry_ref->ref_count++;
+        return geometry_ref->geometry;
     };
 
-    void GeometrySystem::ReleaseGeometry(u32 id) {
-        if (registered_geometries.size() < id) {
-            ERROR("GeometrySystem::ReleaseGeometry: Invalid out of bounds ID. Array size: '%u', ID: '%u'.", registered_geometries.size(), id);
+    Geometry* GeometrySystem::GetGeometry(GeometryHandle handle) {
+        GeometryReference* geometry_ref = registered_geometries.Get(handle);
+        return geometry_ref ? geometry_ref->geometry : nullptr;
+    };
+
+    void GeometrySystem::ReleaseGeometry(GeometryHandle handle) {
+        GeometryReference* geometry_ref = registered_geometries.Get(handle);
+        if (!geometry_ref) {
+            WARN("GeometrySystem::ReleaseGeometry: Geometry with this handle does not exist.");
             return;
         }
 
-        GeometryReference* geometry_ref = &registered_geometries[id];
+        geometry_ref->ref_count--;
 
-        if (!geometry_ref->geometry) {
-            WARN("GeometrySystem::ReleaseGeometry: Geometry with this ID does not exist.");
+        if (geometry_ref->auto_release && geometry_ref->ref_count == 0) {
+            // Same size the reference recorded on creation, so the cache's byte total stays balanced.
+            inactive.Push(handle, geometry_ref->size, Platform::GetAbsoluteTime());
+            TrimInactive();
+        }
+    };
+
+    void GeometrySystem::DestroyGeometry(GeometryHandle handle) {
+        GeometryReference* geometry_ref = registered_geometries.Get(handle);
+        if (!geometry_ref) {
             return;
         }
 
-        geometry_ref->ref_count--;
+        if (geometry_ref->material.IsValid()) {
+            MaterialSystem::GetInstance()->ReleaseMaterial(geometry_ref->material);
+        }
 
-        if (geometry_ref->auto_release && geometry_ref->ref_count == 0) {
-            delete geometry_ref->geometry;
+        delete geometry_ref->geometry;
+        // Colliding geometries are never shared and have no key entry of their own.
+        auto it = geometry_keys.find(geometry_ref->key);
+        if (it != geometry_keys.end() && it->second == handle) {
+            geometry_keys.erase(it);
         }
+        registered_geometries.Remove(handle);
+    };
 
+    void GeometrySystem::TrimInactive() {
+        std::vector<GeometryHandle> evicted;
+        inactive.Collect(Platform::GetAbsoluteTime(), evicted);
+        for (GeometryHandle handle : evicted) {
+            DestroyGeometry(handle);
+        }
     };
 
     void GeometrySystem::CreateDefaultGeometries() {
@@ -120,59 +160,81 @@ namespace Engine {
         delete default_geometry;
     };
 
-    u32 GeometrySystem::GetNewGeometryId() {
-        b8 found = false;
-        for (u32 i = 0; i < registered_geometries.size(); ++i) {
-            if (!registered_geometries[i].geometry) {
-                return i;
+    GeometryHandle GeometrySystem::AcquireGeometryFromConfig(GeometryConfig config, b8 auto_release) {
+        u64 key = HashFNV1a(config.name.data(), config.name.size());
+        key = HashFNV1a(config.vertices, (u64)config.vertex_size * config.vertex_count, key);
+        key = HashFNV1a(config.indices, (u64)config.index_size * config.index_count, key);
+
+        b8 shared = true;
+        auto it = geometry_keys.find(key);
+        if (it != geometry_keys.end()) {
+            GeometryReference* geometry_ref = registered_geometries.Get(it->second);
+            if (geometry_ref->name == config.name &&
+                geometry_ref->vertex_count == config.vertex_count && geometry_ref->vertex_size == config.vertex_size &&
+                geometry_ref->index_count == config.index_count && geometry_ref->index_size == config.index_size) {
+                if (geometry_ref->ref_count == 0) {
+                    inactive.Take(it->second);
+                }
+                geometry_ref->ref_count++;
+                return it->second;
             }
+
+            // The key belongs to another mesh, this one gets a geometry of its own.
+            WARN("GeometrySystem - key collision between '%s' and '%s', not sharing.", config.name.c_str(), geometry_ref->name.c_str());
+            shared = false;
         }
-        if (!found) {
-            return registered_geometries.size();
-        }
-        return INVALID_ID;
-    };
 
-    Geometry* GeometrySystem::AcquireGeometryFromConfig(GeometryConfig config, b8 auto_release) {
+        inactive.RecordMiss();
+
+        // The slot is reserved first so the geometry can carry its index as internal id.
+        GeometryReference reference = {};
+        reference.geometry = nullptr;
+        reference.auto_release = auto_release;
+        reference.ref_count = 1;
+        reference.key = key;
+        reference.name = config.name;
+        reference.vertex_count = config.vertex_count;
+        reference.vertex_size = config.vertex_size;
+        reference.index_count = config.index_count;
+        reference.index_size = config.index_size;
+        reference.size = (u64)config.vertex_size * config.vertex_count + (u64)config.index_size * config.index_count;
+        GeometryHandle handle = registered_geometries.Insert(reference);
+
         GeometryCreateInfo create_info = {};
-        create_info.id = GetNewGeometryId();
+        create_info.id = handle.index;
         create_info.vertices = config.vertices;
         create_info.vertex_count = config.vertex_count;
         create_info.vertex_element_size = config.vertex_size;
         create_info.indices = config.indices;
         create_info.index_count = config.index_count;
         create_info.index_element_size = config.index_size;
-        create_info.material = MaterialSystem::GetInstance()->AcquireMaterial(config.material_name);
+        MaterialHandle material = MaterialSystem::GetInstance()->AcquireMaterialHandle(config.material_name);
+        create_info.material = MaterialSystem::GetInstance()->GetMaterial(material);
 
         if (!create_info.material) {
             WARN("Unable to acquire material '%s' for geometry '%s'. Swapping to default.", config.material_name.c_str(), config.name.c_str());
             create_info.material = MaterialSystem::GetInstance()->GetDefaultMaterial();
         }
 
-        if (create_info.id == INVALID_ID) {
-            ERROR("GeometrySystem::AcquireGeometryFromConfig: Unable to acquire new geometry ID.");
-            return nullptr;
-        }
-
         create_info.name = config.name;
 
         Geometry* g = RendererFrontend::GetInstance()->CreateGeometry(create_info);
         if (!g) {
             ERROR("Error occured during creating geometry '%s'.", config.name.c_str());
+            if (material.IsValid()) {
+                MaterialSystem::GetInstance()->ReleaseMaterial(material);
+            }
+            registered_geometries.Remove(handle);
+            return GeometryHandle();
         }
 
-        if (g->GetInternalId() == registered_geometries.size()) {
-            registered_geometries.push_back((GeometryReference){
-                g, auto_release, 1
-            });
-        } else {
-            u32 id = g->GetInternalId();
-            registered_geometries[id].geometry = g;
-            registered_geometries[id].auto_release = auto_release;
-            registered_geometries[id].ref_count = 1;
+        GeometryReference* geometry_ref = registered_geometries.Get(handle);
+        geometry_ref->geometry = g;
+        geometry_ref->material = material;
+        if (shared) {
+            geometry_keys[key] = handle;
         }
-        
-        return g;
+        return handle;
     };
 
     Geometry* GeometrySystem::GetDefaultGeometry() {
@@ -2,6 +2,13 @@
 
 #include "defines.hpp"
 #include "resources/geometry/geometry.hpp"
+#include "core/utils/slot_map.hpp"
+#include "core/utils/inactive_cache.hpp"
+#include "systems/material/material_system.hpp"
+
+// Released geometries stay uploaded until one of these limits is hit.
+#define GEOMETRY_INACTIVE_CACHE_BUDGET 128 MB
+#define GEOMETRY_INACTIVE_CACHE_MAX_AGE 60.0
 
 namespace Engine {
 
@@ -9,8 +16,21 @@ namespace Engine {
         Geometry* geometry;
         b8 auto_release;
         u32 ref_count;
+        // Hash of name and vertex/index data, identical configs share one geometry.
+        u64 key;
+        // Checked on key hits, a hash collision never aliases two different meshes.
+        std::string name;
+        u32 vertex_count;
+        u32 vertex_size;
+        u32 index_count;
+        u32 index_size;
+        // Vertex and index bytes, what the inactive cache budgets with.
+        u64 size;
+        MaterialHandle material;
     };
 
+    typedef Handle<Geometry> GeometryHandle;
+
     class ENGINE_API GeometrySystem {
         public:
             GeometrySystem();
@@ -20,10 +40,9 @@ namespace Engine {
             static void Shutdown();
             static GeometrySystem* GetInstance() { return instance; };
 
-            Geometry* AcquireGeometryById(u32 id);
-            void ReleaseGeometry(u32 id);
-
-            u32 GetNewGeometryId();
+            Geometry* AcquireGeometry(GeometryHandle handle);
+            Geometry* GetGeometry(GeometryHandle handle);
+            void ReleaseGeometry(GeometryHandle handle);
 
             Geometry* GetDefaultGeometry();
 
@@ -43,12 +62,22 @@ namespace Engine {
 
             void DisposeConfig(GeometryConfig& config);
 
-            Geometry* AcquireGeometryFromConfig(GeometryConfig config, b8 auto_release);
+            // One reference per call, give it back with ReleaseGeometry.
+            GeometryHandle AcquireGeometryFromConfig(GeometryConfig config, b8 auto_release);
+
+            // Zero-ref geometries with auto_release wait here before being destroyed.
+            void TrimInactive();
+            void SetInactiveCacheConfig(InactiveCacheConfig config) { inactive.SetConfig(config); };
+            InactiveCacheStats& GetInactiveCacheStats() { return inactive.GetStats(); };
 
         private:
+            void DestroyGeometry(GeometryHandle handle);
+
             static GeometrySystem* instance;
 
             Geometry* default_geometry;
-            std::vector<GeometryReference> registered_geometries;
+            SlotMap<GeometryReference, Geometry> registered_geometries;
+            std::unordered_map<u64, GeometryHandle> geometry_keys;
+            InactiveCache<Geometry> inactive;
     };
 } 
@@ -9,25 +9,30 @@
 #include "systems/shader/shader_system.hpp"
 
 #include "resources/texture/sampler.hpp"
+#include "platform/platform.hpp"
 
 namespace Engine {
 
     MaterialSystem* MaterialSystem::instance = nullptr;
 
     MaterialSystem::MaterialSystem() {
-       CreateDefaultMaterial();
+        InactiveCacheConfig inactive_config;
+        inactive_config.max_count = MATERIAL_INACTIVE_CACHE_MAX_COUNT;
+        inactive_config.max_age = MATERIAL_INACTIVE_CACHE_MAX_AGE;
+        inactive.SetConfig(inactive_config);
+
+        CreateDefaultMaterial();
     };
 
     MaterialSystem::~MaterialSystem() {
         DestroyDefaultMaterial();
 
-        for (auto& [key, material_ref] : registered_materials) { 
+        for (MaterialReference& material_ref : registered_materials) {
             delete material_ref.material;
-            material_ref.ref_count = 0;
-            material_ref.auto_release = false;
-        } 
+        }
 
-        registered_materials.clear();
+        registered_materials.Clear();
+        material_handles.clear();
     };
 
     void MaterialSystem::CreateDefaultMaterial() {
@@ -103,29 +108,104 @@ namespace Engine {
         ERROR("MaterialSystem is not initialized.");
     };
 
-    Material* MaterialSystem::AcquireMaterial(std::string name, b8 auto_release) {
-        if (registered_materials.count(name)) {
-            registered_materials[name].ref_count++;
-            return registered_materials[name].material;
+    MaterialHandle MaterialSystem::AcquireMaterialHandle(std::string name, b8 auto_release) {
+        auto it = material_handles.find(name);
+        if (it != material_handles.end()) {
+            MaterialReference* material_ref = registered_materials.Get(it->second);
+            if (material_ref->ref_count == 0) {
+                inactive.Take(it->second);
+            }
+            material_ref->ref_count++;
+            return it->second;
         }
 
+        inactive.RecordMiss();
+
         MaterialResource* resource = static_cast<MaterialResource*>(ResourceSystem::GetInstance()->LoadResource(ResourceType::MATERIAL, name));
         if (!resource) {
             ERROR("MaterialSystem::AcquireMaterial falied to load material '%s'", name.c_str());
-            return nullptr;
+            return MaterialHandle();
         }
         MaterialConfig config = resource->GetConfig();
         delete resource;
-        Material* material = LoadMaterial(config);
-        if (material) {
-            registered_materials[name].material = material;
-            registered_materials[name].ref_count = 1;
-            registered_materials[name].auto_release = auto_release;
+        std::vector<TextureHandle> textures;
+        Material* material = LoadMaterial(config, &textures);
+        if (!material) {
+            ReleaseMaterialTextures(textures);
+            return MaterialHandle();
         }
-        return material;
+
+        MaterialHandle handle = registered_materials.Insert((MaterialReference){material, auto_release, 1, name, textures});
+        material_handles[name] = handle;
+        return handle;
+    };
+
+    Material* MaterialSystem::GetMaterial(MaterialHandle handle) {
+        MaterialReference* material_ref = registered_materials.Get(handle);
+        return material_ref ? material_ref->material : nullptr;
     };
 
-    Material* MaterialSystem::LoadMaterial(MaterialConfig& config) {
+    void MaterialSystem::ReleaseMaterial(MaterialHandle handle) {
+        MaterialReference* material_ref = registered_materials.Get(handle);
+        if (!material_ref) {
+            return;
+        }
+
+        material_ref->ref_count--;
+
+        if (material_ref->auto_release && material_ref->ref_count == 0) {
+            inactive.Push(handle, 0, Platform::GetAbsoluteTime());
+            TrimInactive();
+        }
+    };
+
+    void MaterialSystem::DestroyMaterial(MaterialHandle handle) {
+        MaterialReference* material_ref = registered_materials.Get(handle);
+        if (!material_ref) {
+            return;
+        }
+
+        ReleaseMaterialTextures(material_ref->textures);
+
+        delete material_ref->material;
+        material_handles.erase(material_ref->name);
+        registered_materials.Remove(handle);
+    };
+
+    void MaterialSystem::TrimInactive() {
+        std::vector<MaterialHandle> evicted;
+        inactive.Collect(Platform::GetAbsoluteTime(), evicted);
+        for (MaterialHandle handle : evicted) {
+            DestroyMaterial(handle);
+        }
+    };
+
+    Texture* MaterialSystem::AcquireMaterialTexture(const std::string& name, std::vector<TextureHandle>* out_textures) {
+        TextureSystem* ts = TextureSystem::GetInstance();
+        if (name == DEFAULT_TEXTURE_NAME) {
+            return ts->AcquireTexture(name, true);
+        }
+
+        TextureHandle handle = ts->AcquireTextureHandle(name, true);
+        if (handle.IsValid() && out_textures) {
+            out_textures->push_back(handle);
+        }
+        return ts->GetTexture(handle);
+    };
+
+    void MaterialSystem::ReleaseMaterialTextures(std::vector<TextureHandle>& textures) {
+        TextureSystem* ts = TextureSystem::GetInstance();
+        for (TextureHandle texture : textures) {
+            ts->ReleaseTexture(texture);
+        }
+        textures.clear();
+    };
+
+    Material* MaterialSystem::AcquireMaterial(std::string name, b8 auto_release) {
+        return GetMaterial(AcquireMaterialHandle(name, auto_release));
+    };
+
+    Material* MaterialSystem::LoadMaterial(MaterialConfig& config, std::vector<TextureHandle>* out_textures) {
         MaterialCreateInfo mat_create_info = {};
         mat_create_info.shader = ShaderSystem::GetInstance()->GetShader(config.shader_name);
         mat_create_info.name = config.name;
@@ -144,7 +224,7 @@ namespace Engine {
             if (config.specular_map_name == "default") {
                 diffuse = ts->GetDefaultDiffuse();
             } else {
-                diffuse = ts->AcquireTexture(config.diffuse_map_name, true);
+                diffuse = AcquireMaterialTexture(config.diffuse_map_name, out_textures);
             }
             if (!diffuse) {
                 WARN("Unable to load texture '%s' for material '%s', using default.", config.diffuse_map_name.c_str(), mat_create_info.name.c_str());
@@ -171,7 +251,7 @@ namespace Engine {
             if (config.specular_map_name == "default") {
                 specular = ts->GetDefaultSpecular();
             } else {
-                specular = ts->AcquireTexture(config.specular_map_name, true);
+                specular = AcquireMaterialTexture(config.specular_map_name, out_textures);
             }
             if (!specular) {
                 WARN("Unable to load texture '%s' for material '%s', using default.", config.specular_map_name.c_str(), mat_create_info.name.c_str());
@@ -197,7 +277,7 @@ namespace Engine {
             if (config.normal_map_name == "default") {
                 normal = ts->GetDefaultNormal();
             } else {
-                normal = ts->AcquireTexture(config.normal_map_name, true);
+                normal = AcquireMaterialTexture(config.normal_map_name, out_textures);
             }
             if (!normal) {
                 WARN("Unable to load texture '%s' for material '%s', using default.", config.normal_map_name.c_str(), mat_create_info.name.c_str());
@@ -226,34 +306,34 @@ namespace Engine {
             return default_material;
         }
 
-        if (registered_materials.count(config.name)) {
-            return registered_materials[config.name].material;
-        } else {
-            registered_materials[config.name].material = LoadMaterial(config);
-
-            if (!registered_materials[config.name].material) {
-                ERROR("Failed to load texture '%s'.", config.name.c_str());
-                return nullptr;
+        auto it = material_handles.find(config.name);
+        if (it != material_handles.end()) {
+            MaterialReference* material_ref = registered_materials.Get(it->second);
+            if (material_ref->ref_count == 0) {
+                inactive.Take(it->second);
             }
+            material_ref->ref_count++;
+            return material_ref->material;
+        }
 
-            registered_materials[config.name].auto_release = auto_release;
-            registered_materials[config.name].ref_count = 1;
+        inactive.RecordMiss();
 
-            return registered_materials[config.name].material;
-        }   
+        std::vector<TextureHandle> textures;
+        Material* material = LoadMaterial(config, &textures);
+        if (!material) {
+            ERROR("Failed to load material '%s'.", config.name.c_str());
+            ReleaseMaterialTextures(textures);
+            return nullptr;
+        }
 
-        return nullptr;
+        material_handles[config.name] = registered_materials.Insert((MaterialReference){material, auto_release, 1, config.name, textures});
+        return material;
     };
 
     void MaterialSystem::ReleaseMaterial(std::string name) {
-        if (registered_materials.count(name)) {
-            MaterialReference* material_ref = &registered_materials[name];
-
-            material_ref->ref_count--;
-
-            if (material_ref->auto_release && material_ref->ref_count == 0) {
-                delete material_ref->material;
-            }
+        auto it = material_handles.find(name);
+        if (it != material_handles.end()) {
+            ReleaseMaterial(it->second);
         }
     };
 
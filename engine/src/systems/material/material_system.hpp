@@ -4,6 +4,13 @@
 
 #include "resources/material/material.hpp"
 #include "systems/resource/resources/material/material_resource.hpp"
+#include "core/utils/slot_map.hpp"
+#include "core/utils/inactive_cache.hpp"
+#include "systems/texture/texture_system.hpp"
+
+// Released materials stay loaded until one of these limits is hit.
+#define MATERIAL_INACTIVE_CACHE_MAX_COUNT 128
+#define MATERIAL_INACTIVE_CACHE_MAX_AGE 60.0
 
 namespace Engine {
 
@@ -11,8 +18,13 @@ namespace Engine {
         Material* material;
         b8 auto_release;
         u32 ref_count;
+        std::string name;
+        // Released together with the material.
+        std::vector<TextureHandle> textures;
     };
 
+    typedef Handle<Material> MaterialHandle;
+
     class ENGINE_API MaterialSystem {
         public:
             MaterialSystem();
@@ -22,10 +34,14 @@ namespace Engine {
             static void Shutdown();
             static MaterialSystem* GetInstance() { return instance; };
 
+            MaterialHandle AcquireMaterialHandle(std::string name, b8 auto_release = true);
+            Material* GetMaterial(MaterialHandle handle);
+            void ReleaseMaterial(MaterialHandle handle);
+
             Material* AcquireMaterial(std::string name, b8 auto_release = true);
             void ReleaseMaterial(std::string name);
 
-            Material* LoadMaterial(MaterialConfig& config);
+            Material* LoadMaterial(MaterialConfig& config, std::vector<TextureHandle>* out_textures = nullptr);
             Material* GetDefaultMaterial() {return default_material; };
 
 
@@ -34,11 +50,22 @@ namespace Engine {
 
             Material* AcquireMaterialFromConfig(MaterialConfig& config, b8 auto_release = true);
 
+            // Zero-ref materials with auto_release wait here before being destroyed.
+            void TrimInactive();
+            void SetInactiveCacheConfig(InactiveCacheConfig config) { inactive.SetConfig(config); };
+            InactiveCacheStats& GetInactiveCacheStats() { return inactive.GetStats(); };
+
         private:
+            Texture* AcquireMaterialTexture(const std::string& name, std::vector<TextureHandle>* out_textures);
+            void ReleaseMaterialTextures(std::vector<TextureHandle>& textures);
+            void DestroyMaterial(MaterialHandle handle);
+
             static MaterialSystem* instance;
 
             Material* default_material;
-            std::unordered_map<std::string, MaterialReference> registered_materials;
+            SlotMap<MaterialReference, Material> registered_materials;
+            std::unordered_map<std::string, MaterialHandle> material_handles;
+            InactiveCache<Material> inactive;
     };
 
 };
\ No newline at end of file
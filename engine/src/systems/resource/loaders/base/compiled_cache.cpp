@@ -0,0 +1,86 @@
+#include "compiled_cache.hpp"
+
+#include "core/logger/logger.hpp"
+#include "platform/filesystem.hpp"
+#include "platform/platform.hpp"
+#include "core/utils/hash.hpp"
+#include "systems/resource/resource_system.hpp"
+
+namespace Engine {
+
+    b8 CompiledCache::Load(const std::string& source_path, const std::string& compiled_path, u32 magic, u16 version, std::vector<c8>& out_payload) {
+        VirtualFileSystem* vfs = ResourceSystem::GetInstance()->GetFileSystem();
+        if (!vfs->Exists(compiled_path)) {
+            return false;
+        }
+
+        // Compiled files may ship inside a pack next to their sources.
+        std::vector<c8> compiled;
+        if (!vfs->ReadAll(compiled_path, compiled) || compiled.size() < sizeof(CompiledCacheHeader)) {
+            return false;
+        }
+
+        CompiledCacheHeader header;
+        Platform::CpMemory(&header, compiled.data(), sizeof(CompiledCacheHeader));
+        if (header.magic != magic || header.version != version || sizeof(CompiledCacheHeader) + header.payload_size != compiled.size()) {
+            return false;
+        }
+
+        u64 mtime = 0;
+        u64 size = 0;
+        b8 has_stamp = vfs->GetFileStamp(source_path, &mtime, &size);
+        b8 fresh = has_stamp && header.source_mtime == mtime && header.source_size == size;
+
+        std::vector<c8> payload(compiled.begin() + sizeof(CompiledCacheHeader), compiled.end());
+
+        if (!fresh) {
+            // Touched or packed sources still hit if the content is unchanged.
+            std::vector<c8> source;
+            if (!vfs->ReadAll(source_path, source)) {
+                return false;
+            }
+            if (source.size() != header.source_size || Hash(source.data(), source.size()) != header.source_hash) {
+                return false;
+            }
+            if (has_stamp) {
+                Store(source_path, compiled_path, magic, version, source, payload);
+            }
+        }
+
+        out_payload = std::move(payload);
+        return true;
+    };
+
+    b8 CompiledCache::Store(const std::string& source_path, const std::string& compiled_path, u32 magic, u16 version, const std::vector<c8>& source_data, std::vector<c8>& payload) {
+        CompiledCacheHeader header;
+        Platform::ZrMemory(&header, sizeof(CompiledCacheHeader));
+        header.magic = magic;
+        header.version = version;
+        header.source_size = source_data.size();
+        header.source_hash = Hash(source_data.data(), source_data.size());
+        header.payload_size = payload.size();
+
+        u64 size = 0;
+        ResourceSystem::GetInstance()->GetFileSystem()->GetFileStamp(source_path, &header.source_mtime, &size);
+
+        File* file = FileSystem::FileOpen(compiled_path, FileMode::WRITE, true);
+        if (!file->IsReady()) {
+            DEBUG("CompiledCache::Store - unable to write '%s'.", compiled_path.c_str());
+            FileSystem::FileClose(file);
+            return false;
+        }
+
+        file->Write(sizeof(CompiledCacheHeader), &header);
+        if (payload.size()) {
+            file->Write(payload.size(), payload.data());
+        }
+        FileSystem::FileClose(file);
+
+        return true;
+    };
+
+    u64 CompiledCache::Hash(const c8* data, u64 size) {
+        return HashFNV1a(data, size);
+    };
+
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "defines.hpp"
+
+namespace Engine {
+
+    struct CompiledCacheHeader {
+        u32 magic;
+        u16 version;
+        u16 reserved;
+        u64 source_mtime;
+        u64 source_size;
+        u64 source_hash;
+        u64 payload_size;
+    };
+
+    // Binary forms of text assets, stored next to the source like e3dm meshes.
+    // An entry is fresh when the source mtime and size match, or failing that its content hash.
+    class CompiledCache {
+        public:
+            static b8 Load(const std::string& source_path, const std::string& compiled_path, u32 magic, u16 version, std::vector<c8>& out_payload);
+            static b8 Store(const std::string& source_path, const std::string& compiled_path, u32 magic, u16 version, const std::vector<c8>& source_data, std::vector<c8>& payload);
+
+            static u64 Hash(const c8* data, u64 size);
+    };
+
+};
@@ -6,6 +6,7 @@
 #include "vendor/stb_image/stb_image.h"
 
 #include "systems/resource/resources/image/image_resource.hpp"
+#include "systems/resource/resource_system.hpp"
 
 namespace Engine {
     ImageLoader::ImageLoader(u32 id, std::string type_path, std::string custom_type) : ResourceLoader(id, ResourceType::IMAGE, type_path, custom_type) {};
@@ -14,13 +15,15 @@ namespace Engine {
     Resource* ImageLoader::Load(std::string name) {
         stbi_set_flip_vertically_on_load(true);
 
+        VirtualFileSystem* vfs = ResourceSystem::GetInstance()->GetFileSystem();
+
         #define IMAGE_EXTENSION_COUNT 4
         b8 found = false;
         std::string file_path;
         std::string extensions[IMAGE_EXTENSION_COUNT] = {".tga", ".png", ".jpg", ".bmp"};
         for (u32 i = 0; i < IMAGE_EXTENSION_COUNT; ++i) {
             file_path = StringFormat("%s/%s%s", type_path.c_str(), name.c_str(), extensions[i].c_str());
-            if (FileSystem::FileExists(file_path)) {
+            if (vfs->Exists(file_path)) {
                 found = true;
                 break;
             }
@@ -37,8 +40,14 @@ namespace Engine {
         i32 height;
         i32 channel_count;
 
-        u8* data = stbi_load(
-            file_path.c_str(),
+        std::vector<c8> bytes;
+        if (!vfs->ReadAll(file_path, bytes)) {
+            ERROR("ImageLoader::Load - unable to read '%s'", file_path.c_str());
+            return nullptr;
+        }
+
+        u8* data = stbi_load_from_memory(
+            (const stbi_uc*)bytes.data(), bytes.size(),
             &width, &height,
             &channel_count,
             required_channel_count);
@@ -2,6 +2,8 @@
 
 #include "core/logger/logger.hpp"
 #include "platform/filesystem.hpp"
+#include "systems/resource/resource_system.hpp"
+#include "systems/resource/loaders/base/compiled_cache.hpp"
 
 #include "systems/resource/resources/material/material_resource.hpp"
 
@@ -11,17 +13,36 @@ namespace Engine {
 
     Resource* MaterialLoader::Load(std::string name) {
         std::string file_path = StringFormat("%s/%s.%s", type_path.c_str(), name.c_str(), "mat");
-        tinyxml2::XMLDocument* file = FileSystem::OpenXml(file_path);
+        std::string compiled_path = StringFormat("%s/%s.%s", type_path.c_str(), name.c_str(), "matc");
+
+        MaterialConfig data;
+        std::vector<c8> compiled;
+        if (CompiledCache::Load(file_path, compiled_path, MATERIAL_COMPILED_MAGIC, MATERIAL_COMPILED_VERSION, compiled)) {
+            BinaryReader reader(compiled.data(), compiled.size());
+            if (ReadCompiled(reader, data)) {
+                return new MaterialResource(id, name, file_path, data);
+            }
+            WARN("MaterialLoader::Load - compiled material '%s' is corrupted, rebuilding.", compiled_path.c_str());
+        }
+
+        std::vector<c8> source;
+        if (!ResourceSystem::GetInstance()->GetFileSystem()->ReadAll(file_path, source)) {
+            ERROR("MaterialLoader::Load - unable to read '%s'.", file_path.c_str());
+            return nullptr;
+        }
+
+        tinyxml2::XMLDocument* file = new tinyxml2::XMLDocument();
+        file->Parse(source.data(), source.size());
 
         // TODO: Use of versions
         // tinyxml2::XMLElement* version = file->FirstChildElement("Version");
         tinyxml2::XMLElement* material = file->FirstChildElement("Material");
         if (!material) {
             ERROR("MaterialLoader::Load - error opening file '%s'.", name.c_str());
+            FileSystem::CloseXml(file);
             return nullptr;
         }
 
-        MaterialConfig data;
         std::string diffuse_color = material->Attribute("diffuse_color");
         if (!Parse(diffuse_color, &data.diffuse_color)) {
             ERROR("Error occured when parsing parameter 'diffuse_color' in material file '%s'.", diffuse_color.c_str(), file_path.c_str());
@@ -59,7 +80,32 @@ namespace Engine {
 
         FileSystem::CloseXml(file);
 
+        BinaryWriter writer;
+        WriteCompiled(writer, data);
+        CompiledCache::Store(file_path, compiled_path, MATERIAL_COMPILED_MAGIC, MATERIAL_COMPILED_VERSION, source, writer.GetData());
+
         return new MaterialResource(id, name, file_path, data);
     };
 
+    void MaterialLoader::WriteCompiled(BinaryWriter& writer, MaterialConfig& config) {
+        writer.WriteString(config.name);
+        writer.WriteString(config.shader_name);
+        writer.Write(config.diffuse_color);
+        writer.WriteString(config.diffuse_map_name);
+        writer.WriteString(config.specular_map_name);
+        writer.WriteString(config.normal_map_name);
+        writer.Write(config.shininess);
+    };
+
+    b8 MaterialLoader::ReadCompiled(BinaryReader& reader, MaterialConfig& config) {
+        reader.ReadString(config.name);
+        reader.ReadString(config.shader_name);
+        reader.Read(config.diffuse_color);
+        reader.ReadString(config.diffuse_map_name);
+        reader.ReadString(config.specular_map_name);
+        reader.ReadString(config.normal_map_name);
+        reader.Read(config.shininess);
+        return !reader.Failed();
+    };
+
 }
@@ -1,15 +1,24 @@
 #pragma once
 
 #include "systems/resource/loaders/base/resource_loader.hpp"
+#include "systems/resource/resources/material/material_resource.hpp"
+#include "core/utils/binary_stream.hpp"
 
 namespace Engine {
 
+    #define MATERIAL_COMPILED_MAGIC 0x54414D45U
+    #define MATERIAL_COMPILED_VERSION 1
+
     class MaterialLoader : public ResourceLoader {
         public:
             MaterialLoader(u32 id, std::string type_path, std::string custom_type);
             MaterialLoader(u32 id, std::string type_path);
 
             Resource* Load(std::string name);
+
+        protected:
+            static void WriteCompiled(BinaryWriter& writer, MaterialConfig& config);
+            static b8 ReadCompiled(BinaryReader& reader, MaterialConfig& config);
     };
 
 } 
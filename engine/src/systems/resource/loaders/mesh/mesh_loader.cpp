@@ -5,6 +5,7 @@
 #include "platform/platform.hpp"
 #include "vendor/tinyobj/tinyobj.hpp"
 #include "systems/resource/resources/mesh/mesh_resource.hpp"
+#include "systems/resource/resource_system.hpp"
 
 namespace Engine {
 
@@ -27,9 +28,13 @@ namespace Engine {
 
         MeshResource* resource = nullptr;
 
+        VirtualFileSystem* vfs = ResourceSystem::GetInstance()->GetFileSystem();
+
         for (u32 i = 0; i < mesh_file_types.size(); ++i) {
             file_path = StringFormat(format, type_path.c_str(), name.c_str(), mesh_file_types[i].ext.c_str());
-            if (FileSystem::FileExists(file_path)) {
+            // tinyobj reads obj and mtl files by path, so those only come from loose files.
+            b8 exists = mesh_file_types[i].type == MeshFileType::OBJ ? FileSystem::FileExists(file_path) : vfs->Exists(file_path);
+            if (exists) {
                 switch (mesh_file_types[i].type) {
                     case MeshFileType::E3DM: {
                         resource = LoadE3DM(file_path, name);
@@ -126,74 +131,94 @@ namespace Engine {
     };
 
     MeshResource* MeshLoader::LoadE3DM(const std::string& file_path, const std::string& name) {
-        File* file = FileSystem::FileOpen(file_path, FileMode::READ, true);
-        if (!file) {
+        std::vector<c8> bytes;
+        if (!ResourceSystem::GetInstance()->GetFileSystem()->ReadAll(file_path, bytes)) {
             ERROR("MeshLoader::LoadE3DM: Unable to open file '%s' in read mode.", file_path.c_str());
             return nullptr;  
         }
 
+        u64 cursor = 0;
+        b8 truncated = false;
+        auto read_bytes = [&](u64 size, void* data) {
+            if (cursor + size > bytes.size()) {
+                truncated = true;
+                Platform::ZrMemory(data, size);
+                return;
+            }
+            Platform::CpMemory(data, bytes.data() + cursor, size);
+            cursor += size;
+        };
+
         // Version
         u16 version = 0;
-        file->ReadBytes(sizeof(u16), &version);
+        read_bytes(sizeof(u16), &version);
 
         // Name
         u32 name_length = 0;
-        file->ReadBytes(sizeof(u32), &name_length);
+        read_bytes(sizeof(u32), &name_length);
 
         std::string file_name;
         file_name.resize(name_length);
-        file->ReadBytes(sizeof(char) * name_length, (void*)file_name.c_str());
+        read_bytes(sizeof(char) * name_length, (void*)file_name.c_str());
 
         // Configs
         u64 configs_count = 0;
-        file->ReadBytes(sizeof(u64), &configs_count);
+        read_bytes(sizeof(u64), &configs_count);
 
         GeometryConfigs configs;
-        configs.reserve(configs_count);
 
-        for (u32 i = 0; i < configs_count; ++i) {
+        for (u32 i = 0; i < configs_count && !truncated; ++i) {
 
             GeometryConfig config;
 
             // Vertex count
-            file->ReadBytes(sizeof(u32), &config.vertex_count);
+            read_bytes(sizeof(u32), &config.vertex_count);
 
             // Vertex size
-            file->ReadBytes(sizeof(u32), &config.vertex_size);
+            read_bytes(sizeof(u32), &config.vertex_size);
 
             // Vertices
             u32 vert_array_size = config.vertex_count * config.vertex_size;
             config.vertices = Platform::AllocMemory(vert_array_size);
-            file->ReadBytes(vert_array_size, config.vertices);
+            read_bytes(vert_array_size, config.vertices);
 
             // Index count
-            file->ReadBytes(sizeof(u32), &config.index_count);
+            read_bytes(sizeof(u32), &config.index_count);
 
             // Index size
-            file->ReadBytes(sizeof(u32), &config.index_size);
+            read_bytes(sizeof(u32), &config.index_size);
 
             // Indices
             u32 idx_array_size = config.index_count * config.index_size;
             config.indices = Platform::AllocMemory(idx_array_size);
-            file->ReadBytes(idx_array_size, config.indices);
+            read_bytes(idx_array_size, config.indices);
 
             // Config name
             u32 config_name_size = 0;
-            file->ReadBytes(sizeof(u32), &config_name_size);
+            read_bytes(sizeof(u32), &config_name_size);
 
             config.name.resize(config_name_size);
-            file->ReadBytes(sizeof(char) * config_name_size, (void*)config.name.c_str());
+            read_bytes(sizeof(char) * config_name_size, (void*)config.name.c_str());
 
             // Config material name
             u32 config_material_name_size = 0;
-            file->ReadBytes(sizeof(u32), &config_material_name_size);
+            read_bytes(sizeof(u32), &config_material_name_size);
 
             config.material_name.resize(config_material_name_size);
-            file->ReadBytes(sizeof(char) * config_material_name_size, (void*)config.material_name.c_str());
+            read_bytes(sizeof(char) * config_material_name_size, (void*)config.material_name.c_str());
 
             configs.push_back(config);
         }
 
+        if (truncated) {
+            ERROR("MeshLoader::LoadE3DM: File '%s' is truncated.", file_path.c_str());
+            for (GeometryConfig& config : configs) {
+                Platform::FrMemory(config.vertices);
+                Platform::FrMemory(config.indices);
+            }
+            return nullptr;
+        }
+
         return new MeshResource(id, name, file_path, configs);
     };
 
@@ -2,6 +2,8 @@
 
 #include "core/logger/logger.hpp"
 #include "platform/filesystem.hpp"
+#include "systems/resource/resource_system.hpp"
+#include "systems/resource/loaders/base/compiled_cache.hpp"
 #include "core/utils/string.hpp"
 #include "systems/resource/resources/shader/shader_resource.hpp"
 
@@ -17,18 +19,38 @@ namespace Engine {
 
     Resource* ShaderLoader::Load(std::string name) {
         std::string file_path = StringFormat("%s/%s.shdc", type_path.c_str(), name.c_str());
+        std::string compiled_path = StringFormat("%s/%s.shdcb", type_path.c_str(), name.c_str());
         DEBUG("Loading shader '%s' from '%s'.", name.c_str(), file_path.c_str());
-        tinyxml2::XMLDocument* file = FileSystem::OpenXml(file_path);
+
+        ShaderConfig data = {};
+        std::vector<c8> compiled;
+        if (CompiledCache::Load(file_path, compiled_path, SHADER_COMPILED_MAGIC, SHADER_COMPILED_VERSION, compiled)) {
+            BinaryReader reader(compiled.data(), compiled.size());
+            if (ReadCompiled(reader, data)) {
+                return new ShaderResource(id, name, file_path, data);
+            }
+            WARN("ShaderLoader::Load - compiled shader '%s' is corrupted, rebuilding.", compiled_path.c_str());
+            data = {};
+        }
+
+        std::vector<c8> source;
+        if (!ResourceSystem::GetInstance()->GetFileSystem()->ReadAll(file_path, source)) {
+            ERROR("ShaderLoader::Load - unable to read '%s'.", file_path.c_str());
+            return nullptr;
+        }
+
+        tinyxml2::XMLDocument* file = new tinyxml2::XMLDocument();
+        file->Parse(source.data(), source.size());
 
         // TODO: Use of versions
         // tinyxml2::XMLElement* version = file->FirstChildElement("Version");
         tinyxml2::XMLElement* shader = file->FirstChildElement("Shader");
         if (!shader) {
             ERROR("ShaderLoader::Load - error opening file '%s'.", name.c_str());
+            FileSystem::CloseXml(file);
             return nullptr;
         }
 
-        ShaderConfig data = {};
         std::string buffer;
         data.name = shader->Attribute("name");
         data.renderpass_name = shader->Attribute("renderpass");
@@ -56,6 +78,10 @@ namespace Engine {
                     shader_stage_config.stage = ShaderStage::COMPUTE;
                 }
 
+                const c8* variant = shader_stage->Attribute("variant");
+                shader_stage_config.instanced = variant && std::string(variant) == "instanced";
+                shader_stage_config.bindless = variant && std::string(variant) == "bindless";
+
                 if (!(u32)shader_stage_config.stage) {
                     ERROR("ShaderLoader::Load - '%s' - unknown shader stage type.", stage_type.c_str());
                 } else {
@@ -111,6 +137,9 @@ namespace Engine {
                     attr_config.size = sizeof(f32);
                 }
                 
+                const c8* rate = shader_attribute->Attribute("rate");
+                attr_config.per_instance = rate && std::string(rate) == "instance";
+
                 data.attributes.push_back(attr_config);
 
                 shader_attribute = shader_attribute->NextSiblingElement();
@@ -204,7 +233,110 @@ namespace Engine {
 
         FileSystem::CloseXml(file);
 
+        Shader::ComputeLayout(data);
+
+        BinaryWriter writer;
+        WriteCompiled(writer, data);
+        CompiledCache::Store(file_path, compiled_path, SHADER_COMPILED_MAGIC, SHADER_COMPILED_VERSION, source, writer.GetData());
+
         return new ShaderResource(id, name, file_path, data);
     };
 
+    void ShaderLoader::WriteCompiled(BinaryWriter& writer, ShaderConfig& config) {
+        writer.WriteString(config.name);
+        writer.WriteString(config.renderpass_name);
+        writer.Write(config.use_instances);
+        writer.Write(config.use_local);
+        writer.Write(config.ubo_stride);
+
+        writer.Write<u32>(config.stages.size());
+        for (ShaderStageConfig& stage : config.stages) {
+            writer.WriteString(stage.name);
+            writer.WriteString(stage.file_path);
+            writer.Write(stage.stage);
+            writer.Write(stage.instanced);
+            writer.Write(stage.bindless);
+        }
+
+        writer.Write<u32>(config.attributes.size());
+        for (ShaderAttrConfig& attribute : config.attributes) {
+            writer.WriteString(attribute.name);
+            writer.Write(attribute.size);
+            writer.Write(attribute.type);
+            writer.Write(attribute.offset);
+            writer.Write(attribute.per_instance);
+        }
+
+        writer.Write<u32>(config.uniforms.size());
+        for (ShaderUniformConfig& uniform : config.uniforms) {
+            writer.WriteString(uniform.name);
+            writer.Write(uniform.id);
+            writer.Write(uniform.location);
+            writer.Write(uniform.size);
+            writer.Write(uniform.offset);
+            writer.Write(uniform.type);
+            writer.Write(uniform.scope);
+        }
+
+        writer.Write(config.global_ubo_size);
+        writer.Write(config.ubo_size);
+        writer.Write(config.push_constant_size);
+        writer.Write(config.attribute_stride);
+        writer.Write(config.instance_attribute_stride);
+        writer.Write(config.instance_texture_count);
+    };
+
+    b8 ShaderLoader::ReadCompiled(BinaryReader& reader, ShaderConfig& config) {
+        reader.ReadString(config.name);
+        reader.ReadString(config.renderpass_name);
+        reader.Read(config.use_instances);
+        reader.Read(config.use_local);
+        reader.Read(config.ubo_stride);
+
+        u32 count = 0;
+        reader.Read(count);
+        config.stages.resize(reader.Failed() ? 0 : count);
+        for (ShaderStageConfig& stage : config.stages) {
+            reader.ReadString(stage.name);
+            reader.ReadString(stage.file_path);
+            reader.Read(stage.stage);
+            reader.Read(stage.instanced);
+            reader.Read(stage.bindless);
+        }
+
+        count = 0;
+        reader.Read(count);
+        config.attributes.resize(reader.Failed() ? 0 : count);
+        for (ShaderAttrConfig& attribute : config.attributes) {
+            reader.ReadString(attribute.name);
+            reader.Read(attribute.size);
+            reader.Read(attribute.type);
+            reader.Read(attribute.offset);
+            reader.Read(attribute.per_instance);
+        }
+
+        count = 0;
+        reader.Read(count);
+        config.uniforms.resize(reader.Failed() ? 0 : count);
+        for (ShaderUniformConfig& uniform : config.uniforms) {
+            reader.ReadString(uniform.name);
+            reader.Read(uniform.id);
+            reader.Read(uniform.location);
+            reader.Read(uniform.size);
+            reader.Read(uniform.offset);
+            reader.Read(uniform.type);
+            reader.Read(uniform.scope);
+        }
+
+        reader.Read(config.global_ubo_size);
+        reader.Read(config.ubo_size);
+        reader.Read(config.push_constant_size);
+        reader.Read(config.attribute_stride);
+        reader.Read(config.instance_attribute_stride);
+        reader.Read(config.instance_texture_count);
+
+        config.layout_computed = !reader.Failed();
+        return config.layout_computed;
+    };
+
 };
\ No newline at end of file
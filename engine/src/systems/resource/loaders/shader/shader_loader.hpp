@@ -1,15 +1,24 @@
 #pragma once
 
 #include "systems/resource/loaders/base/resource_loader.hpp"
+#include "resources/shader/shader.hpp"
+#include "core/utils/binary_stream.hpp"
 
 namespace Engine {
 
+    #define SHADER_COMPILED_MAGIC 0x44485345U
+    #define SHADER_COMPILED_VERSION 3
+
     class ShaderLoader : public ResourceLoader {
         public:
             ShaderLoader(u32 id, std::string type_path, std::string custom_type);
             ShaderLoader(u32 id, std::string type_path);
 
             Resource* Load(std::string name);
+
+        protected:
+            static void WriteCompiled(BinaryWriter& writer, ShaderConfig& config);
+            static b8 ReadCompiled(BinaryReader& reader, ShaderConfig& config);
     };
 
 } 
@@ -32,6 +32,12 @@ namespace Engine {
     ResourceSystem::ResourceSystem(std::string base_path) {
         this->base_path = base_path;
 
+        // Packed assets live next to the loose asset directory, e.g. '../assets.epak'.
+        vfs = new VirtualFileSystem(base_path);
+        if (!vfs->MountPack(StringFormat("%s%s", base_path.c_str(), ASSET_PACK_EXTENSION))) {
+            DEBUG("ResourceSystem - no asset pack found, using loose files from '%s'.", base_path.c_str());
+        }
+
         // Image loader
         RegisterLoader(ResourceType::IMAGE, new ImageLoader(registered_loaders.size(), CreateLoaderPath("/textures")));
 
@@ -55,6 +61,7 @@ namespace Engine {
         for (auto [key, loader] : registered_custom_loaders) {
             delete loader;
         }
+        delete vfs;
     };
 
     void ResourceSystem::RegisterLoader(ResourceType type, ResourceLoader* loader) {
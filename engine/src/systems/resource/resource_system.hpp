@@ -3,6 +3,7 @@
 #include "defines.hpp"
 
 #include "loaders/base/resource_loader.hpp"
+#include "vfs/virtual_file_system.hpp"
 
 #include "systems/resource/resources/base/resource.hpp"
 #include "systems/resource/resources/image/image_resource.hpp"
@@ -41,11 +42,14 @@ namespace Engine {
 
             std::string GetLoaderTypeName(ResourceType type);
 
+            VirtualFileSystem* GetFileSystem() { return vfs; };
+
         protected:
             static ResourceSystem* instance;
             std::unordered_map<ResourceType, ResourceLoader*> registered_loaders; 
             std::unordered_map<std::string, ResourceLoader*> registered_custom_loaders;
             std::string base_path;
+            VirtualFileSystem* vfs;
 
     };
 
@@ -0,0 +1,122 @@
+#include "asset_pack.hpp"
+
+#include "core/logger/logger.hpp"
+#include "core/utils/hash.hpp"
+#include "core/utils/lz4.hpp"
+#include "platform/platform.hpp"
+
+namespace Engine {
+
+    AssetPack::AssetPack(std::string path) {
+        this->path = path;
+        ready = false;
+        memory = nullptr;
+        map_handle = nullptr;
+        size = 0;
+        header = nullptr;
+        entries = nullptr;
+        names = nullptr;
+
+        memory = Platform::MapFile(path, &size, &map_handle);
+        if (!memory) {
+            return;
+        }
+
+        if (size < sizeof(AssetPackHeader)) {
+            ERROR("AssetPack::AssetPack - '%s' is too small to be a pack.", path.c_str());
+            return;
+        }
+
+        header = (const AssetPackHeader*)memory;
+        if (header->magic != ASSET_PACK_MAGIC || header->version != ASSET_PACK_VERSION) {
+            ERROR("AssetPack::AssetPack - '%s' has invalid magic or unsupported version %u.", path.c_str(), header->version);
+            return;
+        }
+
+        if (header->toc_offset > size || (u64)header->entry_count * sizeof(AssetPackEntry) > size - header->toc_offset ||
+            header->names_offset > size || header->names_size > size - header->names_offset) {
+            ERROR("AssetPack::AssetPack - '%s' is truncated.", path.c_str());
+            return;
+        }
+
+        entries = (const AssetPackEntry*)((const u8*)memory + header->toc_offset);
+        names = (const c8*)memory + header->names_offset;
+
+        // Checked once here, Find and Read trust the table afterwards.
+        for (u32 i = 0; i < header->entry_count; ++i) {
+            const AssetPackEntry& entry = entries[i];
+            if ((u64)entry.name_offset + entry.name_length > header->names_size ||
+                entry.offset > size || entry.stored_size > size - entry.offset) {
+                ERROR("AssetPack::AssetPack - entry %u of '%s' is out of pack bounds.", i, path.c_str());
+                entries = nullptr;
+                names = nullptr;
+                return;
+            }
+        }
+
+        ready = true;
+        DEBUG("Mounted asset pack '%s' with %u entries.", path.c_str(), header->entry_count);
+    };
+
+    AssetPack::~AssetPack() {
+        Platform::UnmapFile(memory, map_handle);
+        memory = nullptr;
+        map_handle = nullptr;
+        ready = false;
+    };
+
+    const AssetPackEntry* AssetPack::Find(const std::string& name) {
+        if (!ready) {
+            return nullptr;
+        }
+
+        u64 hash = HashName(name);
+
+        u32 first = 0;
+        u32 count = header->entry_count;
+        while (count > 0) {
+            u32 step = count / 2;
+            if (entries[first + step].hash < hash) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+
+        for (u32 i = first; i < header->entry_count && entries[i].hash == hash; ++i) {
+            const AssetPackEntry* entry = &entries[i];
+            if (entry->name_length == name.size() && !std::memcmp(names + entry->name_offset, name.data(), name.size())) {
+                return entry;
+            }
+        }
+
+        return nullptr;
+    };
+
+    b8 AssetPack::Read(const AssetPackEntry* entry, std::vector<c8>& out_data) {
+        if (!ready || !entry) {
+            return false;
+        }
+
+        const u8* data = (const u8*)memory + entry->offset;
+        out_data.resize(entry->size);
+
+        if (entry->flags & AssetPackEntryFlag::LZ4) {
+            if (!LZ4::Decompress(data, entry->stored_size, (u8*)out_data.data(), entry->size)) {
+                ERROR("AssetPack::Read - corrupted LZ4 entry '%.*s' in '%s'.", entry->name_length, names + entry->name_offset, path.c_str());
+                out_data.clear();
+                return false;
+            }
+            return true;
+        }
+
+        Platform::CpMemory(out_data.data(), data, entry->size);
+        return true;
+    };
+
+    u64 AssetPack::HashName(const std::string& name) {
+        return HashFNV1a(name.data(), name.size());
+    };
+
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "defines.hpp"
+
+// "EPAK" little endian
+#define ASSET_PACK_MAGIC 0x4B415045U
+#define ASSET_PACK_VERSION 0x0001U
+#define ASSET_PACK_EXTENSION ".epak"
+
+namespace Engine {
+
+    enum class AssetPackEntryFlag : u32 {
+        NONE = 0x00,
+        LZ4 = 0x01
+    };
+
+    ENABLE_BITMASK_OPERATORS(AssetPackEntryFlag)
+
+    // On-disk layout: header, entry data, table of contents sorted by hash, name table.
+    struct AssetPackHeader {
+        u32 magic;
+        u16 version;
+        u16 reserved;
+        u32 entry_count;
+        u32 names_size;
+        u64 toc_offset;
+        u64 names_offset;
+    };
+
+    struct AssetPackEntry {
+        u64 hash;
+        u64 offset;
+        u64 stored_size;
+        u64 size;
+        u32 name_offset;
+        u32 name_length;
+        AssetPackEntryFlag flags;
+        u32 reserved;
+    };
+
+    class AssetPack {
+        public:
+            AssetPack(std::string path);
+            ~AssetPack();
+
+            b8 IsReady() { return ready; };
+            std::string& GetPath() { return path; };
+
+            // Binary search over the table of contents, names are compared only on hash hit.
+            const AssetPackEntry* Find(const std::string& name);
+            b8 Read(const AssetPackEntry* entry, std::vector<c8>& out_data);
+
+            static u64 HashName(const std::string& name);
+
+        protected:
+            std::string path;
+            b8 ready;
+
+            void* memory;
+            void* map_handle;
+            u64 size;
+
+            const AssetPackHeader* header;
+            const AssetPackEntry* entries;
+            const c8* names;
+    };
+
+};
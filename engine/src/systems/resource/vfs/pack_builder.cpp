@@ -0,0 +1,155 @@
+#include "pack_builder.hpp"
+
+#include "core/logger/logger.hpp"
+#include "core/utils/lz4.hpp"
+#include "platform/filesystem.hpp"
+#include "platform/platform.hpp"
+
+#include <filesystem>
+
+// Entry data is aligned so mapped reads start on a cache line.
+#define ASSET_PACK_DATA_ALIGNMENT 64
+
+namespace Engine {
+
+    PackBuilder::PackBuilder(b8 use_lz4) {
+        this->use_lz4 = use_lz4;
+        Platform::ZrMemory(&stats, sizeof(PackBuilderStats));
+    };
+
+    b8 PackBuilder::AddDirectory(std::string root_path) {
+        std::error_code error;
+        std::filesystem::path root(root_path);
+        if (!std::filesystem::is_directory(root, error)) {
+            ERROR("PackBuilder::AddDirectory - '%s' is not a directory.", root_path.c_str());
+            return false;
+        }
+
+        for (auto& item : std::filesystem::recursive_directory_iterator(root, error)) {
+            if (!item.is_regular_file()) {
+                continue;
+            }
+            std::string name = std::filesystem::relative(item.path(), root, error).generic_string();
+            if (!AddFile(item.path().string(), name)) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    b8 PackBuilder::AddFile(std::string file_path, std::string name) {
+        File* file = FileSystem::FileOpen(file_path, FileMode::READ, true);
+        if (!file->IsReady()) {
+            ERROR("PackBuilder::AddFile - unable to open '%s'.", file_path.c_str());
+            FileSystem::FileClose(file);
+            return false;
+        }
+
+        std::vector<c8> bytes = file->ReadAllBytes();
+        FileSystem::FileClose(file);
+
+        PendingEntry entry;
+        entry.name = name;
+        entry.size = bytes.size();
+        entry.flags = AssetPackEntryFlag::NONE;
+
+        if (use_lz4 && bytes.size()) {
+            LZ4::Compress((const u8*)bytes.data(), bytes.size(), entry.data);
+            // Already compressed formats (png, jpg) only get bigger, keep those raw.
+            if (entry.data.size() < bytes.size()) {
+                entry.flags = AssetPackEntryFlag::LZ4;
+                stats.compressed_count++;
+            }
+        }
+
+        if (!(entry.flags & AssetPackEntryFlag::LZ4)) {
+            entry.data.assign(bytes.begin(), bytes.end());
+        }
+
+        stats.entry_count++;
+        stats.source_bytes += entry.size;
+        stats.stored_bytes += entry.data.size();
+
+        pending.push_back(std::move(entry));
+        return true;
+    };
+
+    b8 PackBuilder::Write(std::string pack_path) {
+        std::vector<AssetPackEntry> toc(pending.size());
+        std::string names;
+
+        u64 offset = GetAligned(sizeof(AssetPackHeader), ASSET_PACK_DATA_ALIGNMENT);
+        for (u32 i = 0; i < pending.size(); ++i) {
+            AssetPackEntry& entry = toc[i];
+            Platform::ZrMemory(&entry, sizeof(AssetPackEntry));
+            entry.hash = AssetPack::HashName(pending[i].name);
+            entry.offset = offset;
+            entry.stored_size = pending[i].data.size();
+            entry.size = pending[i].size;
+            entry.name_offset = names.size();
+            entry.name_length = pending[i].name.size();
+            entry.flags = pending[i].flags;
+
+            names += pending[i].name;
+            offset = GetAligned(offset + entry.stored_size, ASSET_PACK_DATA_ALIGNMENT);
+        }
+
+        AssetPackHeader header;
+        Platform::ZrMemory(&header, sizeof(AssetPackHeader));
+        header.magic = ASSET_PACK_MAGIC;
+        header.version = ASSET_PACK_VERSION;
+        header.entry_count = toc.size();
+        header.names_size = names.size();
+        header.toc_offset = offset;
+        header.names_offset = offset + toc.size() * sizeof(AssetPackEntry);
+
+        // Data goes in insertion order, only the table of contents is sorted.
+        std::vector<AssetPackEntry> sorted_toc = toc;
+        std::sort(sorted_toc.begin(), sorted_toc.end(), [&names](const AssetPackEntry& a, const AssetPackEntry& b) {
+            if (a.hash != b.hash) {
+                return a.hash < b.hash;
+            }
+            return names.compare(a.name_offset, a.name_length, names, b.name_offset, b.name_length) < 0;
+        });
+
+        File* file = FileSystem::FileOpen(pack_path, FileMode::WRITE, true);
+        if (!file->IsReady()) {
+            ERROR("PackBuilder::Write - unable to open '%s' for writing.", pack_path.c_str());
+            FileSystem::FileClose(file);
+            return false;
+        }
+
+        u8 padding[ASSET_PACK_DATA_ALIGNMENT];
+        Platform::ZrMemory(padding, ASSET_PACK_DATA_ALIGNMENT);
+
+        u64 written = 0;
+        file->Write(sizeof(AssetPackHeader), &header);
+        written += sizeof(AssetPackHeader);
+
+        for (u32 i = 0; i < pending.size(); ++i) {
+            file->Write(toc[i].offset - written, padding);
+            written = toc[i].offset;
+            if (pending[i].data.size()) {
+                file->Write(pending[i].data.size(), pending[i].data.data());
+            }
+            written += pending[i].data.size();
+        }
+
+        file->Write(header.toc_offset - written, padding);
+        if (sorted_toc.size()) {
+            file->Write(sorted_toc.size() * sizeof(AssetPackEntry), sorted_toc.data());
+        }
+        if (names.size()) {
+            file->Write(names.size(), (void*)names.data());
+        }
+
+        FileSystem::FileClose(file);
+
+        INFO("PackBuilder::Write - '%s': %u entries (%u compressed), %llu -> %llu bytes.",
+            pack_path.c_str(), stats.entry_count, stats.compressed_count, stats.source_bytes, stats.stored_bytes);
+
+        return true;
+    };
+
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "defines.hpp"
+#include "asset_pack.hpp"
+
+namespace Engine {
+
+    struct PackBuilderStats {
+        u32 entry_count;
+        u32 compressed_count;
+        u64 source_bytes;
+        u64 stored_bytes;
+    };
+
+    class ENGINE_API PackBuilder {
+        public:
+            PackBuilder(b8 use_lz4);
+
+            // Adds every file under root_path, entry names are relative to it with '/' separators.
+            b8 AddDirectory(std::string root_path);
+            b8 AddFile(std::string file_path, std::string name);
+
+            b8 Write(std::string pack_path);
+
+            PackBuilderStats& GetStats() { return stats; };
+
+        protected:
+            struct PendingEntry {
+                std::string name;
+                std::vector<u8> data;
+                u64 size;
+                AssetPackEntryFlag flags;
+            };
+
+            b8 use_lz4;
+            std::vector<PendingEntry> pending;
+            PackBuilderStats stats;
+    };
+
+};
@@ -0,0 +1,129 @@
+#include "virtual_file_system.hpp"
+
+#include "core/logger/logger.hpp"
+#include "platform/filesystem.hpp"
+
+#include <filesystem>
+
+namespace Engine {
+
+    VirtualFileSystem::VirtualFileSystem(std::string root_path) {
+        this->root_path = root_path;
+        std::replace(this->root_path.begin(), this->root_path.end(), '\\', '/');
+        this->loose_files = true;
+    };
+
+    VirtualFileSystem::~VirtualFileSystem() {
+        for (AssetPack* pack : packs) {
+            delete pack;
+        }
+        packs.clear();
+    };
+
+    b8 VirtualFileSystem::MountPack(std::string pack_path) {
+        AssetPack* pack = new AssetPack(pack_path);
+        if (!pack->IsReady()) {
+            delete pack;
+            return false;
+        }
+
+        packs.push_back(pack);
+        return true;
+    };
+
+    std::string VirtualFileSystem::ToPackName(const std::string& path) {
+        std::string name = path;
+        std::replace(name.begin(), name.end(), '\\', '/');
+
+        if (name.compare(0, root_path.size(), root_path) == 0) {
+            name.erase(0, root_path.size());
+        }
+
+        u32 start = 0;
+        while (start < name.size() && name[start] == '/') {
+            start++;
+        }
+        return name.substr(start);
+    };
+
+    const AssetPackEntry* VirtualFileSystem::FindInPacks(const std::string& path, AssetPack** out_pack) {
+        if (!packs.size()) {
+            return nullptr;
+        }
+
+        std::string name = ToPackName(path);
+        for (u32 i = packs.size(); i > 0; --i) {
+            const AssetPackEntry* entry = packs[i - 1]->Find(name);
+            if (entry) {
+                *out_pack = packs[i - 1];
+                return entry;
+            }
+        }
+        return nullptr;
+    };
+
+    b8 VirtualFileSystem::Exists(const std::string& path) {
+        AssetPack* pack = nullptr;
+        if (FindInPacks(path, &pack)) {
+            return true;
+        }
+        return loose_files && FileSystem::FileExists(path);
+    };
+
+    b8 VirtualFileSystem::ReadAll(const std::string& path, std::vector<c8>& out_data) {
+        AssetPack* pack = nullptr;
+        const AssetPackEntry* entry = FindInPacks(path, &pack);
+        if (entry) {
+            return pack->Read(entry, out_data);
+        }
+        if (!loose_files) {
+            return false;
+        }
+
+        File* file = FileSystem::FileOpen(path, FileMode::READ, true);
+        if (!file->IsReady()) {
+            FileSystem::FileClose(file);
+            return false;
+        }
+
+        out_data = file->ReadAllBytes();
+        FileSystem::FileClose(file);
+
+        return true;
+    };
+
+    tinyxml2::XMLDocument* VirtualFileSystem::OpenXml(const std::string& path) {
+        tinyxml2::XMLDocument* doc = new tinyxml2::XMLDocument();
+
+        std::vector<c8> data;
+        if (!ReadAll(path, data)) {
+            ERROR("VirtualFileSystem::OpenXml - unable to read '%s'.", path.c_str());
+            return doc;
+        }
+
+        doc->Parse(data.data(), data.size());
+        return doc;
+    };
+
+    b8 VirtualFileSystem::GetFileStamp(const std::string& path, u64* out_mtime, u64* out_size) {
+        AssetPack* pack = nullptr;
+        if (!loose_files || FindInPacks(path, &pack)) {
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+        if (error) {
+            return false;
+        }
+        u64 size = std::filesystem::file_size(path, error);
+        if (error) {
+            return false;
+        }
+
+        *out_mtime = time.time_since_epoch().count();
+        *out_size = size;
+        return true;
+    };
+
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "defines.hpp"
+#include "asset_pack.hpp"
+#include "vendor/tinyxml/tinyxml.hpp"
+
+namespace Engine {
+
+    // Resolves asset paths against mounted packs, and against loose files when those are enabled.
+    // Loose files are on by default, packed paths win over them. Shipping builds that want a miss
+    // to never touch the disk turn them off after mounting.
+    // Paths are the same ones loaders used before, packs store them relative to root_path.
+    class VirtualFileSystem {
+        public:
+            VirtualFileSystem(std::string root_path);
+            ~VirtualFileSystem();
+
+            b8 MountPack(std::string pack_path);
+
+            // Falls back to files on disk for paths no pack has, on unless turned off.
+            void SetLooseFiles(b8 enabled) { loose_files = enabled; };
+            b8 GetLooseFiles() { return loose_files; };
+
+            b8 Exists(const std::string& path);
+            b8 ReadAll(const std::string& path, std::vector<c8>& out_data);
+            tinyxml2::XMLDocument* OpenXml(const std::string& path);
+
+            // Modification time and size of a loose file, false for packed or missing files.
+            b8 GetFileStamp(const std::string& path, u64* out_mtime, u64* out_size);
+
+        protected:
+            std::string ToPackName(const std::string& path);
+            const AssetPackEntry* FindInPacks(const std::string& path, AssetPack** out_pack);
+
+            std::string root_path;
+            // Later mounts take priority.
+            std::vector<AssetPack*> packs;
+            b8 loose_files;
+    };
+
+};
@@ -17,15 +17,16 @@ namespace Engine {
         return false;
     };
 
-    ShaderSystem::ShaderSystem() {};
+    ShaderSystem::ShaderSystem() {
+        current_shader = nullptr;
+    };
 
     ShaderSystem::~ShaderSystem() {
-        for (auto [key, map] : registered_shaders) {
-            delete map.shader;
-            map.ref_count = 0;
-            map.auto_release = false;
+        for (ShaderReference& shader_ref : registered_shaders) {
+            delete shader_ref.shader;
         }
-        registered_shaders.clear();
+        registered_shaders.Clear();
+        shader_handles.clear();
     };
 
     void ShaderSystem::Shutdown() {
@@ -36,15 +37,42 @@ namespace Engine {
         ERROR("ShaderSystem not initialized!");
     };
 
-    Shader* ShaderSystem::GetShader(std::string name) {
-        if (!registered_shaders.count(name)) {
-            ERROR("ShaderSystem::GetShader - Shader not found with name '%s'. Use ShaderSystem::CreateShader to create a shader.", name.c_str());
+    ShaderReference* ShaderSystem::FindShader(const std::string& name, ShaderHandle* out_handle) {
+        auto it = shader_handles.find(name);
+        if (it == shader_handles.end()) {
             return nullptr;
         }
+        if (out_handle) {
+            *out_handle = it->second;
+        }
+        return registered_shaders.Get(it->second);
+    };
+
+    ShaderHandle ShaderSystem::GetShaderHandle(std::string name) {
+        ShaderHandle handle;
+        ShaderReference* shader_ref = FindShader(name, &handle);
+        if (!shader_ref) {
+            ERROR("ShaderSystem::GetShaderHandle - Shader not found with name '%s'. Use ShaderSystem::CreateShader to create a shader.", name.c_str());
+            return ShaderHandle();
+        }
+
+        shader_ref->ref_count++;
+
+        return handle;
+    };
 
-        registered_shaders[name].ref_count++;
+    Shader* ShaderSystem::GetShader(ShaderHandle handle) {
+        ShaderReference* shader_ref = registered_shaders.Get(handle);
+        return shader_ref ? shader_ref->shader : nullptr;
+    };
 
-        return registered_shaders[name].shader;
+    Shader* ShaderSystem::GetShader(std::string name) {
+        return GetShader(GetShaderHandle(name));
+    };
+
+    Shader* ShaderSystem::LookupShader(const std::string& name) {
+        ShaderReference* shader_ref = FindShader(name, nullptr);
+        return shader_ref ? shader_ref->shader : nullptr;
     };
 
     Shader* ShaderSystem::CreateShader(std::string name, b8 auto_release) {
@@ -58,15 +86,25 @@ namespace Engine {
     };
 
     b8 ShaderSystem::ApplyGlobals(std::string name, ParamsData& params) {
-        Shader* shader = GetShader(name);
-        if (shader) {
+        if (!UpdateGlobals(name, params)) {
+            return false;
+        }
+        LookupShader(name)->RecordGlobals();
+        return true;
+    };
+
+    b8 ShaderSystem::UpdateGlobals(std::string name, ParamsData& params) {
+        // Lookup only, applying globals does not take a reference.
+        ShaderReference* shader_ref = FindShader(name, nullptr);
+        if (shader_ref) {
+            Shader* shader = shader_ref->shader;
             shader->BindGlobals();
     
             for (u32 i = 0; i < params.size(); ++i) {
                 shader->SetUniformByName(params[i].name, params[i].data);
             }
             
-            shader->ApplyGlobals();
+            shader->UpdateGlobals();
 
             return true;
         }
@@ -85,9 +123,10 @@ namespace Engine {
 
         Shader* shader = RendererFrontend::GetInstance()->CreateShader(config);
         if (shader && shader->ready) {
-            registered_shaders[shader->GetName()].shader = shader;
-            registered_shaders[shader->GetName()].ref_count = 1;
-            registered_shaders[shader->GetName()].auto_release = auto_release;
+            ShaderHandle handle = registered_shaders.Insert((ShaderReference){shader, auto_release, 1, shader->GetName()});
+            shader_handles[shader->GetName()] = handle;
+            // Slot index doubles as a compact id for render queue sort keys.
+            shader->SetId(handle.index);
             return shader;
         } 
         delete shader;
@@ -104,34 +143,62 @@ namespace Engine {
         return true;
     };
 
+    b8 ShaderSystem::UseShader(ShaderHandle handle) {
+        Shader* shader = GetShader(handle);
+        if (!shader) {
+            ERROR("ShaderSystem::UseShader - Shader not found with handle (index: %u). Use ShaderSystem::CreateShader to create a shader.", handle.index);
+            return false;
+        }
+
+        current_shader = shader;
+        current_shader->Use();
+
+        return true;
+    };
+
     b8 ShaderSystem::UseShader(std::string name) {
-        if (!registered_shaders.count(name)) {
-            ERROR("ShaderSystem::UseShader - Shader not found with name '%s'. Use ShaderSystem::CreateShader to create a shader.");
+        ShaderReference* shader_ref = FindShader(name, nullptr);
+        if (!shader_ref) {
+            ERROR("ShaderSystem::UseShader - Shader not found with name '%s'. Use ShaderSystem::CreateShader to create a shader.", name.c_str());
             return false;
         }
 
-        current_shader = registered_shaders[name].shader;
+        current_shader = shader_ref->shader;
         current_shader->Use();
         
         return true;
     };
 
-    b8 ShaderSystem::DestroyShader(std::string name) {
-        if (!registered_shaders.count(name)) {
-            ERROR("ShaderSystem::DestroyShader - Shader not found with name '%s'. Use ShaderSystem::CreateShader to create a shader.");
+    b8 ShaderSystem::DestroyShader(ShaderHandle handle) {
+        ShaderReference* shader_ref = registered_shaders.Get(handle);
+        if (!shader_ref) {
+            ERROR("ShaderSystem::DestroyShader - Shader not found with handle (index: %u).", handle.index);
             return false;
         }
 
-        ShaderReference* shader_ref = &registered_shaders[name];
-
         shader_ref->ref_count--;
 
         if (shader_ref->auto_release && shader_ref->ref_count == 0) {
+            if (current_shader == shader_ref->shader) {
+                current_shader = nullptr;
+            }
             delete shader_ref->shader;
+            shader_handles.erase(shader_ref->name);
+            registered_shaders.Remove(handle);
         }
         
         return true;
     };
 
+    b8 ShaderSystem::DestroyShader(std::string name) {
+        ShaderHandle handle;
+        if (!FindShader(name, &handle)) {
+            ERROR("ShaderSystem::DestroyShader - Shader not found with name '%s'. Use ShaderSystem::CreateShader to create a shader.", name.c_str());
+            return false;
+        }
+
+        return DestroyShader(handle);
+    };
+
 }   
 
@@ -3,6 +3,7 @@
 #include "defines.hpp"
 #include "renderer/renderer_types.hpp"
 #include "resources/shader/shader.hpp"
+#include "core/utils/slot_map.hpp"
 
 #define DEFAULT_TEXTURE_NAME "default_texture"
 
@@ -12,8 +13,11 @@ namespace Engine {
         Shader* shader;
         b8 auto_release;
         u32 ref_count;
+        std::string name;
     };
 
+    typedef Handle<Shader> ShaderHandle;
+
     struct Param {
         std::string name;
         void* data;
@@ -30,19 +34,31 @@ namespace Engine {
             static void Shutdown();
             static ShaderSystem* GetInstance() { return instance; };
 
+            ShaderHandle GetShaderHandle(std::string name);
+            Shader* GetShader(ShaderHandle handle);
+            b8 UseShader(ShaderHandle handle);
+            b8 DestroyShader(ShaderHandle handle);
+
             Shader* GetShader(std::string name);
+            // Lookup only, unlike GetShader(name) it does not take a reference. For per frame use.
+            Shader* LookupShader(const std::string& name);
             Shader* CreateShader(ShaderConfig& config, b8 auto_release = true);
             Shader* CreateShader(std::string name, b8 auto_release = true);
             b8 UseShader(std::string name);
             b8 DestroyShader(std::string name);
             
             b8 ApplyGlobals(std::string name, ParamsData& params);
+            // Uploads the globals without binding them, see Shader::RecordGlobals.
+            b8 UpdateGlobals(std::string name, ParamsData& params);
 
             b8 SetUniform(std::string& name, const void* value);
 
         private:
+            ShaderReference* FindShader(const std::string& name, ShaderHandle* out_handle);
+
             static ShaderSystem* instance;
-            std::unordered_map<std::string, ShaderReference> registered_shaders;
+            SlotMap<ShaderReference, Shader> registered_shaders;
+            std::unordered_map<std::string, ShaderHandle> shader_handles;
 
             Shader* current_shader;
     };
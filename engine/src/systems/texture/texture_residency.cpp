@@ -0,0 +1,169 @@
+#include "texture_residency.hpp"
+
+#include "renderer/renderer.hpp"
+#include "core/logger/logger.hpp"
+
+namespace Engine {
+
+    TextureResidency::TextureResidency(TextureResidencyConfig config) {
+        this->config = config;
+        resident_bytes = 0;
+        // Starts at 1 so freshly created textures do not count as used this frame.
+        frame = 1;
+    };
+
+    TextureResidency::~TextureResidency() {
+        entries.clear();
+        resident_bytes = 0;
+    };
+
+    Texture* TextureResidency::CreateTexture(TextureCreateInfo& info, TextureMipChain& mip_chain) {
+        u32 placeholder_mip = mip_chain.GetLevelForDimension(config.placeholder_dimension);
+
+        info.mip_chain = &mip_chain;
+        info.resident_mip = placeholder_mip;
+        Texture* texture = RendererFrontend::GetInstance()->CreateTexture(info);
+        info.mip_chain = nullptr;
+
+        if (!texture) {
+            return nullptr;
+        }
+
+        TextureResidencyEntry& entry = entries[texture];
+        entry.texture = texture;
+        entry.mip_chain = std::move(mip_chain);
+        entry.placeholder_mip = placeholder_mip;
+
+        resident_bytes += GetResidentSize(&entry, texture->GetResidentMip());
+
+        return texture;
+    };
+
+    void TextureResidency::Unregister(Texture* texture) {
+        auto it = entries.find(texture);
+        if (it == entries.end()) {
+            return;
+        }
+
+        resident_bytes -= GetResidentSize(&it->second, texture->GetResidentMip());
+        entries.erase(it);
+    };
+
+    u64 TextureResidency::GetResidentSize(TextureResidencyEntry* entry, u32 resident_mip) {
+        return entry->mip_chain.GetSize(resident_mip);
+    };
+
+    b8 TextureResidency::SetResidentMip(TextureResidencyEntry* entry, u32 resident_mip) {
+        u32 current_mip = entry->texture->GetResidentMip();
+        if (current_mip == resident_mip) {
+            return true;
+        }
+
+        u64 old_size = GetResidentSize(entry, current_mip);
+        if (!entry->texture->UploadMips(entry->mip_chain, resident_mip)) {
+            ERROR("TextureResidency::SetResidentMip - failed to make mip %u resident for texture '%s'.", resident_mip, entry->texture->GetName().c_str());
+            return false;
+        }
+
+        resident_bytes = resident_bytes - old_size + GetResidentSize(entry, resident_mip);
+        return true;
+    };
+
+    b8 TextureResidency::EvictFor(u64 required, u64 min_age) {
+        if (resident_bytes + required <= config.budget) {
+            return true;
+        }
+
+        std::vector<TextureResidencyEntry*> candidates;
+        for (auto& [texture, entry] : entries) {
+            if (texture->GetResidentMip() < entry.placeholder_mip && frame - texture->GetLastUsedFrame() >= min_age) {
+                candidates.push_back(&entry);
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [](TextureResidencyEntry* a, TextureResidencyEntry* b) {
+            return a->texture->GetLastUsedFrame() < b->texture->GetLastUsedFrame();
+        });
+
+        for (TextureResidencyEntry* entry : candidates) {
+            u32 current_mip = entry->texture->GetResidentMip();
+            u64 current_size = GetResidentSize(entry, current_mip);
+
+            // Drop only as much detail as needed, never below the placeholder.
+            u32 target_mip = current_mip + 1;
+            while (target_mip < entry->placeholder_mip &&
+                   resident_bytes - current_size + GetResidentSize(entry, target_mip) + required > config.budget) {
+                target_mip++;
+            }
+
+            SetResidentMip(entry, target_mip);
+
+            if (resident_bytes + required <= config.budget) {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    u64 TextureResidency::GetEvictableBytes(u64 min_age) {
+        u64 evictable = 0;
+        for (auto& [texture, entry] : entries) {
+            u32 current_mip = texture->GetResidentMip();
+            if (current_mip < entry.placeholder_mip && frame - texture->GetLastUsedFrame() >= min_age) {
+                evictable += GetResidentSize(&entry, current_mip) - GetResidentSize(&entry, entry.placeholder_mip);
+            }
+        }
+        return evictable;
+    };
+
+    void TextureResidency::Update() {
+        // Budget might have been lowered, textures used last frame are the last ones to go.
+        if (resident_bytes > config.budget && !EvictFor(0, 2)) {
+            EvictFor(0, 0);
+        }
+
+        std::vector<TextureResidencyEntry*> wanted;
+        for (auto& [texture, entry] : entries) {
+            // Never touched textures have no use stamp and stay at their placeholder.
+            u64 last_used = texture->GetLastUsedFrame();
+            if (texture->GetResidentMip() > 0 && last_used && last_used + 1 >= frame) {
+                wanted.push_back(&entry);
+            }
+        }
+
+        // Cheapest upgrades first so more textures get sharp within the per frame limit.
+        std::sort(wanted.begin(), wanted.end(), [this](TextureResidencyEntry* a, TextureResidencyEntry* b) {
+            return GetResidentSize(a, 0) < GetResidentSize(b, 0);
+        });
+
+        u32 stream_ins = 0;
+        for (TextureResidencyEntry* entry : wanted) {
+            if (stream_ins >= config.max_stream_ins_per_frame) {
+                break;
+            }
+
+            u32 current_mip = entry->texture->GetResidentMip();
+            u64 current_size = GetResidentSize(entry, current_mip);
+
+            // Most detailed mip that fits once textures unused for at least two frames give up their detail,
+            // nothing is evicted before the upgrade is known to fit.
+            u64 available = config.budget + GetEvictableBytes(2);
+            u32 target_mip = 0;
+            while (target_mip < current_mip && resident_bytes - current_size + GetResidentSize(entry, target_mip) > available) {
+                target_mip++;
+            }
+            if (target_mip == current_mip) {
+                continue;
+            }
+
+            u64 extra = GetResidentSize(entry, target_mip) - current_size;
+            if (EvictFor(extra, 2) && SetResidentMip(entry, target_mip)) {
+                stream_ins++;
+            }
+        }
+
+        frame++;
+    };
+
+};
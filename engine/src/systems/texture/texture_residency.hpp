@@ -0,0 +1,61 @@
+#pragma once
+
+#include "defines.hpp"
+#include "resources/texture/texture.hpp"
+
+#define TEXTURE_RESIDENCY_DEFAULT_BUDGET 512 MB
+// Mips at or below this dimension are the placeholder and never get evicted.
+#define TEXTURE_RESIDENCY_PLACEHOLDER_DIMENSION 64
+#define TEXTURE_RESIDENCY_MAX_STREAM_INS_PER_FRAME 4
+
+namespace Engine {
+
+    struct TextureResidencyConfig {
+        u64 budget = TEXTURE_RESIDENCY_DEFAULT_BUDGET;
+        u32 placeholder_dimension = TEXTURE_RESIDENCY_PLACEHOLDER_DIMENSION;
+        u32 max_stream_ins_per_frame = TEXTURE_RESIDENCY_MAX_STREAM_INS_PER_FRAME;
+    };
+
+    struct TextureResidencyEntry {
+        Texture* texture;
+        // The whole chain stays in host memory so detail comes back without reloading, the budget
+        // only covers device memory.
+        TextureMipChain mip_chain;
+        u32 placeholder_mip;
+    };
+
+    class TextureResidency {
+        public:
+            TextureResidency(TextureResidencyConfig config);
+            ~TextureResidency();
+
+            // Creates the texture with only placeholder mips resident and takes over the chain.
+            Texture* CreateTexture(TextureCreateInfo& info, TextureMipChain& mip_chain);
+            void Unregister(Texture* texture);
+
+            void Touch(Texture* texture) { texture->MarkUsed(frame); };
+
+            // Called once per frame outside of command recording.
+            void Update();
+
+            void SetBudget(u64 budget) { config.budget = budget; };
+            u64 GetBudget() { return config.budget; };
+            u64 GetResidentBytes() { return resident_bytes; };
+
+        protected:
+            u64 GetResidentSize(TextureResidencyEntry* entry, u32 resident_mip);
+            b8 SetResidentMip(TextureResidencyEntry* entry, u32 resident_mip);
+
+            // Drops detail from least recently used textures not used since min_age frames until
+            // required bytes fit the budget. Returns false if it could not free enough.
+            b8 EvictFor(u64 required, u64 min_age);
+            // Bytes EvictFor could free with the same min_age.
+            u64 GetEvictableBytes(u64 min_age);
+
+            TextureResidencyConfig config;
+            std::unordered_map<Texture*, TextureResidencyEntry> entries;
+            u64 resident_bytes;
+            u64 frame;
+    };
+
+};
@@ -11,19 +11,28 @@ namespace Engine {
     TextureSystem* TextureSystem::instance = nullptr;
 
     TextureSystem::TextureSystem() {
+        residency = new TextureResidency(TextureResidencyConfig());
+
+        InactiveCacheConfig inactive_config;
+        inactive_config.max_bytes = TEXTURE_INACTIVE_CACHE_BUDGET;
+        inactive_config.max_age = TEXTURE_INACTIVE_CACHE_MAX_AGE;
+        inactive.SetConfig(inactive_config);
+
         CreateDefaultTextures();
     };
 
     TextureSystem::~TextureSystem() {
         DestroyDefaultTextures();
 
-        for (auto& [key, map] : registered_textures) { 
-            delete map.texture;
-            map.ref_count = 0;
-            map.auto_release = false;
-        } 
+        for (TextureReference& texture_ref : registered_textures) {
+            residency->Unregister(texture_ref.texture);
+            delete texture_ref.texture;
+        }
 
-        registered_textures.clear();
+        registered_textures.Clear();
+        texture_handles.clear();
+
+        delete residency;
     };
 
     b8 TextureSystem::Initialize() {
@@ -51,29 +60,90 @@ namespace Engine {
         return nullptr;
     };
 
+    TextureHandle TextureSystem::AcquireTextureHandle(std::string name, b8 auto_release) {
+        auto it = texture_handles.find(name);
+        if (it != texture_handles.end()) {
+            TextureReference* texture_ref = registered_textures.Get(it->second);
+            if (texture_ref->ref_count == 0) {
+                inactive.Take(it->second);
+            }
+            texture_ref->ref_count++;
+            return it->second;
+        }
+
+        inactive.RecordMiss();
+        Texture* texture = LoadTexture(name);
+        if (!texture) {
+            ERROR("Failed to load texture '%s'.", name.c_str());
+            return TextureHandle();
+        }
+
+        TextureHandle handle = registered_textures.Insert((TextureReference){texture, auto_release, 1, name});
+        texture_handles[name] = handle;
+        return handle;
+    };
+
+    Texture* TextureSystem::GetTexture(TextureHandle handle) {
+        TextureReference* texture_ref = registered_textures.Get(handle);
+        return texture_ref ? texture_ref->texture : nullptr;
+    };
+
+    void TextureSystem::ReleaseTexture(TextureHandle handle) {
+        TextureReference* texture_ref = registered_textures.Get(handle);
+        if (!texture_ref) {
+            ERROR("TextureSystem::ReleaseTexture called for non-existing texture.");
+            return;
+        }
+
+        texture_ref->ref_count--;
+        if (texture_ref->ref_count == 0 && texture_ref->auto_release) {
+            Texture* texture = texture_ref->texture;
+            u64 size = (u64)texture->GetWidth() * texture->GetHeight() * texture->GetChannelCount();
+            // Full mip chain is a third on top of the base level.
+            inactive.Push(handle, size + size / 3, Platform::GetAbsoluteTime());
+            TrimInactive();
+        }
+    };
+
+    void TextureSystem::DestroyTexture(TextureHandle handle) {
+        TextureReference* texture_ref = registered_textures.Get(handle);
+        if (!texture_ref) {
+            return;
+        }
+
+        residency->Unregister(texture_ref->texture);
+        delete texture_ref->texture;
+        texture_handles.erase(texture_ref->name);
+        registered_textures.Remove(handle);
+    };
+
+    void TextureSystem::TrimInactive() {
+        std::vector<TextureHandle> evicted;
+        inactive.Collect(Platform::GetAbsoluteTime(), evicted);
+
+        // Over the VRAM budget, unreferenced textures go before live ones lose detail.
+        u64 resident = residency->GetResidentBytes();
+        if (resident > residency->GetBudget()) {
+            inactive.CollectBytes(resident - residency->GetBudget(), evicted);
+        }
+
+        for (TextureHandle handle : evicted) {
+            DestroyTexture(handle);
+        }
+    };
+
+    void TextureSystem::UpdateResidency() {
+        TrimInactive();
+        residency->Update();
+    };
+
     Texture* TextureSystem::AcquireTexture(std::string name, b8 auto_release) {
         if (name == DEFAULT_TEXTURE_NAME) {
             WARN("TextureSystem::AcquireTexture called for default texture.");
             return default_diffuse;
         }
 
-        if (registered_textures.count(name)) {
-            registered_textures[name].ref_count++;
-            return registered_textures[name].texture;
-        } else {
-            registered_textures[name].texture = LoadTexture(name);
-            registered_textures[name].auto_release = auto_release;
-            registered_textures[name].ref_count = 1;
-
-            if (!registered_textures[name].texture) {
-                ERROR("Failed to load texture '%s'.", name.c_str());
-                return nullptr;
-            }
-
-            return registered_textures[name].texture;
-        }   
-
-        return nullptr;
+        return GetTexture(AcquireTextureHandle(name, auto_release));
     };
 
     void TextureSystem::ReleaseTexture(std::string name) {
@@ -82,16 +152,13 @@ namespace Engine {
             return;
         }
 
-        if (registered_textures.count(name)) {
-            registered_textures[name].ref_count--;
-            if (registered_textures[name].ref_count == 0 && registered_textures[name].auto_release) {
-                delete registered_textures[name].texture;
-                registered_textures.erase(name);
-            }
+        auto it = texture_handles.find(name);
+        if (it == texture_handles.end()) {
+            ERROR("TextureSystem::ReleaseTexture called for non-existing texture.");
             return;
         }
 
-        ERROR("TextureSystem::ReleaseTexture called for non-existing texture.");
+        ReleaseTexture(it->second);
     };
 
     b8 TextureSystem::CreateDefaultTextures() {
@@ -208,9 +275,14 @@ namespace Engine {
             create_info.channel_count = image->GetChannelCount();
             create_info.flags = image->HasTransparency() ? TextureFlag::HAS_TRANSPARENCY : TextureFlag::NONE;
             create_info.pixels = image->GetPixels();
-            texture = RendererFrontend::GetInstance()->CreateTexture(create_info);
 
-            texture->UpdateGeneration();
+            // Full chain stays on the CPU, the GPU only gets placeholder mips until the texture is used.
+            TextureMipChain mip_chain(image->GetPixels(), image->GetWidth(), image->GetHeight(), image->GetChannelCount());
+            texture = residency->CreateTexture(create_info, mip_chain);
+
+            if (texture) {
+                texture->UpdateGeneration();
+            }
         }
 
         delete image;
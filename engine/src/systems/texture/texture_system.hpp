@@ -3,19 +3,29 @@
 #include "defines.hpp"
 #include "renderer/renderer_types.hpp"
 #include "resources/texture/texture.hpp"
+#include "texture_residency.hpp"
+#include "core/utils/slot_map.hpp"
+#include "core/utils/inactive_cache.hpp"
 
 #define DEFAULT_TEXTURE_NAME "default_texture"
 #define DEFAULT_SPECULAR_NAME "default_specular"
 #define DEFAULT_NORMAL_NAME "default_normal"
 
+// Released textures stay loaded until one of these limits is hit.
+#define TEXTURE_INACTIVE_CACHE_BUDGET 256 MB
+#define TEXTURE_INACTIVE_CACHE_MAX_AGE 60.0
+
 namespace Engine {
 
     struct TextureReference {
         Texture* texture;
         b8 auto_release;
         u32 ref_count;
+        std::string name;
     };
 
+    typedef Handle<Texture> TextureHandle;
+
     class ENGINE_API TextureSystem {
         public:
             TextureSystem();
@@ -26,6 +36,10 @@ namespace Engine {
             static TextureSystem* GetInstance();
 
             Texture* AcquireWriteableTexture(std::string name, u32 width, u32 height, u8 channel_count, b8 has_transparency, b8 register_texture);
+            TextureHandle AcquireTextureHandle(std::string name, b8 auto_release = true);
+            Texture* GetTexture(TextureHandle handle);
+            void ReleaseTexture(TextureHandle handle);
+
             Texture* AcquireTexture(std::string name, b8 auto_release = true);
             void ReleaseTexture(std::string name);
 
@@ -38,14 +52,30 @@ namespace Engine {
             Texture* GetDefaultNormal() { return default_normal; };
 
             Texture* LoadTexture(std::string texture_name);
+
+            // Residency bookkeeping for loaded textures, Update must run once per frame.
+            void TouchTexture(Texture* texture) { residency->Touch(texture); };
+            void UpdateResidency();
+            void SetResidencyBudget(u64 budget) { residency->SetBudget(budget); };
+            u64 GetResidentBytes() { return residency->GetResidentBytes(); };
+
+            // Zero-ref textures with auto_release wait here before being destroyed.
+            void TrimInactive();
+            void SetInactiveCacheConfig(InactiveCacheConfig config) { inactive.SetConfig(config); };
+            InactiveCacheStats& GetInactiveCacheStats() { return inactive.GetStats(); };
         
         private:
+            void DestroyTexture(TextureHandle handle);
+
             static TextureSystem* instance;
             Texture* default_texture;
             Texture* default_diffuse;
             Texture* default_specular;
             Texture* default_normal;
-            std::unordered_map<std::string, TextureReference> registered_textures;
+            TextureResidency* residency;
+            SlotMap<TextureReference, Texture> registered_textures;
+            std::unordered_map<std::string, TextureHandle> texture_handles;
+            InactiveCache<Texture> inactive;
     };
 
 };
\ No newline at end of file
@@ -0,0 +1,431 @@
+#include "transform_system.hpp"
+
+#include "core/logger/logger.hpp"
+#include "math/transform/transform.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <xmmintrin.h>
+    #define TRANSFORM_SYSTEM_SSE
+#endif
+
+namespace Engine {
+
+    TransformSystem* TransformSystem::instance = nullptr;
+
+    TransformSystem::TransformSystem() {
+        has_dirty = false;
+        needs_compact = false;
+        needs_sort = false;
+    };
+
+    TransformSystem::~TransformSystem() {
+        if (owners.size()) {
+            DEBUG("|_%u transforms still alive on shutdown.", owners.size());
+        }
+    };
+
+    b8 TransformSystem::Initialize() {
+        if (!instance) {
+            instance = new TransformSystem();
+            return true;
+        }
+        WARN("TransformSystem is already initialized.");
+        return true;
+    };
+
+    void TransformSystem::Shutdown() {
+        if (instance) {
+            DEBUG("Shutting down TransformSystem.");
+            delete instance;
+            // Transforms deleted after this point must not reach into a dead system.
+            instance = nullptr;
+            return;
+        }
+        ERROR("TransformSystem is not initialized.");
+    };
+
+    u32 TransformSystem::Create(Transform* owner, glm::vec3 position, glm::quat rotation, glm::vec3 scale, Transform* parent) {
+        u32 slot;
+        if (free_slots.size()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            slot = slot_to_dense.size();
+            slot_to_dense.push_back(INVALID_ID);
+        }
+
+        // Appending keeps the parent before the child.
+        u32 dense_index = owners.size();
+        slot_to_dense[slot] = dense_index;
+        dense_to_slot.push_back(slot);
+
+        f32 values[COMPONENT_COUNT] = {
+            position.x, position.y, position.z,
+            rotation.x, rotation.y, rotation.z, rotation.w,
+            scale.x, scale.y, scale.z
+        };
+        for (u32 i = 0; i < COMPONENT_COUNT; ++i) {
+            components[i].push_back(values[i]);
+        }
+
+        locals.push_back(glm::identity<glm::mat4>());
+        worlds.push_back(glm::identity<glm::mat4>());
+        parents.push_back(parent ? Dense(parent->GetId()) : INVALID_ID);
+        flags.push_back(TransformFlag::LOCAL_DIRTY | TransformFlag::WORLD_DIRTY);
+        owners.push_back(owner);
+        has_dirty = true;
+
+        return slot;
+    };
+
+    void TransformSystem::Destroy(u32 id) {
+        if (id >= slot_to_dense.size() || slot_to_dense[id] == INVALID_ID) {
+            ERROR("TransformSystem::Destroy - invalid transform id %u.", id);
+            return;
+        }
+
+        // Removal is deferred to the next Update so the arrays stay parent sorted.
+        u32 dense_index = Dense(id);
+        flags[dense_index] |= TransformFlag::DEAD;
+        owners[dense_index] = nullptr;
+        dense_to_slot[dense_index] = INVALID_ID;
+        slot_to_dense[id] = INVALID_ID;
+        free_slots.push_back(id);
+        needs_compact = true;
+    };
+
+    glm::vec3 TransformSystem::GetPosition(u32 id) {
+        u32 i = Dense(id);
+        return {components[POSITION_X][i], components[POSITION_Y][i], components[POSITION_Z][i]};
+    };
+
+    glm::quat TransformSystem::GetRotation(u32 id) {
+        u32 i = Dense(id);
+        return glm::quat(components[ROTATION_W][i], components[ROTATION_X][i], components[ROTATION_Y][i], components[ROTATION_Z][i]);
+    };
+
+    glm::vec3 TransformSystem::GetScale(u32 id) {
+        u32 i = Dense(id);
+        return {components[SCALE_X][i], components[SCALE_Y][i], components[SCALE_Z][i]};
+    };
+
+    void TransformSystem::SetPosition(u32 id, glm::vec3 position) {
+        u32 i = Dense(id);
+        components[POSITION_X][i] = position.x;
+        components[POSITION_Y][i] = position.y;
+        components[POSITION_Z][i] = position.z;
+        MarkDirty(i);
+    };
+
+    void TransformSystem::SetRotation(u32 id, glm::quat rotation) {
+        u32 i = Dense(id);
+        components[ROTATION_X][i] = rotation.x;
+        components[ROTATION_Y][i] = rotation.y;
+        components[ROTATION_Z][i] = rotation.z;
+        components[ROTATION_W][i] = rotation.w;
+        MarkDirty(i);
+    };
+
+    void TransformSystem::SetScale(u32 id, glm::vec3 scale) {
+        u32 i = Dense(id);
+        components[SCALE_X][i] = scale.x;
+        components[SCALE_Y][i] = scale.y;
+        components[SCALE_Z][i] = scale.z;
+        MarkDirty(i);
+    };
+
+    b8 TransformSystem::SetParent(u32 id, Transform* parent) {
+        u32 dense_index = Dense(id);
+        u32 parent_index = parent ? Dense(parent->GetId()) : INVALID_ID;
+
+        for (u32 ancestor = parent_index; ancestor != INVALID_ID; ancestor = parents[ancestor]) {
+            if (ancestor == dense_index) {
+                WARN("TransformSystem::SetParent - parenting would create a cycle, ignoring.");
+                return false;
+            }
+        }
+
+        parents[dense_index] = parent_index;
+        if (parent_index != INVALID_ID && parent_index > dense_index) {
+            needs_sort = true;
+        }
+
+        flags[dense_index] |= TransformFlag::WORLD_DIRTY;
+        has_dirty = true;
+        return true;
+    };
+
+    Transform* TransformSystem::GetParent(u32 id) {
+        u32 parent_index = parents[Dense(id)];
+        return parent_index != INVALID_ID ? owners[parent_index] : nullptr;
+    };
+
+    const glm::mat4& TransformSystem::GetLocal(u32 id) {
+        if (has_dirty || needs_compact || needs_sort) {
+            Update();
+        }
+        return locals[Dense(id)];
+    };
+
+    const glm::mat4& TransformSystem::GetWorld(u32 id) {
+        if (has_dirty || needs_compact || needs_sort) {
+            Update();
+        }
+        return worlds[Dense(id)];
+    };
+
+    void TransformSystem::MarkDirty(u32 dense_index) {
+        flags[dense_index] |= TransformFlag::LOCAL_DIRTY | TransformFlag::WORLD_DIRTY;
+        has_dirty = true;
+    };
+
+    void TransformSystem::Update() {
+        if (!has_dirty && !needs_compact && !needs_sort) {
+            return;
+        }
+
+        if (needs_compact) {
+            Compact();
+        }
+        if (needs_sort) {
+            SortByDepth();
+        }
+
+        ComposeLocals();
+
+        // Parents come first, so a dirty parent has already been resolved when its children are reached.
+        u32 count = owners.size();
+        for (u32 i = 0; i < count; ++i) {
+            u32 parent = parents[i];
+            if (parent != INVALID_ID && (flags[parent] & TransformFlag::WORLD_DIRTY)) {
+                flags[i] |= TransformFlag::WORLD_DIRTY;
+            }
+            if (flags[i] & TransformFlag::WORLD_DIRTY) {
+                worlds[i] = parent != INVALID_ID ? worlds[parent] * locals[i] : locals[i];
+            }
+        }
+
+        std::fill(flags.begin(), flags.end(), TransformFlag::NONE);
+        has_dirty = false;
+    };
+
+    void TransformSystem::Compact() {
+        u32 count = owners.size();
+        std::vector<u32> remap(count, INVALID_ID);
+        u32 alive = 0;
+        for (u32 i = 0; i < count; ++i) {
+            if (!(flags[i] & TransformFlag::DEAD)) {
+                remap[i] = alive++;
+            }
+        }
+
+        // Stable, so parent order survives. Children of destroyed transforms become roots.
+        for (u32 i = 0; i < count; ++i) {
+            u32 write = remap[i];
+            if (write == INVALID_ID) {
+                continue;
+            }
+
+            u32 parent = parents[i];
+            for (u32 c = 0; c < COMPONENT_COUNT; ++c) {
+                components[c][write] = components[c][i];
+            }
+            locals[write] = locals[i];
+            worlds[write] = worlds[i];
+            flags[write] = flags[i];
+            owners[write] = owners[i];
+            dense_to_slot[write] = dense_to_slot[i];
+            slot_to_dense[dense_to_slot[write]] = write;
+
+            if (parent != INVALID_ID && remap[parent] == INVALID_ID) {
+                parents[write] = INVALID_ID;
+                flags[write] |= TransformFlag::WORLD_DIRTY;
+                has_dirty = true;
+            } else {
+                parents[write] = parent != INVALID_ID ? remap[parent] : INVALID_ID;
+            }
+        }
+
+        for (u32 c = 0; c < COMPONENT_COUNT; ++c) {
+            components[c].resize(alive);
+        }
+        locals.resize(alive);
+        worlds.resize(alive);
+        parents.resize(alive);
+        flags.resize(alive);
+        owners.resize(alive);
+        dense_to_slot.resize(alive);
+
+        needs_compact = false;
+    };
+
+    void TransformSystem::SortByDepth() {
+        u32 count = owners.size();
+
+        // Depth of every node, each chain is only walked once.
+        std::vector<u32> depth(count, INVALID_ID);
+        std::vector<u32> chain;
+        u32 max_depth = 0;
+        for (u32 i = 0; i < count; ++i) {
+            u32 node = i;
+            while (node != INVALID_ID && depth[node] == INVALID_ID) {
+                chain.push_back(node);
+                node = parents[node];
+            }
+            u32 base = node == INVALID_ID ? 0 : depth[node] + 1;
+            while (chain.size()) {
+                depth[chain.back()] = base++;
+                chain.pop_back();
+            }
+            max_depth = std::max(max_depth, depth[i]);
+        }
+
+        // Stable counting sort on depth puts every parent ahead of its children.
+        std::vector<u32> offsets(max_depth + 2, 0);
+        for (u32 i = 0; i < count; ++i) {
+            offsets[depth[i] + 1]++;
+        }
+        for (u32 d = 1; d < offsets.size(); ++d) {
+            offsets[d] += offsets[d - 1];
+        }
+        std::vector<u32> remap(count);
+        for (u32 i = 0; i < count; ++i) {
+            remap[i] = offsets[depth[i]]++;
+        }
+
+        for (u32 c = 0; c < COMPONENT_COUNT; ++c) {
+            std::vector<f32> sorted(count);
+            for (u32 i = 0; i < count; ++i) {
+                sorted[remap[i]] = components[c][i];
+            }
+            components[c].swap(sorted);
+        }
+
+        std::vector<glm::mat4> sorted_locals(count);
+        std::vector<glm::mat4> sorted_worlds(count);
+        std::vector<u32> sorted_parents(count);
+        std::vector<TransformFlag> sorted_flags(count);
+        std::vector<Transform*> sorted_owners(count);
+        std::vector<u32> sorted_slots(count);
+        for (u32 i = 0; i < count; ++i) {
+            u32 write = remap[i];
+            sorted_locals[write] = locals[i];
+            sorted_worlds[write] = worlds[i];
+            sorted_parents[write] = parents[i] != INVALID_ID ? remap[parents[i]] : INVALID_ID;
+            sorted_flags[write] = flags[i];
+            sorted_owners[write] = owners[i];
+            sorted_slots[write] = dense_to_slot[i];
+            slot_to_dense[dense_to_slot[i]] = write;
+        }
+
+        locals.swap(sorted_locals);
+        worlds.swap(sorted_worlds);
+        parents.swap(sorted_parents);
+        flags.swap(sorted_flags);
+        owners.swap(sorted_owners);
+        dense_to_slot.swap(sorted_slots);
+
+        needs_sort = false;
+    };
+
+    void TransformSystem::ComposeLocals() {
+        dirty_locals.clear();
+        u32 count = owners.size();
+        for (u32 i = 0; i < count; ++i) {
+            if (flags[i] & TransformFlag::LOCAL_DIRTY) {
+                dirty_locals.push_back(i);
+            }
+        }
+
+        u32 i = 0;
+#ifdef TRANSFORM_SYSTEM_SSE
+        // Four transforms at a time, one per lane, straight from the component arrays.
+        for (; i + 4 <= dirty_locals.size(); i += 4) {
+            const u32* ids = &dirty_locals[i];
+            __m128 c[COMPONENT_COUNT];
+            for (u32 k = 0; k < COMPONENT_COUNT; ++k) {
+                const f32* values = components[k].data();
+                c[k] = _mm_set_ps(values[ids[3]], values[ids[2]], values[ids[1]], values[ids[0]]);
+            }
+
+            __m128 one = _mm_set1_ps(1.0f);
+            __m128 x2 = _mm_add_ps(c[ROTATION_X], c[ROTATION_X]);
+            __m128 y2 = _mm_add_ps(c[ROTATION_Y], c[ROTATION_Y]);
+            __m128 z2 = _mm_add_ps(c[ROTATION_Z], c[ROTATION_Z]);
+            __m128 xx = _mm_mul_ps(c[ROTATION_X], x2);
+            __m128 yy = _mm_mul_ps(c[ROTATION_Y], y2);
+            __m128 zz = _mm_mul_ps(c[ROTATION_Z], z2);
+            __m128 xy = _mm_mul_ps(c[ROTATION_X], y2);
+            __m128 xz = _mm_mul_ps(c[ROTATION_X], z2);
+            __m128 yz = _mm_mul_ps(c[ROTATION_Y], z2);
+            __m128 wx = _mm_mul_ps(c[ROTATION_W], x2);
+            __m128 wy = _mm_mul_ps(c[ROTATION_W], y2);
+            __m128 wz = _mm_mul_ps(c[ROTATION_W], z2);
+
+            // Rotation columns.
+            __m128 r00 = _mm_sub_ps(one, _mm_add_ps(yy, zz));
+            __m128 r01 = _mm_add_ps(xy, wz);
+            __m128 r02 = _mm_sub_ps(xz, wy);
+            __m128 r10 = _mm_sub_ps(xy, wz);
+            __m128 r11 = _mm_sub_ps(one, _mm_add_ps(xx, zz));
+            __m128 r12 = _mm_add_ps(yz, wx);
+            __m128 r20 = _mm_add_ps(xz, wy);
+            __m128 r21 = _mm_sub_ps(yz, wx);
+            __m128 r22 = _mm_sub_ps(one, _mm_add_ps(xx, yy));
+
+            __m128 tx = c[POSITION_X];
+            __m128 ty = c[POSITION_Y];
+            __m128 tz = c[POSITION_Z];
+
+            // rotation * translation * scale, same composition as before.
+            __m128 out[12] = {
+                _mm_mul_ps(r00, c[SCALE_X]), _mm_mul_ps(r01, c[SCALE_X]), _mm_mul_ps(r02, c[SCALE_X]),
+                _mm_mul_ps(r10, c[SCALE_Y]), _mm_mul_ps(r11, c[SCALE_Y]), _mm_mul_ps(r12, c[SCALE_Y]),
+                _mm_mul_ps(r20, c[SCALE_Z]), _mm_mul_ps(r21, c[SCALE_Z]), _mm_mul_ps(r22, c[SCALE_Z]),
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(r00, tx), _mm_mul_ps(r10, ty)), _mm_mul_ps(r20, tz)),
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(r01, tx), _mm_mul_ps(r11, ty)), _mm_mul_ps(r21, tz)),
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(r02, tx), _mm_mul_ps(r12, ty)), _mm_mul_ps(r22, tz))
+            };
+
+            alignas(16) f32 lanes[12][4];
+            for (u32 k = 0; k < 12; ++k) {
+                _mm_store_ps(lanes[k], out[k]);
+            }
+
+            for (u32 lane = 0; lane < 4; ++lane) {
+                glm::mat4& m = locals[ids[lane]];
+                m[0] = glm::vec4(lanes[0][lane], lanes[1][lane], lanes[2][lane], 0.0f);
+                m[1] = glm::vec4(lanes[3][lane], lanes[4][lane], lanes[5][lane], 0.0f);
+                m[2] = glm::vec4(lanes[6][lane], lanes[7][lane], lanes[8][lane], 0.0f);
+                m[3] = glm::vec4(lanes[9][lane], lanes[10][lane], lanes[11][lane], 1.0f);
+            }
+        }
+#endif
+        for (; i < dirty_locals.size(); ++i) {
+            ComposeLocal(dirty_locals[i]);
+        }
+    };
+
+    void TransformSystem::ComposeLocal(u32 dense_index) {
+        u32 i = dense_index;
+        f32 x = components[ROTATION_X][i];
+        f32 y = components[ROTATION_Y][i];
+        f32 z = components[ROTATION_Z][i];
+        f32 w = components[ROTATION_W][i];
+        f32 xx = 2.0f * x * x, yy = 2.0f * y * y, zz = 2.0f * z * z;
+        f32 xy = 2.0f * x * y, xz = 2.0f * x * z, yz = 2.0f * y * z;
+        f32 wx = 2.0f * w * x, wy = 2.0f * w * y, wz = 2.0f * w * z;
+
+        glm::vec3 r0(1.0f - (yy + zz), xy + wz, xz - wy);
+        glm::vec3 r1(xy - wz, 1.0f - (xx + zz), yz + wx);
+        glm::vec3 r2(xz + wy, yz - wx, 1.0f - (xx + yy));
+        glm::vec3 t = r0 * components[POSITION_X][i] + r1 * components[POSITION_Y][i] + r2 * components[POSITION_Z][i];
+
+        glm::mat4& m = locals[i];
+        m[0] = glm::vec4(r0 * components[SCALE_X][i], 0.0f);
+        m[1] = glm::vec4(r1 * components[SCALE_Y][i], 0.0f);
+        m[2] = glm::vec4(r2 * components[SCALE_Z][i], 0.0f);
+        m[3] = glm::vec4(t, 1.0f);
+    };
+
+};
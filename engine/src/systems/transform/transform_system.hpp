@@ -0,0 +1,91 @@
+#pragma once
+
+#include "defines.hpp"
+
+namespace Engine {
+
+    class Transform;
+
+    enum class TransformFlag {
+        NONE = 0x00,
+        LOCAL_DIRTY = 0x01,
+        WORLD_DIRTY = 0x02,
+        DEAD = 0x04
+    };
+
+    ENABLE_BITMASK_OPERATORS(TransformFlag)
+
+    // Owns every transform in the scene. Local TRS and matrices live in structure of arrays
+    // sorted so that a parent always comes before its children, which lets Update recompute
+    // only the changed world matrices in a single front to back pass.
+    // Transform objects only keep a stable id into these arrays.
+    class ENGINE_API TransformSystem {
+        public:
+            TransformSystem();
+            ~TransformSystem();
+
+            static b8 Initialize();
+            static void Shutdown();
+            static TransformSystem* GetInstance() { return instance; };
+
+            u32 Create(Transform* owner, glm::vec3 position, glm::quat rotation, glm::vec3 scale, Transform* parent);
+            void Destroy(u32 id);
+
+            glm::vec3 GetPosition(u32 id);
+            glm::quat GetRotation(u32 id);
+            glm::vec3 GetScale(u32 id);
+
+            void SetPosition(u32 id, glm::vec3 position);
+            void SetRotation(u32 id, glm::quat rotation);
+            void SetScale(u32 id, glm::vec3 scale);
+
+            b8 SetParent(u32 id, Transform* parent);
+            Transform* GetParent(u32 id);
+
+            // Both bring the hierarchy up to date first if anything changed since the last Update.
+            const glm::mat4& GetLocal(u32 id);
+            const glm::mat4& GetWorld(u32 id);
+
+            // Composes dirty locals in batches and propagates world matrices down the hierarchy.
+            void Update();
+
+            u32 GetCount() { return owners.size(); };
+
+        private:
+            enum Component {
+                POSITION_X, POSITION_Y, POSITION_Z,
+                ROTATION_X, ROTATION_Y, ROTATION_Z, ROTATION_W,
+                SCALE_X, SCALE_Y, SCALE_Z,
+                COMPONENT_COUNT
+            };
+
+            u32 Dense(u32 id) { return slot_to_dense[id]; };
+            void MarkDirty(u32 dense_index);
+
+            void Compact();
+            void SortByDepth();
+            void ComposeLocals();
+            void ComposeLocal(u32 dense_index);
+
+            static TransformSystem* instance;
+
+            // Dense, parent sorted arrays.
+            std::vector<f32> components[COMPONENT_COUNT];
+            std::vector<glm::mat4> locals;
+            std::vector<glm::mat4> worlds;
+            std::vector<u32> parents;
+            std::vector<TransformFlag> flags;
+            std::vector<Transform*> owners;
+            std::vector<u32> dense_to_slot;
+
+            // Stable ids handed to Transform.
+            std::vector<u32> slot_to_dense;
+            std::vector<u32> free_slots;
+
+            std::vector<u32> dirty_locals;
+            b8 has_dirty;
+            b8 needs_compact;
+            b8 needs_sort;
+    };
+
+};
@@ -0,0 +1,41 @@
+#include "defines.hpp"
+#include "core/logger/logger.hpp"
+#include "systems/resource/vfs/pack_builder.hpp"
+
+// Usage: packer <assets directory> [output pack] [--no-lz4]
+// Output defaults to '<assets directory>.epak', which is where ResourceSystem looks for it.
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: packer <assets directory> [output pack] [--no-lz4]\n");
+        return 1;
+    }
+
+    Engine::Logger::Initialize();
+
+    std::string assets_path = argv[1];
+    while (assets_path.size() > 1 && (assets_path.back() == '/' || assets_path.back() == '\\')) {
+        assets_path.pop_back();
+    }
+
+    std::string pack_path = assets_path + ASSET_PACK_EXTENSION;
+    b8 use_lz4 = true;
+    for (i32 i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--no-lz4") {
+            use_lz4 = false;
+        } else {
+            pack_path = arg;
+        }
+    }
+
+    Engine::PackBuilder builder(use_lz4);
+    b8 result = builder.AddDirectory(assets_path) && builder.Write(pack_path);
+
+    Engine::PackBuilderStats& stats = builder.GetStats();
+    printf("%s: %u entries, %u compressed, %llu -> %llu bytes\n",
+        pack_path.c_str(), stats.entry_count, stats.compressed_count, stats.source_bytes, stats.stored_bytes);
+
+    Engine::Logger::Shutdown();
+
+    return result ? 0 : 1;
+}
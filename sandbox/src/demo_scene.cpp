@@ -11,8 +11,11 @@ DemoScene::DemoScene() {
 }
 
 DemoScene::~DemoScene() {
+    // Meshes give their geometry references back, the renderer must not draw them anymore.
+    RendererFrontend::GetInstance()->meshes.clear();
     for (auto mesh : meshes)
         delete mesh;
+    meshes.clear();
 }
 
 bool DemoScene::Initialize() {
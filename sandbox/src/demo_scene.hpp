@@ -10,6 +10,6 @@ public:
 
 private:
     std::vector<Engine::Mesh*> meshes;
-    Engine::Geometry* test_ui_geometry;
+    Engine::GeometryHandle test_ui_geometry;
     void CreateMeshes();
 };
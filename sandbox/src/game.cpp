@@ -62,6 +62,19 @@ bool Game::Update(float delta, Engine::InputSystem* input) {
         Engine::EventSystem::GetInstance()->FireEvent(Engine::EventType::Debug5, {});
     }
 
+    if (input->IsKeyUp(Engine::Keys::KEYBOARD_P) && input->WasKeyDown(Engine::Keys::KEYBOARD_P)) {
+        if (recording_path) {
+            recording_path = false;
+            if (camera_path.Save("camera_path.campath")) {
+                Engine::Logger::Info("Saved %u camera path frames to camera_path.campath.", camera_path.GetFrameCount());
+            }
+        } else {
+            recording_path = true;
+            camera_path.Clear();
+            Engine::Logger::Info("Recording camera path, press P again to stop.");
+        }
+    }
+
 
     if (input->IsKeyDown(Engine::Keys::KEYBOARD_LEFT)) {
         cs->GetActive()->Yaw(-1.0f * delta);
@@ -111,6 +124,10 @@ bool Game::Update(float delta, Engine::InputSystem* input) {
         u32 frame_width = Engine::RendererFrontend::GetFrameWidthS();
         Engine::Platform::SetCursorPosition(frame_width * 0.5, frame_height * 0.5);
     }
+
+    if (recording_path) {
+        camera_path.Record(cs->GetActive());
+    }
             
     return true;
 };
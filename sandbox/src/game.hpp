@@ -3,6 +3,7 @@
 #include <core/logger/logger.hpp>
 #include <platform/platform.hpp>
 #include <renderer/renderer.hpp>
+#include <camera/camera_path.hpp>
 #include "demo_scene.hpp"
 
 class Game {
@@ -26,5 +27,9 @@ private:
     b8 lock_cursor = false;
     DemoScene* demo;
 
+    // P starts and stops recording the active camera, saved for the bench target to replay.
+    Engine::CameraPath camera_path;
+    b8 recording_path = false;
+
     u32 curr = 3;
 };
\ No newline at end of file